@@ -106,7 +106,7 @@ void setup()
         if (std::fabs(srceen_cont_pos_x) > 60)
             srceen_cont_pos_x = 0;
         if (std::fabs(srceen_cont_pos_y) > 330)
-            srceen_cont_pos_y = 170;
+            srceen_cont_pos_y = 168;
     }
     else
     {
@@ -248,6 +248,9 @@ void setup()
         return;
     }
 
+    // Render only the part of the panel visible through the prism
+    amoled.setViewport(srceen_cont_pos_x, srceen_cont_pos_y, GLASS_VIEWPORT_WIDTH, GLASS_VIEWPORT_HEIGHT);
+
     beginLvglHelper(amoled, false);
     lv_gui_init(&ui);
 
@@ -559,33 +562,17 @@ void touch_event_callback(ButtonState state)
                 default:
                     break;
                 }
+                // Keep the stored position inside the panel
+                srceen_cont_pos_x = constrain(srceen_cont_pos_x, 0, amoled.width() - GLASS_VIEWPORT_WIDTH);
+                srceen_cont_pos_y = constrain(srceen_cont_pos_y, 0, amoled.height() - GLASS_VIEWPORT_HEIGHT);
                 Serial.printf("X: %d\n", srceen_cont_pos_x);
                 Serial.printf("Y: %d\n", srceen_cont_pos_y);
                 EEPROM.write(0, 1);
                 EEPROM.write(1, srceen_cont_pos_x);
                 EEPROM.write(2, srceen_cont_pos_y);
                 EEPROM.commit();
-                lv_obj_set_pos(ui.screen_time_cont, srceen_cont_pos_x, srceen_cont_pos_y);
-                lv_obj_set_pos(ui.screen_pos_cont, srceen_cont_pos_x, srceen_cont_pos_y);
-                lv_obj_set_pos(ui.screen_direction_cont, srceen_cont_pos_x, srceen_cont_pos_y);
-                lv_obj_set_pos(ui.screen_sensor_cont, srceen_cont_pos_x, srceen_cont_pos_y);
-                lv_obj_set_pos(ui.screen_voltage_cont, srceen_cont_pos_x, srceen_cont_pos_y);
-                lv_obj_set_pos(ui.screen_esp_now_cont, srceen_cont_pos_x, srceen_cont_pos_y);
-                lv_obj_set_pos(ui.screen_set_cont, srceen_cont_pos_x, srceen_cont_pos_y);
-                lv_obj_set_pos(ui.screen_tileview_set_cont, srceen_cont_pos_x, srceen_cont_pos_y);
-                lv_obj_set_pos(ui.screen_wifi_rssi_cont, srceen_cont_pos_x, srceen_cont_pos_y);
-                lv_obj_set_pos(ui.screen_mic_cont, srceen_cont_pos_x, srceen_cont_pos_y);
-
-                lv_obj_update_layout(ui.screen_time_cont);
-                lv_obj_update_layout(ui.screen_pos_cont);
-                lv_obj_update_layout(ui.screen_direction_cont);
-                lv_obj_update_layout(ui.screen_sensor_cont);
-                lv_obj_update_layout(ui.screen_voltage_cont);
-                lv_obj_update_layout(ui.screen_esp_now_cont);
-                lv_obj_update_layout(ui.screen_set_cont);
-                lv_obj_update_layout(ui.screen_tileview_set_cont);
-                lv_obj_update_layout(ui.screen_wifi_rssi_cont);
-                lv_obj_update_layout(ui.screen_mic_cont);
+                // Only the viewport moves, the screens stay at 0,0
+                setLvglViewportOffset(srceen_cont_pos_x, srceen_cont_pos_y);
             }
             page_lock = true;
 
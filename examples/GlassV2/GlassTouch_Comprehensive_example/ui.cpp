@@ -2,14 +2,14 @@
 #include <Arduino.h>
 #include "event_init.h"
 
-// width:126
-// hight:294
+// LVGL only renders the 126x126 viewport visible through the prism,
+// srceen_cont_pos_x/y place that viewport on the 126x294 panel
 #define srceen_width 126
-#define screen_hight 294
+#define screen_hight 126
 extern LilyGo_Class amoled;
 
 int16_t srceen_cont_pos_x = 0;
-int16_t srceen_cont_pos_y = 170; // 170
+int16_t srceen_cont_pos_y = 168; // 168
 int8_t srceen_current = 0;       // main srceen
 int8_t srceen_last = 0;          // main srceen
 const char *week_char[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
@@ -318,7 +318,7 @@ void gui_time_init(lv_ui *ui)
 
     // Write codes screen_time_srceen_cont
     ui->screen_time_cont = lv_obj_create(ui->screen_time);
-    lv_obj_set_pos(ui->screen_time_cont, srceen_cont_pos_x, srceen_cont_pos_y);
+    lv_obj_set_pos(ui->screen_time_cont, 0, 0);
     lv_obj_set_size(ui->screen_time_cont, 126, 126);
     lv_obj_set_scrollbar_mode(ui->screen_time_cont, LV_SCROLLBAR_MODE_OFF);
 
@@ -429,7 +429,7 @@ void gui_pos_init(lv_ui *ui)
     // ui->screen_pos_cont = lv_obj_create(ui->screen_postion);
     // Write codes screen_pos_cont
     ui->screen_pos_cont = lv_obj_create(ui->screen_postion);
-    lv_obj_set_pos(ui->screen_pos_cont, srceen_cont_pos_x, srceen_cont_pos_y);
+    lv_obj_set_pos(ui->screen_pos_cont, 0, 0);
     lv_obj_set_size(ui->screen_pos_cont, 126, 126);
     lv_obj_set_scrollbar_mode(ui->screen_pos_cont, LV_SCROLLBAR_MODE_OFF);
 
@@ -473,7 +473,7 @@ void gui_direction_tileview_init(lv_ui *ui)
     lv_obj_set_style_bg_color(ui->screen_direction, lv_color_black(), LV_PART_MAIN | LV_STATE_DEFAULT);
 
     ui->screen_direction_cont = lv_obj_create(ui->screen_direction);
-    lv_obj_set_pos(ui->screen_direction_cont, srceen_cont_pos_x, srceen_cont_pos_y);
+    lv_obj_set_pos(ui->screen_direction_cont, 0, 0);
     lv_obj_set_size(ui->screen_direction_cont, 126, 126);
     lv_obj_set_scrollbar_mode(ui->screen_direction_cont, LV_SCROLLBAR_MODE_OFF);
 
@@ -535,7 +535,7 @@ void gui_sensor_init(lv_ui *ui)
     lv_obj_set_style_bg_color(ui->screen_sensor, lv_color_black(), LV_PART_MAIN | LV_STATE_DEFAULT);
 
     ui->screen_sensor_cont = lv_obj_create(ui->screen_sensor);
-    lv_obj_set_pos(ui->screen_sensor_cont, srceen_cont_pos_x, srceen_cont_pos_y);
+    lv_obj_set_pos(ui->screen_sensor_cont, 0, 0);
     lv_obj_set_size(ui->screen_sensor_cont, 126, 126);
     lv_obj_set_scrollbar_mode(ui->screen_sensor_cont, LV_SCROLLBAR_MODE_OFF);
 
@@ -656,7 +656,7 @@ void gui_vlotage_init(lv_ui *ui)
 
     // glass part
     ui->screen_voltage_cont = lv_obj_create(ui->screen_voltage);
-    lv_obj_set_pos(ui->screen_voltage_cont, srceen_cont_pos_x, srceen_cont_pos_y);
+    lv_obj_set_pos(ui->screen_voltage_cont, 0, 0);
     lv_obj_set_size(ui->screen_voltage_cont, 126, 126);
     lv_obj_set_scrollbar_mode(ui->screen_voltage_cont, LV_SCROLLBAR_MODE_OFF);
     lv_obj_set_style_bg_color(ui->screen_voltage_cont, lv_color_black(), LV_PART_MAIN);
@@ -744,7 +744,7 @@ void gui_esp_now_init(lv_ui *ui)
     lv_obj_set_style_bg_color(ui->screen_esp_now, lv_color_black(), LV_PART_MAIN | LV_STATE_DEFAULT);
 
     ui->screen_esp_now_cont = lv_obj_create(ui->screen_esp_now);
-    lv_obj_set_pos(ui->screen_esp_now_cont, srceen_cont_pos_x, srceen_cont_pos_y);
+    lv_obj_set_pos(ui->screen_esp_now_cont, 0, 0);
     lv_obj_set_size(ui->screen_esp_now_cont, 126, 126);
     lv_obj_set_scrollbar_mode(ui->screen_esp_now_cont, LV_SCROLLBAR_MODE_OFF);
 
@@ -804,7 +804,7 @@ void gui_set_init(lv_ui *ui)
     lv_obj_set_style_bg_color(ui->screen_set, lv_color_black(), LV_PART_MAIN | LV_STATE_DEFAULT);
 
     ui->screen_set_cont = lv_obj_create(ui->screen_set);
-    lv_obj_set_pos(ui->screen_set_cont, srceen_cont_pos_x, srceen_cont_pos_y);
+    lv_obj_set_pos(ui->screen_set_cont, 0, 0);
     lv_obj_set_size(ui->screen_set_cont, 126, 126);
     lv_obj_set_scrollbar_mode(ui->screen_set_cont, LV_SCROLLBAR_MODE_OFF);
 
@@ -842,7 +842,7 @@ void gui_set_tileview_init(lv_ui *ui)
     lv_obj_set_style_bg_color(ui->screen_tileview_set, lv_color_black(), LV_PART_MAIN | LV_STATE_DEFAULT);
 
     ui->screen_tileview_set_cont = lv_obj_create(ui->screen_tileview_set);
-    lv_obj_set_pos(ui->screen_tileview_set_cont, srceen_cont_pos_x, srceen_cont_pos_y);
+    lv_obj_set_pos(ui->screen_tileview_set_cont, 0, 0);
     lv_obj_set_size(ui->screen_tileview_set_cont, 126, 126);
     lv_obj_set_scrollbar_mode(ui->screen_tileview_set_cont, LV_SCROLLBAR_MODE_OFF);
 
@@ -943,7 +943,7 @@ void gui_wifi_rssi_init(lv_ui *ui)
     lv_obj_set_style_bg_color(ui->screen_wifi_rssi, lv_color_black(), LV_PART_MAIN | LV_STATE_DEFAULT);
 
     ui->screen_wifi_rssi_cont = lv_obj_create(ui->screen_wifi_rssi);
-    lv_obj_set_pos(ui->screen_wifi_rssi_cont, srceen_cont_pos_x, srceen_cont_pos_y);
+    lv_obj_set_pos(ui->screen_wifi_rssi_cont, 0, 0);
     lv_obj_set_size(ui->screen_wifi_rssi_cont, 126, 126);
     lv_obj_set_scrollbar_mode(ui->screen_wifi_rssi_cont, LV_SCROLLBAR_MODE_OFF);
 
@@ -1070,7 +1070,7 @@ void gui_mic_init(lv_ui *ui)
     lv_obj_set_style_bg_color(ui->screen_mic, lv_color_black(), LV_PART_MAIN | LV_STATE_DEFAULT);
 
     ui->screen_mic_cont = lv_obj_create(ui->screen_mic);
-    lv_obj_set_pos(ui->screen_mic_cont, srceen_cont_pos_x, srceen_cont_pos_y);
+    lv_obj_set_pos(ui->screen_mic_cont, 0, 0);
     lv_obj_set_size(ui->screen_mic_cont, 126, 126);
     lv_obj_set_scrollbar_mode(ui->screen_mic_cont, LV_SCROLLBAR_MODE_OFF);
 
@@ -58,6 +58,9 @@ void setup(void)
     // Initialize onboard PDM microphone
     amoled.initMicrophone();
 
+    // Only render the area visible through the prism, the window below fills it
+    amoled.setViewport(GLASS_VIEWPORT_X, GLASS_VIEWPORT_Y, GlassViewableWidth, GlassViewableHeight);
+
     beginLvglHelper(amoled);
 
     // Set display background color to black
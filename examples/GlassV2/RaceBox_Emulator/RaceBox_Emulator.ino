@@ -0,0 +1,242 @@
+/*
+==============================================================================
+RaceBox Emulator - BLE stand-in for a RaceBox Mini
+==============================================================================
+
+DESCRIPTION:
+    Runs on any ESP32 and advertises as "RaceBox Mini EMU" with the Nordic UART
+    service the RaceBox uses. Once a client subscribes it streams synthetic
+    RaceBox Data Messages (UBX class 0xFF, id 0x01, 80-byte payload) at 25 Hz:
+    a car lapping a 100 m radius circle at 72 km/h, about 31 s per lap, with a
+    valid 3D fix, accuracies, heading, g-force and a battery level.
+
+    Frames are split to the negotiated MTU exactly like a real device would, so
+    Simple_Display_123 can be tested end to end (framing, MTU and connection
+    parameter negotiation, reconnects, lap timing) without a RaceBox.
+
+SERIAL COMMANDS:
+    1 / 2 / 5 - stream at 10 / 25 / 50 Hz
+    x         - drop the connection, the client should reconnect on its own
+    s         - pause / resume the stream (GPS outage)
+    i         - print link and stream status
+
+AUTHOR: T-Glass Racing Project
+DATE: January 2026
+==============================================================================
+*/
+
+#include <Arduino.h>
+#include "NimBLEDevice.h"
+
+#define SERVICE_UUID    "6E400001-B5A3-F393-E0A9-E50E24DCCA9E"
+#define RX_CHAR_UUID    "6E400002-B5A3-F393-E0A9-E50E24DCCA9E"
+#define TX_CHAR_UUID    "6E400003-B5A3-F393-E0A9-E50E24DCCA9E"
+
+#define PAYLOAD_LEN     80
+#define FRAME_LEN       (6 + PAYLOAD_LEN + 2)
+
+// Simulated track, a circle around this point
+const double centerLat = 42.0000000;
+const double centerLon = 23.0000000;
+const double radiusM = 100.0;
+const double speedMps = 20.0;
+
+static NimBLEServer* server = nullptr;
+static NimBLECharacteristic* txChar = nullptr;
+static volatile bool subscribed = false;
+static volatile uint16_t connHandle = 0xFFFF;
+static volatile uint16_t peerMtu = 23;
+
+uint32_t periodMs = 40;        // 25 Hz
+bool paused = false;
+uint32_t iTOW = 300000000;     // Some time into the GPS week
+double angle = 0.0;            // Position on the circle, radians
+uint32_t framesSent = 0;
+uint32_t notificationsSent = 0;
+
+class ServerCallbacks : public NimBLEServerCallbacks {
+    void onConnect(NimBLEServer* pServer, ble_gap_conn_desc* desc) {
+        connHandle = desc->conn_handle;
+        Serial.printf("Client connected: %s\n", NimBLEAddress(desc->peer_ota_addr).toString().c_str());
+    }
+
+    void onDisconnect(NimBLEServer* pServer) {
+        subscribed = false;
+        connHandle = 0xFFFF;
+        peerMtu = 23;
+        Serial.println("Client disconnected, advertising again");
+    }
+
+    void onMTUChange(uint16_t MTU, ble_gap_conn_desc* desc) {
+        peerMtu = MTU;
+        Serial.printf("MTU changed to %u\n", MTU);
+    }
+};
+
+class TxCallbacks : public NimBLECharacteristicCallbacks {
+    void onSubscribe(NimBLECharacteristic* pCharacteristic, ble_gap_conn_desc* desc, uint16_t subValue) {
+        subscribed = (subValue & 0x0001) != 0;
+        Serial.printf("Notifications %s\n", subscribed ? "on" : "off");
+    }
+};
+
+static void put16(uint8_t* p, int off, int32_t v) {
+    p[off] = v;
+    p[off + 1] = v >> 8;
+}
+
+static void put32(uint8_t* p, int off, int32_t v) {
+    p[off] = v;
+    p[off + 1] = v >> 8;
+    p[off + 2] = v >> 16;
+    p[off + 3] = v >> 24;
+}
+
+// One RaceBox Data Message at the current simulated position
+static void buildFrame(uint8_t* frame) {
+    const double mPerDegLat = 111320.0;
+    const double mPerDegLon = 111320.0 * cos(centerLat * PI / 180.0);
+    double lat = centerLat + radiusM * sin(angle) / mPerDegLat;
+    double lon = centerLon + radiusM * cos(angle) / mPerDegLon;
+    // Counter-clockwise, heading is the tangent direction measured from north
+    double heading = fmod(360.0 + (-angle * 180.0 / PI), 360.0);
+
+    uint8_t* p = frame + 6;
+    memset(p, 0, PAYLOAD_LEN);
+    uint32_t msOfDay = iTOW % 86400000;
+    put32(p, 0, iTOW);
+    put16(p, 4, 2026);
+    p[6] = 1;                                   // Month
+    p[7] = 15;                                  // Day
+    p[8] = msOfDay / 3600000;
+    p[9] = (msOfDay / 60000) % 60;
+    p[10] = (msOfDay / 1000) % 60;
+    p[11] = 0x07;                               // Date, time valid, fully resolved
+    put32(p, 12, 25);                           // Time accuracy, ns
+    put32(p, 16, (int32_t)(msOfDay % 1000) * 1000000);
+    p[20] = 3;                                  // 3D fix
+    p[21] = 0x01;                               // Valid fix
+    p[22] = 0xE0;                               // Date/time confirmed
+    p[23] = 14;                                 // Satellites
+    put32(p, 24, (int32_t)lround(lon * 1e7));
+    put32(p, 28, (int32_t)lround(lat * 1e7));
+    put32(p, 32, 612000);                       // WGS altitude, mm
+    put32(p, 36, 575000);                       // MSL altitude, mm
+    put32(p, 40, 300);                          // Horizontal accuracy, mm
+    put32(p, 44, 600);                          // Vertical accuracy, mm
+    put32(p, 48, (int32_t)(speedMps * 1000));
+    put32(p, 52, (int32_t)lround(heading * 1e5));
+    put32(p, 56, 150);                          // Speed accuracy, mm/s
+    put32(p, 60, 50000);                        // Heading accuracy, 0.5 deg
+    put16(p, 64, 110);                          // PDOP 1.10
+    p[66] = 0;                                  // Lat/lon valid
+    p[67] = 85;                                 // Battery 85 %, not charging
+    // Lateral acceleration v^2/r, milli-g
+    put16(p, 68, 0);
+    put16(p, 70, (int16_t)lround(speedMps * speedMps / radiusM / 9.80665 * 1000));
+    put16(p, 72, 1000);
+    put16(p, 74, 0);
+    put16(p, 76, 0);
+    put16(p, 78, (int16_t)lround(speedMps / radiusM * 180.0 / PI * 100));  // Yaw rate, centi-deg/s
+
+    frame[0] = 0xB5;
+    frame[1] = 0x62;
+    frame[2] = 0xFF;
+    frame[3] = 0x01;
+    frame[4] = PAYLOAD_LEN & 0xFF;
+    frame[5] = PAYLOAD_LEN >> 8;
+    uint8_t ckA = 0, ckB = 0;
+    for (int i = 2; i < 6 + PAYLOAD_LEN; i++) {
+        ckA += frame[i];
+        ckB += ckA;
+    }
+    frame[6 + PAYLOAD_LEN] = ckA;
+    frame[7 + PAYLOAD_LEN] = ckB;
+}
+
+// Send a frame in MTU sized notifications, a real RaceBox splits the same way
+static void sendFrame(const uint8_t* frame) {
+    size_t chunk = peerMtu > 3 ? peerMtu - 3 : 20;
+    for (size_t off = 0; off < FRAME_LEN; off += chunk) {
+        size_t n = FRAME_LEN - off < chunk ? FRAME_LEN - off : chunk;
+        txChar->setValue(frame + off, n);
+        txChar->notify();
+        notificationsSent++;
+    }
+    framesSent++;
+}
+
+static void printStatus() {
+    Serial.printf("Status: %s, mtu=%u, %lu Hz%s, frames=%lu notifications=%lu\n",
+                  subscribed ? "streaming" : "idle", peerMtu, (unsigned long)(1000 / periodMs), paused ? " (paused)" : "",
+                  (unsigned long)framesSent, (unsigned long)notificationsSent);
+    if (connHandle != 0xFFFF) {
+        NimBLEConnInfo info = server->getPeerIDInfo(connHandle);
+        Serial.printf("Connection: interval=%.2f ms latency=%u timeout=%u ms\n",
+                      info.getConnInterval() * 1.25, info.getConnLatency(), info.getConnTimeout() * 10);
+    }
+}
+
+void setup() {
+    Serial.begin(115200);
+    Serial.println("RaceBox emulator starting...");
+
+    NimBLEDevice::init("RaceBox Mini EMU");
+    NimBLEDevice::setMTU(247);
+
+    server = NimBLEDevice::createServer();
+    server->setCallbacks(new ServerCallbacks());
+
+    NimBLEService* service = server->createService(SERVICE_UUID);
+    service->createCharacteristic(RX_CHAR_UUID, NIMBLE_PROPERTY::WRITE | NIMBLE_PROPERTY::WRITE_NR);
+    txChar = service->createCharacteristic(TX_CHAR_UUID, NIMBLE_PROPERTY::NOTIFY);
+    txChar->setCallbacks(new TxCallbacks());
+    service->start();
+
+    NimBLEAdvertising* advertising = NimBLEDevice::getAdvertising();
+    advertising->addServiceUUID(SERVICE_UUID);
+    advertising->setScanResponse(true);  // The name goes in the scan response
+    advertising->start();
+    Serial.println("Advertising as \"RaceBox Mini EMU\"");
+}
+
+void loop() {
+    static uint32_t nextFrame = 0;
+
+    if (Serial.available()) {
+        switch (Serial.read()) {
+        case '1': periodMs = 100; printStatus(); break;
+        case '2': periodMs = 40; printStatus(); break;
+        case '5': periodMs = 20; printStatus(); break;
+        case 's': paused = !paused; printStatus(); break;
+        case 'i': printStatus(); break;
+        case 'x':
+            if (connHandle != 0xFFFF) {
+                Serial.println("Dropping the connection");
+                server->disconnect(connHandle);
+            }
+            break;
+        default: break;
+        }
+    }
+
+    uint32_t now = millis();
+    if ((int32_t)(now - nextFrame) < 0) {
+        delay(1);
+        return;
+    }
+    nextFrame = now + periodMs;
+
+    // The simulated car keeps moving while nobody listens, like a real session
+    iTOW += periodMs;
+    angle += speedMps / radiusM * periodMs / 1000.0;
+    if (angle > 2 * PI) {
+        angle -= 2 * PI;
+    }
+
+    if (subscribed && !paused) {
+        uint8_t frame[FRAME_LEN];
+        buildFrame(frame);
+        sendFrame(frame);
+    }
+}
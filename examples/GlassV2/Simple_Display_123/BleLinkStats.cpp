@@ -0,0 +1,90 @@
+/*
+ * BLE link parameters and notification timing, see BleLinkStats.h
+ */
+#include "BleLinkStats.h"
+
+BleLinkStats::BleLinkStats() : _mtu(0), _interval(0), _latency(0), _timeout(0) {
+    portMUX_INITIALIZE(&_lock);
+    reset();
+}
+
+void BleLinkStats::onNotify(uint32_t now_us, size_t len) {
+    portENTER_CRITICAL(&_lock);
+    _notifications++;
+    _bytes += len;
+    if (_notifications > 1) {
+        uint32_t dt = now_us - _last_us;
+        _count++;
+        double delta = dt - _mean;
+        _mean += delta / _count;
+        _m2 += delta * (dt - _mean);
+        if (dt < _min) {
+            _min = dt;
+        }
+        if (dt > _max) {
+            _max = dt;
+        }
+        if (_count > 1) {
+            int32_t d = (int32_t)(dt - _last_dt);
+            uint32_t ad = d < 0 ? -d : d;
+            // J += (|D| - J) / 16
+            _jitter16 += ad - ((_jitter16 + 8) >> 4);
+        }
+        _last_dt = dt;
+    }
+    _last_us = now_us;
+    portEXIT_CRITICAL(&_lock);
+}
+
+void BleLinkStats::setParams(uint16_t mtu, uint16_t interval, uint16_t latency, uint16_t timeout) {
+    portENTER_CRITICAL(&_lock);
+    _mtu = mtu;
+    _interval = interval;
+    _latency = latency;
+    _timeout = timeout;
+    portEXIT_CRITICAL(&_lock);
+}
+
+void BleLinkStats::reset() {
+    portENTER_CRITICAL(&_lock);
+    _last_us = 0;
+    _last_dt = 0;
+    _count = 0;
+    _notifications = 0;
+    _bytes = 0;
+    _mean = 0;
+    _m2 = 0;
+    _min = UINT32_MAX;
+    _max = 0;
+    _jitter16 = 0;
+    portEXIT_CRITICAL(&_lock);
+}
+
+void BleLinkStats::getStats(ble_link_stats_t *stats) {
+    portENTER_CRITICAL(&_lock);
+    stats->mtu = _mtu;
+    stats->interval = _interval;
+    stats->latency = _latency;
+    stats->timeout = _timeout;
+    stats->notifications = _notifications;
+    stats->bytes = _bytes;
+    stats->mean_us = (uint32_t)_mean;
+    double m2 = _m2;
+    uint32_t count = _count;
+    stats->min_us = _count ? _min : 0;
+    stats->max_us = _max;
+    stats->jitter_us = _jitter16 >> 4;
+    portEXIT_CRITICAL(&_lock);
+    stats->stddev_us = count > 1 ? (uint32_t)sqrt(m2 / (count - 1)) : 0;
+}
+
+void BleLinkStats::printStats(Stream &out) {
+    ble_link_stats_t s;
+    getStats(&s);
+    out.printf("Link: mtu=%u interval=%.2f ms latency=%u timeout=%u ms\n",
+               s.mtu, s.interval * 1.25, s.latency, s.timeout * 10);
+    out.printf("Notify: n=%lu bytes=%lu mean=%lu sd=%lu min=%lu max=%lu jitter=%lu us\n",
+               (unsigned long)s.notifications, (unsigned long)s.bytes, (unsigned long)s.mean_us,
+               (unsigned long)s.stddev_us, (unsigned long)s.min_us, (unsigned long)s.max_us,
+               (unsigned long)s.jitter_us);
+}
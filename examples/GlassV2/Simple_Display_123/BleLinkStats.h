@@ -0,0 +1,60 @@
+/*
+ * BLE link parameters and notification timing.
+ *
+ * Records the MTU and connection parameters the RaceBox granted and the spacing of
+ * the notifications as they arrive: mean, standard deviation, min/max and the RFC 3550
+ * style smoothed jitter (mean change between consecutive intervals). onNotify() runs
+ * in the NimBLE task, the rest from loop(), a spinlock keeps the snapshot consistent.
+ */
+#pragma once
+
+#include <Arduino.h>
+
+typedef struct {
+    // Granted by the peer, connection interval and timeout in BLE units
+    uint16_t mtu;
+    uint16_t interval;          // 1.25 ms
+    uint16_t latency;           // Connection events the peer may skip
+    uint16_t timeout;           // 10 ms
+    // Notification timing since the last reset
+    uint32_t notifications;
+    uint32_t bytes;
+    uint32_t mean_us;
+    uint32_t stddev_us;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint32_t jitter_us;
+} ble_link_stats_t;
+
+class BleLinkStats {
+public:
+    BleLinkStats();
+
+    // NimBLE task, once per notification
+    void onNotify(uint32_t now_us, size_t len);
+
+    void setParams(uint16_t mtu, uint16_t interval, uint16_t latency, uint16_t timeout);
+
+    // Call on every new connection, the first interval would include the reconnect
+    void reset();
+
+    void getStats(ble_link_stats_t *stats);
+    void printStats(Stream &out);
+
+private:
+    portMUX_TYPE _lock;
+    uint16_t _mtu;
+    uint16_t _interval;
+    uint16_t _latency;
+    uint16_t _timeout;
+    uint32_t _last_us;
+    uint32_t _last_dt;
+    uint32_t _count;            // Intervals measured
+    uint32_t _notifications;
+    uint32_t _bytes;
+    double _mean;               // Welford running mean and sum of squares
+    double _m2;
+    uint32_t _min;
+    uint32_t _max;
+    uint32_t _jitter16;         // Jitter * 16, RFC 3550 fixed point
+};
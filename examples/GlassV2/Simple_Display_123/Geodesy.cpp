@@ -0,0 +1,67 @@
+/*
+ * Track frame, see Geodesy.h
+ */
+#include "Geodesy.h"
+
+#define WGS84_A                 6378137.0f
+#define WGS84_E2                6.69437999e-3f
+
+TrackFrame::TrackFrame() {
+    clear();
+}
+
+void TrackFrame::clear() {
+    _valid = false;
+    _lat0 = _lon0 = 0;
+    _m_lat = _m_lon = 0;
+    _k_lat = _k_lon = _k_lon2 = _k_n = _k_n1 = 0;
+}
+
+// Everything trigonometric happens here, once per origin
+void TrackFrame::set(int32_t lat, int32_t lon) {
+    float phi = lat * GEO_E7_TO_RAD;
+    float s = sinf(phi);
+    float c = cosf(phi);
+    float w2 = 1.0f - WGS84_E2 * s * s;
+    float n = WGS84_A / sqrtf(w2);                  // Prime vertical radius
+    float m = n * (1.0f - WGS84_E2) / w2;           // Meridional radius
+    float t = s / c;
+
+    _lat0 = lat;
+    _lon0 = lon;
+    _m_lat = m * GEO_E7_TO_RAD;
+    _m_lon = n * c * GEO_E7_TO_RAD;
+    // d(ln M)/d(phi) and d(ln N cos(phi))/d(phi), cos(phi) also to second order
+    _k_lat = 3.0f * WGS84_E2 * s * c / w2;
+    _k_lon = WGS84_E2 * s * c / w2 - t;
+    _k_lon2 = -0.5f;
+    // The tangent plane drops away from a parallel, east offsets bend northwards, more
+    // so north of the origin
+    _k_n = t / (2.0f * n);
+    _k_n1 = t;
+    _valid = true;
+}
+
+// Unsigned subtraction, a wrap far away from the track is garbage but not undefined
+static inline int32_t e7Diff(int32_t a, int32_t b) {
+    return (int32_t)((uint32_t)a - (uint32_t)b);
+}
+
+enu_t TrackFrame::project(int32_t lat, int32_t lon) const {
+    float dlat = (float)e7Diff(lat, _lat0);
+    float dlon = (float)e7Diff(lon, _lon0);
+    float d = dlat * GEO_E7_TO_RAD;
+    float l = dlon * GEO_E7_TO_RAD;
+    enu_t p;
+    // Third order: sin() of the angles on the plane, the bend growing with latitude
+    p.e = dlon * _m_lon * (1.0f + d * (_k_lon + d * _k_lon2) - l * l * (1.0f / 6.0f));
+    p.n = dlat * _m_lat * (1.0f + d * (0.5f * _k_lat - d * (1.0f / 6.0f))) + p.e * p.e * _k_n * (1.0f + _k_n1 * d);
+    return p;
+}
+
+enu_t TrackFrame::projectFast(int32_t lat, int32_t lon) const {
+    enu_t p;
+    p.e = (float)e7Diff(lon, _lon0) * _m_lon;
+    p.n = (float)e7Diff(lat, _lat0) * _m_lat;
+    return p;
+}
@@ -0,0 +1,88 @@
+/*
+ * Track frame: RaceBox positions as metres east/north of a track origin.
+ *
+ * A fix is projected once, with integer differences from the origin and a handful of
+ * single-precision multiplies, after that distances, gate tests and headings are plain
+ * 2D vector maths. The ESP32-S3 FPU has no double precision, a double haversine per
+ * fix is soft-float emulated and an order of magnitude slower. The host benchmark
+ * bench_geodesy times both; even with a hardware double FPU the haversine is 5 to 8
+ * times the projection.
+ *
+ * The scales are the WGS84 meridional and prime vertical radii at the origin, so the
+ * frame is exact there. Away from it:
+ *
+ *   project()      local tangent plane to third order: both scales follow the
+ *                  latitude offset and east offsets bend north as the plane leaves
+ *                  the parallel. Against ECEF -> ENU in double, latitudes 0 to 60 deg,
+ *                  positions are within 2 mm and distances between any two points
+ *                  within 2.5 mm anywhere inside 5 km, float rounding included.
+ *   projectFast()  plain equirectangular, the precomputed cos(lat0) only. The error
+ *                  grows with tan(lat0) and the square of the offset: at 52 deg 5 mm
+ *                  at 200 m, 0.12 m at 1 km and 2.9 m at 5 km, distances between two
+ *                  points nearly twice that. Not fit for gates or the lap delta beyond
+ *                  a few hundred metres from the origin.
+ *
+ * Float keeps sub-millimetre resolution out to 5 km. The haversine this replaces used
+ * a 6371 km sphere and was off by 0.2 to 0.6 % depending on latitude and direction.
+ */
+#pragma once
+
+#include <Arduino.h>
+
+#define GEO_E7_TO_RAD           1.745329252e-9f // 1e-7 degree in radians
+#define GEO_DEG_TO_RAD          0.0174532925f
+
+// Metres east and north of the track origin
+typedef struct {
+    float e;
+    float n;
+} enu_t;
+
+static inline float enuLength(enu_t a) {
+    return sqrtf(a.e * a.e + a.n * a.n);
+}
+
+static inline float enuDistance(enu_t a, enu_t b) {
+    float de = b.e - a.e;
+    float dn = b.n - a.n;
+    return sqrtf(de * de + dn * dn);
+}
+
+// Degrees from north of the direction a -> b, 0..360
+static inline float enuHeading(enu_t a, enu_t b) {
+    float h = atan2f(b.e - a.e, b.n - a.n) / GEO_DEG_TO_RAD;
+    return h < 0 ? h + 360.0f : h;
+}
+
+class TrackFrame {
+public:
+    TrackFrame();
+
+    // Origin in degrees * 1e7
+    void set(int32_t lat, int32_t lon);
+    void clear();
+    bool valid() {
+        return _valid;
+    }
+    int32_t originLat() {
+        return _lat0;
+    }
+    int32_t originLon() {
+        return _lon0;
+    }
+
+    enu_t project(int32_t lat, int32_t lon) const;
+    enu_t projectFast(int32_t lat, int32_t lon) const;
+
+private:
+    bool _valid;
+    int32_t _lat0;
+    int32_t _lon0;
+    float _m_lat;               // Metres per 1e-7 degree of latitude at the origin
+    float _m_lon;               // ... of longitude
+    float _k_lat;               // Relative change of _m_lat per radian north
+    float _k_lon;               // ... of _m_lon, first order
+    float _k_lon2;              // ... second order
+    float _k_n;                 // Northing bend of an east offset, per metre squared
+    float _k_n1;                // Relative change of _k_n per radian north
+};
@@ -0,0 +1,196 @@
+/*
+ * Live delta against a reference lap, see LapDelta.h
+ */
+#include "LapDelta.h"
+
+typedef struct __attribute__((packed)) {
+    char magic[4];
+    uint32_t count;
+    uint32_t lap_ms;
+    int32_t origin_lat;
+    int32_t origin_lon;
+} delta_file_header_t;
+
+LapDelta::LapDelta() : _ref(nullptr), _rec(nullptr), _ref_count(0), _ref_ms(0), _rec_count(0),
+    _recording(false), _overflow(false), _origin_lat(0), _origin_lon(0), _cursor(0), _valid(false),
+    _delta(0), _max_advance(0) {
+    _last_rec.e = _last_rec.n = 0;
+}
+
+LapDelta::~LapDelta() {
+    free(_ref);
+    free(_rec);
+}
+
+bool LapDelta::begin() {
+    if (!_ref) {
+        _ref = (delta_point_t *)ps_malloc(DELTA_MAX_POINTS * sizeof(delta_point_t));
+        _rec = (delta_point_t *)ps_malloc(DELTA_MAX_POINTS * sizeof(delta_point_t));
+    }
+    return _ref && _rec;
+}
+
+void LapDelta::setOrigin(int32_t lat, int32_t lon) {
+    if (lat != _origin_lat || lon != _origin_lon) {
+        clearReference();
+        _origin_lat = lat;
+        _origin_lon = lon;
+    }
+    _recording = false;
+}
+
+void LapDelta::clearReference() {
+    _ref_count = 0;
+    _ref_ms = 0;
+    _cursor = 0;
+    _valid = false;
+}
+
+// The finish line is the frame origin, both traces start and end there
+void LapDelta::startLap(bool flying) {
+    _cursor = 0;
+    _valid = false;
+    _rec_count = 0;
+    _overflow = false;
+    _recording = flying && _rec;
+    if (_recording) {
+        enu_t origin = {0, 0};
+        _rec[0].e = _rec[0].n = 0;
+        _rec[0].ms = 0;
+        _rec_count = 1;
+        _last_rec = origin;
+    }
+}
+
+void LapDelta::record(enu_t pos, uint32_t ms) {
+    if (enuDistance(_last_rec, pos) < DELTA_STEP_M) {
+        return;
+    }
+    if (_rec_count >= DELTA_MAX_POINTS) {
+        _overflow = true;
+        _recording = false;
+        return;
+    }
+    _rec[_rec_count].e = pos.e;
+    _rec[_rec_count].n = pos.n;
+    _rec[_rec_count].ms = ms;
+    _rec_count++;
+    _last_rec = pos;
+}
+
+// Project onto the segment under the cursor, move on while the fix is past its end
+void LapDelta::match(enu_t pos, uint32_t elapsedMs) {
+    uint32_t start = _cursor;
+    float t = 0;
+    float off2 = 0;
+    for (;;) {
+        const delta_point_t &a = _ref[_cursor];
+        const delta_point_t &b = _ref[_cursor + 1];
+        float se = b.e - a.e;
+        float sn = b.n - a.n;
+        float pe = pos.e - a.e;
+        float pn = pos.n - a.n;
+        float len2 = se * se + sn * sn;
+        t = len2 > 0 ? (pe * se + pn * sn) / len2 : 1.0f;
+        if (t <= 1.0f || _cursor + 2 >= _ref_count || _cursor - start >= DELTA_MAX_ADVANCE) {
+            t = t < 0 ? 0 : (t > 1 ? 1 : t);
+            float de = pe - t * se;
+            float dn = pn - t * sn;
+            off2 = de * de + dn * dn;
+            break;
+        }
+        _cursor++;
+    }
+    if (_cursor - start > _max_advance) {
+        _max_advance = _cursor - start;
+    }
+
+    const delta_point_t &a = _ref[_cursor];
+    const delta_point_t &b = _ref[_cursor + 1];
+    _valid = off2 <= DELTA_MAX_OFFSET_M * DELTA_MAX_OFFSET_M;
+    if (_valid) {
+        float refMs = a.ms + t * (float)(b.ms - a.ms);
+        _delta = (int32_t)elapsedMs - (int32_t)lroundf(refMs);
+    }
+}
+
+void LapDelta::update(enu_t pos, uint32_t elapsedMs) {
+    if (_recording) {
+        record(pos, elapsedMs);
+    }
+    if (hasReference()) {
+        match(pos, elapsedMs);
+    }
+}
+
+bool LapDelta::finishLap(uint32_t lapMs) {
+    bool recorded = _recording && !_overflow;
+    _recording = false;
+    _valid = false;
+    if (!recorded || (hasReference() && lapMs >= _ref_ms)) {
+        return false;
+    }
+    if (_rec_count >= DELTA_MAX_POINTS) {
+        return false;
+    }
+    _rec[_rec_count].e = _rec[_rec_count].n = 0;
+    _rec[_rec_count].ms = lapMs;
+    _rec_count++;
+
+    // The new lap becomes the reference in one step, the old buffer records the next
+    delta_point_t *old = _ref;
+    _ref = _rec;
+    _rec = old;
+    _ref_count = _rec_count;
+    _ref_ms = lapMs;
+    _rec_count = 0;
+    return true;
+}
+
+bool LapDelta::save(Stream &out) {
+    if (!hasReference()) {
+        return false;
+    }
+    delta_file_header_t h;
+    memcpy(h.magic, DELTA_MAGIC, 4);
+    h.count = _ref_count;
+    h.lap_ms = _ref_ms;
+    h.origin_lat = _origin_lat;
+    h.origin_lon = _origin_lon;
+    size_t body = _ref_count * sizeof(delta_point_t);
+    return out.write((const uint8_t *)&h, sizeof(h)) == sizeof(h) &&
+           out.write((const uint8_t *)_ref, body) == body;
+}
+
+// Reads into the spare trace first, a short or foreign file leaves the reference alone
+bool LapDelta::load(Stream &in) {
+    if (!_rec) {
+        return false;
+    }
+    delta_file_header_t h;
+    if (in.readBytes((uint8_t *)&h, sizeof(h)) != sizeof(h) || memcmp(h.magic, DELTA_MAGIC, 4) != 0 ||
+        h.count < 2 || h.count > DELTA_MAX_POINTS) {
+        return false;
+    }
+    if (h.origin_lat != _origin_lat || h.origin_lon != _origin_lon) {
+        Serial.println("Reference lap is for another finish line, ignored");
+        return false;
+    }
+    size_t body = h.count * sizeof(delta_point_t);
+    if (in.readBytes((uint8_t *)_rec, body) != body) {
+        return false;
+    }
+    delta_point_t *old = _ref;
+    _ref = _rec;
+    _rec = old;
+    _ref_count = h.count;
+    _ref_ms = h.lap_ms;
+    _cursor = 0;
+    return true;
+}
+
+void LapDelta::printStats(Stream &out) {
+    out.printf("Delta: reference %lu ms, %lu points, cursor %lu, max advance %lu, %s %+ld ms\n",
+               (unsigned long)_ref_ms, (unsigned long)_ref_count, (unsigned long)_cursor,
+               (unsigned long)_max_advance, _valid ? "live" : "none", (long)_delta);
+}
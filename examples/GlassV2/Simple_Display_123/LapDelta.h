@@ -0,0 +1,96 @@
+/*
+ * Live delta against a reference lap.
+ *
+ * The reference is the fastest flying lap as a trace of track frame points, one every
+ * DELTA_STEP_M metres travelled, each with the time since the lap started, so the
+ * trace is indexed by distance and slow corners cost no more points than straights.
+ * A cursor walks along it: every fix is projected onto the reference segment under
+ * the cursor, the cursor only moves forward (a few segments per fix at most) and the
+ * interpolated reference time at that point gives delta = now - reference.
+ *
+ * Both traces are flat PSRAM arrays allocated once by begin(). The lap being driven
+ * is recorded into the spare one and a faster lap becomes the reference by swapping
+ * the two pointers. The reference is saved with the frame origin it belongs to, see
+ * save() / load(), and dropped when the finish line moves.
+ *
+ * File: "DLT1", uint32 count, uint32 lap ms, int32 origin lat, int32 origin lon (1e-7
+ * degree), then count delta_point_t, all little endian.
+ */
+#pragma once
+
+#include <Arduino.h>
+#include "Geodesy.h"
+
+#define DELTA_MAGIC                 "DLT1"
+#define DELTA_STEP_M                2.0f    // Trace resolution
+#define DELTA_MAX_POINTS            4096    // 8 km of lap
+#define DELTA_MAX_OFFSET_M          25.0f   // Further off the reference line there is no delta
+#define DELTA_MAX_ADVANCE           64      // Segments the cursor may move in one fix
+
+typedef struct {
+    float e;                        // Track frame, metres
+    float n;
+    uint32_t ms;                    // Since the lap started
+} delta_point_t;
+
+class LapDelta {
+public:
+    LapDelta();
+    ~LapDelta();
+
+    // Allocate both traces, false if there is no memory
+    bool begin();
+
+    // The frame the traces are in, a different origin drops the reference
+    void setOrigin(int32_t lat, int32_t lon);
+
+    // At the finish crossing, only a flying lap is recorded as a candidate reference
+    void startLap(bool flying);
+
+    // Every fix of the lap, elapsed since the crossing
+    void update(enu_t pos, uint32_t elapsedMs);
+
+    // At the finish crossing, true when this lap replaced the reference
+    bool finishLap(uint32_t lapMs);
+
+    bool hasReference() {
+        return _ref_count > 1;
+    }
+    uint32_t referenceMs() {
+        return _ref_ms;
+    }
+
+    // Of the last fix: milliseconds ahead (negative) or behind the reference
+    bool valid() {
+        return _valid;
+    }
+    int32_t delta() {
+        return _delta;
+    }
+
+    // Reference persistence, in / out are open files
+    bool save(Stream &out);
+    bool load(Stream &in);
+    void clearReference();
+
+    void printStats(Stream &out);
+
+private:
+    void record(enu_t pos, uint32_t ms);
+    void match(enu_t pos, uint32_t elapsedMs);
+
+    delta_point_t *_ref;
+    delta_point_t *_rec;
+    uint32_t _ref_count;
+    uint32_t _ref_ms;
+    uint32_t _rec_count;
+    bool _recording;
+    bool _overflow;
+    enu_t _last_rec;                // Last recorded point
+    int32_t _origin_lat;
+    int32_t _origin_lon;
+    uint32_t _cursor;               // Reference segment _cursor -> _cursor + 1
+    bool _valid;
+    int32_t _delta;
+    uint32_t _max_advance;          // Longest cursor move in one fix, for the stats
+};
@@ -0,0 +1,110 @@
+/*
+ * Timing gate, see LapGate.h
+ */
+#include "LapGate.h"
+
+LapGate::LapGate() {
+    clear();
+}
+
+void LapGate::clear() {
+    _valid = false;
+    _oriented = false;
+    _have_prev = false;
+    _have_anchor = false;
+    _centre.e = _centre.n = 0;
+    _dx = 0;
+    _dy = 1;
+    _half_width = LAP_GATE_HALF_WIDTH_M;
+    _s = _l = 0;
+}
+
+void LapGate::set(enu_t centre, float headingDeg, float halfWidth) {
+    clear();
+    _centre = centre;
+    _half_width = halfWidth;
+    if (!isnan(headingDeg)) {
+        _dx = sinf(headingDeg * GEO_DEG_TO_RAD);
+        _dy = cosf(headingDeg * GEO_DEG_TO_RAD);
+        _oriented = true;
+    }
+    _valid = true;
+}
+
+float LapGate::heading() {
+    if (!_oriented) {
+        return NAN;
+    }
+    float h = atan2f(_dx, _dy) / GEO_DEG_TO_RAD;
+    return h < 0 ? h + 360.0f : h;
+}
+
+void LapGate::restart() {
+    _have_prev = false;
+}
+
+// The first LAP_GATE_ORIENT_STEP_M of movement near the line defines forwards, measured
+// over several fixes so GPS noise on a single short step does not matter
+void LapGate::orient(float x, float y) {
+    if (x * x + y * y > LAP_GATE_ORIENT_RADIUS_M * LAP_GATE_ORIENT_RADIUS_M) {
+        _have_anchor = false;
+        return;
+    }
+    if (!_have_anchor) {
+        _ax = x;
+        _ay = y;
+        _have_anchor = true;
+        return;
+    }
+    float mx = x - _ax;
+    float my = y - _ay;
+    float len = sqrtf(mx * mx + my * my);
+    if (len >= LAP_GATE_ORIENT_STEP_M) {
+        _dx = mx / len;
+        _dy = my / len;
+        _oriented = true;
+    }
+}
+
+bool LapGate::update(enu_t pos, uint32_t itowMs, uint32_t *crossMs) {
+    if (!_valid) {
+        return false;
+    }
+    float x = pos.e - _centre.e;
+    float y = pos.n - _centre.n;
+
+    bool crossed = false;
+    if (_have_prev && gpsTimeDiff(itowMs, _pt) <= LAP_GATE_MAX_STEP_MS) {
+        float mx = x - _px;
+        float my = y - _py;
+        float step2 = mx * mx + my * my;
+        if (step2 <= LAP_GATE_MAX_STEP_M * LAP_GATE_MAX_STEP_M) {
+            if (!_oriented) {
+                orient(x, y);
+            }
+            if (_oriented) {
+                // Signed distance along the direction of travel, the gate is s = 0
+                float s0 = _px * _dx + _py * _dy;
+                float s1 = x * _dx + y * _dy;
+                if (s0 < 0 && s1 >= 0) {
+                    float f = s0 / (s0 - s1);
+                    // Position along the gate where the step crosses it
+                    float l = (_px + f * mx) * _dy - (_py + f * my) * _dx;
+                    if (fabsf(l) <= _half_width) {
+                        float dt = (float)gpsTimeDiff(itowMs, _pt);
+                        *crossMs = (_pt + (uint32_t)lroundf(f * dt)) % GPS_WEEK_MS;
+                        crossed = true;
+                    }
+                }
+            }
+        }
+    }
+
+    _s = x * _dx + y * _dy;
+    _l = x * _dy - y * _dx;
+    _px = x;
+    _py = y;
+    _pt = itowMs;
+    _have_prev = true;
+    return crossed;
+}
@@ -0,0 +1,80 @@
+/*
+ * Timing gate: the finish line as a segment instead of a point.
+ *
+ * The gate is a line of 2 * LAP_GATE_HALF_WIDTH_M metres through the captured finish
+ * position, perpendicular to the direction of travel at capture time. Each pair of
+ * consecutive fixes is tested against it, a crossing in the direction of travel is
+ * reported with its time interpolated between the two iTOW stamps, so laps resolve to
+ * the millisecond instead of the fix interval.
+ *
+ * Positions are points of the track frame (Geodesy.h), projected once per fix by the
+ * caller, so several gates can share one projection. Single precision, no allocation.
+ * When the heading at capture is unknown (standing still) the gate takes its direction
+ * from the first movement within LAP_GATE_ORIENT_RADIUS_M of the line.
+ */
+#pragma once
+
+#include <Arduino.h>
+#include "Geodesy.h"
+
+#define LAP_GATE_HALF_WIDTH_M       12.0f   // Track width either side of the captured position
+#define LAP_GATE_ORIENT_RADIUS_M    30.0f
+#define LAP_GATE_ORIENT_STEP_M      5.0f
+#define LAP_GATE_MAX_STEP_MS        1000    // Longer gaps between fixes are not bridged
+#define LAP_GATE_MAX_STEP_M         100.0f  // Longer jumps are a glitch, not motion
+#define GPS_WEEK_MS                 604800000UL
+
+// Milliseconds from a to b across a GPS week rollover
+static inline uint32_t gpsTimeDiff(uint32_t b, uint32_t a) {
+    return b >= a ? b - a : b + GPS_WEEK_MS - a;
+}
+
+class LapGate {
+public:
+    LapGate();
+
+    // Centre in the track frame, heading in degrees from north, NAN if unknown
+    void set(enu_t centre, float headingDeg, float halfWidth = LAP_GATE_HALF_WIDTH_M);
+    void clear();
+    bool valid() {
+        return _valid;
+    }
+    bool oriented() {
+        return _oriented;
+    }
+    float heading();
+
+    // Forget the previous fix, e.g. after a reconnect, no crossing is bridged over it
+    void restart();
+
+    // Feed every fix in order. Returns true when the step from the previous fix crossed
+    // the gate forwards, *crossMs is then the interpolated iTOW of the crossing.
+    bool update(enu_t pos, uint32_t itowMs, uint32_t *crossMs);
+
+    // Of the last fix: metres ahead of the gate (negative = before it) and to the side
+    float along() {
+        return _s;
+    }
+    float lateral() {
+        return _l;
+    }
+
+private:
+    void orient(float x, float y);
+
+    bool _valid;
+    bool _oriented;
+    bool _have_prev;
+    bool _have_anchor;          // Start of the movement that orients the gate
+    enu_t _centre;
+    float _dx;                  // Unit direction of travel, east/north
+    float _dy;
+    float _half_width;
+    float _px;                  // Previous fix, metres from the gate
+    float _py;
+    uint32_t _pt;
+    float _ax;
+    float _ay;
+    float _s;
+    float _l;
+};
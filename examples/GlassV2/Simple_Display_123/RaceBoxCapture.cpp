@@ -0,0 +1,96 @@
+/*
+ * RaceBox session capture, see RaceBoxCapture.h
+ */
+#include "RaceBoxCapture.h"
+
+RaceBoxCapture::RaceBoxCapture() : _out(nullptr), _ring(nullptr), _head(0), _tail(0), _start_us(0) {
+    memset(&_stats, 0, sizeof(_stats));
+    portMUX_INITIALIZE(&_lock);
+}
+
+RaceBoxCapture::~RaceBoxCapture() {
+    stop();
+    free(_ring);
+}
+
+bool RaceBoxCapture::start(Stream &out) {
+    if (!_ring) {
+        _ring = (uint8_t *)ps_malloc(RBX_CAPTURE_RING);
+        if (!_ring) {
+            return false;
+        }
+    }
+    portENTER_CRITICAL(&_lock);
+    _head = _tail = 0;
+    memset(&_stats, 0, sizeof(_stats));
+    _start_us = micros();
+    portEXIT_CRITICAL(&_lock);
+    out.write((const uint8_t *)RBX_MAGIC, 4);
+    _out = &out;
+    return true;
+}
+
+void RaceBoxCapture::stop() {
+    if (!_out) {
+        return;
+    }
+    service();
+    _out->flush();
+    _out = nullptr;
+}
+
+size_t RaceBoxCapture::used() {
+    return (_head + RBX_CAPTURE_RING - _tail) % RBX_CAPTURE_RING;
+}
+
+void RaceBoxCapture::record(const uint8_t *data, size_t len) {
+    if (!_out || len > RBX_MAX_RECORD) {
+        return;
+    }
+    rbx_record_t rec;
+    rec.t_us = micros() - _start_us;
+    rec.len = len;
+    size_t total = sizeof(rec) + len;
+
+    portENTER_CRITICAL(&_lock);
+    // One byte stays free to tell a full ring from an empty one
+    if (RBX_CAPTURE_RING - 1 - used() < total) {
+        _stats.dropped++;
+        portEXIT_CRITICAL(&_lock);
+        return;
+    }
+    size_t head = _head;
+    for (size_t i = 0; i < total; i++) {
+        _ring[head] = i < sizeof(rec) ? ((const uint8_t *)&rec)[i] : data[i - sizeof(rec)];
+        head = (head + 1) % RBX_CAPTURE_RING;
+    }
+    _head = head;
+    _stats.records++;
+    _stats.bytes += total;
+    portEXIT_CRITICAL(&_lock);
+}
+
+void RaceBoxCapture::service() {
+    if (!_out) {
+        return;
+    }
+    // Only this side moves the tail, the writer only ever adds behind the head
+    portENTER_CRITICAL(&_lock);
+    size_t head = _head;
+    portEXIT_CRITICAL(&_lock);
+    size_t tail = _tail;
+    while (tail != head) {
+        size_t n = head > tail ? head - tail : RBX_CAPTURE_RING - tail;
+        _out->write(_ring + tail, n);
+        tail = (tail + n) % RBX_CAPTURE_RING;
+    }
+    portENTER_CRITICAL(&_lock);
+    _tail = tail;
+    portEXIT_CRITICAL(&_lock);
+}
+
+void RaceBoxCapture::getStats(rbx_capture_stats_t *stats) {
+    portENTER_CRITICAL(&_lock);
+    *stats = _stats;
+    portEXIT_CRITICAL(&_lock);
+}
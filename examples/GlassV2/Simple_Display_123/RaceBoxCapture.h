@@ -0,0 +1,51 @@
+/*
+ * RaceBox session capture, see RaceBoxReplay.h for the file format.
+ *
+ * RaceBoxCapture is fed from the notification callback and writes to the file from
+ * loop(). The records go through a ring in PSRAM shared with the BLE task under a
+ * portMUX, so unlike the replay this is ESP32 code.
+ */
+#pragma once
+
+#include <Arduino.h>
+#include "RaceBoxReplay.h"
+
+#define RBX_CAPTURE_RING        (32 * 1024) // Bytes buffered between the BLE task and the file
+
+typedef struct {
+    uint32_t records;
+    uint32_t bytes;
+    uint32_t dropped;       // Records lost because the ring was full
+} rbx_capture_stats_t;
+
+class RaceBoxCapture {
+public:
+    RaceBoxCapture();
+    ~RaceBoxCapture();
+
+    // out stays open until stop(), e.g. a LittleFS File
+    bool start(Stream &out);
+    void stop();
+    bool active() {
+        return _out != nullptr;
+    }
+
+    // Notification context, only copies into the ring
+    void record(const uint8_t *data, size_t len);
+
+    // loop() context, writes the buffered records
+    void service();
+
+    void getStats(rbx_capture_stats_t *stats);
+
+private:
+    size_t used();
+
+    Stream *_out;
+    uint8_t *_ring;
+    volatile size_t _head;
+    volatile size_t _tail;
+    uint32_t _start_us;
+    rbx_capture_stats_t _stats;
+    portMUX_TYPE _lock;
+};
@@ -0,0 +1,65 @@
+/*
+ * Typed view over the RaceBox Data Message, see RaceBoxData.h
+ */
+#include "RaceBoxData.h"
+
+bool rbxDecode(const uint8_t *payload, uint16_t len, uint32_t mask, rbx_fix_t *fix) {
+    RaceBoxView v;
+    if (!v.attach(payload, len)) {
+        return false;
+    }
+
+    if (mask & RBX_F_TIME) {
+        fix->itow_ms = v.u<RBX_ITOW>();
+        fix->year = v.u<RBX_YEAR>();
+        fix->month = v.u<RBX_MONTH>();
+        fix->day = v.u<RBX_DAY>();
+        fix->hour = v.u<RBX_HOUR>();
+        fix->minute = v.u<RBX_MINUTE>();
+        fix->second = v.u<RBX_SECOND>();
+        fix->validity = v.u<RBX_VALIDITY>();
+        fix->time_acc_ns = v.u<RBX_TIME_ACC>();
+        fix->nano = v.i<RBX_NANO>();
+        fix->datetime_flags = v.u<RBX_DATETIME_FLAGS>();
+    }
+    if (mask & RBX_F_FIX) {
+        fix->fix_status = v.u<RBX_FIX_STATUS>();
+        fix->fix_flags = v.u<RBX_FIX_FLAGS>();
+        fix->num_sv = v.u<RBX_NUM_SV>();
+    }
+    if (mask & RBX_F_POSITION) {
+        fix->lon = v.i<RBX_LON>();
+        fix->lat = v.i<RBX_LAT>();
+        fix->latlon_flags = v.u<RBX_LATLON_FLAGS>();
+    }
+    if (mask & RBX_F_ALTITUDE) {
+        fix->alt_wgs_mm = v.i<RBX_ALT_WGS>();
+        fix->alt_msl_mm = v.i<RBX_ALT_MSL>();
+    }
+    if (mask & RBX_F_ACCURACY) {
+        fix->h_acc_mm = v.u<RBX_H_ACC>();
+        fix->v_acc_mm = v.u<RBX_V_ACC>();
+        fix->speed_acc_mm_s = v.u<RBX_SPEED_ACC>();
+        fix->heading_acc = v.u<RBX_HEADING_ACC>();
+    }
+    if (mask & RBX_F_MOTION) {
+        fix->speed_mm_s = v.i<RBX_SPEED>();
+        fix->heading = v.i<RBX_HEADING>();
+    }
+    if (mask & RBX_F_DOP) {
+        fix->pdop = v.u<RBX_PDOP>();
+    }
+    if (mask & RBX_F_BATTERY) {
+        fix->battery = v.u<RBX_BATTERY>();
+    }
+    if (mask & RBX_F_IMU) {
+        fix->g_mg[0] = v.i<RBX_G_X>();
+        fix->g_mg[1] = v.i<RBX_G_Y>();
+        fix->g_mg[2] = v.i<RBX_G_Z>();
+        fix->rot_cdps[0] = v.i<RBX_ROT_X>();
+        fix->rot_cdps[1] = v.i<RBX_ROT_Y>();
+        fix->rot_cdps[2] = v.i<RBX_ROT_Z>();
+    }
+    fix->mask = mask & RBX_F_ALL;
+    return true;
+}
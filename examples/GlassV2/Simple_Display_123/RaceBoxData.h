@@ -0,0 +1,164 @@
+/*
+ * Typed view over the RaceBox Data Message (UBX class 0xFF, id 0x01).
+ *
+ * The 80-byte payload layout is described once, as a constexpr table checked at compile
+ * time, and read in place with little-endian loads. rbxDecode() converts the fields
+ * selected by a mask into an rbx_fix_t in one pass, so a screen that only shows speed
+ * does not pay for altitude or the IMU. Units are left as sent, no floating point.
+ */
+#pragma once
+
+#include <Arduino.h>
+#include <string.h>
+
+#define RACEBOX_MSG_CLASS       0xFF
+#define RACEBOX_MSG_ID          0x01
+#define RACEBOX_PAYLOAD_LEN     80
+
+// Field groups for rbxDecode()
+#define RBX_F_TIME              0x0001  // iTOW, date, time, validity, accuracy
+#define RBX_F_FIX               0x0002  // Fix status and flags, satellites
+#define RBX_F_POSITION          0x0004  // Latitude, longitude, their flags
+#define RBX_F_ALTITUDE          0x0008  // WGS and MSL altitude
+#define RBX_F_ACCURACY          0x0010  // Horizontal, vertical, speed and heading accuracy
+#define RBX_F_MOTION            0x0020  // Speed, heading
+#define RBX_F_DOP               0x0040
+#define RBX_F_BATTERY           0x0080
+#define RBX_F_IMU               0x0100  // G-force, rotation rates
+#define RBX_F_ALL               0x01FF
+
+// Field offsets in the payload, in the order of the RaceBox protocol description
+enum rbx_field_t {
+    RBX_ITOW,                   // U4 ms, GPS time of week
+    RBX_YEAR,                   // U2
+    RBX_MONTH,                  // U1
+    RBX_DAY,                    // U1
+    RBX_HOUR,                   // U1
+    RBX_MINUTE,                 // U1
+    RBX_SECOND,                 // U1
+    RBX_VALIDITY,               // X1 date, time, fully resolved, magnetic declination
+    RBX_TIME_ACC,               // U4 ns
+    RBX_NANO,                   // I4 ns, fraction of the second, may be negative
+    RBX_FIX_STATUS,             // U1 0 = no fix, 2 = 2D, 3 = 3D
+    RBX_FIX_FLAGS,              // X1 bit 0 = valid fix
+    RBX_DATETIME_FLAGS,         // X1
+    RBX_NUM_SV,                 // U1
+    RBX_LON,                    // I4 degrees * 1e7
+    RBX_LAT,                    // I4 degrees * 1e7
+    RBX_ALT_WGS,                // I4 mm
+    RBX_ALT_MSL,                // I4 mm
+    RBX_H_ACC,                  // U4 mm
+    RBX_V_ACC,                  // U4 mm
+    RBX_SPEED,                  // I4 mm/s
+    RBX_HEADING,                // I4 degrees * 1e5
+    RBX_SPEED_ACC,              // U4 mm/s
+    RBX_HEADING_ACC,            // U4 degrees * 1e5
+    RBX_PDOP,                   // U2 * 0.01
+    RBX_LATLON_FLAGS,           // X1 bit 0 = invalid lat/lon
+    RBX_BATTERY,                // X1 Mini: bit 7 charging + percent, Micro: volts * 10
+    RBX_G_X,                    // I2 milli-g
+    RBX_G_Y,
+    RBX_G_Z,
+    RBX_ROT_X,                  // I2 centi-degrees/s
+    RBX_ROT_Y,
+    RBX_ROT_Z,
+    RBX_FIELD_COUNT,
+};
+
+struct rbx_field_desc_t {
+    uint8_t offset;
+    uint8_t size;
+};
+
+constexpr rbx_field_desc_t RBX_FIELDS[RBX_FIELD_COUNT] = {
+    {0, 4}, {4, 2}, {6, 1}, {7, 1}, {8, 1}, {9, 1}, {10, 1}, {11, 1},
+    {12, 4}, {16, 4}, {20, 1}, {21, 1}, {22, 1}, {23, 1},
+    {24, 4}, {28, 4}, {32, 4}, {36, 4}, {40, 4}, {44, 4},
+    {48, 4}, {52, 4}, {56, 4}, {60, 4}, {64, 2}, {66, 1}, {67, 1},
+    {68, 2}, {70, 2}, {72, 2}, {74, 2}, {76, 2}, {78, 2},
+};
+
+// Every field starts where the previous one ends and the last one ends the payload
+constexpr bool rbxLayoutValid(int i = 0, int offset = 0) {
+    return i == RBX_FIELD_COUNT ? offset == RACEBOX_PAYLOAD_LEN
+           : RBX_FIELDS[i].offset == offset && rbxLayoutValid(i + 1, offset + RBX_FIELDS[i].size);
+}
+
+static_assert(rbxLayoutValid(), "RaceBox payload table has a gap, an overlap or the wrong length");
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "RaceBox loads assume a little-endian CPU");
+
+typedef struct {
+    uint32_t mask;              // RBX_F_* groups that were decoded
+    uint32_t itow_ms;
+    uint32_t time_acc_ns;
+    int32_t nano;
+    int32_t lon;
+    int32_t lat;
+    int32_t alt_wgs_mm;
+    int32_t alt_msl_mm;
+    uint32_t h_acc_mm;
+    uint32_t v_acc_mm;
+    int32_t speed_mm_s;
+    int32_t heading;            // Degrees * 1e5
+    uint32_t speed_acc_mm_s;
+    uint32_t heading_acc;       // Degrees * 1e5
+    uint16_t year;
+    uint16_t pdop;              // * 0.01
+    int16_t g_mg[3];
+    int16_t rot_cdps[3];
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+    uint8_t validity;
+    uint8_t fix_status;
+    uint8_t fix_flags;
+    uint8_t datetime_flags;
+    uint8_t num_sv;
+    uint8_t latlon_flags;
+    uint8_t battery;
+} rbx_fix_t;
+
+// Reads fields in place, the payload must stay valid while the view is used
+class RaceBoxView {
+public:
+    // Returns false if the payload is too short to be a data message
+    bool attach(const uint8_t *payload, uint16_t len) {
+        _p = len >= RACEBOX_PAYLOAD_LEN ? payload : nullptr;
+        return _p != nullptr;
+    }
+
+    template <rbx_field_t F>
+    uint32_t u() const {
+        static_assert(RBX_FIELDS[F].size == 1 || RBX_FIELDS[F].size == 2 || RBX_FIELDS[F].size == 4,
+                      "Unsupported field size");
+        const uint8_t *p = _p + RBX_FIELDS[F].offset;
+        if (RBX_FIELDS[F].size == 1) {
+            return p[0];
+        }
+        if (RBX_FIELDS[F].size == 2) {
+            uint16_t v;
+            memcpy(&v, p, sizeof(v));
+            return v;
+        }
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    // Sign extended to the field size
+    template <rbx_field_t F>
+    int32_t i() const {
+        return RBX_FIELDS[F].size == 1 ? (int32_t)(int8_t)u<F>()
+               : RBX_FIELDS[F].size == 2 ? (int32_t)(int16_t)u<F>()
+               : (int32_t)u<F>();
+    }
+
+private:
+    const uint8_t *_p = nullptr;
+};
+
+// Decode the groups in mask, fields outside it are left untouched. Returns false and
+// decodes nothing if len is too short.
+bool rbxDecode(const uint8_t *payload, uint16_t len, uint32_t mask, rbx_fix_t *fix);
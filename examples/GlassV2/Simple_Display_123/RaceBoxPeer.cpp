@@ -0,0 +1,133 @@
+/*
+ * Remembered RaceBox and reconnect policy, see RaceBoxPeer.h
+ */
+#include "RaceBoxPeer.h"
+#include <Preferences.h>
+
+RaceBoxPeer::RaceBoxPeer() : _addr_type(0), _char_handle(0), _direct_failures(0),
+    _backoff_ms(0), _drop_ms(0), _drop_pending(false) {
+    _addr[0] = '\0';
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+bool RaceBoxPeer::load() {
+    Preferences prefs;
+    if (!prefs.begin(RBX_PEER_NAMESPACE, true)) {
+        return false;
+    }
+    if (!prefs.isKey("addr")) {
+        prefs.end();
+        return false;
+    }
+    size_t n = prefs.getString("addr", _addr, sizeof(_addr));
+    _addr_type = prefs.getUChar("type", 0);
+    _char_handle = prefs.getUShort("handle", 0);
+    prefs.end();
+    if (n == 0) {
+        _addr[0] = '\0';
+        return false;
+    }
+    Serial.printf("Known RaceBox: %s (type %u, handle %u)\n", _addr, _addr_type, _char_handle);
+    return true;
+}
+
+void RaceBoxPeer::store(const char *addr, uint8_t addrType, uint16_t charHandle) {
+    _direct_failures = 0;
+    if (strcmp(addr, _addr) == 0 && addrType == _addr_type && charHandle == _char_handle) {
+        return;
+    }
+    strlcpy(_addr, addr, sizeof(_addr));
+    _addr_type = addrType;
+    _char_handle = charHandle;
+
+    Preferences prefs;
+    if (prefs.begin(RBX_PEER_NAMESPACE, false)) {
+        prefs.putString("addr", _addr);
+        prefs.putUChar("type", _addr_type);
+        prefs.putUShort("handle", _char_handle);
+        prefs.end();
+    }
+    Serial.printf("Remembered RaceBox %s\n", _addr);
+}
+
+void RaceBoxPeer::forget() {
+    _addr[0] = '\0';
+    _addr_type = 0;
+    _char_handle = 0;
+    _direct_failures = 0;
+    Preferences prefs;
+    if (prefs.begin(RBX_PEER_NAMESPACE, false)) {
+        prefs.clear();
+        prefs.end();
+    }
+}
+
+bool RaceBoxPeer::preferDirect() {
+    return known() && _direct_failures < RBX_PEER_DIRECT_TRIES;
+}
+
+void RaceBoxPeer::directResult(bool ok) {
+    if (ok) {
+        _stats.direct_ok++;
+        _direct_failures = 0;
+    } else {
+        _stats.direct_failed++;
+        _direct_failures++;
+    }
+}
+
+void RaceBoxPeer::scanStarted() {
+    _stats.scans++;
+    // Give the remembered RaceBox another chance after this scan
+    _direct_failures = 0;
+}
+
+uint32_t RaceBoxPeer::nextBackoffMs() {
+    _backoff_ms = _backoff_ms == 0 ? RBX_PEER_BACKOFF_MIN_MS : _backoff_ms * 2;
+    if (_backoff_ms > RBX_PEER_BACKOFF_MAX_MS) {
+        _backoff_ms = RBX_PEER_BACKOFF_MAX_MS;
+    }
+    return _backoff_ms;
+}
+
+void RaceBoxPeer::resetBackoff() {
+    _backoff_ms = 0;
+}
+
+void RaceBoxPeer::markDrop(uint32_t now_ms) {
+    _stats.drops++;
+    _drop_ms = now_ms;
+    _drop_pending = true;
+}
+
+void RaceBoxPeer::markConnected(uint32_t now_ms) {
+    if (_drop_pending) {
+        _stats.last_connect_ms = now_ms - _drop_ms;
+    }
+}
+
+void RaceBoxPeer::markFirstFix(uint32_t now_ms) {
+    // A link that delivers fixes again is healthy, the next drop starts from a short retry
+    resetBackoff();
+    if (!_drop_pending) {
+        return;
+    }
+    _drop_pending = false;
+    _stats.last_recovery_ms = now_ms - _drop_ms;
+    if (_stats.last_recovery_ms > _stats.max_recovery_ms) {
+        _stats.max_recovery_ms = _stats.last_recovery_ms;
+    }
+    Serial.printf("RaceBox recovered: connected after %lu ms, first fix after %lu ms\n",
+                  (unsigned long)_stats.last_connect_ms, (unsigned long)_stats.last_recovery_ms);
+}
+
+void RaceBoxPeer::getStats(rbx_peer_stats_t *stats) {
+    *stats = _stats;
+}
+
+void RaceBoxPeer::printStats(Stream &out) {
+    out.printf("Peer: %s drops=%lu direct ok=%lu failed=%lu scans=%lu connect=%lu ms recovery last=%lu max=%lu ms\n",
+               known() ? _addr : "none", (unsigned long)_stats.drops, (unsigned long)_stats.direct_ok,
+               (unsigned long)_stats.direct_failed, (unsigned long)_stats.scans, (unsigned long)_stats.last_connect_ms,
+               (unsigned long)_stats.last_recovery_ms, (unsigned long)_stats.max_recovery_ms);
+}
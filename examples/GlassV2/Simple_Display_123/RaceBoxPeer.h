@@ -0,0 +1,81 @@
+/*
+ * Remembered RaceBox and reconnect policy.
+ *
+ * The address, address type and TX characteristic handle of the last RaceBox that
+ * delivered data are kept in NVS, so after a drop or a reboot the sketch connects to
+ * it directly instead of scanning first. A scan is only used after RBX_PEER_DIRECT_TRIES
+ * direct attempts failed, e.g. when the RaceBox was swapped. Retries back off
+ * exponentially from RBX_PEER_BACKOFF_MIN_MS to RBX_PEER_BACKOFF_MAX_MS and the time
+ * from a drop to the next GPS fix is recorded.
+ */
+#pragma once
+
+#include <Arduino.h>
+
+#define RBX_PEER_NAMESPACE          "racebox"
+#define RBX_PEER_DIRECT_TRIES       2       // Direct connects before falling back to a scan
+#define RBX_PEER_BACKOFF_MIN_MS     250
+#define RBX_PEER_BACKOFF_MAX_MS     8000
+#define RBX_PEER_ADDR_LEN           18      // "aa:bb:cc:dd:ee:ff"
+
+typedef struct {
+    uint32_t drops;                 // Connections lost
+    uint32_t direct_ok;
+    uint32_t direct_failed;
+    uint32_t scans;                 // Fallback scans started
+    uint32_t last_connect_ms;       // Drop to connected
+    uint32_t last_recovery_ms;      // Drop to the first GPS fix
+    uint32_t max_recovery_ms;
+} rbx_peer_stats_t;
+
+class RaceBoxPeer {
+public:
+    RaceBoxPeer();
+
+    // Read the remembered RaceBox from NVS, false if there is none
+    bool load();
+
+    // Remember the RaceBox, NVS is only written when something changed
+    void store(const char *addr, uint8_t addrType, uint16_t charHandle);
+    void forget();
+
+    bool known() {
+        return _addr[0] != '\0';
+    }
+    const char *address() {
+        return _addr;
+    }
+    uint8_t addressType() {
+        return _addr_type;
+    }
+    uint16_t charHandle() {
+        return _char_handle;
+    }
+
+    // Whether the next attempt should be a direct connect rather than a scan
+    bool preferDirect();
+    void directResult(bool ok);
+    void scanStarted();
+
+    // Delay before the next retry, doubles on every call until resetBackoff()
+    uint32_t nextBackoffMs();
+    void resetBackoff();
+
+    // Recovery timing, all from loop()
+    void markDrop(uint32_t now_ms);
+    void markConnected(uint32_t now_ms);
+    void markFirstFix(uint32_t now_ms);
+
+    void getStats(rbx_peer_stats_t *stats);
+    void printStats(Stream &out);
+
+private:
+    char _addr[RBX_PEER_ADDR_LEN];
+    uint8_t _addr_type;
+    uint16_t _char_handle;
+    uint8_t _direct_failures;
+    uint32_t _backoff_ms;
+    uint32_t _drop_ms;
+    bool _drop_pending;
+    rbx_peer_stats_t _stats;
+};
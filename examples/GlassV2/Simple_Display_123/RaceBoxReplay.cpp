@@ -0,0 +1,123 @@
+/*
+ * RaceBox session replay, see RaceBoxReplay.h
+ */
+#include "RaceBoxReplay.h"
+
+RaceBoxReplay::RaceBoxReplay() : _in(nullptr), _speed(1.0f), _start_us(0), _end_us(0),
+    _messages(0), _pending(false), _lap_count(0) {
+    memset(&_pipeline, 0, sizeof(_pipeline));
+    memset(_stages, 0, sizeof(_stages));
+}
+
+bool RaceBoxReplay::start(Stream &in, const rbx_pipeline_t &pipeline, float speed) {
+    char magic[4];
+    if (!pipeline.parse || in.readBytes(magic, 4) != 4 || memcmp(magic, RBX_MAGIC, 4) != 0) {
+        return false;
+    }
+    _in = &in;
+    _pipeline = pipeline;
+    _speed = speed < 0 ? 0 : speed;
+    _messages = 0;
+    _pending = false;
+    _lap_count = 0;
+    memset(_stages, 0, sizeof(_stages));
+    _start_us = micros();
+    _end_us = _start_us;
+    return true;
+}
+
+void RaceBoxReplay::stop() {
+    if (_in) {
+        _end_us = micros();
+    }
+    _in = nullptr;
+}
+
+bool RaceBoxReplay::readRecord() {
+    if (_in->readBytes((char *)&_record, sizeof(_record)) != sizeof(_record)) {
+        return false;
+    }
+    if (_record.len > RBX_MAX_RECORD) {
+        return false;
+    }
+    return _in->readBytes((char *)_payload, _record.len) == _record.len;
+}
+
+void RaceBoxReplay::runStage(RbxStage stage) {
+    uint32_t start = micros();
+    switch (stage) {
+    case RBX_STAGE_PARSE:
+        _pipeline.parse(_payload, _record.len);
+        break;
+    case RBX_STAGE_LAP:
+        if (!_pipeline.lap) {
+            return;
+        }
+        _pipeline.lap();
+        break;
+    case RBX_STAGE_DISPLAY:
+        if (!_pipeline.display) {
+            return;
+        }
+        _pipeline.display();
+        break;
+    default:
+        return;
+    }
+    uint32_t us = micros() - start;
+    rbx_stage_stats_t *s = &_stages[stage];
+    s->count++;
+    s->total_us += us;
+    if (us > s->max_us) {
+        s->max_us = us;
+    }
+}
+
+bool RaceBoxReplay::service() {
+    if (!_in) {
+        return false;
+    }
+    for (uint32_t i = 0; _speed == 0 ? i < RBX_REPLAY_BATCH : true; i++) {
+        if (!_pending) {
+            if (!readRecord()) {
+                stop();
+                return false;
+            }
+            _pending = true;
+        }
+        // Paced replay waits until the scaled capture time has been reached
+        if (_speed > 0 && (uint32_t)(micros() - _start_us) < (uint32_t)(_record.t_us / _speed)) {
+            return true;
+        }
+        _pending = false;
+        _messages++;
+        runStage(RBX_STAGE_PARSE);
+        runStage(RBX_STAGE_LAP);
+        runStage(RBX_STAGE_DISPLAY);
+    }
+    return true;
+}
+
+void RaceBoxReplay::recordLap(uint32_t lap_ms) {
+    if (_lap_count < RBX_REPLAY_MAX_LAPS) {
+        _laps[_lap_count] = lap_ms;
+    }
+    _lap_count++;
+}
+
+void RaceBoxReplay::printReport(Stream &out) {
+    static const char *names[RBX_STAGE_COUNT] = {"parse", "lap", "display"};
+    uint32_t elapsed = (_in ? micros() : _end_us) - _start_us;
+    out.printf("Replay: %lu messages in %.3f s, %.1f msg/s\n", (unsigned long)_messages,
+               elapsed / 1e6, elapsed ? _messages * 1e6 / elapsed : 0.0);
+    for (int i = 0; i < RBX_STAGE_COUNT; i++) {
+        rbx_stage_stats_t *s = &_stages[i];
+        out.printf("  %-8s n=%lu avg=%.1fus max=%luus\n", names[i], (unsigned long)s->count,
+                   s->count ? (double)s->total_us / s->count : 0.0, (unsigned long)s->max_us);
+    }
+    out.printf("  laps=%lu\n", (unsigned long)_lap_count);
+    for (uint32_t i = 0; i < _lap_count && i < RBX_REPLAY_MAX_LAPS; i++) {
+        out.printf("  lap %lu: %lu.%03lu s\n", (unsigned long)(i + 1),
+                   (unsigned long)(_laps[i] / 1000), (unsigned long)(_laps[i] % 1000));
+    }
+}
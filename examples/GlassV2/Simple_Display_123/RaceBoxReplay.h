@@ -0,0 +1,88 @@
+/*
+ * RaceBox session replay and the capture file format.
+ *
+ * Capture file: "RBX1", then one record per BLE notification:
+ *   uint32 t_us   microseconds since the capture started, little endian
+ *   uint16 len    payload bytes
+ *   payload       the notification exactly as received
+ *
+ * RaceBoxReplay reads a capture back and pushes every record through the same
+ * parse -> lap -> display stages as live data, at the recorded pace, N times faster
+ * or as fast as possible, and times each stage. It only needs a Stream and micros(),
+ * the host build replays through it. Recording is RaceBoxCapture.h, which depends on
+ * the ESP32 (PSRAM ring, portMUX).
+ */
+#pragma once
+
+#include <Arduino.h>
+
+#define RBX_MAGIC               "RBX1"
+#define RBX_MAX_RECORD          512         // Longest notification kept
+#define RBX_REPLAY_BATCH        32          // Records per service() call at max speed
+#define RBX_REPLAY_MAX_LAPS     32
+
+typedef struct __attribute__((packed)) {
+    uint32_t t_us;
+    uint16_t len;
+} rbx_record_t;
+
+typedef struct {
+    uint32_t count;
+    uint64_t total_us;
+    uint32_t max_us;
+} rbx_stage_stats_t;
+
+enum RbxStage {
+    RBX_STAGE_PARSE,
+    RBX_STAGE_LAP,
+    RBX_STAGE_DISPLAY,
+    RBX_STAGE_COUNT
+};
+
+// The stages a record goes through, lap and display may be NULL
+typedef struct {
+    void (*parse)(uint8_t *data, size_t len);
+    void (*lap)();
+    void (*display)();
+} rbx_pipeline_t;
+
+class RaceBoxReplay {
+public:
+    RaceBoxReplay();
+
+    // speed: 1 = recorded pace, N = N times faster, 0 = as fast as possible
+    bool start(Stream &in, const rbx_pipeline_t &pipeline, float speed = 1.0f);
+    void stop();
+    bool active() {
+        return _in != nullptr;
+    }
+
+    // Returns false once the capture has been played completely
+    bool service();
+
+    // Lap times produced while replaying, reported by printReport
+    void recordLap(uint32_t lap_ms);
+
+    void printReport(Stream &out);
+
+    uint32_t messages() {
+        return _messages;
+    }
+
+private:
+    bool readRecord();
+    void runStage(RbxStage stage);
+
+    Stream *_in;
+    rbx_pipeline_t _pipeline;
+    float _speed;
+    uint32_t _start_us;
+    uint32_t _end_us;
+    uint32_t _messages;
+    rbx_record_t _record;
+    uint8_t _payload[RBX_MAX_RECORD];
+    bool _pending;
+    rbx_stage_stats_t _stages[RBX_STAGE_COUNT];
+    uint32_t _laps[RBX_REPLAY_MAX_LAPS];
+    uint32_t _lap_count;
+};
@@ -0,0 +1,172 @@
+/*
+ * Sector timing, see Sectors.h
+ */
+#include "Sectors.h"
+#include <Preferences.h>
+
+SectorTimer::SectorTimer() : _count(0), _enabled(false), _running(false), _flying(false),
+    _current(0), _sector_start(0) {
+    memset(_times, 0, sizeof(_times));
+    memset(_lap, 0, sizeof(_lap));
+    resetBests();
+}
+
+bool SectorTimer::load() {
+    Preferences prefs;
+    if (!prefs.begin(SECTOR_NAMESPACE, true)) {
+        return false;
+    }
+    size_t n = prefs.getBytesLength("splits");
+    if (n == 0 || n % sizeof(split_gate_t) != 0 || n > sizeof(_defs)) {
+        prefs.end();
+        return false;
+    }
+    prefs.getBytes("splits", _defs, n);
+    prefs.end();
+    _count = n / sizeof(split_gate_t);
+    Serial.printf("Loaded %u split gates\n", _count);
+    return true;
+}
+
+void SectorTimer::store() {
+    Preferences prefs;
+    if (!prefs.begin(SECTOR_NAMESPACE, false)) {
+        return;
+    }
+    if (_count) {
+        prefs.putBytes("splits", _defs, _count * sizeof(split_gate_t));
+    } else {
+        prefs.remove("splits");
+    }
+    prefs.end();
+}
+
+bool SectorTimer::addSplit(int32_t lat, int32_t lon, float headingDeg) {
+    if (_count >= SECTOR_MAX_SPLITS) {
+        return false;
+    }
+    _defs[_count].lat = lat;
+    _defs[_count].lon = lon;
+    _defs[_count].heading = headingDeg;
+    _count++;
+    // Sector layout changed, bests of the old layout mean nothing
+    resetBests();
+    _running = false;
+    return true;
+}
+
+void SectorTimer::clearSplits() {
+    _count = 0;
+    _enabled = false;
+    _running = false;
+    resetBests();
+}
+
+void SectorTimer::setFrame(const TrackFrame &frame) {
+    _enabled = _count > 0;
+    for (uint8_t i = 0; i < _count; i++) {
+        enu_t p = frame.project(_defs[i].lat, _defs[i].lon);
+        if (enuLength(p) > SECTOR_MAX_RANGE_M) {
+            Serial.printf("Split gate %u is %.0f m from the finish line, sectors off\n", i + 1, enuLength(p));
+            _enabled = false;
+            break;
+        }
+        _gates[i].set(p, _defs[i].heading);
+    }
+    _running = false;
+}
+
+void SectorTimer::startLap(uint32_t itowMs, bool flying) {
+    memset(_times, 0, sizeof(_times));
+    _current = 0;
+    _sector_start = itowMs;
+    _flying = flying;
+    _running = true;
+    if (splits()) {
+        _gates[0].restart();
+    }
+}
+
+void SectorTimer::restart() {
+    if (_running && _current < splits()) {
+        _gates[_current].restart();
+    }
+}
+
+void SectorTimer::resetBests() {
+    memset(_best, 0, sizeof(_best));
+    _last_index = 0;
+    _last_time = 0;
+    _last_delta = 0;
+    _last_has_delta = false;
+    _last_is_best = false;
+}
+
+// Time the sector in progress up to crossMs and compare it with the best
+void SectorTimer::closeSector(uint32_t crossMs) {
+    uint8_t i = _current;
+    uint32_t t = gpsTimeDiff(crossMs, _sector_start);
+    _times[i] = t;
+    _last_index = i;
+    _last_time = t;
+    _last_has_delta = _best[i] != 0;
+    _last_delta = _last_has_delta ? (int32_t)t - (int32_t)_best[i] : 0;
+    _last_is_best = false;
+    if ((i > 0 || _flying) && (_best[i] == 0 || t < _best[i])) {
+        _best[i] = t;
+        _last_is_best = true;
+    }
+    _sector_start = crossMs;
+}
+
+bool SectorTimer::update(enu_t pos, uint32_t itowMs) {
+    if (!_running || _current >= splits()) {
+        return false;
+    }
+    uint32_t crossMs;
+    if (!_gates[_current].update(pos, itowMs, &crossMs)) {
+        return false;
+    }
+    closeSector(crossMs);
+    _current++;
+    if (_current < splits()) {
+        // Only the next gate is watched, start it from this fix
+        _gates[_current].restart();
+        _gates[_current].update(pos, itowMs, &crossMs);
+    }
+    return true;
+}
+
+bool SectorTimer::finishLap(uint32_t crossMs) {
+    if (!_running) {
+        return false;
+    }
+    bool complete = _current == splits();
+    if (complete) {
+        closeSector(crossMs);
+    } else {
+        Serial.printf("Missed split gate %u, lap sectors incomplete\n", _current + 1);
+    }
+    memcpy(_lap, _times, sizeof(_lap));
+    return complete;
+}
+
+uint32_t SectorTimer::theoreticalBest() {
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i < sectors(); i++) {
+        if (_best[i] == 0) {
+            return 0;
+        }
+        sum += _best[i];
+    }
+    return sum;
+}
+
+void SectorTimer::printStats(Stream &out) {
+    out.printf("Sectors: %u splits%s, in sector %u\n", _count, _enabled || !_count ? "" : " (off track)",
+               _current + 1);
+    for (uint8_t i = 0; i < sectors(); i++) {
+        out.printf("  S%u last=%lu best=%lu ms\n", i + 1, (unsigned long)_lap[i], (unsigned long)_best[i]);
+    }
+    out.printf("Theoretical best: %lu ms\n", (unsigned long)theoreticalBest());
+}
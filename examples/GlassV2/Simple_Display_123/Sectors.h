@@ -0,0 +1,122 @@
+/*
+ * Sector timing: split gates between two finish line crossings.
+ *
+ * Up to SECTOR_MAX_SPLITS split gates divide the lap into sectors. Each is a LapGate in
+ * the track frame, stored in NVS as a position and direction of travel so it survives a
+ * new frame origin. Sectors are run in order, so a fix is only ever tested against the
+ * next split gate, O(1) whatever the number of gates.
+ *
+ * Every sector time is the difference of two interpolated crossings. Session bests are
+ * kept per sector, their sum is the theoretical best lap, and each closed sector is
+ * compared with the best before it for the live delta. A missed split gate leaves the
+ * rest of that lap untimed, and the first sector after a standing start never counts
+ * as a best.
+ */
+#pragma once
+
+#include <Arduino.h>
+#include "Geodesy.h"
+#include "LapGate.h"
+
+#define SECTOR_NAMESPACE            "sectors"
+#define SECTOR_MAX_SPLITS           7       // A lap has up to 8 sectors
+#define SECTOR_MAX                  (SECTOR_MAX_SPLITS + 1)
+#define SECTOR_MAX_RANGE_M          5000.0f // Split gates further from the origin belong to another track
+
+typedef struct {
+    int32_t lat;                    // Degrees * 1e7
+    int32_t lon;
+    float heading;                  // Direction of travel, degrees from north, NAN if unknown
+} split_gate_t;
+
+class SectorTimer {
+public:
+    SectorTimer();
+
+    // Split gates from NVS, false if there are none
+    bool load();
+    void store();
+
+    // Splits go in lap order, addSplit() returns false when all are used
+    bool addSplit(int32_t lat, int32_t lon, float headingDeg);
+    void clearSplits();
+    uint8_t splits() {
+        return _enabled ? _count : 0;
+    }
+    uint8_t sectors() {
+        return splits() + 1;
+    }
+
+    // Place the split gates in the frame of the finish line, call whenever it changes
+    void setFrame(const TrackFrame &frame);
+
+    // At the finish line crossing, or at a standing start when flying is false
+    void startLap(uint32_t itowMs, bool flying);
+
+    // Closes the last sector at the finish crossing, true if the whole lap was timed
+    bool finishLap(uint32_t crossMs);
+
+    // Forget the previous fix, e.g. after a reconnect
+    void restart();
+
+    // Every fix while a lap runs, true when it crossed a split gate
+    bool update(enu_t pos, uint32_t itowMs);
+
+    void resetBests();
+
+    // Sector in progress, 0 based
+    uint8_t current() {
+        return _current;
+    }
+
+    // The sector closed last: index, time and difference to the best before it,
+    // lastHasDelta() is false until that sector has a best to compare with
+    uint8_t lastIndex() {
+        return _last_index;
+    }
+    uint32_t lastTime() {
+        return _last_time;
+    }
+    int32_t lastDelta() {
+        return _last_delta;
+    }
+    bool lastHasDelta() {
+        return _last_has_delta;
+    }
+    bool lastIsBest() {
+        return _last_is_best;
+    }
+
+    // Of the last finished lap, 0 = not timed
+    uint32_t lapSector(uint8_t i) {
+        return i < SECTOR_MAX ? _lap[i] : 0;
+    }
+    uint32_t bestSector(uint8_t i) {
+        return i < SECTOR_MAX ? _best[i] : 0;
+    }
+
+    // Sum of the best sectors, 0 until every sector has one
+    uint32_t theoreticalBest();
+
+    void printStats(Stream &out);
+
+private:
+    void closeSector(uint32_t crossMs);
+
+    split_gate_t _defs[SECTOR_MAX_SPLITS];
+    LapGate _gates[SECTOR_MAX_SPLITS];
+    uint8_t _count;
+    bool _enabled;                  // All split gates are on the current track
+    bool _running;
+    bool _flying;                   // The first sector started with a crossing
+    uint8_t _current;
+    uint32_t _sector_start;         // iTOW of the last crossing
+    uint32_t _times[SECTOR_MAX];    // Lap in progress
+    uint32_t _lap[SECTOR_MAX];      // Last finished lap
+    uint32_t _best[SECTOR_MAX];
+    uint8_t _last_index;
+    uint32_t _last_time;
+    int32_t _last_delta;
+    bool _last_has_delta;
+    bool _last_is_best;
+};
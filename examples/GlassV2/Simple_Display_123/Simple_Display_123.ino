@@ -53,6 +53,51 @@ GPS DRIFT FIX (Jan 2026):
     • This prevents drift caused by poor-quality GPS readings being used for
       lap timing/distance calculations while speed remains accurate
 
+SESSION CAPTURE / REPLAY (serial commands):
+    c - start/stop recording RaceBox notifications to /session.rbx (LittleFS)
+    x - replay the recording at real time, f - at 10x, X - as fast as possible
+    The replay runs the recorded packets through the same parse, lap and display
+    code and prints messages/s, per-stage latency and the lap times produced.
+
+TELEMETRY PIPELINE:
+    • The BLE callback only frames and decodes, each fix goes into a lock-free ring
+    • loop() drains the ring in order, so every fix reaches speed, finish line
+      capture and lap timing, not just the one present at a status update
+    • 'u' on serial prints the ring depth, high water mark, overflows and latency
+
+RECONNECT:
+    • The last RaceBox (address, type, TX handle) is kept in NVS and reconnected
+      directly, a scan is only used after two direct attempts fail
+    • Retries back off from 250 ms to 8 s instead of a fixed 5 s wait
+    • 'l' on serial prints drops, direct/scan counts and drop-to-first-fix time,
+      the granted MTU/connection parameters and the notification jitter
+
+LAP TIMING:
+    • The finish line is a 24 m gate across the direction of travel at capture
+      (or of the first movement if captured standing still), stored with it
+    • Every pair of fixes is tested against the gate and the crossing time is
+      interpolated between their iTOW stamps, laps resolve to the millisecond
+    • Fixes are projected once into a metric frame anchored at the finish line,
+      distances and gate tests are single-precision vector maths from there
+    • Up to 7 split gates ('g' adds one where you are, 'G' clears them) give
+      sector times, session best sectors, the theoretical best lap and a
+      sector delta flashed at every split, 's' prints them
+    • The fastest flying lap is kept as a reference trace in LittleFS, every
+      fix is matched against it for a live +/- delta (the DELTA display),
+      'd' prints the matcher state
+
+TRACK DATABASE:
+    • /tracks.db in LittleFS (built with tools/build_trackdb.py, uploaded with
+      "pio run -t uploadfs") holds many tracks with their finish line, split
+      gates and optionally a reference lap
+    • The first good fix looks up the nearest track within 5 km through a grid
+      index and loads it, the first crossing then starts timing on its own
+    • 't' prints the current track and the last lookup
+BLE LINK:
+    • MTU 185 and a 7.5-15 ms connection interval with no latency are requested,
+      the granted values are checked a second after connecting
+    • Without a RaceBox, flash examples/GlassV2/RaceBox_Emulator to any ESP32
+
 AUTHOR: T-Glass Racing Project
 DATE: January 2026
 ==============================================================================
@@ -61,9 +106,25 @@ DATE: January 2026
 #include "Arduino.h"
 #include <LilyGo_Wristband.h>
 #include <LV_Helper.h>
+#include <LilyGo_BootTimeline.h>
+#include <LV_NumberLabel.h>
+#include <LV_BoundLabel.h>
 #include "NimBLEDevice.h"
 #include <EEPROM.h>
 #include <nvs_flash.h>
+#include <LittleFS.h>
+#include "RaceBoxCapture.h"
+#include "RaceBoxReplay.h"
+#include "UbxFramer.h"
+#include "RaceBoxData.h"
+#include "RaceBoxPeer.h"
+#include "BleLinkStats.h"
+#include "Geodesy.h"
+#include "LapGate.h"
+#include "Sectors.h"
+#include "LapDelta.h"
+#include "TrackDb.h"
+#include "TelemetryQueue.h"
 
 // RaceBox BLE UUIDs
 const char* UART_SERVICE_UUID = "6E400001-B5A3-F393-E0A9-E50E24DCCA9E";
@@ -73,6 +134,28 @@ const char* UART_TX_UUID      = "6E400003-B5A3-F393-E0A9-E50E24DCCA9E";
 // Objects
 LilyGo_Class amoled;
 lv_obj_t *number_label;
+lv_obj_t *digits_label;     // Speed and lap timer, only redraws changed digits
+// All label changes go through these, unchanged text, font or color never reach LVGL
+LV_BoundLabel hudText;
+LV_BoundLabel hudDigits;
+
+// Session capture and replay, see RaceBoxCapture.h and RaceBoxReplay.h
+#define CAPTURE_FILE "/session.rbx"
+RaceBoxCapture capture;
+RaceBoxReplay replay;
+File captureFile;
+File replayFile;
+
+// Reference lap for the live delta, written aside and renamed over the old one
+#define REFERENCE_FILE "/reference.lap"
+#define REFERENCE_TMP_FILE "/reference.tmp"
+
+// Track database, see TrackDb.h
+#define TRACKDB_FILE "/tracks.db"
+File trackDbFile;
+TrackDb trackDb;
+bool trackLookupDone = false;      // One lookup per boot, at the first good fix
+char trackName[TRACKDB_NAME_LEN] = "";
 
 // BLE variables (using working example.cpp pattern)
 static BLEUUID serviceUUID("6E400001-B5A3-F393-E0A9-E50E24DCCA9E");
@@ -82,6 +165,20 @@ static bool doConnect = false;
 static bool connected = false;
 static NimBLEAdvertisedDevice* myRaceBox = nullptr;
 static NimBLERemoteCharacteristic* pRemoteCharacteristic = nullptr;
+static NimBLEClient* raceBoxClient = nullptr;     // Reused, keeps the discovered services of the same RaceBox
+RaceBoxPeer racePeer;                               // Remembered RaceBox, direct reconnect and backoff
+const uint8_t directConnectTimeout = 3;             // Seconds, a direct connect to an absent RaceBox fails fast
+
+// Link parameters for the 25 Hz RaceBox stream: one 88-byte frame per notification and
+// a short connection interval so fixes are not batched up
+const uint16_t preferredMtu = 185;
+const uint16_t minUsableMtu = 100;
+const uint16_t connIntervalMin = 6;                 // 7.5 ms, in 1.25 ms units
+const uint16_t connIntervalMax = 12;                // 15 ms
+const uint16_t connLatency = 0;                     // Answer every connection event
+const uint16_t connTimeout = 200;                   // 2 s, in 10 ms units
+BleLinkStats linkStats;
+unsigned long linkCheckTime = 0;                    // When to read back the granted parameters, 0 = done
 
 // Parsed data from RaceBox
 float currentSpeed = 0.0;  // Speed in km/h
@@ -99,14 +196,28 @@ int dataPacketsReceived = 0;
 // GPS Coordinates
 double currentLatitude = 0.0;      // Current latitude in degrees
 double currentLongitude = 0.0;     // Current longitude in degrees
+int32_t currentLatE7 = 0;          // The same in RaceBox units, degrees * 1e7
+int32_t currentLonE7 = 0;
+enu_t currentPos = {0, 0};         // Metres east/north of the finish line, valid with trackFrame
 bool coordsUpdated = false;        // Flag indicating new coordinates received
 uint32_t horizontalAccuracy = 0;   // Horizontal accuracy estimate in mm
 bool gpsAccuracyPoor = false;      // Flag indicating if recent GPS accuracy is poor
 
 // GPS Timestamp
 uint32_t currentGpsTime = 0;       // GPS time of week (iTOW) in milliseconds
+float currentHeading = 0.0;        // Heading of motion in degrees
+float currentGroundSpeed = 0.0;    // Unsmoothed speed in m/s
 bool gpsTimeUpdated = false;       // Flag indicating new GPS time received
 
+// RaceBox fields the HUD screens use, the rest of the payload is not converted
+#define HUD_FIX_FIELDS (RBX_F_TIME | RBX_F_FIX | RBX_F_POSITION | RBX_F_ACCURACY | RBX_F_MOTION | RBX_F_BATTERY)
+
+// Decoded fixes, pushed by the NimBLE task and drained in order by loop()
+TelemetryQueue telemetryQueue;
+uint32_t fixesProcessed = 0;
+uint32_t maxFixLatencyUs = 0;      // Decode to processing, worst case
+unsigned long lastCoordsUpdateTime = 0;
+
 // Connection status
 enum ConnectionState {
   STATE_STARTUP,      // Waiting for user to start BLE sequence
@@ -128,6 +239,7 @@ enum DisplayMode {
   DISPLAY_LAP_CTRL,   // Lap timing controls
   DISPLAY_SET_LINE,   // "SET LINE?" confirmation mode
   DISPLAY_LINE_SAVED, // "LINE SET!" confirmation
+  DISPLAY_TRACK_FOUND, // Track loaded from the database
   DISPLAY_BAD_FIX,    // "BAD FIX" - GPS too poor to set line
   DISPLAY_GPS_DEBUG,   // Show captured GPS coordinates
   DISPLAY_COUNTDOWN_3, // Countdown 3
@@ -144,8 +256,10 @@ enum DisplayMode {
   DISPLAY_LAP_TIMER,   // Current lap duration timer (no timeout)
   DISPLAY_LAP_DEBUG,   // Distance + lap timer combined (2 lines)
   DISPLAY_LAP_SPEED,   // Lap timer + speed combined (2 lines, no timeout)
+  DISPLAY_LIVE_DELTA,  // Live delta to the reference lap + lap timer (2 lines, no timeout)
   DISPLAY_LAP_FLASH,   // Temporary lap time display ("LAP TIME:" + time)
   DISPLAY_LAP_DELTA,  // Delta comparison display (delta + time)
+  DISPLAY_SECTOR_DELTA, // Sector just closed: delta to its best + sector time
   DISPLAY_RESET,      // Reset menu option
   DISPLAY_RESET_CONFIRM // "SURE?" confirmation for reset
 };
@@ -173,6 +287,9 @@ const unsigned long doubleTapWindow = 400; // 400ms window for double tap
 unsigned long lapFlashStart = 0;
 const unsigned long lapFlashDuration = 5000; // 5 seconds to show lap time + delta
 bool isLapFlashing = false;
+unsigned long sectorFlashStart = 0;
+const unsigned long sectorFlashDuration = 3000; // Sector delta, then back to the lap display
+DisplayMode sectorReturnMode = DISPLAY_LAP_DEBUG;
 String bestLapTime = "---.--"; // Best lap of session
 int raceBoxBattery = -1; // RaceBox battery percentage (-1 = unknown)
 
@@ -199,14 +316,21 @@ unsigned long lapCheckCounter = 0;
 double finishLineLat = 0.0;
 double finishLineLon = 0.0;
 bool finishLineSet = false;
-const double crossingThreshold = 3.0; // 3 meters crossing detection (tight for 10Hz GPS)
-const double minDistanceForNextLap = 6.0; // Must be this far away before next lap can trigger
+const double crossingThreshold = 3.0; // Within 3 meters of the gate counts as near the line
+const uint32_t minLapTime = 10000; // ms, a crossing sooner than this after the last one is ignored
+float finishLineHeading = NAN;     // Direction of travel through the line, degrees, NAN = not known yet
+TrackFrame trackFrame;             // Metric frame anchored at the finish line
+LapGate finishGate;                // The finish line as a segment across the track
+SectorTimer sectors;               // Split gates between finish line crossings
+LapDelta lapDelta;                 // Live delta against the reference lap
 
 // Finish line averaging (capture multiple readings for better accuracy)
 const int finishLineReadingsCount = 10; // Average 10 GPS readings
 double finishLineReadingsLat[10];
 double finishLineReadingsLon[10];
 int finishLineReadingsIndex = 0;
+float finishLineHeadingX = 0.0;         // Sum of heading unit vectors while moving
+float finishLineHeadingY = 0.0;
 bool finishLineCapturing = false;
 unsigned long finishLineCaptureStart = 0;
 const unsigned long finishLineCaptureDuration = 3000; // 3 seconds to capture readings
@@ -266,10 +390,10 @@ class MyClientCallback : public NimBLEClientCallbacks {
 void performSystemReset() {
     Serial.println("*** PERFORMING SYSTEM RESET ***");
     
-    // Show reset in progress
-    lv_label_set_text(number_label, "RESET..");
-    lv_timer_handler();
-    amoled.update();
+    // Show reset in progress, the LVGL task draws it during the delay
+    lvglLock();
+    hudText.setText("RESET..");
+    lvglUnlock();
     delay(1000);
     
     // Clear BLE bonds and deinitialize
@@ -284,8 +408,10 @@ void performSystemReset() {
     NimBLEDevice::deleteAllBonds();
     delay(500);
     
-    // Deinitialize BLE stack
+    // Deinitialize BLE stack, this deletes the client too
     NimBLEDevice::deinit();
+    raceBoxClient = nullptr;
+    racePeer.forget();
     delay(500);
     
     // Clear NVS (Non-Volatile Storage)
@@ -294,9 +420,9 @@ void performSystemReset() {
     delay(500);
     
     // Show completion
-    lv_label_set_text(number_label, "DONE!");
-    lv_timer_handler();
-    amoled.update();
+    lvglLock();
+    hudText.setText("DONE!");
+    lvglUnlock();
     delay(1000);
     
     Serial.println("*** RESET COMPLETE - REBOOTING ***");
@@ -305,122 +431,194 @@ void performSystemReset() {
     ESP.restart();
 }
 
-// Calculate distance between two GPS points using Haversine formula
-double calculateDistance(double lat1, double lon1, double lat2, double lon2) {
-    const double R = 6371000; // Earth's radius in meters
-    double dLat = (lat2 - lat1) * PI / 180.0;
-    double dLon = (lon2 - lon1) * PI / 180.0;
-    double a = sin(dLat/2) * sin(dLat/2) + 
-               cos(lat1 * PI / 180.0) * cos(lat2 * PI / 180.0) * 
-               sin(dLon/2) * sin(dLon/2);
-    double c = 2 * atan2(sqrt(a), sqrt(1-a));
-    return R * c; // Distance in meters
+// Reference lap to flash, a power cut mid-write leaves the previous one intact
+void saveReferenceLap() {
+    if (!LittleFS.begin(true)) {
+        return;
+    }
+    File f = LittleFS.open(REFERENCE_TMP_FILE, FILE_WRITE);
+    if (!f) {
+        return;
+    }
+    bool ok = lapDelta.save(f);
+    f.close();
+    if (!ok || !LittleFS.rename(REFERENCE_TMP_FILE, REFERENCE_FILE)) {
+        LittleFS.remove(REFERENCE_TMP_FILE);
+        Serial.println("Saving the reference lap failed");
+    }
 }
 
-void checkLapCrossing() {
+// Flash the sector just closed over the lap display, not over a lap time
+void showSectorDelta() {
+    Serial.printf("Sector %u: %lu ms%s\n", sectors.lastIndex() + 1, (unsigned long)sectors.lastTime(),
+                  sectors.lastIsBest() ? " (best)" : "");
+    if (isLapFlashing) {
+        return;
+    }
+    if (currentDisplayMode != DISPLAY_SECTOR_DELTA) {
+        sectorReturnMode = currentDisplayMode;
+    }
+    currentDisplayMode = DISPLAY_SECTOR_DELTA;
+    sectorFlashStart = millis();
+}
+
+// Lap timing through the finish gate, called for every fix with good accuracy
+void checkLapCrossing(const rbx_fix_t &fix) {
     // Increment lap check counter for debugging
     lapCheckCounter++;
     
-    // Only check if we have valid GPS coordinates and a finish line set
-    if (!coordsUpdated || finishLineLat == 0.0 || finishLineLon == 0.0) {
+    // Only check if a finish line is set
+    if (!finishGate.valid()) {
         return;
     }
     
-    // Calculate distance to finish line
-    double distanceToFinish = calculateDistance(currentLatitude, currentLongitude, 
-                                               finishLineLat, finishLineLon);
-    
-    // Use hysteresis: must be far away before allowing next crossing
-    static bool wasFarAway = false;
-    static double maxDistanceFromLine = 0.0;
+    uint32_t crossTime;
+    bool crossed = finishGate.update(currentPos, fix.itow_ms, &crossTime);
+    bool nearFinishLine = fabsf(finishGate.along()) <= crossingThreshold &&
+                          fabsf(finishGate.lateral()) <= LAP_GATE_HALF_WIDTH_M;
+    wasNearFinishLine = nearFinishLine;
     
-    // Track maximum distance from finish line
-    if (distanceToFinish > maxDistanceFromLine) {
-        maxDistanceFromLine = distanceToFinish;
+    if (lapInProgress && sectors.update(currentPos, fix.itow_ms)) {
+        showSectorDelta();
     }
-    
-    // Consider "far away" if we've moved beyond the minimum distance
-    if (distanceToFinish > minDistanceForNextLap) {
-        wasFarAway = true;
+    if (lapInProgress && !crossed) {
+        lapDelta.update(currentPos, gpsTimeDiff(fix.itow_ms, lapStartTime));
     }
     
-    bool nearFinishLine = (distanceToFinish <= crossingThreshold);
-    
     // Debug output (more frequent and detailed for debugging lap issues)
     static unsigned long lastCrossingDebug = 0;
     if (millis() - lastCrossingDebug > 1000) { // Every 1 second for better debugging
-        Serial.printf("LAP DEBUG: Dist=%.2fm, MaxDist=%.1fm, Near=%s, FarAway=%s, LapActive=%s, Thresh=%.1fm\n", 
-                     distanceToFinish, maxDistanceFromLine,
+        Serial.printf("LAP DEBUG: Along=%.2fm, Side=%.2fm, Heading=%.0f, Near=%s, LapActive=%s\n", 
+                     finishGate.along(), finishGate.lateral(), finishGate.heading(),
                      nearFinishLine ? "Y" : "N", 
-                     wasFarAway ? "Y" : "N",
-                     lapInProgress ? "Y" : "N",
-                     crossingThreshold);
+                     lapInProgress ? "Y" : "N");
         lastCrossingDebug = millis();
     }
     
-    // Detect crossing: was far away, now near (with hysteresis)
-    if (nearFinishLine && wasFarAway) {
-        if (!lapInProgress) {
-            // Lap should already be started after GO! - this case should rarely happen
-            // But start a lap anyway if somehow we get here
-            lapInProgress = true;
-            lapStartTime = currentGpsTime;
-            lapStartMillis = millis(); // Capture system time for smooth display
-            wasFarAway = false; // Reset hysteresis
-            maxDistanceFromLine = 0.0;
-            Serial.printf("=== LAP STARTED (unexpected - should start after GO!) (dist=%.1fm) ===\n", distanceToFinish);
+    if (!crossed) {
+        return;
+    }
+    
+    if (!lapInProgress) {
+        // Without GO! (e.g. a track loaded from the database) the first crossing starts the lap
+        lapInProgress = true;
+        lapStartTime = crossTime;
+        lapStartMillis = millis(); // Capture system time for smooth display
+        sectors.startLap(crossTime, true);
+        lapDelta.startLap(true);
+        Serial.printf("=== LAP STARTED at the line, iTOW %lu ===\n", (unsigned long)crossTime);
+        return;
+    }
+    
+    uint32_t lapTime = gpsTimeDiff(crossTime, lapStartTime);
+    if (lapTime < minLapTime) {
+        Serial.printf("Ignoring crossing %lu ms after the last one\n", (unsigned long)lapTime);
+        return;
+    }
+    
+    // Complete current lap and start new one
+    lastLapTime = lapTime;
+    if (sectors.splits() && sectors.finishLap(crossTime)) {
+        Serial.printf("Sector %u: %lu ms, theoretical best %lu ms\n",
+                     sectors.lastIndex() + 1, (unsigned long)sectors.lastTime(),
+                     (unsigned long)sectors.theoreticalBest());
+    }
+    if (replay.active()) {
+        replay.recordLap(lastLapTime);
+    }
+    if (lapDelta.finishLap(lastLapTime)) {
+        Serial.printf("New reference lap: %lu ms\n", (unsigned long)lastLapTime);
+        if (!replay.active()) {
+            saveReferenceLap();
+        }
+    }
+    
+    // Convert to readable time format (minutes:seconds.tenths)
+    unsigned long totalMs = lastLapTime;
+    unsigned long minutes = totalMs / 60000;
+    unsigned long seconds = (totalMs % 60000) / 1000;
+    unsigned long tenths = (totalMs % 1000) / 100;
+    
+    char lapTimeBuffer[32];
+    snprintf(lapTimeBuffer, sizeof(lapTimeBuffer), "%lu:%02lu.%lu", 
+            minutes, seconds, tenths);
+    currentLapTimeStr = String(lapTimeBuffer);
+    
+    // Calculate delta from best lap
+    if (bestLapTimeMs == 0 || lastLapTime < bestLapTimeMs) {
+        // This is the new best lap!
+        bestLapTimeMs = lastLapTime;
+        bestLapTime = String(lapTimeBuffer); // Update the display string too!
+        deltaStr = "BEST LAP";
+        Serial.printf("=== NEW BEST LAP: %s (%lu ms) ===\n", currentLapTimeStr.c_str(), (unsigned long)lastLapTime);
+    } else {
+        // Calculate delta (positive means slower, negative means faster)
+        int32_t deltaMs = (int32_t)lastLapTime - (int32_t)bestLapTimeMs;
+        float deltaSec = deltaMs / 1000.0;
+        char deltaBuffer[16];
+        if (deltaSec >= 0) {
+            snprintf(deltaBuffer, sizeof(deltaBuffer), "+%.1f", deltaSec);
         } else {
-            // Complete current lap and start new one
-            lastLapTime = currentGpsTime - lapStartTime;
-            
-            // Convert to readable time format (minutes:seconds.tenths)
-            unsigned long totalMs = lastLapTime;
-            unsigned long minutes = totalMs / 60000;
-            unsigned long seconds = (totalMs % 60000) / 1000;
-            unsigned long tenths = (totalMs % 1000) / 100;
-            
-            char lapTimeBuffer[32];
-            snprintf(lapTimeBuffer, sizeof(lapTimeBuffer), "%lu:%02lu.%lu", 
-                    minutes, seconds, tenths);
-            currentLapTimeStr = String(lapTimeBuffer);
-            
-            // Calculate delta from best lap
-            if (bestLapTimeMs == 0 || lastLapTime < bestLapTimeMs) {
-                // This is the new best lap!
-                bestLapTimeMs = lastLapTime;
-                bestLapTime = String(lapTimeBuffer); // Update the display string too!
-                deltaStr = "BEST LAP";
-                Serial.printf("=== NEW BEST LAP: %s (dist=%.1fm) ===\n", 
-                             currentLapTimeStr.c_str(), distanceToFinish);
-            } else {
-                // Calculate delta (positive means slower, negative means faster)
-                int32_t deltaMs = (int32_t)lastLapTime - (int32_t)bestLapTimeMs;
-                float deltaSec = deltaMs / 1000.0;
-                char deltaBuffer[16];
-                if (deltaSec >= 0) {
-                    snprintf(deltaBuffer, sizeof(deltaBuffer), "+%.1f", deltaSec);
-                } else {
-                    snprintf(deltaBuffer, sizeof(deltaBuffer), "%.1f", deltaSec);
-                }
-                deltaStr = String(deltaBuffer);
-                Serial.printf("=== LAP COMPLETE: %s (delta: %s) (dist=%.1fm) ===\n", 
-                             currentLapTimeStr.c_str(), deltaStr.c_str(), distanceToFinish);
-            }
-            
-            // Flash the lap time
-            isLapFlashing = true;
-            lapFlashStart = millis();
-            currentDisplayMode = DISPLAY_LAP_FLASH;
-            
-            // Start new lap
-            lapStartTime = currentGpsTime;
-            lapStartMillis = millis(); // Capture system time for smooth display
-            wasFarAway = false; // Reset hysteresis
-            maxDistanceFromLine = 0.0;
+            snprintf(deltaBuffer, sizeof(deltaBuffer), "%.1f", deltaSec);
         }
+        deltaStr = String(deltaBuffer);
+        Serial.printf("=== LAP COMPLETE: %s (%lu ms, delta: %s) ===\n", 
+                     currentLapTimeStr.c_str(), (unsigned long)lastLapTime, deltaStr.c_str());
     }
     
-    wasNearFinishLine = nearFinishLine;
+    // Flash the lap time
+    isLapFlashing = true;
+    lapFlashStart = millis();
+    currentDisplayMode = DISPLAY_LAP_FLASH;
+    
+    // Start new lap at the crossing, not at the fix after it
+    lapStartTime = crossTime;
+    sectors.startLap(crossTime, true);
+    lapDelta.startLap(true);
+    lapStartMillis = millis() - gpsTimeDiff(fix.itow_ms, crossTime); // Capture system time for smooth display
+}
+
+// Track frame and finish gate from the stored line, a centre and the direction of travel
+void setFinishGate() {
+    trackFrame.set((int32_t)lround(finishLineLat * 1e7), (int32_t)lround(finishLineLon * 1e7));
+    enu_t origin = {0, 0};      // The line is the origin of the frame
+    finishGate.set(origin, finishLineHeading);
+    sectors.setFrame(trackFrame);
+    lapDelta.setOrigin(trackFrame.originLat(), trackFrame.originLon());
+}
+
+// After loadFinishLine(), the reference has to match its frame origin
+void loadReferenceLap() {
+    if (!lapDelta.begin()) {
+        Serial.println("No memory for the live delta");
+        return;
+    }
+    if (!finishLineSet || !LittleFS.begin(true)) {
+        return;
+    }
+    File f = LittleFS.open(REFERENCE_FILE, FILE_READ);
+    if (f && lapDelta.load(f)) {
+        Serial.printf("Reference lap loaded: %lu ms\n", (unsigned long)lapDelta.referenceMs());
+    }
+    f.close();
+}
+
+
+// Split gate where the car is now, the direction of travel orients it
+void addSplitGate() {
+    if (!finishLineSet || !coordsUpdated) {
+        Serial.println("Split gate needs a finish line and a good fix");
+        return;
+    }
+    float heading = currentGroundSpeed > 2.0f ? currentHeading : NAN;
+    if (!sectors.addSplit(currentLatE7, currentLonE7, heading)) {
+        Serial.printf("All %d split gates used\n", SECTOR_MAX_SPLITS);
+        return;
+    }
+    sectors.store();
+    sectors.setFrame(trackFrame);
+    Serial.printf("Split gate %u at %.1f m E %.1f m N, heading %.0f\n",
+                  sectors.splits(), currentPos.e, currentPos.n, heading);
 }
 
 // Save finish line to EEPROM
@@ -429,6 +627,8 @@ void saveFinishLine() {
     EEPROM.put(0, finishLineLat);
     EEPROM.put(8, finishLineLon);
     EEPROM.put(16, true); // finishLineSet flag
+    EEPROM.put(20, finishLineHeading);
+    EEPROM.put(24, (uint8_t)0xA5); // Heading present, older saves have no heading
     EEPROM.commit();
     Serial.printf("Finish line saved: %.7f, %.7f\n", finishLineLat, finishLineLon);
 }
@@ -439,30 +639,170 @@ void loadFinishLine() {
     EEPROM.get(0, finishLineLat);
     EEPROM.get(8, finishLineLon);
     EEPROM.get(16, finishLineSet);
+    uint8_t headingMagic = 0;
+    EEPROM.get(24, headingMagic);
+    if (headingMagic == 0xA5) {
+        EEPROM.get(20, finishLineHeading);
+    }
     if (finishLineSet) {
-        Serial.printf("Finish line loaded: %.7f, %.7f\n", finishLineLat, finishLineLon);
+        setFinishGate();
+        Serial.printf("Finish line loaded: %.7f, %.7f heading %.0f\n", finishLineLat, finishLineLon, finishLineHeading);
     } else {
         Serial.println("No finish line saved");
     }
 }
 
+// Keep the database open, the lookup happens later at the first fix
+void openTrackDb() {
+    if (!LittleFS.begin(true)) {
+        return;
+    }
+    trackDbFile = LittleFS.open(TRACKDB_FILE, FILE_READ);
+    if (!trackDbFile) {
+        return;
+    }
+    if (trackDb.open(trackDbFile)) {
+        Serial.printf("Track database: %lu tracks\n", (unsigned long)trackDb.count());
+    } else {
+        Serial.println(TRACKDB_FILE " is not a track database");
+        trackDbFile.close();
+    }
+}
+
+// Nearest known track to the first good fix, loaded unless it is the line already set
+void detectTrack() {
+    trackLookupDone = true;
+    trackdb_track_t track;
+    float dist;
+    if (!trackDb.isOpen() || !trackDb.findNearest(currentLatE7, currentLonE7, &track, &dist)) {
+        Serial.println("No known track nearby");
+        return;
+    }
+    strlcpy(trackName, track.name, sizeof(trackName));
+    trackdb_stats_t stats;
+    trackDb.getStats(&stats);
+    Serial.printf("Track: %s, finish line %.0f m away (%lu reads, %lu us)\n",
+                  trackName, dist, (unsigned long)stats.reads, (unsigned long)stats.last_us);
+    if (finishLineSet && lround(finishLineLat * 1e7) == track.lat && lround(finishLineLon * 1e7) == track.lon) {
+        return;
+    }
+
+    finishLineLat = track.lat * 1e-7;
+    finishLineLon = track.lon * 1e-7;
+    finishLineHeading = track.heading;
+    finishLineSet = true;
+    sectors.clearSplits();
+    for (uint8_t i = 0; i < track.splits; i++) {
+        sectors.addSplit(track.split[i].lat, track.split[i].lon, track.split[i].heading);
+    }
+    sectors.store();
+    setFinishGate();
+    saveFinishLine();
+    // A lap saved on this track before wins over the one shipped in the database
+    loadReferenceLap();
+    if (!lapDelta.hasReference() && trackDb.seekReference(track) && lapDelta.load(trackDbFile)) {
+        Serial.printf("Reference lap from the database: %lu ms\n", (unsigned long)lapDelta.referenceMs());
+    }
+
+    currentDisplayMode = DISPLAY_TRACK_FOUND;
+    lastDisplayModeChange = millis();
+}
+
+// Finish line capture, averaging multiple readings
+void serviceFinishLineCapture() {
+    // Check for timeout if GPS isn't updating
+    if (millis() - finishLineCaptureStart >= finishLineCaptureDuration) {
+        if (finishLineReadingsIndex == 0) {
+            // No readings captured at all - GPS problem
+            Serial.println("Finish line capture failed - no GPS updates received");
+            finishLineCapturing = false;
+            currentDisplayMode = DISPLAY_BAD_FIX; // Show BAD FIX message
+            badFixMessageStart = millis(); // Start timer for message
+        } else {
+            // Use whatever readings we got
+            Serial.printf("Finish line capture timeout - using %d readings\n", finishLineReadingsIndex);
+        }
+    }
+
+    if (coordsUpdated) {
+        // Store this reading
+        if (finishLineReadingsIndex < finishLineReadingsCount) {
+            finishLineReadingsLat[finishLineReadingsIndex] = currentLatitude;
+            finishLineReadingsLon[finishLineReadingsIndex] = currentLongitude;
+            finishLineReadingsIndex++;
+            if (currentGroundSpeed > 2.0) {
+                // Averaged as unit vectors so 359 and 1 degrees give 0
+                finishLineHeadingX += sinf(currentHeading * DEG_TO_RAD);
+                finishLineHeadingY += cosf(currentHeading * DEG_TO_RAD);
+            }
+            Serial.printf("Captured reading %d/%d: %.7f, %.7f\n", 
+                         finishLineReadingsIndex, finishLineReadingsCount,
+                         currentLatitude, currentLongitude);
+        }
+    }
+
+    // Check if capture is complete (time or count)
+    if (finishLineReadingsIndex >= finishLineReadingsCount || 
+        (millis() - finishLineCaptureStart >= finishLineCaptureDuration && finishLineReadingsIndex > 0)) {
+        // Calculate average position
+        double sumLat = 0.0, sumLon = 0.0;
+        for (int i = 0; i < finishLineReadingsIndex; i++) {
+            sumLat += finishLineReadingsLat[i];
+            sumLon += finishLineReadingsLon[i];
+        }
+        finishLineLat = sumLat / finishLineReadingsIndex;
+        finishLineLon = sumLon / finishLineReadingsIndex;
+        finishLineSet = true;
+        finishLineCapturing = false;
+        // Standing still gives no heading, the gate then orients on the first movement
+        if (finishLineHeadingX != 0.0 || finishLineHeadingY != 0.0) {
+            finishLineHeading = atan2f(finishLineHeadingX, finishLineHeadingY) * RAD_TO_DEG;
+            if (finishLineHeading < 0) finishLineHeading += 360.0;
+        } else {
+            finishLineHeading = NAN;
+        }
+        setFinishGate();
+        saveFinishLine();
+        countdownStartTime = millis(); // Start debugging sequence
+        Serial.printf("Finish line set (averaged %d readings): %.7f, %.7f\n", 
+                     finishLineReadingsIndex, finishLineLat, finishLineLon);
+    }
+}
+
+// Switch between the digit renderer and the text label
+void showDigits(bool digits) {
+    // Hiding or showing an object invalidates it even if nothing changes
+    static int shown = -1;
+    if (shown == digits) {
+        return;
+    }
+    shown = digits;
+    if (digits) {
+        lv_obj_add_flag(number_label, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_clear_flag(digits_label, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_add_flag(digits_label, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_clear_flag(number_label, LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
 // Font switching helper function
 void setDisplayFont(bool useLargeFont) {
     if (useLargeFont) {
         #if LV_FONT_MONTSERRAT_16
-        lv_obj_set_style_text_font(number_label, &lv_font_montserrat_16, 0);
+        hudText.setFont(&lv_font_montserrat_16);
         #elif LV_FONT_MONTSERRAT_14
-        lv_obj_set_style_text_font(number_label, &lv_font_montserrat_14, 0);
+        hudText.setFont(&lv_font_montserrat_14);
         #else
-        lv_obj_set_style_text_font(number_label, LV_FONT_DEFAULT, 0);
+        hudText.setFont(LV_FONT_DEFAULT);
         #endif
     } else {
         #if LV_FONT_MONTSERRAT_12
-        lv_obj_set_style_text_font(number_label, &lv_font_montserrat_12, 0);
+        hudText.setFont(&lv_font_montserrat_12);
         #elif LV_FONT_MONTSERRAT_10
-        lv_obj_set_style_text_font(number_label, &lv_font_montserrat_10, 0);
+        hudText.setFont(&lv_font_montserrat_10);
         #else
-        lv_obj_set_style_text_font(number_label, LV_FONT_DEFAULT, 0);
+        hudText.setFont(LV_FONT_DEFAULT);
         #endif
     }
 }
@@ -507,6 +847,9 @@ void handleLongPress() {
             currentDisplayMode = DISPLAY_LAP_SPEED;
             break;
         case DISPLAY_LAP_SPEED:
+            currentDisplayMode = DISPLAY_LIVE_DELTA;
+            break;
+        case DISPLAY_LIVE_DELTA:
             currentDisplayMode = DISPLAY_RESET;
             break;
         case DISPLAY_RESET:
@@ -530,6 +873,9 @@ void handleLongPress() {
             currentDisplayMode = DISPLAY_LAP_TIMER;
             isLapFlashing = false; // Stop the lap flash sequence
             break;
+        case DISPLAY_SECTOR_DELTA:
+            currentDisplayMode = sectorReturnMode;
+            break;
         default:
             // For any other modes, return to speed
             currentDisplayMode = DISPLAY_SPEED;
@@ -545,8 +891,10 @@ void handleLongPress() {
     Serial.println((int)currentDisplayMode);
     
     // Force display update immediately
+    lvglLock();
     updateDisplayContent();
     updateDisplayContent();
+    lvglUnlock();
     Serial.printf("Long press: %d -> %d\n", previousMode, currentDisplayMode);
 }
 
@@ -569,6 +917,8 @@ void handleDoubleTap() {
                 finishLineCapturing = true;
                 finishLineCaptureStart = millis();
                 finishLineReadingsIndex = 0;
+                finishLineHeadingX = 0.0;
+                finishLineHeadingY = 0.0;
                 Serial.println("Started capturing finish line (averaging 10 readings over 3 seconds)...");
                 currentDisplayMode = DISPLAY_LINE_SAVED; // Show "LINE SET!" while capturing
             } else {
@@ -603,44 +953,82 @@ void handleDoubleTap() {
     }
     
     lastDisplayModeChange = millis();
+    lvglLock();
     updateDisplayContent();
+    lvglUnlock();
 }
 
 // Initialize BLE sequence (called when user long presses in startup mode)
 void initializeBLESequence() {
     Serial.println("User confirmed - starting BLE sequence...");
     
-    // Setup scanner with working parameters
-    lv_label_set_text(number_label, "SETUP");
-    lv_timer_handler();
-    amoled.update();
+    lvglLock();
+    hudText.setText("SETUP");
+    lvglUnlock();
+    
+    // A remembered RaceBox is connected directly, the state machine scans if that fails
+    if (racePeer.preferDirect()) {
+        Serial.printf("Connecting to known RaceBox %s...\n", racePeer.address());
+        doConnect = true;
+        currentState = STATE_CONNECTING;
+        stateChangeTime = millis();
+        return;
+    }
+
+    // Start scanning for RaceBox
+    lvglLock();
+    hudText.setText("SCAN.");
+    lvglUnlock();
+    startRaceBoxScan(0); // Scan indefinitely until we find a device
+}
+
+// Scan for a RaceBox with the working parameters, 0 seconds = until one is found
+void startRaceBoxScan(uint32_t seconds) {
+    static MyAdvertisedDeviceCallbacks scanCallbacks;
     NimBLEScan* pBLEScan = NimBLEDevice::getScan();
-    pBLEScan->setAdvertisedDeviceCallbacks(new MyAdvertisedDeviceCallbacks());
+    pBLEScan->setAdvertisedDeviceCallbacks(&scanCallbacks);
     pBLEScan->setInterval(45);
     pBLEScan->setWindow(15);
     pBLEScan->setActiveScan(true);
-    delay(500); // Brief pause to show setup
-    
-    // Start scanning for RaceBox
-    lv_label_set_text(number_label, "SCAN.");
-    lv_timer_handler();
-    amoled.update();
+
+    racePeer.scanStarted();
     scanStartTime = millis();
-    currentState = STATE_SCANNING; // Move to scanning state
+    currentState = STATE_SCANNING;
     Serial.println("Starting NimBLE scan for RaceBox devices...");
-    pBLEScan->start(0, false); // Scan indefinitely until we find a device
+    pBLEScan->start(seconds, false);
+}
+
+// NVS and NimBLE do not depend on the display, bring them up on core 0 meanwhile
+static SemaphoreHandle_t bringUpDone;
+
+static void bringUpTask(void *arg)
+{
+    int phase = bootPhaseBegin("nvs");
+    sectors.load();             // Before the finish line, which places the split gates
+    loadFinishLine();
+    loadReferenceLap();
+    openTrackDb();
+    racePeer.load();
+    bootPhaseEnd(phase);
+
+    phase = bootPhaseBegin("nimble");
+    NimBLEDevice::init("T-Glass");
+    NimBLEDevice::setMTU(preferredMtu);
+    bootPhaseEnd(phase);
+
+    xSemaphoreGive(bringUpDone);
+    vTaskDelete(NULL);
 }
 
 void setup()
 {
     Serial.begin(115200);
-    delay(800);
-    
-    // Load finish line from EEPROM
-    loadFinishLine();
 
-    // Initialize the AMOLED display
-    bool res = amoled.begin();
+    bringUpDone = xSemaphoreCreateBinary();
+    xTaskCreatePinnedToCore(bringUpTask, "bringup", 8192, NULL, 1, NULL, 0);
+
+    // Initialize the AMOLED display, the motion sensor is not used and keeps loading in the background
+    bool res = amoled.begin(false);
     if (!res)
     {
         while (1)
@@ -654,6 +1042,15 @@ void setup()
     amoled.setRotation(0);
     amoled.setBrightness(255);
 
+    // Only push the dirty areas, a changing digit costs a few hundred bytes instead of a full frame
+    amoled.setFullRefresh(false);
+
+    // Window setup and pixel writes run on core 0, the BLE loop is not held up by the panel
+    amoled.enableCommandQueue();
+
+    // Only render the part of the panel visible through the lens
+    amoled.setViewport(GLASS_VIEWPORT_X, GLASS_VIEWPORT_Y, GLASS_VIEWPORT_WIDTH, GLASS_VIEWPORT_HEIGHT);
+
     // Initialize LVGL helper
     beginLvglHelper(amoled, false);
 
@@ -664,43 +1061,57 @@ void setup()
 
     // Create a label to display status - show INIT immediately
     number_label = lv_label_create(lv_scr_act());
-    lv_label_set_text(number_label, "INIT");
-    lv_obj_set_style_text_color(number_label, lv_color_white(), 0);
+    hudText.attach(number_label);
+    hudText.setText("INIT");
+    hudText.setColor(lv_color_white());
 
     // Use a smaller font for BLE status messages
     #if LV_FONT_MONTSERRAT_20
-    lv_obj_set_style_text_font(number_label, &lv_font_montserrat_20, 0);
+    hudText.setFont(&lv_font_montserrat_20);
     #elif LV_FONT_MONTSERRAT_18
-    lv_obj_set_style_text_font(number_label, &lv_font_montserrat_18, 0);
+    hudText.setFont(&lv_font_montserrat_18);
     #elif LV_FONT_MONTSERRAT_16
-    lv_obj_set_style_text_font(number_label, &lv_font_montserrat_16, 0);
+    hudText.setFont(&lv_font_montserrat_16);
     #elif LV_FONT_MONTSERRAT_14
-    lv_obj_set_style_text_font(number_label, &lv_font_montserrat_14, 0);
+    hudText.setFont(&lv_font_montserrat_14);
     #else
-    lv_obj_set_style_text_font(number_label, LV_FONT_DEFAULT, 0);
+    hudText.setFont(LV_FONT_DEFAULT);
     #endif
 
     // Position the label aligned with the lens
-    lv_obj_align(number_label, LV_ALIGN_CENTER, -25, 55);
+    lv_obj_align(number_label, LV_ALIGN_CENTER, -25, -29);
+
+    // Fixed width digits for speed and lap time, same large font as setDisplayFont
+    #if LV_FONT_MONTSERRAT_16
+    digits_label = lv_number_label_create(lv_scr_act(), &lv_font_montserrat_16, 8);
+    #else
+    digits_label = lv_number_label_create(lv_scr_act(), LV_FONT_DEFAULT, 8);
+    #endif
+    hudDigits.attach(digits_label);
+    hudDigits.setColor(lv_color_white());
+    lv_obj_align(digits_label, LV_ALIGN_CENTER, -25, -29);
+    showDigits(false);
     
     // Update display to show INIT status
     lv_timer_handler();
     amoled.update();
-    delay(500); // Brief pause to show INIT
 
-    // Initialize BLE (using working example.cpp pattern)
-    lv_label_set_text(number_label, "BLE");
+    // Wait for NimBLE, started in bringUpTask
+    hudText.setText("BLE");
     lv_timer_handler();
     amoled.update();
     Serial.println("Initializing NimBLE...");
-    NimBLEDevice::init("T-Glass");
-    delay(500); // Brief pause to show BLE init
+    xSemaphoreTake(bringUpDone, portMAX_DELAY);
     
     // PAUSE HERE - Show "START?" and wait for long press before continuing
-    lv_label_set_text(number_label, "START?");
+    hudText.setText("START?");
     lv_timer_handler();
     amoled.update();
     Serial.println("Display ready - Long press to start BLE connection sequence");
+    printBootTimeline();
+
+    // From here on LVGL renders in its own task, loop() only touches it under lvglLock()
+    beginLvglTask(1);
     
     // Don't proceed with BLE setup until user confirms
     // The rest will happen in the loop() when they long press
@@ -711,9 +1122,11 @@ void loop()
     // Get current time for all timing operations
     unsigned long currentTime = millis();
     
-    // Update the display
+    // Update the sensors, LVGL renders in its own task
     amoled.update();
-    lv_timer_handler();
+
+    // Every fix received since the last pass, in order
+    processTelemetry();
 
     // Check for button press (boot button on T-Glass) - long press vs quick double tap
     static bool lastButtonState = HIGH;
@@ -795,6 +1208,8 @@ void loop()
             lapInProgress = true;
             lapStartTime = currentGpsTime;
             lapStartMillis = millis();
+            sectors.startLap(currentGpsTime, false);
+            lapDelta.startLap(false);
             Serial.println("GO! - Starting lap timer immediately");
         }
     }
@@ -804,6 +1219,7 @@ void loop()
         currentDisplayMode != DISPLAY_SPEED && 
         currentDisplayMode != DISPLAY_LAP_FLASH &&
         currentDisplayMode != DISPLAY_LAP_DELTA &&
+        currentDisplayMode != DISPLAY_SECTOR_DELTA &&
         currentDisplayMode != DISPLAY_LINE_SAVED &&
         currentDisplayMode != DISPLAY_COUNTDOWN_3 &&
         currentDisplayMode != DISPLAY_COUNTDOWN_2 &&
@@ -813,6 +1229,7 @@ void loop()
         currentDisplayMode != DISPLAY_LAP_TIMER && // Lap timer stays active
         currentDisplayMode != DISPLAY_LAP_DEBUG && // Lap debug stays active
         currentDisplayMode != DISPLAY_LAP_SPEED && // Lap speed stays active
+        currentDisplayMode != DISPLAY_LIVE_DELTA && // Live delta stays active
         currentDisplayMode != DISPLAY_RESET && // Reset menu stays active
         currentDisplayMode != DISPLAY_RESET_CONFIRM && // Reset confirmation stays active
         countdownStartTime == 0 &&
@@ -821,6 +1238,11 @@ void loop()
         Serial.println("Auto-returning to speed display");
     }
     
+    // Sector delta timeout, back to whatever it interrupted
+    if (currentDisplayMode == DISPLAY_SECTOR_DELTA && currentTime - sectorFlashStart > sectorFlashDuration) {
+        currentDisplayMode = sectorReturnMode;
+    }
+    
     // Handle lap flash timeout and transition to delta
     if (isLapFlashing && currentTime - lapFlashStart > lapFlashDuration) {
         if (currentDisplayMode == DISPLAY_LAP_FLASH) {
@@ -835,6 +1257,9 @@ void loop()
         }
     }
 
+    // The display updates below change LVGL objects
+    lvglLock();
+
     // Check if it's time to update the status
     if (currentTime - lastUpdate >= updateInterval) {
         updateConnectionStatus();
@@ -853,11 +1278,56 @@ void loop()
     if (currentState == STATE_CONNECTED && 
         (currentDisplayMode == DISPLAY_LAP_TIMER || 
          currentDisplayMode == DISPLAY_LAP_DEBUG || 
-         currentDisplayMode == DISPLAY_LAP_SPEED) &&
+         currentDisplayMode == DISPLAY_LAP_SPEED ||
+         currentDisplayMode == DISPLAY_SECTOR_DELTA ||
+         currentDisplayMode == DISPLAY_LIVE_DELTA) &&
         currentTime - lastLapTimerUpdate >= lapTimerUpdateInterval) {
         updateDisplayContent();
         lastLapTimerUpdate = currentTime;
     }
+    lvglUnlock();
+
+    // Frame statistics on demand: 'p' prints CSV, 'b' sends binary, 'r' resets.
+    // 'c' starts/stops a capture, 'x' replays it at 1x, 'f' at 10x, 'X' as fast as possible,
+    // 'u' prints the UBX framer and telemetry queue counters, 'l' the reconnect and link statistics,
+    // 'g' adds a split gate here, 'G' clears them, 's' prints the sector times, 'd' the live delta,
+    // 't' the track found in the database
+    if (Serial.available()) {
+        switch (Serial.read()) {
+        case 'p': dumpLvglPerf(Serial); break;
+        case 'b': dumpLvglPerf(Serial, true); break;
+        case 'r': resetLvglPerf(); break;
+        case 'c': toggleCapture(); break;
+        case 'x': startReplay(1); break;
+        case 'f': startReplay(10); break;
+        case 'X': startReplay(0); break;
+        case 'u': printUbxStats(); break;
+        case 'g': addSplitGate(); break;
+        case 'G':
+            sectors.clearSplits();
+            sectors.store();
+            Serial.println("Split gates cleared");
+            break;
+        case 's': sectors.printStats(Serial); break;
+        case 'd': lapDelta.printStats(Serial); break;
+        case 't': {
+            trackdb_stats_t stats;
+            trackDb.getStats(&stats);
+            Serial.printf("Track: %s, database %lu tracks, %lu lookups, last %lu reads in %lu us\n",
+                          trackName[0] ? trackName : "none", (unsigned long)trackDb.count(),
+                          (unsigned long)stats.lookups, (unsigned long)stats.reads, (unsigned long)stats.last_us);
+            break;
+        }
+        case 'l':
+            racePeer.printStats(Serial);
+            readLinkParams();
+            linkStats.printStats(Serial);
+            break;
+        default: break;
+        }
+    }
+    serviceReplay();
+    checkLinkParams();
 
     // Handle BLE connection state machine
     handleBLEStateMachine();
@@ -873,20 +1343,29 @@ void updateDisplayContent() {
         return; // Only update content when connected (except for RESET)
     }
     
-    char displayText[32];  // Increased buffer size
+    char displayText[32] = "";  // Increased buffer size, empty for the screens without text
     bool useLargeFont = true;
+    bool useDigits = false;
+    const char *speedSuffix = NULL;     // Speed is shown with setNumber, no formatting when unchanged
     
     switch (currentDisplayMode) {
         case DISPLAY_SPEED:
             if (gpsStable) {
+                static bool firstSpeed = true;
+                if (firstSpeed) {
+                    firstSpeed = false;
+                    bootPhaseMark("first speed");
+                    printBootTimeline();
+                }
                 // Show speed with lap status indicator (removed coordinate indicator)
                 if (wasNearFinishLine && lapInProgress) {
-                    snprintf(displayText, sizeof(displayText), "%.1f*", currentSpeed); // * means near line, lap active
+                    speedSuffix = "*"; // * means near line, lap active
                 } else if (wasNearFinishLine) {
-                    snprintf(displayText, sizeof(displayText), "%.1f+", currentSpeed); // + means near line  
+                    speedSuffix = "+"; // + means near line
                 } else {
-                    snprintf(displayText, sizeof(displayText), "%.1f", currentSpeed);
+                    speedSuffix = "";
                 }
+                useDigits = true;
             } else {
                 // Animate FIXING with dots
                 static unsigned long lastFixingAnimation = 0;
@@ -936,6 +1415,11 @@ void updateDisplayContent() {
             useLargeFont = false;
             break;
             
+        case DISPLAY_TRACK_FOUND:
+            snprintf(displayText, sizeof(displayText), "TRACK\n%s", trackName);
+            useLargeFont = false;
+            break;
+            
         case DISPLAY_BAD_FIX:
             snprintf(displayText, sizeof(displayText), "BAD FIX");
             useLargeFont = false;
@@ -979,7 +1463,9 @@ void updateDisplayContent() {
             if (storedSet && (storedLat != 0.0 || storedLon != 0.0) && 
                 currentLatitude != 0.0 && currentLongitude != 0.0) {
                 // Calculate and show distance to finish line
-                double dist = calculateDistance(currentLatitude, currentLongitude, storedLat, storedLon);
+                TrackFrame stored;
+                stored.set((int32_t)lround(storedLat * 1e7), (int32_t)lround(storedLon * 1e7));
+                float dist = enuLength(stored.project(currentLatE7, currentLonE7));
                 snprintf(displayText, sizeof(displayText), "D:%.1fm C:%lu", dist, coordsUpdateCounter);
             } else {
                 snprintf(displayText, sizeof(displayText), "E:NONE C:%lu", coordsUpdateCounter);
@@ -1034,12 +1520,11 @@ void updateDisplayContent() {
         case DISPLAY_DISTANCE_FROM_START: {
             // Distance from start point (finish line)
             if (finishLineSet && currentLatitude != 0.0 && currentLongitude != 0.0) {
-                double distance = calculateDistance(currentLatitude, currentLongitude, 
-                                                  finishLineLat, finishLineLon);
+                float distance = enuLength(currentPos);  // The finish line is the origin
                 if (distance < 1000) {
                     snprintf(displayText, sizeof(displayText), "%.1fm", distance);
                 } else {
-                    snprintf(displayText, sizeof(displayText), "%.2fkm", distance / 1000.0);
+                    snprintf(displayText, sizeof(displayText), "%.2fkm", distance / 1000.0f);
                 }
             } else if (!finishLineSet) {
                 snprintf(displayText, sizeof(displayText), "NO START");
@@ -1068,6 +1553,7 @@ void updateDisplayContent() {
                 snprintf(displayText, sizeof(displayText), "0:00.00");
             }
             useLargeFont = true;
+            useDigits = true;
             break;
         }
         
@@ -1078,14 +1564,13 @@ void updateDisplayContent() {
             
             // Get distance to finish line
             if (finishLineSet && currentLatitude != 0.0 && currentLongitude != 0.0) {
-                double distance = calculateDistance(currentLatitude, currentLongitude, 
-                                                  finishLineLat, finishLineLon);
+                float distance = enuLength(currentPos);  // The finish line is the origin
                 if (distance < 10) {
                     snprintf(distStr, sizeof(distStr), "%.1fm%s", distance, gpsAccuracyPoor ? "*" : "");
                 } else if (distance < 1000) {
                     snprintf(distStr, sizeof(distStr), "%.0fm%s", distance, gpsAccuracyPoor ? "*" : "");
                 } else {
-                    snprintf(distStr, sizeof(distStr), "%.1fkm%s", distance / 1000.0, gpsAccuracyPoor ? "*" : "");
+                    snprintf(distStr, sizeof(distStr), "%.1fkm%s", distance / 1000.0f, gpsAccuracyPoor ? "*" : "");
                 }
             } else if (!finishLineSet) {
                 snprintf(distStr, sizeof(distStr), "NO START");
@@ -1140,10 +1625,38 @@ void updateDisplayContent() {
             break;
         }
         
-        case DISPLAY_BEST_LAP:
-            snprintf(displayText, sizeof(displayText), "%s", bestLapTime.c_str());
+        case DISPLAY_LIVE_DELTA: {
+            // Live delta to the reference lap on line 1, lap timer on line 2
+            char lapStr[16] = "0:00.0";
+            if (lapInProgress && currentGpsTime > 0 && lapStartTime > 0) {
+                unsigned long currentLapMs = gpsTimeDiff(currentGpsTime, lapStartTime);
+                snprintf(lapStr, sizeof(lapStr), "%lu:%02lu.%lu", currentLapMs / 60000,
+                         (currentLapMs % 60000) / 1000, (currentLapMs % 1000) / 100);
+            }
+            if (!lapDelta.hasReference()) {
+                snprintf(displayText, sizeof(displayText), "NO REF\n%s", lapStr);
+            } else if (lapInProgress && lapDelta.valid()) {
+                snprintf(displayText, sizeof(displayText), "%+.2f\n%s", lapDelta.delta() / 1000.0f, lapStr);
+            } else {
+                snprintf(displayText, sizeof(displayText), "--.--\n%s", lapStr);
+            }
+            useLargeFont = false;
+            break;
+        }
+        
+        case DISPLAY_BEST_LAP: {
+            // Theoretical best (sum of best sectors) underneath once every sector has one
+            uint32_t tb = sectors.splits() ? sectors.theoreticalBest() : 0;
+            if (tb) {
+                snprintf(displayText, sizeof(displayText), "%s\nTB %lu:%02lu.%lu", bestLapTime.c_str(),
+                         (unsigned long)(tb / 60000), (unsigned long)((tb % 60000) / 1000),
+                         (unsigned long)((tb % 1000) / 100));
+            } else {
+                snprintf(displayText, sizeof(displayText), "%s", bestLapTime.c_str());
+            }
             useLargeFont = false; // Lap times are longer
             break;
+        }
             
         case DISPLAY_LAP_FLASH:
             // Show "LAP TIME:" on line 1, actual time on line 2
@@ -1157,6 +1670,21 @@ void updateDisplayContent() {
             useLargeFont = false;
             break;
             
+        case DISPLAY_SECTOR_DELTA: {
+            // Sector and its delta on line 1, sector time on line 2
+            uint32_t sectorMs = sectors.lastTime();
+            if (sectors.lastHasDelta()) {
+                snprintf(displayText, sizeof(displayText), "S%u %+.2f\n%lu.%02lu", sectors.lastIndex() + 1,
+                         sectors.lastDelta() / 1000.0f, (unsigned long)(sectorMs / 1000),
+                         (unsigned long)((sectorMs % 1000) / 10));
+            } else {
+                snprintf(displayText, sizeof(displayText), "S%u\n%lu.%02lu", sectors.lastIndex() + 1,
+                         (unsigned long)(sectorMs / 1000), (unsigned long)((sectorMs % 1000) / 10));
+            }
+            useLargeFont = false;
+            break;
+        }
+            
         case DISPLAY_RESET:
             snprintf(displayText, sizeof(displayText), "RESET");
             useLargeFont = true;
@@ -1181,19 +1709,27 @@ void updateDisplayContent() {
         case DISPLAY_COUNTDOWN_2:
         case DISPLAY_COUNTDOWN_1:
             // Bright red for countdown numbers
-            lv_obj_set_style_text_color(number_label, lv_color_make(255, 0, 0), 0);
+            hudText.setColor(lv_color_make(255, 0, 0));
             break;
         case DISPLAY_COUNTDOWN_GO:
             // Bright green for GO!
-            lv_obj_set_style_text_color(number_label, lv_color_make(0, 255, 0), 0);
+            hudText.setColor(lv_color_make(0, 255, 0));
             break;
         case DISPLAY_BAD_FIX:
             // Bright red for BAD FIX
-            lv_obj_set_style_text_color(number_label, lv_color_make(255, 0, 0), 0);
+            hudText.setColor(lv_color_make(255, 0, 0));
+            break;
+        case DISPLAY_LIVE_DELTA:
+            // Green while ahead of the reference, red while behind
+            if (lapInProgress && lapDelta.valid()) {
+                hudText.setColor(lapDelta.delta() <= 0 ? lv_color_make(0, 255, 0) : lv_color_make(255, 0, 0));
+            } else {
+                hudText.setColor(lv_color_white());
+            }
             break;
         default:
             // White for all other modes
-            lv_obj_set_style_text_color(number_label, lv_color_white(), 0);
+            hudText.setColor(lv_color_white());
             break;
     }
     
@@ -1206,13 +1742,28 @@ void updateDisplayContent() {
         }
     }
     
-    lv_label_set_text(number_label, displayText);
+    if (useDigits) {
+        // Always white, unchanged digits are not redrawn
+        if (speedSuffix) {
+            hudDigits.setNumber(lroundf(currentSpeed * 10), 1, speedSuffix);
+        } else {
+            hudDigits.setText(displayText);
+        }
+        showDigits(true);
+        return;
+    }
+    showDigits(false);
+    hudText.setText(displayText);
 }
 
 void updateConnectionStatus() {
+    // updateDisplayContent picks the label itself when connected
+    if (currentState != STATE_CONNECTED) {
+        showDigits(false);
+    }
     switch (currentState) {
         case STATE_STARTUP:
-            lv_label_set_text(number_label, "START?");
+            hudText.setText("START?");
             break;
         case STATE_SCANNING:
             {
@@ -1232,97 +1783,30 @@ void updateConnectionStatus() {
                 } else {
                     snprintf(scanText, sizeof(scanText), "SCAN...");
                 }
-                lv_label_set_text(number_label, scanText);
+                hudText.setText(scanText);
             }
             break;
         case STATE_DEVICE_FOUND:
-            lv_label_set_text(number_label, "FIND");
+            hudText.setText("FIND");
             break;
         case STATE_CONNECTING:
-            lv_label_set_text(number_label, "CONN");
+            hudText.setText("CONN");
             break;
         case STATE_CONNECTED:
             if (speedUpdated) {
-                // Handle finish line capture (averaging multiple readings)
+                // Fixes are processed as they arrive, this only catches a capture
+                // timing out after the GPS went quiet
                 if (finishLineCapturing) {
-                    // Check for timeout if GPS isn't updating
-                    if (millis() - finishLineCaptureStart >= finishLineCaptureDuration) {
-                        if (finishLineReadingsIndex == 0) {
-                            // No readings captured at all - GPS problem
-                            Serial.println("Finish line capture failed - no GPS updates received");
-                            finishLineCapturing = false;
-                            currentDisplayMode = DISPLAY_BAD_FIX; // Show BAD FIX message
-                            badFixMessageStart = millis(); // Start timer for message
-                        } else {
-                            // Use whatever readings we got
-                            Serial.printf("Finish line capture timeout - using %d readings\n", finishLineReadingsIndex);
-                        }
-                    }
-                    
-                    if (coordsUpdated) {
-                        // Store this reading
-                        if (finishLineReadingsIndex < finishLineReadingsCount) {
-                            finishLineReadingsLat[finishLineReadingsIndex] = currentLatitude;
-                            finishLineReadingsLon[finishLineReadingsIndex] = currentLongitude;
-                            finishLineReadingsIndex++;
-                            Serial.printf("Captured reading %d/%d: %.7f, %.7f\n", 
-                                         finishLineReadingsIndex, finishLineReadingsCount,
-                                         currentLatitude, currentLongitude);
-                        }
-                    }
-                    
-                    // Check if capture is complete (time or count)
-                    if (finishLineReadingsIndex >= finishLineReadingsCount || 
-                        (millis() - finishLineCaptureStart >= finishLineCaptureDuration && finishLineReadingsIndex > 0)) {
-                        // Calculate average position
-                        double sumLat = 0.0, sumLon = 0.0;
-                        for (int i = 0; i < finishLineReadingsIndex; i++) {
-                            sumLat += finishLineReadingsLat[i];
-                            sumLon += finishLineReadingsLon[i];
-                        }
-                        finishLineLat = sumLat / finishLineReadingsIndex;
-                        finishLineLon = sumLon / finishLineReadingsIndex;
-                        finishLineSet = true;
-                        finishLineCapturing = false;
-                        saveFinishLine();
-                        countdownStartTime = millis(); // Start debugging sequence
-                        Serial.printf("Finish line set (averaged %d readings): %.7f, %.7f\n", 
-                                     finishLineReadingsIndex, finishLineLat, finishLineLon);
-                    }
-                }
-                
-                // Check for lap crossing when coordinates are updated (FIRST, before resetting flags)
-                if (coordsUpdated && !finishLineCapturing) {
-                    coordsUpdateCounter++; // Track coordinate updates for debugging
-                    checkLapCrossing();
-                }
-                
-                // Debug output for coordinates (only print occasionally to avoid spam)
-                static uint32_t lastCoordPrint = 0;
-                static uint32_t lastGpsUpdate = 0;
-                if (coordsUpdated) {
-                    lastGpsUpdate = millis();
-                    if (millis() - lastCoordPrint > 5000) { // Print every 5 seconds
-                        Serial.printf("GPS: iTOW=%lu ms, Lat=%.7f, Lon=%.7f, Speed=%.1f km/h, Acc=%.2fm\n", 
-                                      currentGpsTime, currentLatitude, currentLongitude, currentSpeed,
-                                      horizontalAccuracy / 1000.0);
-                        lastCoordPrint = millis();
-                    }
+                    serviceFinishLineCapture();
                 }
                 
                 // Warn if GPS updates have stopped
                 static uint32_t lastGpsWarning = 0;
-                if (millis() - lastGpsUpdate > 10000 && millis() - lastGpsWarning > 10000) {
+                if (millis() - lastCoordsUpdateTime > 10000 && millis() - lastGpsWarning > 10000) {
                     Serial.println("WARNING: No GPS coordinate updates for 10+ seconds");
                     lastGpsWarning = millis();
                 }
                 
-                // Always reset coordinate flags after processing
-                if (coordsUpdated) {
-                    coordsUpdated = false;
-                    gpsTimeUpdated = false;
-                }
-                
                 // Check if GPS has become unstable due to timeout
                 if (gpsStable && millis() - lastGpsUpdateTime > 5000) {
                     Serial.println("GPS became unstable - no updates for 5+ seconds");
@@ -1335,13 +1819,13 @@ void updateConnectionStatus() {
             updateDisplayContent();
             break;
         case STATE_NO_DEVICE:
-            lv_label_set_text(number_label, "NONE");
+            hudText.setText("NONE");
             break;
         case STATE_SCAN_TIMEOUT:
-            lv_label_set_text(number_label, "TOUT");
+            hudText.setText("TOUT");
             break;
         case STATE_ERROR:
-            lv_label_set_text(number_label, "FAIL");
+            hudText.setText("FAIL");
             break;
     }
 }
@@ -1349,6 +1833,18 @@ void updateConnectionStatus() {
 void handleBLEStateMachine() {
     unsigned long currentTime = millis();
     
+    // Time a drop until the RaceBox is back, replay ending is not a drop
+    static ConnectionState lastState = STATE_STARTUP;
+    static unsigned long retryAt = 0;
+    if (currentState != lastState) {
+        if (lastState == STATE_CONNECTED && currentState != STATE_STARTUP) {
+            racePeer.markDrop(currentTime);
+        } else if (currentState == STATE_CONNECTED) {
+            racePeer.markConnected(currentTime);
+        }
+        lastState = currentState;
+    }
+    
     switch (currentState) {
         case STATE_SCANNING:
             if (doConnect) {
@@ -1372,7 +1868,12 @@ void handleBLEStateMachine() {
         case STATE_CONNECTING:
             if (!connected && doConnect) {
                 Serial.println("Attempting connection...");
-                if (connectToRaceBox()) {
+                bool direct = myRaceBox == nullptr;
+                bool ok = connectToRaceBox();
+                if (direct) {
+                    racePeer.directResult(ok);
+                }
+                if (ok) {
                     Serial.println("Connection successful!");
                     currentState = STATE_CONNECTED;
                 } else {
@@ -1396,222 +1897,243 @@ void handleBLEStateMachine() {
         case STATE_SCAN_TIMEOUT:
         case STATE_NO_DEVICE:
         case STATE_ERROR:
-            // Wait a bit then restart scanning
-            if (currentTime - lastUpdate > 5000) { // Wait 5 seconds
-                Serial.printf("Restarting scan after: %s\n", errorReason.c_str());
-                currentState = STATE_SCANNING;
+            // Back off before retrying, the first retry after a drop comes almost at once
+            if (retryAt == 0) {
+                retryAt = currentTime + racePeer.nextBackoffMs();
+            }
+            if ((long)(currentTime - retryAt) >= 0) {
+                Serial.printf("Retrying after: %s\n", errorReason.c_str());
+                retryAt = 0;
                 doConnect = false;
                 connected = false;
                 myRaceBox = nullptr;
                 errorReason = "";
-                scanStartTime = currentTime;
-                Serial.println("Starting new BLE scan...");
                 
-                // Setup scan with proper parameters
-                NimBLEScan* pBLEScan = NimBLEDevice::getScan();
-                pBLEScan->setAdvertisedDeviceCallbacks(new MyAdvertisedDeviceCallbacks());
-                pBLEScan->setInterval(45);
-                pBLEScan->setWindow(15);
-                pBLEScan->setActiveScan(true);
-                pBLEScan->start(10, false); // Scan for 10 seconds
+                if (racePeer.preferDirect()) {
+                    // Straight to the remembered RaceBox, no scan
+                    doConnect = true;
+                    currentState = STATE_CONNECTING;
+                    stateChangeTime = currentTime;
+                } else {
+                    startRaceBoxScan(10); // Scan for 10 seconds
+                }
             }
             break;
     }
 }
 
-// UBX parsing function
-void parseUBXPacket(uint8_t* data, size_t length) {
-    // Look for UBX sync bytes (0xB5 0x62)
-    for (size_t i = 0; i <= length - 8; i++) {
-        if (data[i] == 0xB5 && data[i + 1] == 0x62) {
-            // Found UBX header
-            if (i + 7 < length) {
-                uint8_t msgClass = data[i + 2];
-                uint8_t msgId = data[i + 3];
-                uint16_t payloadLen = (data[i + 5] << 8) | data[i + 4];
-                
-                // Check for RaceBox Data Message (Class 0xFF, ID 0x01) - this is the correct message type!
-                if (msgClass == 0xFF && msgId == 0x01 && i + 6 + payloadLen <= length) {
-                    dataPacketsReceived++;
-                    
-                    // GPS Time of Week (iTOW) is at offset 8 in RaceBox payload (4 bytes, little endian, ms)
-                    size_t itowOffset = i + 6 + 8;
-                    if (itowOffset + 3 < length) {
-                        currentGpsTime = (uint32_t)(data[itowOffset] | 
-                                                    (data[itowOffset + 1] << 8) |
-                                                    (data[itowOffset + 2] << 16) |
-                                                    (data[itowOffset + 3] << 24));
-                        gpsTimeUpdated = true;
-                    }
-                    
-                    // Parse GPS status fields (matching example.cpp)
-                    size_t fixStatusOffset = i + 6 + 26;        // GPS fix status
-                    size_t fixStatusFlagsOffset = i + 6 + 27;   // GPS fix flags 
-                    size_t numSVsOffset = i + 6 + 29;           // Number of satellites
-                    
-                    if (fixStatusOffset < length) {
-                        lastFixStatus = data[fixStatusOffset];
-                    }
-                    if (fixStatusFlagsOffset < length) {
-                        lastFixStatusFlags = data[fixStatusFlagsOffset];
-                        hasGpsFix = (lastFixStatusFlags & 0x01) != 0;
-                    }
-                    if (numSVsOffset < length) {
-                        numSatellites = data[numSVsOffset];
-                    }
-                    
-                    if (hasGpsFix) {
-                        gpsFxCount++;
-                    } else {
-                        gpsFxCount = 0;
-                    }
-                    
-                    // Longitude is at offset 24 in RaceBox payload (4 bytes, little endian, scaled by 1e-7)
-                    size_t lonOffset = i + 6 + 24;
-                    if (lonOffset + 3 < length) {
-                        int32_t lonRaw = (int32_t)(data[lonOffset] | 
-                                                   (data[lonOffset + 1] << 8) |
-                                                   (data[lonOffset + 2] << 16) |
-                                                   (data[lonOffset + 3] << 24));
-                        currentLongitude = lonRaw * 1e-7;  // Convert to degrees
-                    }
-                    
-                    // Latitude is at offset 28 in RaceBox payload (4 bytes, little endian, scaled by 1e-7)
-                    size_t latOffset = i + 6 + 28;
-                    if (latOffset + 3 < length) {
-                        int32_t latRaw = (int32_t)(data[latOffset] | 
-                                                   (data[latOffset + 1] << 8) |
-                                                   (data[latOffset + 2] << 16) |
-                                                   (data[latOffset + 3] << 24));
-                        currentLatitude = latRaw * 1e-7;  // Convert to degrees
-                    }
-                    
-                    // Horizontal accuracy is at offset 40 in RaceBox payload (4 bytes, mm)
-                    size_t hAccOffset = i + 6 + 40;
-                    if (hAccOffset + 3 < length) {
-                        horizontalAccuracy = (uint32_t)(data[hAccOffset] | 
-                                                       (data[hAccOffset + 1] << 8) |
-                                                       (data[hAccOffset + 2] << 16) |
-                                                       (data[hAccOffset + 3] << 24));
-                        
-                        // Only mark coordinates as updated if accuracy is good (<500mm = 50cm)
-                        // This prevents using poor GPS readings that cause drift
-                        if (horizontalAccuracy < 500) {
-                            coordsUpdated = true;  // Mark that we have new, accurate coordinate data
-                            gpsAccuracyPoor = false; // Good accuracy
-                        } else {
-                            coordsUpdated = false; // Skip this reading - accuracy too poor
-                            gpsAccuracyPoor = true; // Mark accuracy as poor for display
-                            static unsigned long lastAccWarn = 0;
-                            if (millis() - lastAccWarn > 2000) {  // More frequent warnings for debugging
-                                Serial.printf("WARNING: Poor GPS accuracy: %lu mm (%.1f m) - skipping\n", 
-                                            horizontalAccuracy, horizontalAccuracy / 1000.0);
-                                lastAccWarn = millis();
-                            }
-                        }
-                        
-                        // Always log accuracy for debugging GPS issues
-                        static unsigned long lastAccLog = 0;
-                        if (millis() - lastAccLog > 3000) {
-                            Serial.printf("GPS Accuracy: %.1fm (using: %s)\n", 
-                                        horizontalAccuracy / 1000.0, 
-                                        coordsUpdated ? "YES" : "NO");
-                            lastAccLog = millis();
-                        }
-                    }
-                    
-                    // Speed is at offset 48 in RaceBox payload (4 bytes, little endian, mm/s, SIGNED)
-                    size_t speedOffset = i + 6 + 48;
-                    if (speedOffset + 3 < length) {
-                        // Parse as SIGNED 32-bit integer (matching Python's signed=True)
-                        int32_t speedMmPerSec = (int32_t)(data[speedOffset] | 
-                                                         (data[speedOffset + 1] << 8) |
-                                                         (data[speedOffset + 2] << 16) |
-                                                         (data[speedOffset + 3] << 24));
-                        
-                        // Convert mm/s to km/h (divide by 1000 for m/s, multiply by 3.6 for km/h)
-                        float rawSpeed = (speedMmPerSec / 1000.0) * 3.6;
-                        
-                        // Apply speed stabilization
-                        if (rawSpeed < speedThreshold) {
-                            // Below threshold, gradually move to 0
-                            stabilizedSpeed = stabilizedSpeed * (1.0 - speedSmoothingFactor);
-                            if (stabilizedSpeed < 0.1) stabilizedSpeed = 0.0;
-                        } else {
-                            // Above threshold, smooth the reading
-                            stabilizedSpeed = stabilizedSpeed * (1.0 - speedSmoothingFactor) + 
-                                              rawSpeed * speedSmoothingFactor;
-                        }
-                        
-                        currentSpeed = stabilizedSpeed;
-                        speedUpdated = true;
-                        
-                        // Update GPS stability tracking
-                        lastGpsUpdateTime = millis();
-                        
-                        // GPS is considered stable after receiving good data for 2+ seconds
-                        if (hasGpsFix && gpsFxCount > 3) {
-                            if (!gpsStable) {
-                                if (gpsStableTime == 0) {
-                                    gpsStableTime = millis(); // First good reading
-                                } else if (millis() - gpsStableTime > 2000) {
-                                    gpsStable = true; // Stable after 2 seconds
-                                    Serial.println("GPS stabilized - switching to speed display");
-                                }
-                            }
-                        } else {
-                            // Lost good GPS fix
-                            gpsStable = false;
-                            gpsStableTime = 0;
-                        }
-                    }
-                    
-                    // Parse RaceBox battery information at offset 67 (official spec)
-                    size_t batteryOffset = i + 6 + 67;
-                    if (batteryOffset < length) {
-                        uint8_t batteryByte = data[batteryOffset];
-                        
-                        // Check if this looks like Mini/Mini S (percentage) or Micro (voltage)
-                        if ((batteryByte & 0x7F) <= 100) {
-                            // RaceBox Mini/Mini S format:
-                            // MSB = charging status, lower 7 bits = battery percentage
-                            raceBoxBattery = batteryByte & 0x7F;  // Extract percentage (0-100)
-                            bool isCharging = (batteryByte & 0x80) != 0;  // Extract charging bit
-                            
-                            // Debug output occasionally
-                            static unsigned long lastBatteryDebug = 0;
-                            if (millis() - lastBatteryDebug > 10000) {
-                                Serial.printf("RB Battery: %d%% %s\\n", 
-                                              raceBoxBattery, isCharging ? "(charging)" : "");
-                                lastBatteryDebug = millis();
-                            }
-                        } else {
-                            // RaceBox Micro format: input voltage * 10
-                            // Convert to voltage and then estimate percentage (rough approximation)
-                            float voltage = batteryByte / 10.0;
-                            // Rough battery estimation: 11.1V = 0%, 12.6V = 100%
-                            int estimatedPercent = (int)((voltage - 11.1) / (12.6 - 11.1) * 100);
-                            if (estimatedPercent < 0) estimatedPercent = 0;
-                            if (estimatedPercent > 100) estimatedPercent = 100;
-                            raceBoxBattery = estimatedPercent;
-                            
-                            // Debug output occasionally  
-                            static unsigned long lastVoltageDebug = 0;
-                            if (millis() - lastVoltageDebug > 10000) {
-                                Serial.printf("RB Voltage: %.1fV (est. %d%%)\\n", voltage, estimatedPercent);
-                                lastVoltageDebug = millis();
-                            }
-                        }
-                    }
-                } else {
-                    // Show other message types for debugging
-                    Serial.printf("Other UBX message: Class=0x%02X, ID=0x%02X\n", msgClass, msgId);
-                }
+// RaceBox data message decoding, frames come from the UBX framer with a valid checksum.
+// This runs in the NimBLE task, so it only decodes and queues, processFix() does the rest.
+static void handleUbxFrame(uint8_t msgClass, uint8_t msgId, const uint8_t *payload, uint16_t len, void *user) {
+    if (msgClass != RACEBOX_MSG_CLASS || msgId != RACEBOX_MSG_ID) {
+        // Show other message types for debugging
+        Serial.printf("Other UBX message: Class=0x%02X, ID=0x%02X\n", msgClass, msgId);
+        return;
+    }
+
+    gnss_fix_t fix;
+    if (!rbxDecode(payload, len, HUD_FIX_FIELDS, &fix.rbx)) {
+        Serial.printf("Short RaceBox message: %u bytes\n", len);
+        return;
+    }
+    fix.rx_us = micros();
+
+    // A full ring drops the fix, counted in telemetryQueue.overflows()
+    telemetryQueue.push(fix);
+}
+
+// Apply one fix to the GPS state, then run the finish line capture and lap check on it
+static void processFix(const gnss_fix_t &fix) {
+    dataPacketsReceived++;
+    
+    currentGpsTime = fix.rbx.itow_ms;
+    gpsTimeUpdated = true;
+    
+    // GPS status fields
+    lastFixStatus = fix.rbx.fix_status;
+    lastFixStatusFlags = fix.rbx.fix_flags;
+    hasGpsFix = (lastFixStatusFlags & 0x01) != 0;
+    numSatellites = fix.rbx.num_sv;
+    
+    if (hasGpsFix) {
+        gpsFxCount++;
+        racePeer.markFirstFix(millis());
+    } else {
+        gpsFxCount = 0;
+    }
+    
+    currentLongitude = fix.rbx.lon * 1e-7;  // Convert to degrees
+    currentLatitude = fix.rbx.lat * 1e-7;   // Convert to degrees
+    currentLatE7 = fix.rbx.lat;
+    currentLonE7 = fix.rbx.lon;
+    if (trackFrame.valid()) {
+        currentPos = trackFrame.project(currentLatE7, currentLonE7);  // Once per fix
+    }
+    
+    horizontalAccuracy = fix.rbx.h_acc_mm;
+    
+    // Only mark coordinates as updated if accuracy is good (<500mm = 50cm)
+    // This prevents using poor GPS readings that cause drift
+    if (horizontalAccuracy < 500) {
+        coordsUpdated = true;  // Mark that we have new, accurate coordinate data
+        gpsAccuracyPoor = false; // Good accuracy
+    } else {
+        coordsUpdated = false; // Skip this reading - accuracy too poor
+        gpsAccuracyPoor = true; // Mark accuracy as poor for display
+        static unsigned long lastAccWarn = 0;
+        if (millis() - lastAccWarn > 2000) {  // More frequent warnings for debugging
+            Serial.printf("WARNING: Poor GPS accuracy: %lu mm (%.1f m) - skipping\n", 
+                        (unsigned long)horizontalAccuracy, horizontalAccuracy / 1000.0);
+            lastAccWarn = millis();
+        }
+    }
+    
+    // Always log accuracy for debugging GPS issues
+    static unsigned long lastAccLog = 0;
+    if (millis() - lastAccLog > 3000) {
+        Serial.printf("GPS Accuracy: %.1fm (using: %s)\n", 
+                    horizontalAccuracy / 1000.0, 
+                    coordsUpdated ? "YES" : "NO");
+        lastAccLog = millis();
+    }
+    
+    int32_t speedMmPerSec = fix.rbx.speed_mm_s;
+    currentGroundSpeed = speedMmPerSec / 1000.0;
+    currentHeading = fix.rbx.heading * 1e-5;
+    
+    // Convert mm/s to km/h (divide by 1000 for m/s, multiply by 3.6 for km/h)
+    float rawSpeed = (speedMmPerSec / 1000.0) * 3.6;
+    
+    // Apply speed stabilization
+    if (rawSpeed < speedThreshold) {
+        // Below threshold, gradually move to 0
+        stabilizedSpeed = stabilizedSpeed * (1.0 - speedSmoothingFactor);
+        if (stabilizedSpeed < 0.1) stabilizedSpeed = 0.0;
+    } else {
+        // Above threshold, smooth the reading
+        stabilizedSpeed = stabilizedSpeed * (1.0 - speedSmoothingFactor) + 
+                          rawSpeed * speedSmoothingFactor;
+    }
+    
+    currentSpeed = stabilizedSpeed;
+    speedUpdated = true;
+    
+    // Update GPS stability tracking
+    lastGpsUpdateTime = millis();
+    
+    // GPS is considered stable after receiving good data for 2+ seconds
+    if (hasGpsFix && gpsFxCount > 3) {
+        if (!gpsStable) {
+            if (gpsStableTime == 0) {
+                gpsStableTime = millis(); // First good reading
+            } else if (millis() - gpsStableTime > 2000) {
+                gpsStable = true; // Stable after 2 seconds
+                Serial.println("GPS stabilized - switching to speed display");
             }
         }
+    } else {
+        // Lost good GPS fix
+        gpsStable = false;
+        gpsStableTime = 0;
+    }
+    
+    // RaceBox battery information
+    uint8_t batteryByte = fix.rbx.battery;
+    
+    // Check if this looks like Mini/Mini S (percentage) or Micro (voltage)
+    if ((batteryByte & 0x7F) <= 100) {
+        // RaceBox Mini/Mini S format:
+        // MSB = charging status, lower 7 bits = battery percentage
+        raceBoxBattery = batteryByte & 0x7F;  // Extract percentage (0-100)
+        bool isCharging = (batteryByte & 0x80) != 0;  // Extract charging bit
+        
+        // Debug output occasionally
+        static unsigned long lastBatteryDebug = 0;
+        if (millis() - lastBatteryDebug > 10000) {
+            Serial.printf("RB Battery: %d%% %s\\n", 
+                          raceBoxBattery, isCharging ? "(charging)" : "");
+            lastBatteryDebug = millis();
+        }
+    } else {
+        // RaceBox Micro format: input voltage * 10
+        // Convert to voltage and then estimate percentage (rough approximation)
+        float voltage = batteryByte / 10.0;
+        // Rough battery estimation: 11.1V = 0%, 12.6V = 100%
+        int estimatedPercent = (int)((voltage - 11.1) / (12.6 - 11.1) * 100);
+        if (estimatedPercent < 0) estimatedPercent = 0;
+        if (estimatedPercent > 100) estimatedPercent = 100;
+        raceBoxBattery = estimatedPercent;
+        
+        // Debug output occasionally  
+        static unsigned long lastVoltageDebug = 0;
+        if (millis() - lastVoltageDebug > 10000) {
+            Serial.printf("RB Voltage: %.1fV (est. %d%%)\\n", voltage, estimatedPercent);
+            lastVoltageDebug = millis();
+        }
+    }
+
+    // Every fix counts for the finish line and lap timing, not just one per status update
+    if (finishLineCapturing) {
+        serviceFinishLineCapture();
+    }
+    if (coordsUpdated && hasGpsFix && !trackLookupDone && !finishLineCapturing) {
+        detectTrack();
+    }
+    if (coordsUpdated && !finishLineCapturing) {
+        coordsUpdateCounter++; // Track coordinate updates for debugging
+        checkLapCrossing(fix.rbx);
+    }
+    
+    // Debug output for coordinates (only print occasionally to avoid spam)
+    static uint32_t lastCoordPrint = 0;
+    if (coordsUpdated) {
+        lastCoordsUpdateTime = millis();
+        if (millis() - lastCoordPrint > 5000) { // Print every 5 seconds
+            Serial.printf("GPS: iTOW=%lu ms, Lat=%.7f, Lon=%.7f, Speed=%.1f km/h, Acc=%.2fm\n", 
+                          (unsigned long)currentGpsTime, currentLatitude, currentLongitude, currentSpeed,
+                          horizontalAccuracy / 1000.0);
+            lastCoordPrint = millis();
+        }
+    }
+    
+    // The flags describe this fix only
+    coordsUpdated = false;
+    gpsTimeUpdated = false;
+}
+
+// Drain the fixes queued by the BLE callback, oldest first
+void processTelemetry() {
+    gnss_fix_t fix;
+    while (telemetryQueue.pop(fix)) {
+        uint32_t latencyUs = micros() - fix.rx_us;
+        if (latencyUs > maxFixLatencyUs) {
+            maxFixLatencyUs = latencyUs;
+        }
+        processFix(fix);
+        fixesProcessed++;
     }
 }
 
+// Notifications carry a byte stream, frames may be split across them or share one
+UbxFramer ubxFramer(handleUbxFrame);
+
+void parseUBXPacket(uint8_t* data, size_t length) {
+    ubxFramer.push(data, length);
+}
+
+void printUbxStats() {
+    ubx_framer_stats_t stats;
+    ubxFramer.getStats(&stats);
+    Serial.printf("UBX: frames=%lu crc=%lu oversize=%lu resyncs=%lu skipped=%lu bytes=%llu rate=%lu B/s\n",
+                  (unsigned long)stats.frames, (unsigned long)stats.crc_errors, (unsigned long)stats.oversize,
+                  (unsigned long)stats.resyncs, (unsigned long)stats.skipped_bytes, (unsigned long long)stats.bytes,
+                  (unsigned long)stats.bytes_per_s);
+    Serial.printf("Fixes: processed=%lu queued=%lu high=%lu/%lu overflows=%lu latency max=%lu us\n",
+                  (unsigned long)fixesProcessed, (unsigned long)telemetryQueue.size(),
+                  (unsigned long)telemetryQueue.highWater(), (unsigned long)telemetryQueue.capacity(),
+                  (unsigned long)telemetryQueue.overflows(), (unsigned long)maxFixLatencyUs);
+}
+
 // Notification callback with UBX parsing
 static void notifyCallback(
   NimBLERemoteCharacteristic* pBLERemoteCharacteristic,
@@ -1619,37 +2141,120 @@ static void notifyCallback(
   size_t length,
   bool isNotify) {
     
+    linkStats.onNotify(micros(), length);
+    capture.record(pData, length);
+
     // Parse UBX data for speed
     parseUBXPacket(pData, length);
 }
 
-// Connection function based on working example.cpp
+// Replay stages, the same work live notifications cause
+static void replayLapStage() {
+    processTelemetry();
+}
+
+static void replayDisplayStage() {
+    lvglLock();
+    updateDisplayContent();
+    lvglUnlock();
+}
+
+// Start or stop recording the RaceBox notifications to flash
+void toggleCapture() {
+    if (capture.active()) {
+        capture.stop();
+        captureFile.close();
+        rbx_capture_stats_t stats;
+        capture.getStats(&stats);
+        Serial.printf("Capture stopped: %lu records, %lu bytes, %lu dropped\n",
+                      (unsigned long)stats.records, (unsigned long)stats.bytes, (unsigned long)stats.dropped);
+        return;
+    }
+    if (!LittleFS.begin(true)) {
+        Serial.println("LittleFS mount failed");
+        return;
+    }
+    captureFile = LittleFS.open(CAPTURE_FILE, FILE_WRITE);
+    if (!captureFile || !capture.start(captureFile)) {
+        Serial.println("Capture start failed");
+        return;
+    }
+    Serial.println("Capturing to " CAPTURE_FILE);
+}
+
+// Play the captured session through parse -> lap -> display, speed 0 = as fast as possible
+void startReplay(float speed) {
+    if (connected || replay.active() || capture.active()) {
+        Serial.println("Replay needs an idle RaceBox connection");
+        return;
+    }
+    if (!LittleFS.begin(true) || !(replayFile = LittleFS.open(CAPTURE_FILE, FILE_READ))) {
+        Serial.println("No capture file");
+        return;
+    }
+    static const rbx_pipeline_t pipeline = {parseUBXPacket, replayLapStage, replayDisplayStage};
+    if (!replay.start(replayFile, pipeline, speed)) {
+        Serial.println("Not a capture file");
+        replayFile.close();
+        return;
+    }
+    // The HUD only shows data while connected
+    ubxFramer.reset();
+    telemetryQueue.clear();
+    finishGate.restart();
+    sectors.restart();
+    connected = true;
+    currentState = STATE_CONNECTED;
+    Serial.printf("Replaying " CAPTURE_FILE " at %s\n", speed > 0 ? String(speed, 1).c_str() : "max speed");
+}
+
+void serviceReplay() {
+    capture.service();
+    if (replay.active() && !replay.service()) {
+        replayFile.close();
+        replay.printReport(Serial);
+        connected = false;
+        currentState = STATE_STARTUP;
+    }
+}
+
+// Connection function based on working example.cpp. Connects to the scanned device in
+// myRaceBox, or directly to the remembered RaceBox when there is none.
 bool connectToRaceBox() {
   Serial.println("Starting connection to RaceBox...");
   
-  // Create a NimBLE client
-  NimBLEClient* pClient = NimBLEDevice::createClient();
-  if (pClient == nullptr) {
-    Serial.println("Failed to create BLE client");
-    return false;
+  // One client for the RaceBox, created on first use
+  if (raceBoxClient == nullptr) {
+    raceBoxClient = NimBLEDevice::createClient();
+    if (raceBoxClient == nullptr) {
+      Serial.println("Failed to create BLE client");
+      return false;
+    }
+    Serial.println("Created BLE client");
+    
+    // Set client callbacks - use static instance to avoid heap issues
+    static MyClientCallback clientCallback;
+    raceBoxClient->setClientCallbacks(&clientCallback);
   }
-  Serial.println("Created BLE client");
+  NimBLEClient* pClient = raceBoxClient;
   
-  // Set client callbacks - use static instance to avoid heap issues
-  static MyClientCallback clientCallback;
-  pClient->setClientCallbacks(&clientCallback);
+  // Keep the discovered services when it is the same RaceBox as last time
+  NimBLEAddress target = myRaceBox ? myRaceBox->getAddress()
+                                   : NimBLEAddress(std::string(racePeer.address()), racePeer.addressType());
+  bool samePeer = pClient->getPeerAddress() == target;
   
-  // Connect to the remote BLE Server using the device reference (not address string)
-  Serial.println("Attempting BLE connection...");
-  pClient->setConnectTimeout(10); // 10 second timeout
-  if (!pClient->connect(myRaceBox)) {  // This is the key difference!
-    Serial.println("Failed to connect using device reference");
-    NimBLEDevice::deleteClient(pClient);
+  Serial.printf("Attempting BLE connection to %s%s...\n", target.toString().c_str(), myRaceBox ? "" : " (direct)");
+  pClient->setConnectTimeout(myRaceBox ? 10 : directConnectTimeout);
+  pClient->setConnectionParams(connIntervalMin, connIntervalMax, connLatency, connTimeout);
+  bool ok = myRaceBox ? pClient->connect(myRaceBox, !samePeer)  // Device reference from the scan
+                      : pClient->connect(target, !samePeer);
+  if (!ok) {
+    Serial.println("Failed to connect");
     return false;
   }
   Serial.println("Connected to server");
   
-  // Obtain a reference to the service
+  // Obtain a reference to the service, only discovered if not kept from last time
   NimBLERemoteService* pRemoteService = pClient->getService(serviceUUID);
   if (pRemoteService == nullptr) {
     Serial.print("Failed to find service UUID: ");
@@ -1669,13 +2274,22 @@ bool connectToRaceBox() {
   }
   Serial.println("Found characteristic");
   
-  // Read the value of the characteristic
-  if(pRemoteCharacteristic->canRead()) {
+  if (racePeer.charHandle() != 0 && pRemoteCharacteristic->getHandle() != racePeer.charHandle()) {
+    Serial.printf("RaceBox TX handle changed: %u -> %u\n", racePeer.charHandle(), pRemoteCharacteristic->getHandle());
+  }
+  
+  // Read the value of the characteristic, once per RaceBox, it costs a round trip
+  if(!samePeer && pRemoteCharacteristic->canRead()) {
     std::string value = pRemoteCharacteristic->readValue();
     Serial.print("Characteristic value: ");
     Serial.println(value.c_str());
   }
   
+  // The notify callback owns the framer and the producer side of the queue once
+  // subscribed, drop what the last connection left before it can run
+  ubxFramer.reset();
+  telemetryQueue.clear();
+  
   // Turn on notifications (using newer API)
   if(pRemoteCharacteristic->canNotify()) {
     if(!pRemoteCharacteristic->subscribe(true, notifyCallback)) {
@@ -1685,7 +2299,44 @@ bool connectToRaceBox() {
     }
   }
   
+  // Ask again now the stream is running, the RaceBox may have moved the connection on its own
+  pClient->updateConnParams(connIntervalMin, connIntervalMax, connLatency, connTimeout);
+  linkStats.reset();
+  linkCheckTime = millis() + 1000;
+  
+  racePeer.store(target.toString().c_str(), target.getType(), pRemoteCharacteristic->getHandle());
+  
+  finishGate.restart();
+  sectors.restart();
   connected = true;
   Serial.println("Successfully connected and setup notifications");
   return true;
 }
+
+// Record the MTU and connection parameters the RaceBox actually granted
+void readLinkParams() {
+  if (raceBoxClient == nullptr || !raceBoxClient->isConnected()) {
+    return;
+  }
+  NimBLEConnInfo info = raceBoxClient->getConnInfo();
+  linkStats.setParams(raceBoxClient->getMTU(), info.getConnInterval(), info.getConnLatency(), info.getConnTimeout());
+}
+
+// Once the parameter update had time to complete, check what was granted
+void checkLinkParams() {
+  if (linkCheckTime == 0 || (long)(millis() - linkCheckTime) < 0) {
+    return;
+  }
+  linkCheckTime = 0;
+  readLinkParams();
+  ble_link_stats_t stats;
+  linkStats.getStats(&stats);
+  if (stats.mtu < minUsableMtu) {
+    Serial.printf("WARNING: MTU %u, RaceBox frames will be split across notifications\n", stats.mtu);
+  }
+  if (stats.interval > connIntervalMax || stats.latency > connLatency) {
+    Serial.printf("WARNING: connection interval %.2f ms latency %u, fixes will arrive batched\n",
+                  stats.interval * 1.25, stats.latency);
+  }
+  linkStats.printStats(Serial);
+}
@@ -0,0 +1,95 @@
+/*
+ * Telemetry hand-off between the BLE callback and the main loop.
+ *
+ * The NimBLE task decodes each RaceBox data message into a gnss_fix_t and pushes it,
+ * loop() pops the fixes in order and runs every one through speed, lap and statistics
+ * processing. The ring is single producer / single consumer: one index is written by
+ * each side, so no lock is needed and the callback never waits on loop(). A full ring
+ * drops the new fix and counts it, it never overwrites one the consumer may be reading.
+ */
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include "RaceBoxData.h"
+
+#define TELEMETRY_QUEUE_SIZE    128     // Fixes, about 5 s at 25 Hz, 11 KB
+
+// One RaceBox data message, only the groups in rbx.mask are filled in
+typedef struct {
+    uint32_t rx_us;             // micros() when the frame was decoded
+    rbx_fix_t rbx;
+} gnss_fix_t;
+
+// N must be a power of two, one slot is not wasted since the indices run free
+template <typename T, uint32_t N>
+class SpscQueue {
+    static_assert(N && (N & (N - 1)) == 0, "SpscQueue size must be a power of two");
+
+public:
+    // start: first index, the tests run the indices across their wrap with it
+    SpscQueue(uint32_t start = 0) : _head(start), _tail(start), _overflows(0), _high_water(0) {}
+
+    // Producer side only
+    bool push(const T &item) {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        uint32_t used = head - _tail.load(std::memory_order_acquire);
+        if (used >= N) {
+            _overflows.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        _items[head & (N - 1)] = item;
+        _head.store(head + 1, std::memory_order_release);
+        if (used + 1 > _high_water.load(std::memory_order_relaxed)) {
+            _high_water.store(used + 1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    // Consumer side only
+    bool pop(T &item) {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = _items[tail & (N - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side only, drops everything queued, e.g. on a new connection
+    void clear() {
+        _tail.store(_head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    uint32_t size() const {
+        return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+    }
+
+    uint32_t capacity() const {
+        return N;
+    }
+
+    uint32_t overflows() const {
+        return _overflows.load(std::memory_order_relaxed);
+    }
+
+    // Deepest the ring has been since the last resetStats()
+    uint32_t highWater() const {
+        return _high_water.load(std::memory_order_relaxed);
+    }
+
+    void resetStats() {
+        _overflows.store(0, std::memory_order_relaxed);
+        _high_water.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    T _items[N];
+    std::atomic<uint32_t> _head;        // Written by the producer
+    std::atomic<uint32_t> _tail;        // Written by the consumer
+    std::atomic<uint32_t> _overflows;
+    std::atomic<uint32_t> _high_water;
+};
+
+typedef SpscQueue<gnss_fix_t, TELEMETRY_QUEUE_SIZE> TelemetryQueue;
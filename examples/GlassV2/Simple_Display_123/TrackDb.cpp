@@ -0,0 +1,134 @@
+/*
+ * Track database on flash, see TrackDb.h
+ */
+#include "TrackDb.h"
+
+#define TRACKDB_CELL_M      (TRACKDB_CELL_E7 * 0.0111319491f)   // Cell height in metres
+
+TrackDb::TrackDb() : _file(nullptr), _tracks_offset(0) {
+    memset(&_header, 0, sizeof(_header));
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+bool TrackDb::open(fs::File &file) {
+    close();
+    if (!file.seek(0) || file.read((uint8_t *)&_header, sizeof(_header)) != sizeof(_header) ||
+        memcmp(_header.magic, TRACKDB_MAGIC, 4) != 0 || _header.cell_e7 != TRACKDB_CELL_E7) {
+        memset(&_header, 0, sizeof(_header));
+        return false;
+    }
+    _tracks_offset = sizeof(_header) + _header.cells * sizeof(trackdb_cell_t);
+    if (file.size() < _tracks_offset + _header.tracks * sizeof(trackdb_track_t)) {
+        memset(&_header, 0, sizeof(_header));
+        return false;
+    }
+    _file = &file;
+    return true;
+}
+
+void TrackDb::close() {
+    _file = nullptr;
+    memset(&_header, 0, sizeof(_header));
+}
+
+bool TrackDb::readCell(uint32_t i, trackdb_cell_t *cell) {
+    _stats.reads++;
+    return _file->seek(sizeof(_header) + i * sizeof(trackdb_cell_t)) &&
+           _file->read((uint8_t *)cell, sizeof(*cell)) == sizeof(*cell);
+}
+
+bool TrackDb::readTrack(uint32_t i, trackdb_track_t *track) {
+    _stats.reads++;
+    return _file->seek(_tracks_offset + i * sizeof(trackdb_track_t)) &&
+           _file->read((uint8_t *)track, sizeof(*track)) == sizeof(*track);
+}
+
+// First cell with a key >= key, the cell count if there is none
+uint32_t TrackDb::lowerBound(uint32_t key) {
+    uint32_t lo = 0;
+    uint32_t hi = _header.cells;
+    trackdb_cell_t cell;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (!readCell(mid, &cell)) {
+            return _header.cells;
+        }
+        if (cell.key < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+bool TrackDb::findNearest(int32_t lat, int32_t lon, trackdb_track_t *track, float *distM) {
+    if (!_file || _header.tracks == 0) {
+        return false;
+    }
+    uint32_t start = micros();
+    _stats.lookups++;
+    _stats.reads = 0;
+
+    // Grid rows and columns the match range can reach, columns narrow towards the poles
+    TrackFrame here;
+    here.set(lat, lon);
+    float latDeg = lat * 1e-7f;
+    float cosLat = cosf((fabsf(latDeg) + TRACKDB_CELL_E7 * 1e-7f) * GEO_DEG_TO_RAD);
+    int32_t dr = (int32_t)ceilf(TRACKDB_MATCH_RANGE_M / TRACKDB_CELL_M);
+    int32_t dc = cosLat > 0.01f ? (int32_t)ceilf(TRACKDB_MATCH_RANGE_M / (TRACKDB_CELL_M * cosLat)) : TRACKDB_COLUMNS;
+    uint32_t key = trackDbKey(lat, lon);
+    int32_t row0 = key / TRACKDB_COLUMNS;
+    int32_t col0 = key % TRACKDB_COLUMNS;
+    int32_t rows = 1800000000L / TRACKDB_CELL_E7 + 1;
+    int32_t colLo = col0 - dc < 0 ? 0 : col0 - dc;
+    int32_t colHi = col0 + dc >= TRACKDB_COLUMNS ? TRACKDB_COLUMNS - 1 : col0 + dc;
+
+    bool found = false;
+    float best = TRACKDB_MATCH_RANGE_M;
+    trackdb_track_t t;
+    for (int32_t row = row0 - dr; row <= row0 + dr; row++) {
+        if (row < 0 || row >= rows) {
+            continue;
+        }
+        uint32_t keyLo = row * TRACKDB_COLUMNS + colLo;
+        uint32_t keyHi = row * TRACKDB_COLUMNS + colHi;
+        trackdb_cell_t cell;
+        for (uint32_t i = lowerBound(keyLo); i < _header.cells; i++) {
+            if (!readCell(i, &cell) || cell.key > keyHi) {
+                break;
+            }
+            for (uint32_t j = cell.first; j < cell.first + cell.count && j < _header.tracks; j++) {
+                if (!readTrack(j, &t)) {
+                    break;
+                }
+                float d = enuLength(here.project(t.lat, t.lon));
+                if (d <= best) {
+                    best = d;
+                    *track = t;
+                    found = true;
+                }
+            }
+        }
+    }
+    if (found) {
+        track->name[TRACKDB_NAME_LEN - 1] = '\0';
+        if (track->splits > SECTOR_MAX_SPLITS) {
+            track->splits = SECTOR_MAX_SPLITS;
+        }
+        *distM = best;
+    }
+    _stats.last_us = micros() - start;
+    return found;
+}
+
+bool TrackDb::seekReference(const trackdb_track_t &track) {
+    if (!_file || track.ref_offset == 0 || track.ref_offset + track.ref_len > _file->size()) {
+        return false;
+    }
+    return _file->seek(track.ref_offset);
+}
+
+void TrackDb::getStats(trackdb_stats_t *stats) {
+    *stats = _stats;
+}
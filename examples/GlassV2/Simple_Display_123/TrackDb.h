@@ -0,0 +1,105 @@
+/*
+ * Track database on flash, built on the host by tools/build_trackdb.py.
+ *
+ * File: a header, a grid index, then fixed size track records.
+ *   trackdb_header_t   "TDB1", track and cell counts, grid cell size
+ *   trackdb_cell_t     one per occupied grid cell, sorted by key
+ *   trackdb_track_t    sorted by cell key, so every cell is a run of records
+ *   reference laps     optional, LapDelta files ("DLT1") the records point into
+ *
+ * The grid splits the globe into TRACKDB_CELL_E7 sized cells keyed row * columns +
+ * column, a track lives in the cell of its finish line. findNearest() binary searches
+ * the cell table once per grid row within TRACKDB_MATCH_RANGE_M of the fix and only
+ * reads the records of those cells, O(log n) file reads for n tracks. Tracks across
+ * the 180th meridian are not matched from the other side.
+ */
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+#include "Geodesy.h"
+#include "Sectors.h"
+
+#define TRACKDB_MAGIC               "TDB1"
+#define TRACKDB_CELL_E7             1000000     // 0.1 degree grid, about 11 km
+#define TRACKDB_COLUMNS             (3600000000L / TRACKDB_CELL_E7)
+#define TRACKDB_MATCH_RANGE_M       5000.0f     // A finish line further away is another venue
+#define TRACKDB_NAME_LEN            24
+
+typedef struct __attribute__((packed)) {
+    char magic[4];
+    uint32_t tracks;
+    uint32_t cells;
+    int32_t cell_e7;                // Grid cell size the file was built with
+} trackdb_header_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t key;
+    uint32_t first;                 // Index of the first track record
+    uint32_t count;
+} trackdb_cell_t;
+
+typedef struct __attribute__((packed)) {
+    char name[TRACKDB_NAME_LEN];    // NUL padded
+    int32_t lat;                    // Finish line centre, degrees * 1e7
+    int32_t lon;
+    float heading;                  // Direction of travel through it, NAN if unknown
+    uint8_t splits;
+    uint8_t reserved[3];
+    split_gate_t split[SECTOR_MAX_SPLITS];
+    uint32_t ref_offset;            // Reference lap in this file, 0 if there is none
+    uint32_t ref_len;
+} trackdb_track_t;
+
+static_assert(sizeof(trackdb_header_t) == 16, "trackdb_header_t layout");
+static_assert(sizeof(trackdb_cell_t) == 12, "trackdb_cell_t layout");
+static_assert(sizeof(trackdb_track_t) == 132, "trackdb_track_t layout");
+
+typedef struct {
+    uint32_t lookups;
+    uint32_t reads;                 // Cell and track records read by the last lookup
+    uint32_t last_us;
+} trackdb_stats_t;
+
+// Grid key of a position, see TRACKDB_CELL_E7
+static inline uint32_t trackDbKey(int32_t lat, int32_t lon) {
+    uint32_t row = (uint32_t)((int64_t)lat + 900000000) / TRACKDB_CELL_E7;
+    uint32_t col = (uint32_t)((int64_t)lon + 1800000000) / TRACKDB_CELL_E7;
+    if (col >= TRACKDB_COLUMNS) {
+        col = TRACKDB_COLUMNS - 1;  // +180 degrees exactly
+    }
+    return row * TRACKDB_COLUMNS + col;
+}
+
+class TrackDb {
+public:
+    TrackDb();
+
+    // file stays open until close(), false if it is not a track database
+    bool open(fs::File &file);
+    void close();
+    bool isOpen() {
+        return _file != nullptr;
+    }
+    uint32_t count() {
+        return _header.tracks;
+    }
+
+    // Nearest finish line within TRACKDB_MATCH_RANGE_M of the position
+    bool findNearest(int32_t lat, int32_t lon, trackdb_track_t *track, float *distM);
+
+    // Position the file at the track's reference lap for LapDelta::load()
+    bool seekReference(const trackdb_track_t &track);
+
+    void getStats(trackdb_stats_t *stats);
+
+private:
+    bool readCell(uint32_t i, trackdb_cell_t *cell);
+    bool readTrack(uint32_t i, trackdb_track_t *track);
+    uint32_t lowerBound(uint32_t key);
+
+    fs::File *_file;
+    trackdb_header_t _header;
+    uint32_t _tracks_offset;
+    trackdb_stats_t _stats;
+};
@@ -0,0 +1,150 @@
+/*
+ * Streaming UBX framer, see UbxFramer.h
+ */
+#include "UbxFramer.h"
+
+UbxFramer::UbxFramer(ubx_frame_cb_t cb, void *user) : _cb(cb), _user(user) {
+    reset();
+    resetStats();
+}
+
+void UbxFramer::setCallback(ubx_frame_cb_t cb, void *user) {
+    _cb = cb;
+    _user = user;
+}
+
+void UbxFramer::reset() {
+    _pos = 0;
+    _frame_len = 0;
+    _skipping = false;
+}
+
+void UbxFramer::resetStats() {
+    memset(&_stats, 0, sizeof(_stats));
+    _rate_start_ms = millis();
+    _rate_bytes = 0;
+}
+
+void UbxFramer::getStats(ubx_framer_stats_t *stats) {
+    *stats = _stats;
+}
+
+// Appends b to the candidate frame in _buf
+UbxFramer::Result UbxFramer::step(uint8_t b) {
+    if (_pos == 0) {
+        if (b != UBX_SYNC1) {
+            lostSync();
+            _stats.skipped_bytes++;
+            return NEED_MORE;
+        }
+        _buf[_pos++] = b;
+        return NEED_MORE;
+    }
+
+    _buf[_pos++] = b;
+    if (_pos == 2) {
+        return b == UBX_SYNC2 ? NEED_MORE : REJECT;
+    }
+    if (_pos == UBX_HEADER_SIZE) {
+        uint16_t payload_len = _buf[4] | (_buf[5] << 8);
+        if (payload_len > UBX_MAX_PAYLOAD) {
+            _stats.oversize++;
+            return REJECT;
+        }
+        _frame_len = UBX_HEADER_SIZE + payload_len + 2;
+        return NEED_MORE;
+    }
+    if (!_frame_len || _pos < _frame_len) {
+        return NEED_MORE;
+    }
+
+    // 8-bit Fletcher over class, id, length and payload
+    uint8_t ck_a = 0, ck_b = 0;
+    for (uint16_t i = 2; i < _frame_len - 2; i++) {
+        ck_a += _buf[i];
+        ck_b += ck_a;
+    }
+    if (ck_a != _buf[_frame_len - 2] || ck_b != _buf[_frame_len - 1]) {
+        _stats.crc_errors++;
+        return REJECT;
+    }
+    return FRAME;
+}
+
+// Garbage and rejected candidates count once, until a valid frame is back in sync
+void UbxFramer::lostSync() {
+    if (!_skipping) {
+        _skipping = true;
+        _stats.resyncs++;
+    }
+}
+
+void UbxFramer::deliver() {
+    _stats.frames++;
+    _delivered++;
+    if (_cb) {
+        _cb(_buf[2], _buf[3], _buf + UBX_HEADER_SIZE, _frame_len - UBX_HEADER_SIZE - 2, _user);
+    }
+    reset();
+}
+
+// The candidate in _buf[0, _pos) was rejected. Anything after its first byte may still
+// hold the start of a real frame, so those bytes are fed again. step() writes at _pos,
+// which never passes the read position, so this works in place
+void UbxFramer::rescan() {
+    for (;;) {
+        uint16_t len = _pos;
+        uint16_t start = 1;
+        while (start < len && _buf[start] != UBX_SYNC1) {
+            start++;
+        }
+        lostSync();
+        _stats.skipped_bytes += start;
+        _pos = 0;
+        _frame_len = 0;
+        if (start == len) {
+            return;
+        }
+
+        uint16_t i = start;
+        bool rejected = false;
+        for (; i < len; i++) {
+            Result r = step(_buf[i]);
+            if (r == FRAME) {
+                deliver();
+            } else if (r == REJECT) {
+                // Keep the bytes not fed yet behind the new rejected candidate
+                uint16_t rest = len - i - 1;
+                memmove(_buf + _pos, _buf + i + 1, rest);
+                _pos += rest;
+                rejected = true;
+                break;
+            }
+        }
+        if (!rejected) {
+            return;
+        }
+    }
+}
+
+uint32_t UbxFramer::push(const uint8_t *data, size_t len) {
+    _delivered = 0;
+    for (size_t i = 0; i < len; i++) {
+        Result r = step(data[i]);
+        if (r == FRAME) {
+            deliver();
+        } else if (r == REJECT) {
+            rescan();
+        }
+    }
+
+    _stats.bytes += len;
+    _rate_bytes += len;
+    uint32_t now = millis();
+    if (now - _rate_start_ms >= 1000) {
+        _stats.bytes_per_s = (uint64_t)_rate_bytes * 1000 / (now - _rate_start_ms);
+        _rate_start_ms = now;
+        _rate_bytes = 0;
+    }
+    return _delivered;
+}
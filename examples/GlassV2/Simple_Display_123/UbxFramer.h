@@ -0,0 +1,69 @@
+/*
+ * Streaming UBX framer.
+ *
+ * Bytes go in as they arrive, in pieces of any size, and only complete frames with a
+ * valid Fletcher checksum come out. A frame may be split across BLE notifications and a
+ * notification may hold several frames. After garbage, a bad checksum or an impossible
+ * length the framer resyncs on the next 0xB5 0x62, including one inside the rejected
+ * bytes. No allocation, the frame buffer is part of the object.
+ */
+#pragma once
+
+#include <Arduino.h>
+
+#define UBX_SYNC1               0xB5
+#define UBX_SYNC2               0x62
+#define UBX_HEADER_SIZE         6       // Sync, class, id, length
+#define UBX_MAX_PAYLOAD         512     // Longer frames are rejected
+
+// payload is only valid during the call
+typedef void (*ubx_frame_cb_t)(uint8_t msgClass, uint8_t msgId, const uint8_t *payload, uint16_t len, void *user);
+
+typedef struct {
+    uint32_t frames;            // Valid frames delivered
+    uint32_t crc_errors;        // Frames dropped on a checksum mismatch
+    uint32_t oversize;          // Headers announcing more than UBX_MAX_PAYLOAD
+    uint32_t resyncs;           // Times sync was lost, once until the next valid frame
+    uint32_t skipped_bytes;     // Bytes that were not part of a valid frame
+    uint64_t bytes;             // All bytes pushed
+    uint32_t bytes_per_s;       // Over the last complete second
+} ubx_framer_stats_t;
+
+class UbxFramer {
+public:
+    UbxFramer(ubx_frame_cb_t cb = nullptr, void *user = nullptr);
+
+    void setCallback(ubx_frame_cb_t cb, void *user = nullptr);
+
+    // Returns the number of frames delivered to the callback
+    uint32_t push(const uint8_t *data, size_t len);
+
+    // Drop a partial frame, e.g. after a reconnect
+    void reset();
+
+    void getStats(ubx_framer_stats_t *stats);
+    void resetStats();
+
+private:
+    enum Result {
+        NEED_MORE,
+        FRAME,
+        REJECT,
+    };
+
+    Result step(uint8_t b);
+    void lostSync();
+    void deliver();
+    void rescan();
+
+    ubx_frame_cb_t _cb;
+    void *_user;
+    uint8_t _buf[UBX_HEADER_SIZE + UBX_MAX_PAYLOAD + 2];
+    uint16_t _pos;
+    uint16_t _frame_len;        // Whole frame including checksum, 0 until the header is in
+    bool _skipping;             // Sync lost, counted in resyncs
+    uint32_t _delivered;
+    uint32_t _rate_start_ms;
+    uint32_t _rate_bytes;
+    ubx_framer_stats_t _stats;
+};
@@ -0,0 +1,182 @@
+#!/usr/bin/env python3
+"""
+Build the track database (tracks.db) Simple_Display_123 looks up at the first fix.
+
+Input is a JSON list of tracks, positions in degrees, headings in degrees from
+north (the direction of travel through the gate, leave out if unknown):
+
+    [
+      {
+        "name": "Home Kart Track",
+        "finish": {"lat": 42.6512345, "lon": 23.3456789, "heading": 87},
+        "splits": [
+          {"lat": 42.6520000, "lon": 23.3470000, "heading": 180},
+          {"lat": 42.6505000, "lon": 23.3462000}
+        ],
+        "reference": "home.lap"
+      }
+    ]
+
+"reference" is optional: a reference lap saved by the glasses (/reference.lap,
+"DLT1"), it must have been driven with the same finish line.
+
+Copy the result to data/tracks.db next to platformio.ini and upload it with
+"pio run -t uploadfs". That rewrites the whole LittleFS partition, captures and
+the saved reference lap included.
+
+    build_trackdb.py tracks.json -o data/tracks.db
+    build_trackdb.py --random 10000 -o bench.db       # synthetic, for benchmarks
+
+The layout matches TrackDb.h.
+"""
+import argparse
+import json
+import math
+import os
+import random
+import struct
+import sys
+
+MAGIC = b"TDB1"
+CELL_E7 = 1000000                   # TRACKDB_CELL_E7
+COLUMNS = 3600000000 // CELL_E7
+NAME_LEN = 24                       # TRACKDB_NAME_LEN
+MAX_SPLITS = 7                      # SECTOR_MAX_SPLITS
+MAX_SPLIT_RANGE_M = 5000.0          # SECTOR_MAX_RANGE_M
+
+HEADER = struct.Struct("<4sIIi")
+CELL = struct.Struct("<III")
+SPLIT = struct.Struct("<iif")
+TRACK = struct.Struct("<%dsiifB3x%dsII" % (NAME_LEN, SPLIT.size * MAX_SPLITS))
+DELTA_HEADER = struct.Struct("<4sIIii")
+
+assert HEADER.size == 16 and CELL.size == 12 and TRACK.size == 132
+
+
+def e7(deg):
+    return int(round(deg * 1e7))
+
+
+def key(lat, lon):
+    row = (lat + 900000000) // CELL_E7
+    col = min((lon + 1800000000) // CELL_E7, COLUMNS - 1)
+    return row * COLUMNS + col
+
+
+def distance_m(lat1, lon1, lat2, lon2):
+    # Only for sanity checks, spherical is plenty
+    p1, p2 = math.radians(lat1 * 1e-7), math.radians(lat2 * 1e-7)
+    dp = p2 - p1
+    dl = math.radians((lon2 - lon1) * 1e-7)
+    a = math.sin(dp / 2) ** 2 + math.cos(p1) * math.cos(p2) * math.sin(dl / 2) ** 2
+    return 2 * 6371000 * math.asin(math.sqrt(a))
+
+
+def heading(obj):
+    h = obj.get("heading")
+    return float("nan") if h is None else float(h) % 360.0
+
+
+def load_reference(path, lat, lon):
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) < DELTA_HEADER.size:
+        raise ValueError("%s: too short" % path)
+    magic, count, lap_ms, olat, olon = DELTA_HEADER.unpack_from(data)
+    if magic != b"DLT1" or len(data) != DELTA_HEADER.size + count * 12:
+        raise ValueError("%s: not a reference lap" % path)
+    if (olat, olon) != (lat, lon):
+        raise ValueError("%s: recorded against another finish line (%.7f, %.7f)" %
+                         (path, olat * 1e-7, olon * 1e-7))
+    return data
+
+
+def parse_track(t, base_dir):
+    name = t["name"].encode("utf-8")[:NAME_LEN - 1]
+    lat, lon = e7(t["finish"]["lat"]), e7(t["finish"]["lon"])
+    if not (-900000000 <= lat <= 900000000 and -1800000000 <= lon <= 1800000000):
+        raise ValueError("%s: finish line out of range" % t["name"])
+    splits = t.get("splits", [])
+    if len(splits) > MAX_SPLITS:
+        raise ValueError("%s: at most %d splits" % (t["name"], MAX_SPLITS))
+    packed = b""
+    for s in splits:
+        slat, slon = e7(s["lat"]), e7(s["lon"])
+        if distance_m(lat, lon, slat, slon) > MAX_SPLIT_RANGE_M:
+            raise ValueError("%s: split gate more than %.0f m from the finish line" %
+                             (t["name"], MAX_SPLIT_RANGE_M))
+        packed += SPLIT.pack(slat, slon, heading(s))
+    ref = None
+    if t.get("reference"):
+        ref = load_reference(os.path.join(base_dir, t["reference"]), lat, lon)
+    return {"name": name, "lat": lat, "lon": lon, "heading": heading(t["finish"]),
+            "splits": len(splits), "split": packed, "ref": ref}
+
+
+def random_tracks(n, seed):
+    # Clustered like real venues, a few hundred regions with tracks close together
+    rng = random.Random(seed)
+    regions = [(rng.uniform(-60, 65), rng.uniform(-179, 179)) for _ in range(max(1, n // 40))]
+    tracks = []
+    for i in range(n):
+        rlat, rlon = rng.choice(regions)
+        lat = rlat + rng.gauss(0, 0.5)
+        lon = (rlon + rng.gauss(0, 0.5) + 180.0) % 360.0 - 180.0
+        tracks.append({"name": ("Track %d" % i).encode(), "lat": e7(lat), "lon": e7(lon),
+                       "heading": rng.uniform(0, 360), "splits": 0, "split": b"", "ref": None})
+    return tracks
+
+
+def build(tracks):
+    tracks.sort(key=lambda t: (key(t["lat"], t["lon"]), t["name"]))
+    cells = []
+    for i, t in enumerate(tracks):
+        k = key(t["lat"], t["lon"])
+        if cells and cells[-1][0] == k:
+            cells[-1][2] += 1
+        else:
+            cells.append([k, i, 1])
+
+    out = bytearray(HEADER.pack(MAGIC, len(tracks), len(cells), CELL_E7))
+    for c in cells:
+        out += CELL.pack(*c)
+    ref_offset = len(out) + len(tracks) * TRACK.size
+    refs = bytearray()
+    for t in tracks:
+        off, length = 0, 0
+        if t["ref"]:
+            off, length = ref_offset + len(refs), len(t["ref"])
+            refs += t["ref"]
+        split = t["split"].ljust(SPLIT.size * MAX_SPLITS, b"\0")
+        out += TRACK.pack(t["name"], t["lat"], t["lon"], t["heading"], t["splits"], split, off, length)
+    out += refs
+    return bytes(out), len(cells)
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Build tracks.db for Simple_Display_123")
+    ap.add_argument("input", nargs="?", help="tracks JSON")
+    ap.add_argument("-o", "--output", default="tracks.db")
+    ap.add_argument("--random", type=int, metavar="N", help="N synthetic tracks instead of an input")
+    ap.add_argument("--seed", type=int, default=1)
+    args = ap.parse_args()
+
+    if args.random:
+        tracks = random_tracks(args.random, args.seed)
+    elif args.input:
+        with open(args.input) as f:
+            tracks = [parse_track(t, os.path.dirname(args.input)) for t in json.load(f)]
+    else:
+        ap.error("an input file or --random is needed")
+
+    data, cells = build(tracks)
+    with open(args.output, "wb") as f:
+        f.write(data)
+    print("%s: %d tracks in %d cells, %d bytes" % (args.output, len(tracks), cells, len(data)))
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except (ValueError, KeyError) as e:
+        sys.exit("error: %s" % e)
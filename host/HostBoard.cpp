@@ -0,0 +1,196 @@
+/*
+ * Board stand-ins of the host runtime: the recording SPI panel IO of HostPanelIO.h and
+ * the buses, pads and interrupts LilyGo_Wristband touches
+ */
+#include "HostPanelIO.h"
+#include "HostRuntime.h"
+#include <esp_lcd_panel_io.h>
+#include <Wire.h>
+#include <SPI.h>
+#include <algorithm>
+
+struct esp_lcd_panel_io_t {
+    esp_lcd_panel_io_spi_config_t config;
+    uint32_t inflight;              // Color transfers queued and not done yet
+    uint64_t bus_free_us;           // When the last of them is out
+    SemaphoreHandle_t drained;      // Given when inflight drops to 0
+};
+
+// A color transfer on the bus. The bytes are read when it completes, like the DMA
+// reads them while it runs, so a buffer reused too early shows in the log.
+typedef struct {
+    esp_lcd_panel_io_t *io;
+    size_t log_index;
+    const uint8_t *data;
+    size_t size;
+    uint64_t done_us;
+} bus_transfer_t;
+
+#define BUS_QUEUE_DEPTH     10
+
+static std::vector<host_spi_transfer_t> spi_log;
+static std::vector<esp_lcd_panel_io_t *> panel_ios;
+static QueueHandle_t bus_queue;
+
+TwoWire Wire;
+SPIClass SPI;
+
+// Completes the queued color transfers in order, each after its time on the bus
+static void busTask(void *arg)
+{
+    (void)arg;
+    bus_transfer_t t;
+    for (;;) {
+        xQueueReceive(bus_queue, &t, portMAX_DELAY);
+        uint64_t now = hostMicros();
+        if (t.done_us > now) {
+            delayMicroseconds(t.done_us - now);
+        }
+        spi_log[t.log_index].data.assign(t.data, t.data + t.size);
+        esp_lcd_panel_io_t *io = t.io;
+        io->inflight--;
+        if (io->config.on_color_trans_done) {
+            io->config.on_color_trans_done(io, NULL, io->config.user_ctx);
+        }
+        if (!io->inflight) {
+            xSemaphoreGive(io->drained);
+        }
+    }
+}
+
+static void waitDrained(esp_lcd_panel_io_t *io)
+{
+    while (io->inflight) {
+        xSemaphoreTake(io->drained, portMAX_DELAY);
+    }
+}
+
+const std::vector<host_spi_transfer_t> &hostSpiLog()
+{
+    hostSpiWaitIdle();
+    return spi_log;
+}
+
+void hostSpiClear()
+{
+    hostSpiWaitIdle();
+    spi_log.clear();
+}
+
+void hostSpiWaitIdle()
+{
+    for (esp_lcd_panel_io_t *io : panel_ios) {
+        waitDrained(io);
+    }
+}
+
+esp_err_t esp_lcd_new_panel_io_spi(esp_lcd_spi_bus_handle_t bus, const esp_lcd_panel_io_spi_config_t *io_config, esp_lcd_panel_io_handle_t *ret_io)
+{
+    (void)bus;
+    if (!io_config || !ret_io) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!bus_queue) {
+        bus_queue = xQueueCreate(BUS_QUEUE_DEPTH, sizeof(bus_transfer_t));
+        xTaskCreatePinnedToCore(busTask, "spi", 4096, NULL, 1, NULL, 0);
+    }
+    esp_lcd_panel_io_t *io = new esp_lcd_panel_io_t();
+    io->config = *io_config;
+    io->drained = xSemaphoreCreateBinary();
+    panel_ios.push_back(io);
+    *ret_io = io;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_io_del(esp_lcd_panel_io_handle_t io)
+{
+    waitDrained(io);
+    panel_ios.erase(std::find(panel_ios.begin(), panel_ios.end(), io));
+    vSemaphoreDelete(io->drained);
+    delete io;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_io_tx_param(esp_lcd_panel_io_handle_t io, int lcd_cmd, const void *param, size_t param_size)
+{
+    // Like the IDF driver, a command waits for the color transfers before it
+    waitDrained(io);
+    const uint8_t *p = (const uint8_t *)param;
+    host_spi_transfer_t t = {lcd_cmd, std::vector<uint8_t>(p, p + (p ? param_size : 0)), false};
+    spi_log.push_back(t);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_io_tx_color(esp_lcd_panel_io_handle_t io, int lcd_cmd, const void *color, size_t color_size)
+{
+    host_spi_transfer_t t = {lcd_cmd, std::vector<uint8_t>(), true};
+    spi_log.push_back(t);
+
+    uint64_t start = std::max(hostMicros(), io->bus_free_us);
+    uint64_t bits = (uint64_t)color_size * 8;
+    uint32_t pclk = io->config.pclk_hz;
+    bus_transfer_t transfer = {io, spi_log.size() - 1, (const uint8_t *)color, color_size,
+                               start + (pclk ? bits * 1000000 / pclk : 0)
+                              };
+    io->bus_free_us = transfer.done_us;
+    io->inflight++;
+    // Blocks while the transaction queue is full, like trans_queue_depth on the target
+    xQueueSend(bus_queue, &transfer, portMAX_DELAY);
+    return ESP_OK;
+}
+
+void attachInterruptArg(uint8_t pin, void (*handler)(void *), void *arg, int mode)
+{
+    (void)pin;
+    (void)handler;
+    (void)arg;
+    (void)mode;
+}
+
+void detachInterrupt(uint8_t pin)
+{
+    (void)pin;
+}
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration)
+{
+    (void)pin;
+    (void)frequency;
+    (void)duration;
+}
+
+void touchAttachInterrupt(uint8_t pin, void (*handler)(void), uint16_t threshold)
+{
+    (void)pin;
+    (void)handler;
+    (void)threshold;
+}
+
+void touchDetachInterrupt(uint8_t pin)
+{
+    (void)pin;
+}
+
+bool touchInterruptGetLastStatus(uint8_t pin)
+{
+    (void)pin;
+    return false;
+}
+
+void touchSleepWakeUpEnable(uint8_t pin, uint16_t threshold)
+{
+    (void)pin;
+    (void)threshold;
+}
+
+esp_err_t esp_sleep_enable_touchpad_wakeup(void)
+{
+    return ESP_OK;
+}
+
+void esp_deep_sleep_start(void)
+{
+    printf("host: esp_deep_sleep_start(), exiting\n");
+    fflush(stdout);
+    exit(0);
+}
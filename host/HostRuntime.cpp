@@ -0,0 +1,583 @@
+/*
+ * Simulated time, tasks, pins and serial port of the host runtime, see HostRuntime.h
+ */
+#include "HostRuntime.h"
+#include <esp_timer.h>
+#include <stdarg.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define HOST_NEVER          UINT64_MAX
+#define HOST_PINS           64
+#define HOST_LOOP_CORE      1       // Where the Arduino core runs setup() and loop()
+
+struct host_task_t {
+    std::condition_variable cv;
+    const char *name;
+    BaseType_t core;
+    uint64_t wake_us;               // Sleeping until, or the timeout of a block
+    std::function<bool()> ready;    // Set while blocked
+    uint64_t order;                 // When it last gave up the CPU, breaks ties first come first served
+    uint32_t notify;
+    bool done;
+};
+
+enum HostQueueKind {
+    HOST_QUEUE,
+    HOST_SEMAPHORE,
+    HOST_MUTEX,
+    HOST_RECURSIVE_MUTEX,
+};
+
+struct host_queue_t {
+    HostQueueKind kind;
+    uint32_t item_size;
+    uint32_t capacity;
+    std::deque<std::vector<uint8_t>> items;
+    uint32_t count;                 // Semaphores and mutexes
+    host_task_t *owner;
+    uint32_t depth;
+};
+
+typedef struct {
+    std::vector<host_task_t *> tasks;
+    host_task_t *current;
+    uint64_t now_us;
+    uint64_t order;
+} host_sched_t;
+
+// Never destroyed, parked task threads still wait on them when the program exits
+static std::mutex &schedLock()
+{
+    static std::mutex *lock = new std::mutex;
+    return *lock;
+}
+
+static host_sched_t &sched()
+{
+    static host_sched_t *s = [] {
+        host_sched_t *s = new host_sched_t();
+        host_task_t *loop = new host_task_t();
+        loop->name = "loopTask";
+        loop->core = HOST_LOOP_CORE;
+        loop->wake_us = 0;
+        loop->order = 0;
+        loop->notify = 0;
+        loop->done = false;
+        s->tasks.push_back(loop);
+        s->current = loop;
+        s->now_us = 0;
+        s->order = 0;
+        return s;
+    }();
+    return *s;
+}
+
+// The task that can run soonest, the clock moves to that moment
+static host_task_t *pickNext(host_sched_t &s)
+{
+    host_task_t *best = NULL;
+    uint64_t best_us = 0;
+    for (host_task_t *t : s.tasks) {
+        if (t->done) {
+            continue;
+        }
+        uint64_t at = t->wake_us;
+        if (t->ready && t->ready()) {
+            at = s.now_us;
+        } else if (at == HOST_NEVER) {
+            continue;
+        }
+        if (at < s.now_us) {
+            at = s.now_us;
+        }
+        if (!best || at < best_us || (at == best_us && t->order < best->order)) {
+            best = t;
+            best_us = at;
+        }
+    }
+    if (!best) {
+        fprintf(stderr, "host: every task is blocked forever\n");
+        abort();
+    }
+    s.now_us = best_us;
+    return best;
+}
+
+// Hand the CPU to the next task and wait until it comes back, unless me is done
+static void switchFrom(std::unique_lock<std::mutex> &lock, host_task_t *me)
+{
+    host_sched_t &s = sched();
+    me->order = ++s.order;
+    host_task_t *next = pickNext(s);
+    s.current = next;
+    if (next == me) {
+        return;
+    }
+    next->cv.notify_one();
+    while (!me->done && s.current != me) {
+        me->cv.wait(lock);
+    }
+}
+
+static void sleepUntil(uint64_t wake_us)
+{
+    std::unique_lock<std::mutex> lock(schedLock());
+    host_task_t *me = sched().current;
+    me->wake_us = wake_us;
+    switchFrom(lock, me);
+}
+
+// Wait until ready holds or ticks pass, false on timeout
+static bool blockUntil(std::function<bool()> ready, TickType_t ticks)
+{
+    std::unique_lock<std::mutex> lock(schedLock());
+    host_sched_t &s = sched();
+    if (ready()) {
+        return true;
+    }
+    if (ticks == 0) {
+        return false;
+    }
+    host_task_t *me = s.current;
+    me->ready = ready;
+    me->wake_us = ticks == portMAX_DELAY ? HOST_NEVER : s.now_us + ticks * 1000ULL;
+    switchFrom(lock, me);
+    me->ready = nullptr;
+    return ready();
+}
+
+uint64_t hostMicros()
+{
+    return sched().now_us;
+}
+
+void hostAdvance(uint32_t ms)
+{
+    delay(ms);
+}
+
+uint32_t millis(void)
+{
+    return (uint32_t)(sched().now_us / 1000);
+}
+
+uint32_t micros(void)
+{
+    return (uint32_t)sched().now_us;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return (int64_t)sched().now_us;
+}
+
+void delay(uint32_t ms)
+{
+    sleepUntil(sched().now_us + ms * 1000ULL);
+}
+
+void delayMicroseconds(uint32_t us)
+{
+    sleepUntil(sched().now_us + us);
+}
+
+void yield(void)
+{
+    sleepUntil(sched().now_us);
+}
+
+BaseType_t xPortGetCoreID(void)
+{
+    return sched().current->core;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *handle, BaseType_t core)
+{
+    (void)stack;
+    (void)priority;
+    std::unique_lock<std::mutex> lock(schedLock());
+    host_sched_t &s = sched();
+    host_task_t *t = new host_task_t();
+    t->name = name;
+    t->core = core == tskNO_AFFINITY ? 0 : core;
+    t->wake_us = s.now_us;
+    t->order = ++s.order;
+    t->notify = 0;
+    t->done = false;
+    s.tasks.push_back(t);
+    // Runs once the creator sleeps or blocks
+    std::thread([t, fn, arg] {
+        {
+            std::unique_lock<std::mutex> lock(schedLock());
+            while (sched().current != t) {
+                t->cv.wait(lock);
+            }
+        }
+        fn(arg);
+        vTaskDelete(NULL);
+    }).detach();
+    if (handle) {
+        *handle = t;
+    }
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                       UBaseType_t priority, TaskHandle_t *handle)
+{
+    return xTaskCreatePinnedToCore(fn, name, stack, arg, priority, handle, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    std::unique_lock<std::mutex> lock(schedLock());
+    host_task_t *me = sched().current;
+    host_task_t *t = task ? task : me;
+    t->done = true;
+    if (t != me) {
+        return;
+    }
+    switchFrom(lock, me);
+    // Never scheduled again
+    for (;;) {
+        me->cv.wait(lock);
+    }
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    delay(ticks);
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return millis();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return sched().current;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    task->notify++;
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken)
+{
+    task->notify++;
+    if (woken) {
+        *woken = pdTRUE;
+    }
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks)
+{
+    host_task_t *me = sched().current;
+    if (!blockUntil([me] { return me->notify > 0; }, ticks)) {
+        return 0;
+    }
+    uint32_t value = me->notify;
+    me->notify = clear ? 0 : value - 1;
+    return value;
+}
+
+static host_queue_t *newQueue(HostQueueKind kind, uint32_t item_size, uint32_t capacity, uint32_t count)
+{
+    host_queue_t *q = new host_queue_t();
+    q->kind = kind;
+    q->item_size = item_size;
+    q->capacity = capacity;
+    q->count = count;
+    q->owner = NULL;
+    q->depth = 0;
+    return q;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    return newQueue(HOST_QUEUE, item_size, length, 0);
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    delete queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t ticks)
+{
+    if (!blockUntil([q] { return q->items.size() < q->capacity; }, ticks)) {
+        return errQUEUE_FULL;
+    }
+    const uint8_t *p = (const uint8_t *)item;
+    q->items.emplace_back(p, p + q->item_size);
+    return pdPASS;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t q, const void *item, BaseType_t *woken)
+{
+    if (woken) {
+        *woken = pdFALSE;
+    }
+    return xQueueSend(q, item, 0);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t ticks)
+{
+    if (!blockUntil([q] { return !q->items.empty(); }, ticks)) {
+        return pdFALSE;
+    }
+    memcpy(item, q->items.front().data(), q->item_size);
+    q->items.pop_front();
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q)
+{
+    return q->items.size();
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t q)
+{
+    return q->capacity - q->items.size();
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return newQueue(HOST_SEMAPHORE, 0, 1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max, UBaseType_t initial)
+{
+    return newQueue(HOST_SEMAPHORE, 0, max, initial);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return newQueue(HOST_MUTEX, 0, 1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void)
+{
+    return newQueue(HOST_RECURSIVE_MUTEX, 0, 1, 1);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem)
+{
+    delete sem;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    if (!blockUntil([sem] { return sem->count > 0; }, ticks)) {
+        return pdFALSE;
+    }
+    sem->count--;
+    if (sem->kind != HOST_SEMAPHORE) {
+        sem->owner = sched().current;
+        sem->depth = 1;
+    }
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    if (sem->kind != HOST_SEMAPHORE) {
+        if (sem->owner != sched().current) {
+            return pdFALSE;
+        }
+        sem->owner = NULL;
+        sem->depth = 0;
+    }
+    if (sem->count >= sem->capacity) {
+        return pdFALSE;
+    }
+    sem->count++;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t sem, BaseType_t *woken)
+{
+    if (woken) {
+        *woken = pdFALSE;
+    }
+    return xSemaphoreGive(sem);
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    if (sem->owner == sched().current) {
+        sem->depth++;
+        return pdTRUE;
+    }
+    return xSemaphoreTake(sem, ticks);
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t sem)
+{
+    if (sem->owner != sched().current) {
+        return pdFALSE;
+    }
+    if (--sem->depth) {
+        return pdTRUE;
+    }
+    sem->owner = NULL;
+    sem->count = 1;
+    return pdTRUE;
+}
+
+UBaseType_t uxSemaphoreGetCount(SemaphoreHandle_t sem)
+{
+    return sem->count;
+}
+
+static int pins[HOST_PINS];
+static bool pins_set[HOST_PINS];
+
+void hostSetPin(uint8_t pin, int level)
+{
+    if (pin < HOST_PINS) {
+        pins[pin] = level;
+        pins_set[pin] = true;
+    }
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    (void)pin;
+    (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+    hostSetPin(pin, val);
+}
+
+int digitalRead(uint8_t pin)
+{
+    if (pin >= HOST_PINS || !pins_set[pin]) {
+        return HIGH;
+    }
+    return pins[pin];
+}
+
+uint16_t analogRead(uint8_t pin)
+{
+    (void)pin;
+    return 0;
+}
+
+static std::deque<char> serial_input;
+static bool serial_mute;
+
+HardwareSerial Serial;
+EspClass ESP;
+
+void hostSerialInput(const char *text)
+{
+    while (*text) {
+        serial_input.push_back(*text++);
+    }
+}
+
+void hostSerialMute(bool mute)
+{
+    serial_mute = mute;
+}
+
+int HardwareSerial::available()
+{
+    return serial_input.size();
+}
+
+int HardwareSerial::read()
+{
+    if (serial_input.empty()) {
+        return -1;
+    }
+    int c = (uint8_t)serial_input.front();
+    serial_input.pop_front();
+    return c;
+}
+
+int HardwareSerial::peek()
+{
+    return serial_input.empty() ? -1 : (uint8_t)serial_input.front();
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    if (!serial_mute) {
+        fwrite(buffer, 1, size, stdout);
+    }
+    return size;
+}
+
+void HardwareSerial::flush()
+{
+    fflush(stdout);
+}
+
+size_t Print::printWidened(const char *format, ...)
+{
+    char buf[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    if (len < 0) {
+        return 0;
+    }
+    if ((size_t)len < sizeof(buf)) {
+        return write((const uint8_t *)buf, len);
+    }
+    std::vector<char> big(len + 1);
+    va_start(args, format);
+    vsnprintf(big.data(), big.size(), format, args);
+    va_end(args);
+    return write((const uint8_t *)big.data(), len);
+}
+
+size_t Print::printNumber(unsigned long long v, int base)
+{
+    char buf[8 * sizeof(v) + 1];
+    char *p = &buf[sizeof(buf) - 1];
+    *p = '\0';
+    if (base < 2) {
+        base = 10;
+    }
+    do {
+        int digit = v % base;
+        *--p = digit < 10 ? '0' + digit : 'A' + digit - 10;
+        v /= base;
+    } while (v);
+    return write(p);
+}
+
+size_t Print::printSigned(long long v, int base)
+{
+    if (v < 0 && base == 10) {
+        return print('-') + printNumber(-(unsigned long long)v, base);
+    }
+    return printNumber(v, base);
+}
+
+void EspClass::restart()
+{
+    printf("host: ESP.restart(), exiting\n");
+    fflush(stdout);
+    exit(0);
+}
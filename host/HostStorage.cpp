@@ -0,0 +1,354 @@
+/*
+ * LittleFS, EEPROM, Preferences and NVS of the host runtime, plus the NimBLE statics
+ */
+#include "HostRuntime.h"
+#include <EEPROM.h>
+#include <LittleFS.h>
+#include <NimBLEDevice.h>
+#include <Preferences.h>
+#include <nvs_flash.h>
+#include <filesystem>
+#include <system_error>
+
+namespace stdfs = std::filesystem;
+
+static std::string fs_root = "host_fs";
+
+void hostFsRoot(const char *path)
+{
+    fs_root = path;
+    std::error_code ec;
+    stdfs::create_directories(fs_root, ec);
+}
+
+static std::string hostPath(const char *path)
+{
+    return fs_root + (path[0] == '/' ? "" : "/") + path;
+}
+
+namespace fs
+{
+
+File::Handle::~Handle()
+{
+    if (f) {
+        fclose(f);
+    }
+}
+
+File::File(FILE *f, const char *path) : _h(std::make_shared<Handle>())
+{
+    _h->f = f;
+    _h->path = path;
+}
+
+size_t File::write(uint8_t c)
+{
+    return write(&c, 1);
+}
+
+size_t File::write(const uint8_t *buffer, size_t size)
+{
+    return *this ? fwrite(buffer, 1, size, _h->f) : 0;
+}
+
+int File::available()
+{
+    return *this ? (int)(size() - position()) : 0;
+}
+
+int File::read()
+{
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::peek()
+{
+    if (!*this) {
+        return -1;
+    }
+    int c = fgetc(_h->f);
+    if (c != EOF) {
+        ungetc(c, _h->f);
+    }
+    return c == EOF ? -1 : c;
+}
+
+size_t File::read(uint8_t *buffer, size_t size)
+{
+    return *this ? fread(buffer, 1, size, _h->f) : 0;
+}
+
+size_t File::readBytes(char *buffer, size_t length)
+{
+    return read((uint8_t *)buffer, length);
+}
+
+void File::flush()
+{
+    if (*this) {
+        fflush(_h->f);
+    }
+}
+
+bool File::seek(uint32_t pos, SeekMode mode)
+{
+    static const int whence[] = {SEEK_SET, SEEK_CUR, SEEK_END};
+    return *this && fseek(_h->f, pos, whence[mode]) == 0;
+}
+
+size_t File::position() const
+{
+    return *this ? ftell(_h->f) : 0;
+}
+
+size_t File::size() const
+{
+    if (!*this) {
+        return 0;
+    }
+    long at = ftell(_h->f);
+    fseek(_h->f, 0, SEEK_END);
+    long end = ftell(_h->f);
+    fseek(_h->f, at, SEEK_SET);
+    return end;
+}
+
+void File::close()
+{
+    if (_h && _h->f) {
+        fclose(_h->f);
+        _h->f = NULL;
+    }
+}
+
+const char *File::path() const
+{
+    return _h ? _h->path.c_str() : NULL;
+}
+
+const char *File::name() const
+{
+    if (!_h) {
+        return NULL;
+    }
+    const char *slash = strrchr(_h->path.c_str(), '/');
+    return slash ? slash + 1 : _h->path.c_str();
+}
+
+File::operator bool() const
+{
+    return _h && _h->f;
+}
+
+File FS::open(const char *path, const char *mode, bool create)
+{
+    std::string host = hostPath(path);
+    if (create) {
+        std::error_code ec;
+        stdfs::create_directories(stdfs::path(host).parent_path(), ec);
+    }
+    // Binary, and "r+" style access is not used by the sketches
+    std::string m = std::string(mode) + "b";
+    FILE *f = fopen(host.c_str(), m.c_str());
+    if (!f) {
+        return File();
+    }
+    return File(f, path);
+}
+
+bool FS::exists(const char *path)
+{
+    std::error_code ec;
+    return stdfs::exists(hostPath(path), ec);
+}
+
+bool FS::remove(const char *path)
+{
+    std::error_code ec;
+    return stdfs::remove(hostPath(path), ec);
+}
+
+bool FS::rename(const char *from, const char *to)
+{
+    std::error_code ec;
+    stdfs::rename(hostPath(from), hostPath(to), ec);
+    return !ec;
+}
+
+bool FS::mkdir(const char *path)
+{
+    std::error_code ec;
+    stdfs::create_directories(hostPath(path), ec);
+    return !ec;
+}
+
+bool LittleFSFS::begin(bool formatOnFail, const char *basePath, uint8_t maxOpenFiles, const char *partitionLabel)
+{
+    (void)formatOnFail;
+    (void)basePath;
+    (void)maxOpenFiles;
+    (void)partitionLabel;
+    std::error_code ec;
+    stdfs::create_directories(fs_root, ec);
+    return !ec;
+}
+
+bool LittleFSFS::format()
+{
+    std::error_code ec;
+    stdfs::remove_all(fs_root, ec);
+    stdfs::create_directories(fs_root, ec);
+    return !ec;
+}
+
+size_t LittleFSFS::totalBytes()
+{
+    // The size of the ffat/littlefs partition of the default 16 MB layout
+    return 0x300000;
+}
+
+size_t LittleFSFS::usedBytes()
+{
+    size_t used = 0;
+    std::error_code ec;
+    for (auto it = stdfs::recursive_directory_iterator(fs_root, ec); !ec && it != stdfs::recursive_directory_iterator();
+            it.increment(ec)) {
+        if (it->is_regular_file(ec)) {
+            used += it->file_size(ec);
+        }
+    }
+    return used;
+}
+
+}
+
+fs::LittleFSFS LittleFS;
+
+EEPROMClass EEPROM;
+
+typedef std::map<std::string, std::vector<uint8_t>> host_namespace_t;
+
+static std::map<std::string, host_namespace_t> &nvs()
+{
+    static std::map<std::string, host_namespace_t> store;
+    return store;
+}
+
+bool Preferences::begin(const char *name, bool readOnly)
+{
+    // Like nvs_open(), a namespace that was never written cannot be opened read-only
+    if (readOnly && !nvs().count(name)) {
+        return false;
+    }
+    _ns = &nvs()[name];
+    _readOnly = readOnly;
+    return true;
+}
+
+void Preferences::end()
+{
+    _ns = nullptr;
+}
+
+bool Preferences::clear()
+{
+    if (!_ns || _readOnly) {
+        return false;
+    }
+    _ns->clear();
+    return true;
+}
+
+bool Preferences::remove(const char *key)
+{
+    if (!_ns || _readOnly) {
+        return false;
+    }
+    return _ns->erase(key) > 0;
+}
+
+bool Preferences::isKey(const char *key)
+{
+    return _ns && _ns->count(key);
+}
+
+size_t Preferences::putBytes(const char *key, const void *value, size_t len)
+{
+    if (!_ns || _readOnly) {
+        return 0;
+    }
+    const uint8_t *p = (const uint8_t *)value;
+    (*_ns)[key].assign(p, p + len);
+    return len;
+}
+
+size_t Preferences::getString(const char *key, char *value, size_t maxLen)
+{
+    size_t len = getBytesLength(key);
+    if (!len || len > maxLen) {
+        return 0;
+    }
+    return getBytes(key, value, maxLen);
+}
+
+size_t Preferences::getBytesLength(const char *key)
+{
+    if (!isKey(key)) {
+        return 0;
+    }
+    return (*_ns)[key].size();
+}
+
+size_t Preferences::getBytes(const char *key, void *buf, size_t maxLen)
+{
+    size_t len = getBytesLength(key);
+    if (!len || len > maxLen) {
+        return 0;
+    }
+    memcpy(buf, (*_ns)[key].data(), len);
+    return len;
+}
+
+esp_err_t nvs_flash_init(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase(void)
+{
+    nvs().clear();
+    EEPROM.clear();
+    return ESP_OK;
+}
+
+static NimBLEScan ble_scan;
+static std::list<NimBLEClient *> ble_clients;
+
+void NimBLEDevice::deinit(bool clearAll)
+{
+    if (clearAll) {
+        for (NimBLEClient *client : ble_clients) {
+            delete client;
+        }
+        ble_clients.clear();
+    }
+}
+
+NimBLEScan *NimBLEDevice::getScan()
+{
+    return &ble_scan;
+}
+
+NimBLEClient *NimBLEDevice::createClient()
+{
+    NimBLEClient *client = new NimBLEClient();
+    ble_clients.push_back(client);
+    return client;
+}
+
+std::list<NimBLEClient *> *NimBLEDevice::getClientList()
+{
+    return &ble_clients;
+}
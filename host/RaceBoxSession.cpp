@@ -0,0 +1,303 @@
+/*
+ * Synthetic RaceBox sessions and track databases, see RaceBoxSession.h
+ */
+#include "RaceBoxSession.h"
+#include "RaceBoxReplay.h"
+#include <algorithm>
+
+#define WGS84_A         6378137.0
+#define WGS84_E2        6.69437999014e-3
+
+session_params_t sessionDefaults(uint8_t laps)
+{
+    session_params_t p;
+    p.lat = 520733000;
+    p.lon = -10167000;
+    p.straight_m = 300.0f;
+    p.radius_m = 50.0f;
+    p.straight_mps = 40.0f;
+    for (uint8_t i = 0; i < laps; i++) {
+        // Each lap a different time, the third one the fastest
+        static const float corner[] = {18.0f, 19.5f, 21.0f, 19.0f, 20.0f, 18.5f, 20.5f};
+        p.corner_mps.push_back(corner[i % 7]);
+    }
+    p.lead_in_m = 100.0f;
+    p.lead_out_m = 100.0f;
+    p.itow_ms = 388800000;      // Thursday 12:00
+    p.rate_hz = 25;
+    return p;
+}
+
+RaceBoxSession::RaceBoxSession(const session_params_t &params) : _p(params)
+{
+    double lat0 = _p.lat * 1e-7 * M_PI / 180.0;
+    double w = sqrt(1.0 - WGS84_E2 * sin(lat0) * sin(lat0));
+    _m_lat = WGS84_A * (1.0 - WGS84_E2) / (w * w * w);
+    _m_lon = WGS84_A / w;
+
+    // Distance against time is piecewise linear, one piece per straight or corner
+    double half = _p.straight_m / 2.0;
+    double arc = M_PI * _p.radius_m;
+    Knot k = {-_p.lead_in_m, 0.0};
+    _knots.push_back(k);
+    k.d = 0.0;
+    k.t = _p.lead_in_m / _p.straight_mps * 1000.0;
+    _knots.push_back(k);
+    for (float corner : _p.corner_mps) {
+        const double len[] = {half, arc, _p.straight_m, arc, half};
+        const double v[] = {_p.straight_mps, corner, _p.straight_mps, corner, _p.straight_mps};
+        for (int i = 0; i < 5; i++) {
+            k.d += len[i];
+            k.t += len[i] / v[i] * 1000.0;
+            _knots.push_back(k);
+        }
+    }
+    k.d += _p.lead_out_m;
+    k.t += _p.lead_out_m / _p.straight_mps * 1000.0;
+    _knots.push_back(k);
+}
+
+float RaceBoxSession::lapLength() const
+{
+    return 2.0f * _p.straight_m + 2.0f * (float)M_PI * _p.radius_m;
+}
+
+uint8_t RaceBoxSession::laps() const
+{
+    return _p.corner_mps.size();
+}
+
+double RaceBoxSession::timeAtDistance(double d) const
+{
+    for (size_t i = 1; i < _knots.size(); i++) {
+        if (d <= _knots[i].d || i == _knots.size() - 1) {
+            const Knot &a = _knots[i - 1];
+            const Knot &b = _knots[i];
+            return a.t + (d - a.d) / (b.d - a.d) * (b.t - a.t);
+        }
+    }
+    return 0.0;
+}
+
+double RaceBoxSession::distanceAt(double t) const
+{
+    for (size_t i = 1; i < _knots.size(); i++) {
+        if (t <= _knots[i].t || i == _knots.size() - 1) {
+            const Knot &a = _knots[i - 1];
+            const Knot &b = _knots[i];
+            return a.d + (t - a.t) / (b.t - a.t) * (b.d - a.d);
+        }
+    }
+    return 0.0;
+}
+
+double RaceBoxSession::timeAt(uint8_t lap, float s) const
+{
+    return _p.itow_ms + timeAtDistance((double)lap * lapLength() + s);
+}
+
+double RaceBoxSession::lapTime(uint8_t lap) const
+{
+    return timeAt(lap + 1, 0) - timeAt(lap, 0);
+}
+
+enu_t RaceBoxSession::position(float s, float *headingDeg) const
+{
+    double half = _p.straight_m / 2.0;
+    double r = _p.radius_m;
+    double b1 = half;
+    double b2 = b1 + M_PI * r;
+    double b3 = b2 + _p.straight_m;
+    double b4 = b3 + M_PI * r;
+    s = fmod(s, lapLength());
+    if (s < 0) {
+        s += lapLength();
+    }
+    double e;
+    double n;
+    double heading;
+    if (s < b1) {
+        e = 0;
+        n = s;
+        heading = 0;
+    } else if (s < b2 || (s >= b3 && s < b4)) {
+        // Counter-clockwise around the centre of the north or the south corner
+        bool north = s < b2;
+        double a = north ? (s - b1) / r : M_PI + (s - b3) / r;
+        e = -r + r * cos(a);
+        n = (north ? half : -half) + r * sin(a);
+        heading = fmod(720.0 - a * 180.0 / M_PI, 360.0);
+    } else if (s < b3) {
+        e = -2.0 * r;
+        n = half - (s - b2);
+        heading = 180;
+    } else {
+        e = 0;
+        n = -half + (s - b4);
+        heading = 0;
+    }
+    if (headingDeg) {
+        *headingDeg = heading;
+    }
+    enu_t pos = {(float)e, (float)n};
+    return pos;
+}
+
+void RaceBoxSession::toLatLon(enu_t pos, int32_t *lat, int32_t *lon) const
+{
+    double lat0 = _p.lat * 1e-7 * M_PI / 180.0;
+    double latRad = lat0 + pos.n / _m_lat;
+    double lonRad = _p.lon * 1e-7 * M_PI / 180.0 + pos.e / (_m_lon * cos(latRad));
+    *lat = (int32_t)llround(latRad * 180.0 / M_PI * 1e7);
+    *lon = (int32_t)llround(lonRad * 180.0 / M_PI * 1e7);
+}
+
+uint32_t RaceBoxSession::fixCount() const
+{
+    return (uint32_t)(_knots.back().t * _p.rate_hz / 1000.0) + 1;
+}
+
+void RaceBoxSession::fix(uint32_t i, rbx_fix_t *fix) const
+{
+    uint32_t t = (uint32_t)((uint64_t)i * 1000 / _p.rate_hz);
+    double d = distanceAt(t);
+    double v = (distanceAt(t + 1.0) - d) * 1000.0;
+    float heading;
+    enu_t pos = position(d, &heading);
+
+    memset(fix, 0, sizeof(*fix));
+    fix->mask = RBX_F_ALL;
+    fix->itow_ms = _p.itow_ms + t;
+    uint32_t msOfDay = fix->itow_ms % 86400000;
+    fix->year = 2026;
+    fix->month = 1;
+    fix->day = 15;
+    fix->hour = msOfDay / 3600000;
+    fix->minute = (msOfDay / 60000) % 60;
+    fix->second = (msOfDay / 1000) % 60;
+    fix->validity = 0x07;
+    fix->time_acc_ns = 25;
+    fix->nano = (msOfDay % 1000) * 1000000;
+    fix->fix_status = 3;
+    fix->fix_flags = 0x01;
+    fix->datetime_flags = 0xE0;
+    fix->num_sv = 14;
+    toLatLon(pos, &fix->lat, &fix->lon);
+    fix->alt_wgs_mm = 150000;
+    fix->alt_msl_mm = 103000;
+    fix->h_acc_mm = 300;
+    fix->v_acc_mm = 600;
+    fix->speed_mm_s = (int32_t)lround(v * 1000.0);
+    fix->heading = (int32_t)lround(heading * 1e5);
+    fix->speed_acc_mm_s = 150;
+    fix->heading_acc = 50000;
+    fix->pdop = 110;
+    fix->battery = 85;
+    fix->g_mg[2] = 1000;
+}
+
+bool RaceBoxSession::writeCapture(const char *path) const
+{
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        return false;
+    }
+    fwrite(RBX_MAGIC, 1, 4, f);
+    uint32_t start = _p.itow_ms;
+    for (uint32_t i = 0; i < fixCount(); i++) {
+        rbx_fix_t fx;
+        fix(i, &fx);
+        uint8_t frame[SESSION_FRAME_SIZE];
+        rbx_record_t record = {(fx.itow_ms - start) * 1000, (uint16_t)rbxEncodeFrame(fx, frame)};
+        fwrite(&record, sizeof(record), 1, f);
+        fwrite(frame, 1, record.len, f);
+    }
+    return fclose(f) == 0;
+}
+
+static void put(uint8_t *payload, rbx_field_t field, uint32_t value)
+{
+    memcpy(payload + RBX_FIELDS[field].offset, &value, RBX_FIELDS[field].size);
+}
+
+size_t rbxEncodeFrame(const rbx_fix_t &fix, uint8_t *frame)
+{
+    uint8_t *p = frame + 6;
+    put(p, RBX_ITOW, fix.itow_ms);
+    put(p, RBX_YEAR, fix.year);
+    put(p, RBX_MONTH, fix.month);
+    put(p, RBX_DAY, fix.day);
+    put(p, RBX_HOUR, fix.hour);
+    put(p, RBX_MINUTE, fix.minute);
+    put(p, RBX_SECOND, fix.second);
+    put(p, RBX_VALIDITY, fix.validity);
+    put(p, RBX_TIME_ACC, fix.time_acc_ns);
+    put(p, RBX_NANO, fix.nano);
+    put(p, RBX_FIX_STATUS, fix.fix_status);
+    put(p, RBX_FIX_FLAGS, fix.fix_flags);
+    put(p, RBX_DATETIME_FLAGS, fix.datetime_flags);
+    put(p, RBX_NUM_SV, fix.num_sv);
+    put(p, RBX_LON, fix.lon);
+    put(p, RBX_LAT, fix.lat);
+    put(p, RBX_ALT_WGS, fix.alt_wgs_mm);
+    put(p, RBX_ALT_MSL, fix.alt_msl_mm);
+    put(p, RBX_H_ACC, fix.h_acc_mm);
+    put(p, RBX_V_ACC, fix.v_acc_mm);
+    put(p, RBX_SPEED, fix.speed_mm_s);
+    put(p, RBX_HEADING, fix.heading);
+    put(p, RBX_SPEED_ACC, fix.speed_acc_mm_s);
+    put(p, RBX_HEADING_ACC, fix.heading_acc);
+    put(p, RBX_PDOP, fix.pdop);
+    put(p, RBX_LATLON_FLAGS, fix.latlon_flags);
+    put(p, RBX_BATTERY, fix.battery);
+    for (int i = 0; i < 3; i++) {
+        put(p, (rbx_field_t)(RBX_G_X + i), (uint16_t)fix.g_mg[i]);
+        put(p, (rbx_field_t)(RBX_ROT_X + i), (uint16_t)fix.rot_cdps[i]);
+    }
+
+    frame[0] = 0xB5;
+    frame[1] = 0x62;
+    frame[2] = RACEBOX_MSG_CLASS;
+    frame[3] = RACEBOX_MSG_ID;
+    frame[4] = RACEBOX_PAYLOAD_LEN & 0xFF;
+    frame[5] = RACEBOX_PAYLOAD_LEN >> 8;
+    uint8_t ckA = 0;
+    uint8_t ckB = 0;
+    for (int i = 2; i < 6 + RACEBOX_PAYLOAD_LEN; i++) {
+        ckA += frame[i];
+        ckB += ckA;
+    }
+    frame[6 + RACEBOX_PAYLOAD_LEN] = ckA;
+    frame[7 + RACEBOX_PAYLOAD_LEN] = ckB;
+    return SESSION_FRAME_SIZE;
+}
+
+bool writeTrackDb(const char *path, std::vector<trackdb_track_t> tracks)
+{
+    std::stable_sort(tracks.begin(), tracks.end(), [](const trackdb_track_t &a, const trackdb_track_t &b) {
+        return trackDbKey(a.lat, a.lon) < trackDbKey(b.lat, b.lon);
+    });
+    std::vector<trackdb_cell_t> cells;
+    for (uint32_t i = 0; i < tracks.size(); i++) {
+        uint32_t key = trackDbKey(tracks[i].lat, tracks[i].lon);
+        if (cells.empty() || cells.back().key != key) {
+            trackdb_cell_t cell = {key, i, 0};
+            cells.push_back(cell);
+        }
+        cells.back().count++;
+    }
+    trackdb_header_t header;
+    memcpy(header.magic, TRACKDB_MAGIC, 4);
+    header.tracks = tracks.size();
+    header.cells = cells.size();
+    header.cell_e7 = TRACKDB_CELL_E7;
+
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        return false;
+    }
+    fwrite(&header, sizeof(header), 1, f);
+    fwrite(cells.data(), sizeof(trackdb_cell_t), cells.size(), f);
+    fwrite(tracks.data(), sizeof(trackdb_track_t), tracks.size(), f);
+    return fclose(f) == 0;
+}
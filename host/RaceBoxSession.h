@@ -0,0 +1,82 @@
+/*
+ * Synthetic RaceBox sessions and track databases for the host tests.
+ *
+ * The track is a stadium: two straights joined by half circles, the finish line in
+ * the middle of the east straight with travel to the north. Speed is constant on every
+ * straight and per lap in the corners, so each lap is a different time and every time
+ * along the lap is known exactly. The straights are driven at the same speed every lap
+ * and a crossing always falls between two fixes on a straight, so an interpolated
+ * crossing time is exact up to the 1e-7 degree resolution of the positions.
+ */
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+#include "Geodesy.h"
+#include "RaceBoxData.h"
+#include "TrackDb.h"
+
+#define UBX_FRAME_OVERHEAD      8       // Sync, class, id, length, checksum
+#define SESSION_FRAME_SIZE      (UBX_FRAME_OVERHEAD + RACEBOX_PAYLOAD_LEN)
+
+typedef struct {
+    int32_t lat;                    // Finish line, degrees * 1e7
+    int32_t lon;
+    float straight_m;               // Length of each straight
+    float radius_m;                 // Of the half circles
+    float straight_mps;             // Speed on the straights, every lap
+    std::vector<float> corner_mps;  // Speed in the corners, one per lap
+    float lead_in_m;                // Driven before the first crossing
+    float lead_out_m;               // ... after the last one
+    uint32_t itow_ms;               // GPS time of the first fix
+    uint16_t rate_hz;
+} session_params_t;
+
+// Defaults: a 1.2 km lap near Silverstone at 25 Hz, laps of about 32 s
+session_params_t sessionDefaults(uint8_t laps);
+
+class RaceBoxSession {
+public:
+    RaceBoxSession(const session_params_t &params);
+
+    float lapLength() const;
+    uint8_t laps() const;
+
+    // iTOW in ms, with fraction, when lap (0 = the one after the first crossing) is s
+    // metres along, and the time of a whole lap
+    double timeAt(uint8_t lap, float s) const;
+    double lapTime(uint8_t lap) const;
+
+    // Track frame point s metres past the finish line, heading in degrees from north
+    enu_t position(float s, float *headingDeg) const;
+
+    // Degrees * 1e7 of a track frame point, the inverse of TrackFrame::project()
+    void toLatLon(enu_t pos, int32_t *lat, int32_t *lon) const;
+
+    // Fixes at rate_hz from the start of the lead-in to the end of the lead-out
+    uint32_t fixCount() const;
+    void fix(uint32_t i, rbx_fix_t *fix) const;
+
+    // RaceBoxCapture file (RBX1) of every fix, one notification per frame
+    bool writeCapture(const char *path) const;
+
+private:
+    struct Knot {
+        double d;                   // Metres from the first crossing
+        double t;                   // ms from the first fix
+    };
+
+    double distanceAt(double t) const;
+    double timeAtDistance(double d) const;
+
+    session_params_t _p;
+    std::vector<Knot> _knots;
+    double _m_lat;                  // Metres per radian at the finish line
+    double _m_lon;
+};
+
+// RaceBox data message frame of every field of fix, SESSION_FRAME_SIZE bytes
+size_t rbxEncodeFrame(const rbx_fix_t &fix, uint8_t *frame);
+
+// TrackDb file of the tracks, in any order, the way tools/build_trackdb.py lays it out
+bool writeTrackDb(const char *path, std::vector<trackdb_track_t> tracks);
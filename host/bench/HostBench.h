@@ -0,0 +1,58 @@
+/*
+ * Wall clock timing for the host benchmarks. The numbers compare implementations on
+ * the build machine, they are not ESP32-S3 timings: expect the ratios to carry over
+ * roughly, the absolute times not at all.
+ *
+ * Every benchmark takes --quick, which runs each case just long enough to check it
+ * still works, the way ctest runs them.
+ */
+#pragma once
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+static bool bench_quick;
+
+// Parses --quick, returns false on anything else
+static inline bool benchArgs(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--quick")) {
+            bench_quick = true;
+        } else {
+            fprintf(stderr, "usage: %s [--quick]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Mean wall time of one call of fn in ns, calls repeated for about 200 ms (1 ms quick)
+template <typename Fn>
+static double benchNs(Fn fn)
+{
+    using clock = std::chrono::steady_clock;
+    const double budget = bench_quick ? 1e6 : 2e8;
+    fn();
+    uint64_t calls = 0;
+    uint64_t batch = 1;
+    auto start = clock::now();
+    double elapsed;
+    do {
+        for (uint64_t i = 0; i < batch; i++) {
+            fn();
+        }
+        calls += batch;
+        batch *= 2;
+        elapsed = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+    } while (elapsed < budget);
+    return elapsed / calls;
+}
+
+// Keeps a result alive so the optimiser cannot drop the work that produced it
+template <typename T>
+static inline void benchKeep(const T &value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
@@ -0,0 +1,127 @@
+/*
+ * TrackFrame of the sketch against the double haversine calculateDistance() it
+ * replaced, on the fixes of a host session and on points out to 5 km of the origin.
+ * The per fix work of each: the haversine from the fix to the finish line, project()
+ * or projectFast() of the fix and enuLength() to the origin, and enuDistance() between
+ * two projected points, which is all a gate or the lap delta does after projecting.
+ *
+ * The build machine has a double precision FPU, the ESP32-S3 does not and emulates
+ * every double operation in software, so the ratio here is the least the HUD gains.
+ * The haversine distances must stay within the 0.6 % Geodesy.h gives for its sphere.
+ */
+#include "HostBench.h"
+#include "RaceBoxSession.h"
+#include "Geodesy.h"
+#include <random>
+#include <vector>
+
+typedef struct {
+    int32_t lat;
+    int32_t lon;
+} bench_point_t;
+
+// calculateDistance() of the original sketch, degrees in, metres out
+static double calculateDistance(double lat1, double lon1, double lat2, double lon2)
+{
+    const double R = 6371000;
+    double dLat = (lat2 - lat1) * PI / 180.0;
+    double dLon = (lon2 - lon1) * PI / 180.0;
+    double a = sin(dLat / 2) * sin(dLat / 2) +
+               cos(lat1 * PI / 180.0) * cos(lat2 * PI / 180.0) * sin(dLon / 2) * sin(dLon / 2);
+    double c = 2 * atan2(sqrt(a), sqrt(1 - a));
+    return R * c;
+}
+
+int main(int argc, char **argv)
+{
+    if (!benchArgs(argc, argv)) {
+        return 2;
+    }
+    session_params_t params = sessionDefaults(1);
+    RaceBoxSession session(params);
+    TrackFrame frame;
+    frame.set(params.lat, params.lon);
+
+    std::vector<bench_point_t> sessionPoints;
+    for (uint32_t i = 0; i < session.fixCount(); i++) {
+        rbx_fix_t fix;
+        session.fix(i, &fix);
+        sessionPoints.push_back({fix.lat, fix.lon});
+    }
+    std::mt19937 rng(20251017);
+    std::uniform_real_distribution<double> offsetM(-3500.0, 3500.0);
+    std::vector<bench_point_t> farPoints;
+    for (int i = 0; i < 1000; i++) {
+        double lat = params.lat + offsetM(rng) / 0.0111319491;
+        double lon = params.lon + offsetM(rng) / (0.0111319491 * cos(params.lat * 1e-7 * M_PI / 180.0));
+        farPoints.push_back({(int32_t)llround(lat), (int32_t)llround(lon)});
+    }
+
+    const struct {
+        const char *name;
+        const std::vector<bench_point_t> *points;
+    } cases[] = {
+        {"session", &sessionPoints},
+        {"5 km", &farPoints},
+    };
+
+    int failures = 0;
+    printf("%-8s %12s %12s %12s %12s %8s\n", "points", "haversine", "project", "projectFast", "enuDistance",
+           "speedup");
+    for (const auto &c : cases) {
+        const std::vector<bench_point_t> &pts = *c.points;
+        const double lat0 = params.lat * 1e-7;
+        const double lon0 = params.lon * 1e-7;
+        std::vector<double> haversine(pts.size());
+        std::vector<float> projected(pts.size());
+        std::vector<enu_t> enu(pts.size());
+
+        double haversineNs = benchNs([&] {
+            for (size_t i = 0; i < pts.size(); i++) {
+                haversine[i] = calculateDistance(pts[i].lat * 1e-7, pts[i].lon * 1e-7, lat0, lon0);
+            }
+            benchKeep(haversine);
+        }) / pts.size();
+        double projectNs = benchNs([&] {
+            for (size_t i = 0; i < pts.size(); i++) {
+                enu[i] = frame.project(pts[i].lat, pts[i].lon);
+                projected[i] = enuLength(enu[i]);
+            }
+            benchKeep(projected);
+        }) / pts.size();
+        std::vector<float> fast(pts.size());
+        double fastNs = benchNs([&] {
+            for (size_t i = 0; i < pts.size(); i++) {
+                fast[i] = enuLength(frame.projectFast(pts[i].lat, pts[i].lon));
+            }
+            benchKeep(fast);
+        }) / pts.size();
+        std::vector<float> between(pts.size());
+        double distanceNs = benchNs([&] {
+            for (size_t i = 0; i + 1 < enu.size(); i++) {
+                between[i] = enuDistance(enu[i], enu[i + 1]);
+            }
+            benchKeep(between);
+        }) / (pts.size() - 1);
+        printf("%-8s %12.2f %12.2f %12.2f %12.2f %7.1fx\n", c.name, haversineNs, projectNs, fastNs, distanceNs,
+               haversineNs / projectNs);
+
+        // The sphere of the haversine, not the projection, is what is off
+        double worst = 0;
+        for (size_t i = 0; i < pts.size(); i++) {
+            if (projected[i] > 10.0f) {
+                worst = std::max(worst, fabs(haversine[i] - projected[i]) / projected[i]);
+            }
+        }
+        printf("%-8s haversine off by up to %.2f %%\n", "", worst * 100);
+        if (worst > 0.006) {
+            printf("FAIL: %s, the haversine and project() differ by %.2f %%\n", c.name, worst * 100);
+            failures++;
+        }
+        if (projectNs >= haversineNs) {
+            printf("FAIL: %s, project() is not faster than the haversine\n", c.name);
+            failures++;
+        }
+    }
+    return failures ? 1 : 0;
+}
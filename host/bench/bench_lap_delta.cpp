@@ -0,0 +1,248 @@
+/*
+ * LapDelta of the sketch over a 20 minute session at 25 Hz, 39 laps fed the way
+ * checkLapCrossing() and loop() do: finish gate, startLap() / finishLap() at each
+ * crossing and update() on every other fix. Next to it the same delta found by
+ * projecting each fix onto every segment of the reference trace, which is what the
+ * cursor walk replaced: the cursor must cost the same per fix whatever the length of
+ * the lap, and give the same delta.
+ *
+ * The session knows when every point of every lap is passed, so each delta is also
+ * checked against the exact one, the time of this lap at the point of the fix minus
+ * that of the reference lap at the same point. The trace is linear between points, so
+ * where the speed changes at a corner entry or exit the reference time is off by up to
+ * a quarter of a segment times the change in pace; everywhere else only the rounding
+ * of the crossings is left.
+ */
+#include "HostBench.h"
+#include "HostRuntime.h"
+#include "RaceBoxSession.h"
+#include "LapDelta.h"
+#include "LapGate.h"
+#include <algorithm>
+#include <vector>
+
+#define SESSION_LAPS            39      // 20 minutes of laps of about 31 s
+
+typedef struct {
+    enu_t pos;
+    uint32_t itow;
+    bool finish;                // Crossed the finish line, at cross
+    uint32_t cross;
+    uint8_t lap;                // 0 = the lap after the first crossing
+} bench_fix_t;
+
+// Metres along lap at iTOW t, by bisection on the exact times of the session
+static float distanceAt(const RaceBoxSession &session, uint8_t lap, double t)
+{
+    float lo = 0;
+    float hi = session.lapLength();
+    for (int i = 0; i < 40; i++) {
+        float mid = (lo + hi) / 2;
+        (session.timeAt(lap, mid) < t ? lo : hi) = mid;
+    }
+    return (lo + hi) / 2;
+}
+
+// Within one trace segment of a corner entry or exit, where the speed of the session steps
+static bool nearKnot(const session_params_t &p, float s)
+{
+    const float segment = DELTA_STEP_M + p.straight_mps / p.rate_hz;
+    const float corner = M_PI * p.radius_m;
+    const float knots[] = {p.straight_m / 2, p.straight_m / 2 + corner, p.straight_m * 1.5f + corner,
+                           p.straight_m * 1.5f + 2 * corner};
+    for (float k : knots) {
+        if (fabs(s - k) < segment) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The trace LapDelta::record() keeps of a lap, for the scan
+static void recordTrace(std::vector<delta_point_t> &trace, enu_t pos, uint32_t ms)
+{
+    enu_t last = {trace.back().e, trace.back().n};
+    if (enuDistance(last, pos) >= DELTA_STEP_M) {
+        trace.push_back({pos.e, pos.n, ms});
+    }
+}
+
+// Nearest segment of the whole trace, the delta at the fix projected onto it
+static bool scanDelta(const std::vector<delta_point_t> &ref, enu_t pos, uint32_t elapsedMs, int32_t *delta)
+{
+    float best = INFINITY;
+    float refMs = 0;
+    for (size_t i = 0; i + 1 < ref.size(); i++) {
+        const delta_point_t &a = ref[i];
+        const delta_point_t &b = ref[i + 1];
+        float se = b.e - a.e;
+        float sn = b.n - a.n;
+        float pe = pos.e - a.e;
+        float pn = pos.n - a.n;
+        float len2 = se * se + sn * sn;
+        float t = len2 > 0 ? (pe * se + pn * sn) / len2 : 1.0f;
+        t = t < 0 ? 0 : (t > 1 ? 1 : t);
+        float de = pe - t * se;
+        float dn = pn - t * sn;
+        float off2 = de * de + dn * dn;
+        if (off2 < best) {
+            best = off2;
+            refMs = a.ms + t * (float)(b.ms - a.ms);
+        }
+    }
+    if (best > DELTA_MAX_OFFSET_M * DELTA_MAX_OFFSET_M) {
+        return false;
+    }
+    *delta = (int32_t)elapsedMs - (int32_t)lroundf(refMs);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    if (!benchArgs(argc, argv)) {
+        return 2;
+    }
+    session_params_t params = sessionDefaults(SESSION_LAPS);
+    RaceBoxSession session(params);
+    TrackFrame frame;
+    frame.set(params.lat, params.lon);
+
+    // The finish line is the same work for both, it is done once here
+    std::vector<bench_fix_t> fixes;
+    LapGate finish;
+    finish.set(frame.project(params.lat, params.lon), 0);
+    int crossings = -1;
+    for (uint32_t i = 0; i < session.fixCount(); i++) {
+        rbx_fix_t fix;
+        session.fix(i, &fix);
+        bench_fix_t f;
+        f.pos = frame.project(fix.lat, fix.lon);
+        f.itow = fix.itow_ms;
+        f.finish = finish.update(f.pos, f.itow, &f.cross);
+        crossings += f.finish;
+        f.lap = crossings < 0 ? 0 : crossings;
+        fixes.push_back(f);
+    }
+
+    hostSerialMute(true);
+    LapDelta delta;
+    if (!delta.begin()) {
+        printf("FAIL: no memory for the traces\n");
+        return 1;
+    }
+    delta.setOrigin(params.lat, params.lon);
+    hostSerialMute(false);
+
+    std::vector<int32_t> cursorDeltas;
+    std::vector<uint8_t> refLaps;
+    double cursorNs = benchNs([&] {
+        cursorDeltas.clear();
+        refLaps.clear();
+        delta.clearReference();
+        bool running = false;
+        uint32_t lapStart = 0;
+        uint8_t refLap = 0;
+        for (const bench_fix_t &f : fixes) {
+            if (f.finish) {
+                if (running && delta.finishLap(gpsTimeDiff(f.cross, lapStart))) {
+                    refLap = f.lap - 1;
+                }
+                lapStart = f.cross;
+                delta.startLap(true);
+                running = true;
+            } else if (running) {
+                delta.update(f.pos, gpsTimeDiff(f.itow, lapStart));
+            }
+            cursorDeltas.push_back(delta.valid() ? delta.delta() : INT32_MIN);
+            refLaps.push_back(delta.hasReference() ? refLap : UINT8_MAX);
+        }
+        benchKeep(cursorDeltas);
+    }) / fixes.size();
+
+    // The same laps recorded the same way, every fix against every segment
+    std::vector<int32_t> scanDeltas;
+    double scanNs = benchNs([&] {
+        scanDeltas.clear();
+        std::vector<delta_point_t> ref;
+        std::vector<delta_point_t> rec;
+        uint32_t refMs = 0;
+        bool running = false;
+        uint32_t lapStart = 0;
+        for (const bench_fix_t &f : fixes) {
+            int32_t d = INT32_MIN;
+            if (f.finish) {
+                uint32_t lapMs = gpsTimeDiff(f.cross, lapStart);
+                if (running && (ref.empty() || lapMs < refMs)) {
+                    rec.push_back({0, 0, lapMs});
+                    ref.swap(rec);
+                    refMs = lapMs;
+                }
+                lapStart = f.cross;
+                rec.assign(1, {0, 0, 0});
+                running = true;
+            } else if (running) {
+                uint32_t elapsed = gpsTimeDiff(f.itow, lapStart);
+                recordTrace(rec, f.pos, elapsed);
+                if (!ref.empty() && !scanDelta(ref, f.pos, elapsed, &d)) {
+                    d = INT32_MIN;
+                }
+            }
+            scanDeltas.push_back(d);
+        }
+        benchKeep(scanDeltas);
+    }) / fixes.size();
+
+    // Against the exact delta, on every fix of a lap with a reference
+    int failures = 0;
+    uint32_t checked = 0;
+    uint32_t invalid = 0;
+    uint32_t differ = 0;
+    double worst = 0;
+    double worstKnot = 0;
+    for (size_t i = 0; i < fixes.size(); i++) {
+        const bench_fix_t &f = fixes[i];
+        if (f.finish || refLaps[i] == UINT8_MAX || f.lap >= session.laps()) {
+            continue;
+        }
+        checked++;
+        if (cursorDeltas[i] == INT32_MIN) {
+            invalid++;
+            continue;
+        }
+        differ += cursorDeltas[i] != scanDeltas[i];
+        uint8_t ref = refLaps[i];
+        float s = distanceAt(session, f.lap, f.itow);
+        double exact = (f.itow - session.timeAt(f.lap, 0)) - (session.timeAt(ref, s) - session.timeAt(ref, 0));
+        double &w = nearKnot(params, s) ? worstKnot : worst;
+        w = std::max(w, fabs(cursorDeltas[i] - exact));
+    }
+
+    double minutes = (fixes.back().itow - fixes.front().itow) / 60000.0;
+    printf("%.1f min, %zu fixes at %u Hz, %u laps, reference lap %u\n", minutes, fixes.size(), params.rate_hz,
+           session.laps(), refLaps.back() + 1);
+    printf("%-8s %10s %14s\n", "delta", "ns/fix", "session ms");
+    printf("%-8s %10.1f %14.3f\n", "cursor", cursorNs, cursorNs * fixes.size() / 1e6);
+    printf("%-8s %10.1f %14.3f\n", "scan", scanNs, scanNs * fixes.size() / 1e6);
+    printf("%u fixes checked, %u without a delta, %u differ from the scan\n", checked, invalid, differ);
+    printf("worst error %.3f ms, %.3f ms at a corner entry or exit\n", worst, worstKnot);
+    delta.printStats(Serial);
+
+    if (minutes < 20.0 || checked < fixes.size() * 9 / 10) {
+        printf("FAIL: %.1f min session, %u fixes with a reference\n", minutes, checked);
+        failures++;
+    }
+    if (invalid || differ) {
+        printf("FAIL: the cursor lost the reference line\n");
+        failures++;
+    }
+    // Both crossings are rounded to the millisecond, and a segment across a speed step
+    // puts the kink of the pace at worst in its middle
+    float slowest = *std::min_element(params.corner_mps.begin(), params.corner_mps.end());
+    double knotBound = 2.0 + (DELTA_STEP_M + params.straight_mps / params.rate_hz) / 4 *
+                       (1000.0 / slowest - 1000.0 / params.straight_mps);
+    if (worst > 2.0 || worstKnot > knotBound) {
+        printf("FAIL: delta off by %.3f ms, %.3f ms at a corner (%.3f ms allowed)\n", worst, worstKnot, knotBound);
+        failures++;
+    }
+    return failures ? 1 : 0;
+}
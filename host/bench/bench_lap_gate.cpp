@@ -0,0 +1,73 @@
+/*
+ * LapGate of the sketch on a five lap synthetic session at 25 Hz: the time of one
+ * update with the projection done once per fix beforehand, the way the sketch feeds
+ * it, and the lap times it gives against the exact ones of the session. Next to it the
+ * lap times taken at the first fix past the line, which is what the gate's
+ * interpolation replaced, to show what the millisecond resolution is worth.
+ */
+#include "HostBench.h"
+#include "RaceBoxSession.h"
+#include "LapGate.h"
+#include <vector>
+
+int main(int argc, char **argv)
+{
+    if (!benchArgs(argc, argv)) {
+        return 2;
+    }
+    session_params_t params = sessionDefaults(5);
+    RaceBoxSession session(params);
+    TrackFrame frame;
+    frame.set(params.lat, params.lon);
+
+    std::vector<enu_t> positions;
+    std::vector<uint32_t> itows;
+    for (uint32_t i = 0; i < session.fixCount(); i++) {
+        rbx_fix_t fix;
+        session.fix(i, &fix);
+        positions.push_back(frame.project(fix.lat, fix.lon));
+        itows.push_back(fix.itow_ms);
+    }
+
+    LapGate gate;
+    std::vector<uint32_t> interpolated;
+    std::vector<uint32_t> atFix;
+    double ns = benchNs([&] {
+        gate.set(frame.project(params.lat, params.lon), 0);
+        interpolated.clear();
+        atFix.clear();
+        for (size_t i = 0; i < positions.size(); i++) {
+            uint32_t cross;
+            if (gate.update(positions[i], itows[i], &cross)) {
+                interpolated.push_back(cross);
+                atFix.push_back(itows[i]);
+            }
+        }
+        benchKeep(interpolated);
+    }) / positions.size();
+
+    int failures = 0;
+    if (interpolated.size() != session.laps() + 1u) {
+        printf("FAIL: %zu crossings, expected %u\n", interpolated.size(), session.laps() + 1u);
+        return 1;
+    }
+    double worstInterpolated = 0;
+    double worstAtFix = 0;
+    printf("%-4s %12s %14s %12s\n", "lap", "exact ms", "interpolated", "at fix");
+    for (uint8_t lap = 0; lap < session.laps(); lap++) {
+        double exact = session.lapTime(lap);
+        double a = gpsTimeDiff(interpolated[lap + 1], interpolated[lap]) - exact;
+        double b = gpsTimeDiff(atFix[lap + 1], atFix[lap]) - exact;
+        printf("%-4u %12.3f %+14.3f %+12.3f\n", lap + 1, exact, a, b);
+        worstInterpolated = std::max(worstInterpolated, fabs(a));
+        worstAtFix = std::max(worstAtFix, fabs(b));
+    }
+    printf("update %.1f ns/fix, worst lap error %.3f ms interpolated, %.3f ms at the fix\n", ns,
+           worstInterpolated, worstAtFix);
+    // Each crossing is rounded to the millisecond
+    if (worstInterpolated > 1.0) {
+        printf("FAIL: interpolated lap times are off by more than 1 ms\n");
+        failures++;
+    }
+    return failures ? 1 : 0;
+}
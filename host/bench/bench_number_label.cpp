@@ -0,0 +1,115 @@
+/*
+ * lv_number_label against the lv_label it replaced for the HUD digits. A lap timer
+ * ticking every 10 ms and a speed changing every fix are set on each label and the
+ * 126 x 126 viewport screen is refreshed after every update, the way the HUD loop
+ * does. Reports the time per update, render included, and the pixels flushed.
+ */
+#include "HostBench.h"
+#include "HostRuntime.h"
+#include "LV_NumberLabel.h"
+#include <vector>
+
+#define SCREEN_SIZE     126
+
+static lv_disp_draw_buf_t draw_buf;
+static lv_disp_drv_t disp_drv;
+static std::vector<lv_color_t> buffer(SCREEN_SIZE * SCREEN_SIZE);
+static uint64_t flushed;
+
+static void flush(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p)
+{
+    (void)color_p;
+    flushed += (uint64_t)lv_area_get_width(area) * lv_area_get_height(area);
+    lv_disp_flush_ready(drv);
+}
+
+static void lapText(uint32_t i, char *text, size_t size)
+{
+    uint32_t ms = 31470 + i * 10;
+    snprintf(text, size, "%u:%02u.%02u", ms / 60000, (ms / 1000) % 60, (ms % 1000) / 10);
+}
+
+static void speedText(uint32_t i, char *text, size_t size)
+{
+    uint32_t tenths = 1234 + (i % 50) * 3;
+    snprintf(text, size, "%u.%u*", tenths / 10, tenths % 10);
+}
+
+typedef void (*text_fn_t)(uint32_t, char *, size_t);
+
+typedef struct {
+    double ns;
+    double pixels;
+} result_t;
+
+static result_t run(lv_obj_t *obj, bool number, text_fn_t text)
+{
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_HIDDEN);
+    uint32_t i = 0;
+    flushed = 0;
+    uint64_t updates = 0;
+    double ns = benchNs([&] {
+        char buf[16];
+        text(i++, buf, sizeof(buf));
+        if (number) {
+            lv_number_label_set_text(obj, buf);
+        } else {
+            lv_label_set_text(obj, buf);
+        }
+        lv_refr_now(NULL);
+        updates++;
+    });
+    lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+    lv_refr_now(NULL);
+    result_t r = {ns, (double)flushed / updates};
+    return r;
+}
+
+int main(int argc, char **argv)
+{
+    if (!benchArgs(argc, argv)) {
+        return 2;
+    }
+    lv_init();
+    lv_disp_draw_buf_init(&draw_buf, buffer.data(), NULL, buffer.size());
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.hor_res = SCREEN_SIZE;
+    disp_drv.ver_res = SCREEN_SIZE;
+    disp_drv.flush_cb = flush;
+    disp_drv.draw_buf = &draw_buf;
+    lv_disp_drv_register(&disp_drv);
+    lv_obj_set_style_bg_color(lv_scr_act(), lv_color_black(), 0);
+
+    // The HUD's digits: montserrat 16, 8 cells, white, centred left of the lens
+    lv_obj_t *label = lv_label_create(lv_scr_act());
+    lv_obj_set_style_text_font(label, &lv_font_montserrat_16, 0);
+    lv_obj_set_style_text_color(label, lv_color_white(), 0);
+    lv_obj_align(label, LV_ALIGN_CENTER, -25, -29);
+    lv_obj_add_flag(label, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_t *digits = lv_number_label_create(lv_scr_act(), &lv_font_montserrat_16, 8);
+    lv_obj_set_style_text_color(digits, lv_color_white(), 0);
+    lv_obj_align(digits, LV_ALIGN_CENTER, -25, -29);
+    lv_obj_add_flag(digits, LV_OBJ_FLAG_HIDDEN);
+    lv_refr_now(NULL);
+
+    const struct {
+        const char *name;
+        text_fn_t text;
+    } cases[] = {
+        {"lap timer", lapText},
+        {"speed", speedText},
+    };
+    int failures = 0;
+    printf("%-10s %14s %14s %14s %14s %8s\n", "case", "label ns", "number ns", "label px", "number px", "speedup");
+    for (const auto &c : cases) {
+        result_t l = run(label, false, c.text);
+        result_t n = run(digits, true, c.text);
+        printf("%-10s %14.0f %14.0f %14.0f %14.0f %7.2fx\n", c.name, l.ns, n.ns, l.pixels, n.pixels, l.ns / n.ns);
+        // Only the changed cells are invalidated, never more than the whole label
+        if (n.pixels > l.pixels) {
+            printf("FAIL: %s flushes more pixels with lv_number_label\n", c.name);
+            failures++;
+        }
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,152 @@
+/*
+ * rbxDecode() of the sketch against the extraction it replaced: parseUBXPacket() found
+ * the sync bytes in each notification and assembled every field it used from single
+ * bytes with shifts and ors. The reference here does the same for the groups of the
+ * mask, at the offsets of the protocol description (parseUBXPacket read the time at 8
+ * and the fix at 26 to 29, which rbxDecode corrected), so both must give the same fix.
+ * Timed with the groups the HUD decodes, HUD_FIX_FIELDS of the sketch, and with all of
+ * them, over the data messages of a host session.
+ */
+#include "HostBench.h"
+#include "RaceBoxData.h"
+#include "RaceBoxSession.h"
+#include "UbxFramer.h"
+#include <vector>
+
+// HUD_FIX_FIELDS of Simple_Display_123.ino
+#define BENCH_HUD_FIELDS (RBX_F_TIME | RBX_F_FIX | RBX_F_POSITION | RBX_F_ACCURACY | RBX_F_MOTION | RBX_F_BATTERY)
+
+static uint32_t le32(const uint8_t *p)
+{
+    return (uint32_t)(p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24));
+}
+
+static uint16_t le16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+// The parseUBXPacket() way: scan for the header, then byte by byte from the frame start
+static bool shiftDecode(const uint8_t *data, size_t length, uint32_t mask, rbx_fix_t *fix)
+{
+    for (size_t i = 0; i + 8 <= length; i++) {
+        if (data[i] != 0xB5 || data[i + 1] != 0x62) {
+            continue;
+        }
+        uint16_t payloadLen = (data[i + 5] << 8) | data[i + 4];
+        if (data[i + 2] != 0xFF || data[i + 3] != 0x01 || payloadLen < RACEBOX_PAYLOAD_LEN ||
+            i + 6 + payloadLen > length) {
+            continue;
+        }
+        const uint8_t *p = data + i + 6;
+        if (mask & RBX_F_TIME) {
+            fix->itow_ms = le32(p);
+            fix->year = le16(p + 4);
+            fix->month = p[6];
+            fix->day = p[7];
+            fix->hour = p[8];
+            fix->minute = p[9];
+            fix->second = p[10];
+            fix->validity = p[11];
+            fix->time_acc_ns = le32(p + 12);
+            fix->nano = (int32_t)le32(p + 16);
+            fix->datetime_flags = p[22];
+        }
+        if (mask & RBX_F_FIX) {
+            fix->fix_status = p[20];
+            fix->fix_flags = p[21];
+            fix->num_sv = p[23];
+        }
+        if (mask & RBX_F_POSITION) {
+            fix->lon = (int32_t)le32(p + 24);
+            fix->lat = (int32_t)le32(p + 28);
+            fix->latlon_flags = p[66];
+        }
+        if (mask & RBX_F_ALTITUDE) {
+            fix->alt_wgs_mm = (int32_t)le32(p + 32);
+            fix->alt_msl_mm = (int32_t)le32(p + 36);
+        }
+        if (mask & RBX_F_ACCURACY) {
+            fix->h_acc_mm = le32(p + 40);
+            fix->v_acc_mm = le32(p + 44);
+            fix->speed_acc_mm_s = le32(p + 56);
+            fix->heading_acc = le32(p + 60);
+        }
+        if (mask & RBX_F_MOTION) {
+            fix->speed_mm_s = (int32_t)le32(p + 48);
+            fix->heading = (int32_t)le32(p + 52);
+        }
+        if (mask & RBX_F_DOP) {
+            fix->pdop = le16(p + 64);
+        }
+        if (mask & RBX_F_BATTERY) {
+            fix->battery = p[67];
+        }
+        if (mask & RBX_F_IMU) {
+            for (int k = 0; k < 3; k++) {
+                fix->g_mg[k] = (int16_t)le16(p + 68 + 2 * k);
+                fix->rot_cdps[k] = (int16_t)le16(p + 74 + 2 * k);
+            }
+        }
+        fix->mask = mask & RBX_F_ALL;
+        return true;
+    }
+    return false;
+}
+
+int main(int argc, char **argv)
+{
+    if (!benchArgs(argc, argv)) {
+        return 2;
+    }
+    RaceBoxSession session(sessionDefaults(1));
+    const uint32_t count = 500;
+    std::vector<uint8_t> frames(count * SESSION_FRAME_SIZE);
+    for (uint32_t i = 0; i < count; i++) {
+        rbx_fix_t fix;
+        session.fix(i, &fix);
+        rbxEncodeFrame(fix, &frames[i * SESSION_FRAME_SIZE]);
+    }
+
+    const struct {
+        const char *name;
+        uint32_t mask;
+    } cases[] = {
+        {"hud", BENCH_HUD_FIELDS},
+        {"all", RBX_F_ALL},
+    };
+
+    int failures = 0;
+    printf("%-6s %14s %14s %8s\n", "fields", "shift ns/msg", "decode ns/msg", "speedup");
+    for (const auto &c : cases) {
+        std::vector<rbx_fix_t> shifted(count);
+        std::vector<rbx_fix_t> decoded(count);
+        memset(shifted.data(), 0, count * sizeof(rbx_fix_t));
+        memset(decoded.data(), 0, count * sizeof(rbx_fix_t));
+        uint32_t shiftOk = 0;
+        uint32_t decodeOk = 0;
+        double shiftNs = benchNs([&] {
+            shiftOk = 0;
+            for (uint32_t i = 0; i < count; i++) {
+                shiftOk += shiftDecode(&frames[i * SESSION_FRAME_SIZE], SESSION_FRAME_SIZE, c.mask, &shifted[i]);
+            }
+            benchKeep(shifted);
+        }) / count;
+        double decodeNs = benchNs([&] {
+            decodeOk = 0;
+            for (uint32_t i = 0; i < count; i++) {
+                decodeOk += rbxDecode(&frames[i * SESSION_FRAME_SIZE + UBX_HEADER_SIZE], RACEBOX_PAYLOAD_LEN,
+                                      c.mask, &decoded[i]);
+            }
+            benchKeep(decoded);
+        }) / count;
+        printf("%-6s %14.2f %14.2f %7.2fx\n", c.name, shiftNs, decodeNs, shiftNs / decodeNs);
+
+        if (shiftOk != count || decodeOk != count ||
+            memcmp(shifted.data(), decoded.data(), count * sizeof(rbx_fix_t)) != 0) {
+            printf("FAIL: %s fields, rbxDecode and the shift and or extraction give another fix\n", c.name);
+            failures++;
+        }
+    }
+    return failures ? 1 : 0;
+}
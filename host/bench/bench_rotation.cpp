@@ -0,0 +1,184 @@
+/*
+ * Software rotation of src/LilyGo_Rotation.cpp against the plain per pixel transpose
+ * it replaced, on the blocks the T-Glass flushes: the full logical 294 x 126 screen and
+ * an LVGL band of 40 rows. The naive loop walks the source by column, one cache line
+ * per pixel; the tiles keep the rows they touch in cache and move pixel pairs.
+ *
+ * The 8-bit indexed flush (LV_COLOR_DEPTH 8) on the same blocks: expand_index8 against
+ * the per pixel palette lookup, and rotate_index8_cw/ccw against the naive lookup and
+ * transpose and against expanding to RGB565 first and rotating that, the two passes
+ * the fused kernel saves.
+ */
+#include "HostBench.h"
+#include "LilyGo_Rotation.h"
+#include <vector>
+
+static void naiveCw(const uint16_t *src, uint16_t *dst, uint32_t width, uint32_t height)
+{
+    uint32_t index = 0;
+    for (uint32_t j = 0; j < width; j++) {
+        for (uint32_t i = 0; i < height; i++) {
+            dst[index++] = src[width * (height - i - 1) + j];
+        }
+    }
+}
+
+static void naiveCcw(const uint16_t *src, uint16_t *dst, uint32_t width, uint32_t height)
+{
+    uint32_t index = 0;
+    for (uint32_t j = 0; j < width; j++) {
+        for (uint32_t i = 0; i < height; i++) {
+            dst[index++] = src[width * i + (width - 1 - j)];
+        }
+    }
+}
+
+typedef void (*rotate_fn_t)(const uint16_t *, uint16_t *, uint32_t, uint32_t);
+
+static void naiveExpand(const uint8_t *src, uint16_t *dst, uint32_t len, const uint16_t *palette)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        dst[i] = palette[src[i]];
+    }
+}
+
+static void naiveIndex8Cw(const uint8_t *src, uint16_t *dst, uint32_t width, uint32_t height, const uint16_t *palette)
+{
+    uint32_t index = 0;
+    for (uint32_t j = 0; j < width; j++) {
+        for (uint32_t i = 0; i < height; i++) {
+            dst[index++] = palette[src[width * (height - i - 1) + j]];
+        }
+    }
+}
+
+static void naiveIndex8Ccw(const uint8_t *src, uint16_t *dst, uint32_t width, uint32_t height, const uint16_t *palette)
+{
+    uint32_t index = 0;
+    for (uint32_t j = 0; j < width; j++) {
+        for (uint32_t i = 0; i < height; i++) {
+            dst[index++] = palette[src[width * i + (width - 1 - j)]];
+        }
+    }
+}
+
+typedef void (*rotate_index8_fn_t)(const uint8_t *, uint16_t *, uint32_t, uint32_t, const uint16_t *);
+
+// Indexed blocks, returns the number of kernels that gave other pixels than the naive loops
+static int benchIndex8(const uint32_t sizes[][2], size_t count)
+{
+    const struct {
+        const char *name;
+        rotate_index8_fn_t naive;
+        rotate_index8_fn_t fused;
+        rotate_fn_t rotate;
+    } cases[] = {
+        {"cw", naiveIndex8Cw, rotate_index8_cw, rotate_rgb565_cw},
+        {"ccw", naiveIndex8Ccw, rotate_index8_ccw, rotate_rgb565_ccw},
+    };
+    uint16_t palette[256];
+    for (uint32_t i = 0; i < 256; i++) {
+        palette[i] = (uint16_t)(i * 0x0101 ^ 0x5A3C);
+    }
+
+    int failures = 0;
+    printf("\n%-7s %-9s %12s %12s %12s %8s\n", "index8", "block", "naive ns", "two pass ns", "fused ns", "speedup");
+    for (size_t n = 0; n < count; n++) {
+        uint32_t width = sizes[n][0];
+        uint32_t height = sizes[n][1];
+        std::vector<uint8_t> src(width * height);
+        for (uint32_t i = 0; i < src.size(); i++) {
+            src[i] = (uint8_t)(i * 2654435761u >> 24);
+        }
+        std::vector<uint16_t> want(src.size());
+        std::vector<uint16_t> expanded(src.size());
+        std::vector<uint16_t> dst(src.size());
+        char block[16];
+        snprintf(block, sizeof(block), "%ux%u", width, height);
+
+        double naive = benchNs([&] {
+            naiveExpand(src.data(), want.data(), src.size(), palette);
+            benchKeep(want[0]);
+        });
+        double expand = benchNs([&] {
+            expand_index8(src.data(), dst.data(), src.size(), palette);
+            benchKeep(dst[0]);
+        });
+        printf("%-7s %-9s %12.0f %12s %12.0f %7.2fx\n", "expand", block, naive, "-", expand, naive / expand);
+        if (dst != want) {
+            printf("FAIL: expand %s differs from the palette lookup\n", block);
+            failures++;
+        }
+
+        for (const auto &c : cases) {
+            naive = benchNs([&] {
+                c.naive(src.data(), want.data(), width, height, palette);
+                benchKeep(want[0]);
+            });
+            double twoPass = benchNs([&] {
+                expand_index8(src.data(), expanded.data(), src.size(), palette);
+                c.rotate(expanded.data(), dst.data(), width, height);
+                benchKeep(dst[0]);
+            });
+            bool twoPassRight = dst == want;
+            double fused = benchNs([&] {
+                c.fused(src.data(), dst.data(), width, height, palette);
+                benchKeep(dst[0]);
+            });
+            printf("%-7s %-9s %12.0f %12.0f %12.0f %7.2fx\n", c.name, block, naive, twoPass, fused, naive / fused);
+            if (dst != want || !twoPassRight) {
+                printf("FAIL: index8 %s %s differs from the naive lookup and transpose\n", c.name, block);
+                failures++;
+            }
+        }
+    }
+    return failures;
+}
+
+int main(int argc, char **argv)
+{
+    if (!benchArgs(argc, argv)) {
+        return 2;
+    }
+    const uint32_t sizes[][2] = {{294, 126}, {294, 40}};
+    const struct {
+        const char *name;
+        rotate_fn_t naive;
+        rotate_fn_t tiled;
+    } cases[] = {
+        {"cw", naiveCw, rotate_rgb565_cw},
+        {"ccw", naiveCcw, rotate_rgb565_ccw},
+    };
+
+    int failures = 0;
+    printf("%-4s %-9s %12s %12s %8s\n", "dir", "block", "naive ns", "tiled ns", "speedup");
+    for (const uint32_t *size : sizes) {
+        uint32_t width = size[0];
+        uint32_t height = size[1];
+        std::vector<uint16_t> src(width * height);
+        for (uint32_t i = 0; i < src.size(); i++) {
+            src[i] = (uint16_t)(i * 2654435761u >> 16);
+        }
+        std::vector<uint16_t> want(src.size());
+        std::vector<uint16_t> dst(src.size());
+        for (const auto &c : cases) {
+            double naive = benchNs([&] {
+                c.naive(src.data(), want.data(), width, height);
+                benchKeep(want[0]);
+            });
+            double tiled = benchNs([&] {
+                c.tiled(src.data(), dst.data(), width, height);
+                benchKeep(dst[0]);
+            });
+            char block[16];
+            snprintf(block, sizeof(block), "%ux%u", width, height);
+            printf("%-4s %-9s %12.0f %12.0f %7.2fx\n", c.name, block, naive, tiled, naive / tiled);
+            if (dst != want) {
+                printf("FAIL: %s %s differs from the naive transpose\n", c.name, block);
+                failures++;
+            }
+        }
+    }
+    failures += benchIndex8(sizes, sizeof(sizes) / sizeof(sizes[0]));
+    return failures ? 1 : 0;
+}
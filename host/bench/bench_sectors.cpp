@@ -0,0 +1,122 @@
+/*
+ * SectorTimer of the sketch against testing every split gate on every fix, on a five
+ * lap session at 25 Hz with 1, 3 and 7 split gates. The timer only watches the next
+ * gate, so its cost per fix stays that of one LapGate whatever the number of splits;
+ * the scan grows with them. Both must time the same sectors.
+ */
+#include "HostBench.h"
+#include "HostRuntime.h"
+#include "RaceBoxSession.h"
+#include "Sectors.h"
+#include <vector>
+
+typedef struct {
+    enu_t pos;
+    uint32_t itow;
+    bool finish;                // Crossed the finish line, at cross
+    uint32_t cross;
+} bench_fix_t;
+
+int main(int argc, char **argv)
+{
+    if (!benchArgs(argc, argv)) {
+        return 2;
+    }
+    session_params_t params = sessionDefaults(5);
+    RaceBoxSession session(params);
+    TrackFrame frame;
+    frame.set(params.lat, params.lon);
+
+    // The finish line is the same work for both, it is done once here
+    std::vector<bench_fix_t> fixes;
+    LapGate finish;
+    finish.set(frame.project(params.lat, params.lon), 0);
+    for (uint32_t i = 0; i < session.fixCount(); i++) {
+        rbx_fix_t fix;
+        session.fix(i, &fix);
+        bench_fix_t f;
+        f.pos = frame.project(fix.lat, fix.lon);
+        f.itow = fix.itow_ms;
+        f.finish = finish.update(f.pos, f.itow, &f.cross);
+        fixes.push_back(f);
+    }
+
+    const std::vector<std::vector<float>> layouts = {
+        {400.0f},
+        {100.0f, 400.0f, 850.0f},
+        {25.0f, 75.0f, 125.0f, 350.0f, 450.0f, 550.0f, 850.0f},
+    };
+
+    int failures = 0;
+    printf("%-6s %14s %14s %8s\n", "splits", "timer ns/fix", "scan ns/fix", "ratio");
+    for (const std::vector<float> &layout : layouts) {
+        hostSerialMute(true);
+        SectorTimer timer;
+        std::vector<LapGate> gates(layout.size());
+        for (size_t k = 0; k < layout.size(); k++) {
+            float h;
+            int32_t lat;
+            int32_t lon;
+            session.toLatLon(session.position(layout[k], &h), &lat, &lon);
+            timer.addSplit(lat, lon, h);
+            gates[k].set(frame.project(lat, lon), h);
+        }
+        timer.setFrame(frame);
+        hostSerialMute(false);
+
+        std::vector<uint32_t> timed;
+        double timerNs = benchNs([&] {
+            timed.clear();
+            bool running = false;
+            for (const bench_fix_t &f : fixes) {
+                if (running && timer.update(f.pos, f.itow)) {
+                    timed.push_back(timer.lastTime());
+                }
+                if (f.finish) {
+                    if (running && timer.finishLap(f.cross)) {
+                        timed.push_back(timer.lastTime());
+                    }
+                    timer.startLap(f.cross, true);
+                    running = true;
+                }
+            }
+            benchKeep(timed);
+        }) / fixes.size();
+
+        // Every gate every fix, the crossing of the expected one closes its sector
+        std::vector<uint32_t> scanned;
+        double scanNs = benchNs([&] {
+            scanned.clear();
+            bool running = false;
+            size_t next = 0;
+            uint32_t start = 0;
+            for (const bench_fix_t &f : fixes) {
+                for (size_t k = 0; k < gates.size(); k++) {
+                    uint32_t cross;
+                    if (gates[k].update(f.pos, f.itow, &cross) && running && k == next) {
+                        scanned.push_back(gpsTimeDiff(cross, start));
+                        start = cross;
+                        next++;
+                    }
+                }
+                if (f.finish) {
+                    if (running && next == gates.size()) {
+                        scanned.push_back(gpsTimeDiff(f.cross, start));
+                    }
+                    start = f.cross;
+                    next = 0;
+                    running = true;
+                }
+            }
+            benchKeep(scanned);
+        }) / fixes.size();
+
+        printf("%-6zu %14.1f %14.1f %7.2fx\n", layout.size(), timerNs, scanNs, scanNs / timerNs);
+        // Splits in the lead-out are timed as well
+        if (timed != scanned || timed.size() < session.laps() * (layout.size() + 1)) {
+            printf("FAIL: %zu splits, %zu sectors timed, %zu scanned\n", layout.size(), timed.size(), scanned.size());
+            failures++;
+        }
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,172 @@
+/*
+ * TrackDb of the sketch on a database of 10000 tracks, the lookup detectTrack() does
+ * once a fix is good, against reading every record of the file. The tracks sit in
+ * venues of a few tracks each, spread over the inhabited latitudes; half the lookups
+ * are a few kilometres from a venue, the other half anywhere, mostly out of range of
+ * every track. The grid index must read a handful of records whatever the size of the
+ * file and find the same track as the full scan.
+ */
+#include "HostBench.h"
+#include "HostRuntime.h"
+#include "RaceBoxSession.h"
+#include "TrackDb.h"
+#include <LittleFS.h>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+#define BENCH_TRACKS            10000
+#define BENCH_VENUE_TRACKS      4       // Layouts sharing a venue, within a kilometre
+#define BENCH_LOOKUPS           1000
+
+typedef struct {
+    int32_t lat;
+    int32_t lon;
+} bench_point_t;
+
+// The point east / north metres from p, on a sphere: the positions only need to be spread
+static bench_point_t offset(bench_point_t p, double e, double n)
+{
+    const double mPerE7 = 0.0111319491;
+    double lat = p.lat + n / mPerE7;
+    double lon = p.lon + e / (mPerE7 * cos(lat * 1e-7 * M_PI / 180.0));
+    bench_point_t q = {(int32_t)llround(lat), (int32_t)llround(lon)};
+    return q;
+}
+
+// Every record of the file, the nearest finish line within TRACKDB_MATCH_RANGE_M
+static bool scanNearest(fs::File &file, int32_t lat, int32_t lon, trackdb_track_t *track, uint32_t *reads)
+{
+    trackdb_header_t header;
+    if (!file.seek(0) || file.read((uint8_t *)&header, sizeof(header)) != sizeof(header)) {
+        return false;
+    }
+    *reads = 0;
+    TrackFrame here;
+    here.set(lat, lon);
+    bool found = false;
+    float best = TRACKDB_MATCH_RANGE_M;
+    trackdb_track_t t;
+    file.seek(sizeof(header) + header.cells * sizeof(trackdb_cell_t));
+    for (uint32_t i = 0; i < header.tracks; i++) {
+        (*reads)++;
+        if (file.read((uint8_t *)&t, sizeof(t)) != sizeof(t)) {
+            break;
+        }
+        float d = enuLength(here.project(t.lat, t.lon));
+        if (d <= best) {
+            best = d;
+            *track = t;
+            found = true;
+        }
+    }
+    return found;
+}
+
+int main(int argc, char **argv)
+{
+    if (!benchArgs(argc, argv)) {
+        return 2;
+    }
+    const char *fsDir = "bench_trackdb_fs";
+    std::error_code ec;
+    std::filesystem::remove_all(fsDir, ec);
+    hostFsRoot(fsDir);
+
+    std::mt19937 rng(20251017);
+    std::uniform_real_distribution<double> latDeg(-55.0, 65.0);
+    std::uniform_real_distribution<double> lonDeg(-179.0, 179.0);
+    std::uniform_real_distribution<double> venueM(-1000.0, 1000.0);
+    std::vector<trackdb_track_t> tracks;
+    std::vector<bench_point_t> venues;
+    while (tracks.size() < BENCH_TRACKS) {
+        bench_point_t venue = {(int32_t)llround(latDeg(rng) * 1e7), (int32_t)llround(lonDeg(rng) * 1e7)};
+        venues.push_back(venue);
+        for (int k = 0; k < BENCH_VENUE_TRACKS && tracks.size() < BENCH_TRACKS; k++) {
+            trackdb_track_t t;
+            memset(&t, 0, sizeof(t));
+            snprintf(t.name, sizeof(t.name), "Track %05zu", tracks.size());
+            bench_point_t p = offset(venue, venueM(rng), venueM(rng));
+            t.lat = p.lat;
+            t.lon = p.lon;
+            t.heading = NAN;
+            tracks.push_back(t);
+        }
+    }
+    if (!writeTrackDb((std::string(fsDir) + "/tracks.db").c_str(), tracks)) {
+        printf("FAIL: cannot write the track database\n");
+        return 1;
+    }
+
+    std::vector<bench_point_t> lookups;
+    std::uniform_real_distribution<double> nearM(-2000.0, 2000.0);
+    for (int i = 0; i < BENCH_LOOKUPS; i++) {
+        if (i % 2) {
+            lookups.push_back({(int32_t)llround(latDeg(rng) * 1e7), (int32_t)llround(lonDeg(rng) * 1e7)});
+            continue;
+        }
+        const bench_point_t &venue = venues[rng() % venues.size()];
+        lookups.push_back(offset(venue, nearM(rng), nearM(rng)));
+    }
+
+    fs::File file = LittleFS.open("/tracks.db", FILE_READ);
+    TrackDb db;
+    if (!file || !db.open(file) || db.count() != BENCH_TRACKS) {
+        printf("FAIL: cannot open the track database\n");
+        return 1;
+    }
+
+    std::vector<trackdb_track_t> indexed(lookups.size());
+    std::vector<bool> indexedFound(lookups.size());
+    uint32_t maxReads = 0;
+    uint64_t reads = 0;
+    double indexNs = benchNs([&] {
+        maxReads = 0;
+        reads = 0;
+        for (size_t i = 0; i < lookups.size(); i++) {
+            float dist;
+            indexedFound[i] = db.findNearest(lookups[i].lat, lookups[i].lon, &indexed[i], &dist);
+            trackdb_stats_t stats;
+            db.getStats(&stats);
+            maxReads = std::max(maxReads, stats.reads);
+            reads += stats.reads;
+        }
+        benchKeep(indexed);
+    }) / lookups.size();
+
+    std::vector<trackdb_track_t> scanned(lookups.size());
+    std::vector<bool> scannedFound(lookups.size());
+    uint32_t scanReads = 0;
+    double scanNs = benchNs([&] {
+        for (size_t i = 0; i < lookups.size(); i++) {
+            scannedFound[i] = scanNearest(file, lookups[i].lat, lookups[i].lon, &scanned[i], &scanReads);
+        }
+        benchKeep(scanned);
+    }) / lookups.size();
+
+    uint32_t matched = 0;
+    uint32_t differ = 0;
+    for (size_t i = 0; i < lookups.size(); i++) {
+        matched += indexedFound[i];
+        differ += indexedFound[i] != scannedFound[i] ||
+                  (indexedFound[i] && strcmp(indexed[i].name, scanned[i].name) != 0);
+    }
+
+    printf("%u tracks at %zu venues, %zu lookups, %u matched\n", db.count(), venues.size(), lookups.size(), matched);
+    printf("%-8s %12s %14s %12s\n", "lookup", "us/lookup", "reads/lookup", "max reads");
+    printf("%-8s %12.2f %14.1f %12u\n", "index", indexNs / 1e3, (double)reads / lookups.size(), maxReads);
+    printf("%-8s %12.2f %14.1f %12u\n", "scan", scanNs / 1e3, (double)scanReads, scanReads);
+
+    int failures = 0;
+    if (differ) {
+        printf("FAIL: %u lookups found another track than the scan\n", differ);
+        failures++;
+    }
+    // Every lookup near a venue is within 4.3 km of each of its finish lines
+    if (matched < lookups.size() / 2) {
+        printf("FAIL: %u of %zu lookups near a venue matched\n", matched, lookups.size() / 2);
+        failures++;
+    }
+    std::filesystem::remove_all(fsDir, ec);
+    return failures ? 1 : 0;
+}
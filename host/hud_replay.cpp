@@ -0,0 +1,314 @@
+/*
+ * Runs the Simple_Display_123 sketch on the host and replays a RaceBox session through
+ * it: setup(), then 'x' on serial and loop() until the replay ends, exactly the path
+ * the serial replay command takes on the glasses. The panel is a LilyGo_FrameBuffer.
+ *
+ * Without --capture the session is the synthetic stadium of RaceBoxSession.h with a
+ * track database holding its finish line and split gates, so the track is detected at
+ * the first fix and every lap time is known: each one has to match within 2 ms. After
+ * the second lap the boot button is held until the HUD shows the live delta.
+ *
+ * --screens then draws every display mode with the state the replay left and writes
+ * the viewport of each to dir/screenNN.raw, panel order RGB565 row by row, for
+ * test_hud_depth to compare the RGB565 and the 8-bit indexed build. LVGL only
+ * antialiases above 8-bit color, so the RGB565 build renders without it there.
+ *
+ *   hud_replay [--fs dir] [--capture session.rbx] [--laps n] [--ppm out.ppm] [--screens dir] [--verbose]
+ *
+ * Exits non-zero if a lap is missing or off, the replay did not run faster than real
+ * time or the viewport stayed black.
+ */
+#include "HostRuntime.h"
+#include "RaceBoxSession.h"
+#include <chrono>
+#include <filesystem>
+
+// Arduino generates these for the sketch, it uses functions before defining them
+#include <LilyGo_Wristband.h>
+#include <LV_Helper.h>
+#include <LilyGo_BootTimeline.h>
+#include <LV_NumberLabel.h>
+#include <LV_BoundLabel.h>
+#include "NimBLEDevice.h"
+#include "RaceBoxCapture.h"
+#include "RaceBoxReplay.h"
+#include "UbxFramer.h"
+#include "TelemetryQueue.h"
+
+void performSystemReset();
+void saveReferenceLap();
+void showSectorDelta();
+void checkLapCrossing(const rbx_fix_t &fix);
+void setFinishGate();
+void loadReferenceLap();
+void addSplitGate();
+void saveFinishLine();
+void loadFinishLine();
+void openTrackDb();
+void detectTrack();
+void serviceFinishLineCapture();
+void showDigits(bool digits);
+void setDisplayFont(bool useLargeFont);
+void handleLongPress();
+void handleDoubleTap();
+void initializeBLESequence();
+void startRaceBoxScan(uint32_t seconds);
+void setup();
+void loop();
+void updateDisplayContent();
+void updateConnectionStatus();
+void handleBLEStateMachine();
+static void handleUbxFrame(uint8_t msgClass, uint8_t msgId, const uint8_t *payload, uint16_t len, void *user);
+static void processFix(const gnss_fix_t &fix);
+void processTelemetry();
+void parseUBXPacket(uint8_t *data, size_t length);
+void printUbxStats();
+static void replayLapStage();
+static void replayDisplayStage();
+void toggleCapture();
+void startReplay(float speed);
+void serviceReplay();
+bool connectToRaceBox();
+void readLinkParams();
+void checkLinkParams();
+
+#include "../examples/GlassV2/Simple_Display_123/Simple_Display_123.ino"
+
+#define LAP_TOLERANCE_MS        2
+#define BUTTON_HOLD_MS          600     // Over longPressDuration
+#define BUTTON_GAP_MS           100
+#define MAX_PRESSES             10
+
+namespace stdfs = std::filesystem;
+
+// Split gates mid back straight and halfway down the last straight, both exact crossings
+static void writeSessionTrackDb(const RaceBoxSession &session, const session_params_t &p, const char *path)
+{
+    trackdb_track_t track;
+    memset(&track, 0, sizeof(track));
+    strlcpy(track.name, "Host Stadium", sizeof(track.name));
+    track.lat = p.lat;
+    track.lon = p.lon;
+    track.heading = 0;
+    float at[] = {p.straight_m / 2 + (float)M_PI * p.radius_m + p.straight_m / 2,
+                  session.lapLength() - p.straight_m / 4
+                 };
+    for (float s : at) {
+        float heading;
+        enu_t pos = session.position(s, &heading);
+        split_gate_t split;
+        session.toLatLon(pos, &split.lat, &split.lon);
+        split.heading = heading;
+        track.split[track.splits++] = split;
+    }
+    writeTrackDb(path, {track});
+}
+
+// Every display mode drawn in turn, as if the RaceBox was still connected
+static bool writeScreens(const char *dir)
+{
+    std::error_code ec;
+    stdfs::remove_all(dir, ec);
+    stdfs::create_directories(dir, ec);
+    currentState = STATE_CONNECTED;
+    for (int mode = DISPLAY_SPEED; mode <= DISPLAY_RESET_CONFIRM; mode++) {
+        currentDisplayMode = (DisplayMode)mode;
+        updateDisplayContent();
+        hostAdvance(100);
+        char path[256];
+        snprintf(path, sizeof(path), "%s/screen%02d.raw", dir, mode);
+        FILE *f = fopen(path, "wb");
+        if (!f) {
+            return false;
+        }
+        for (uint16_t y = GLASS_VIEWPORT_Y; y < GLASS_VIEWPORT_Y + GLASS_VIEWPORT_HEIGHT; y++) {
+            for (uint16_t x = GLASS_VIEWPORT_X; x < GLASS_VIEWPORT_X + GLASS_VIEWPORT_WIDTH; x++) {
+                uint16_t pixel = amoled.getPixel(x, y);
+                fwrite(&pixel, sizeof(pixel), 1, f);
+            }
+        }
+        if (fclose(f) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    const char *fsDir = "hud_replay_fs";
+    const char *capturePath = nullptr;
+    const char *ppmPath = nullptr;
+    const char *screensDir = nullptr;
+    int laps = 5;
+    bool verbose = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--fs") && i + 1 < argc) {
+            fsDir = argv[++i];
+        } else if (!strcmp(argv[i], "--capture") && i + 1 < argc) {
+            capturePath = argv[++i];
+        } else if (!strcmp(argv[i], "--laps") && i + 1 < argc) {
+            laps = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--ppm") && i + 1 < argc) {
+            ppmPath = argv[++i];
+        } else if (!strcmp(argv[i], "--screens") && i + 1 < argc) {
+            screensDir = argv[++i];
+        } else if (!strcmp(argv[i], "--verbose")) {
+            verbose = true;
+        } else {
+            fprintf(stderr, "usage: %s [--fs dir] [--capture session.rbx] [--laps n] [--ppm out.ppm] [--screens dir] [--verbose]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // A fresh flash every run, nothing left over from the last one
+    std::error_code ec;
+    stdfs::remove_all(fsDir, ec);
+    hostFsRoot(fsDir);
+    std::string sessionFile = std::string(fsDir) + CAPTURE_FILE;
+    session_params_t params = sessionDefaults(laps);
+    RaceBoxSession session(params);
+    if (capturePath) {
+        stdfs::copy_file(capturePath, sessionFile, ec);
+        if (ec) {
+            fprintf(stderr, "Cannot copy %s: %s\n", capturePath, ec.message().c_str());
+            return 1;
+        }
+    } else {
+        session.writeCapture(sessionFile.c_str());
+        writeSessionTrackDb(session, params, (std::string(fsDir) + TRACKDB_FILE).c_str());
+    }
+
+    hostSerialMute(!verbose);
+    auto wallStart = std::chrono::steady_clock::now();
+    setup();
+    if (screensDir) {
+        lvglLock();
+        lv_disp_get_default()->driver->antialiasing = 0;
+        lv_obj_invalidate(lv_scr_act());
+        lvglUnlock();
+    }
+
+    hostSerialInput("x");
+    loop();
+    if (!replay.active()) {
+        hostSerialMute(false);
+        fprintf(stderr, "Replay did not start\n");
+        return 1;
+    }
+    uint64_t simStart = hostMicros();
+
+    std::vector<uint32_t> lapTimes;
+    uint32_t lastSeen = 0;
+    int presses = 0;
+    uint32_t pressAt = 0;
+    uint32_t releaseAt = 0;
+    bool pressed = false;
+    bool reachedLiveDelta = false;
+    framebuffer_stats_t liveStart = {};
+    framebuffer_stats_t liveEnd = {};
+    while (replay.active()) {
+        loop();
+        if (lastLapTime != lastSeen) {
+            lastSeen = lastLapTime;
+            lapTimes.push_back(lastLapTime);
+        }
+
+        // Long presses through the lap screens until the live delta shows
+        uint32_t now = millis();
+        if (currentDisplayMode == DISPLAY_LIVE_DELTA && !reachedLiveDelta) {
+            reachedLiveDelta = true;
+            amoled.getStats(&liveStart);
+        }
+        if (reachedLiveDelta && currentDisplayMode == DISPLAY_LIVE_DELTA) {
+            amoled.getStats(&liveEnd);
+        }
+        if (lapTimes.size() >= 2 && !reachedLiveDelta && presses < MAX_PRESSES) {
+            if (!pressed && now - releaseAt >= BUTTON_GAP_MS) {
+                hostSetPin(BOARD_BOOT_PIN, LOW);
+                pressed = true;
+                pressAt = now;
+            } else if (pressed && now - pressAt >= BUTTON_HOLD_MS) {
+                hostSetPin(BOARD_BOOT_PIN, HIGH);
+                pressed = false;
+                releaseAt = now;
+                presses++;
+            }
+        } else if (pressed) {
+            hostSetPin(BOARD_BOOT_PIN, HIGH);
+            pressed = false;
+        }
+    }
+    // Let the LVGL task render the last state
+    hostAdvance(100);
+
+    double simS = (hostMicros() - simStart) / 1e6;
+    double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    hostSerialMute(false);
+
+    int failures = 0;
+    printf("Replayed %u messages, %.1f s of session in %.2f s (%.1fx real time)\n",
+           replay.messages(), simS, wallS, simS / wallS);
+    if (simS <= wallS) {
+        printf("FAIL: slower than real time\n");
+        failures++;
+    }
+
+    for (size_t i = 0; i < lapTimes.size(); i++) {
+        printf("Lap %zu: %u ms", i + 1, lapTimes[i]);
+        if (!capturePath) {
+            double expected = session.lapTime(i);
+            bool ok = i < session.laps() && fabs(lapTimes[i] - expected) <= LAP_TOLERANCE_MS;
+            printf(", expected %.1f ms%s", expected, ok ? "" : " FAIL");
+            failures += !ok;
+        }
+        printf("\n");
+    }
+    if (!capturePath) {
+        if (lapTimes.size() != session.laps()) {
+            printf("FAIL: %zu laps timed, the session has %u\n", lapTimes.size(), session.laps());
+            failures++;
+        }
+        if (session.laps() > 2) {
+            printf("Live delta: %s after %d presses, %u pixels pushed while shown\n",
+                   reachedLiveDelta ? "shown" : "NOT shown", presses, liveEnd.pixels - liveStart.pixels);
+            if (!reachedLiveDelta || liveEnd.pixels == liveStart.pixels) {
+                printf("FAIL: the live delta screen was not reached or never drawn\n");
+                failures++;
+            }
+        }
+        printf("Sectors: %u per lap, theoretical best %u ms\n", sectors.sectors(), sectors.theoreticalBest());
+    }
+
+    uint32_t lit = 0;
+    for (uint16_t y = GLASS_VIEWPORT_Y; y < GLASS_VIEWPORT_Y + GLASS_VIEWPORT_HEIGHT; y++) {
+        for (uint16_t x = GLASS_VIEWPORT_X; x < GLASS_VIEWPORT_X + GLASS_VIEWPORT_WIDTH; x++) {
+            lit += amoled.getPixel(x, y) != 0;
+        }
+    }
+    printf("Viewport: %u of %d pixels lit\n", lit, GLASS_VIEWPORT_WIDTH * GLASS_VIEWPORT_HEIGHT);
+    if (!lit) {
+        printf("FAIL: blank viewport\n");
+        failures++;
+    }
+    if (ppmPath) {
+        File out(fopen(ppmPath, "wb"), ppmPath);
+        if (out) {
+            amoled.writePPM(out, true);
+            out.close();
+        }
+    }
+    if (screensDir) {
+        hostSerialMute(!verbose);
+        bool written = writeScreens(screensDir);
+        hostSerialMute(false);
+        if (!written) {
+            printf("FAIL: cannot write the screens to %s\n", screensDir);
+            failures++;
+        }
+    }
+
+    printf("%s\n", failures ? "FAILED" : "PASSED");
+    fflush(stdout);
+    return failures ? 1 : 0;
+}
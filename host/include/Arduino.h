@@ -0,0 +1,122 @@
+/*
+ * Host stand-in for the arduino-esp32 core.
+ *
+ * Just enough of the core for the library and the Simple_Display_123 sketch to build
+ * and run on Linux. Time is simulated: millis() and micros() only move when a task
+ * sleeps or blocks, see HostRuntime.h. The C part is also included by LVGL through
+ * lv_conf.h for the tick and the PSRAM allocator.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include "esp_arduino_version.h"
+#include "esp32-hal-psram.h"
+#include "esp32-hal-log.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "esp_sleep.h"
+
+#define HIGH                0x1
+#define LOW                 0x0
+#define INPUT               0x01
+#define OUTPUT              0x03
+#define PULLUP              0x04
+#define INPUT_PULLUP        0x05
+#define PULLDOWN            0x08
+#define INPUT_PULLDOWN      0x09
+#define OPEN_DRAIN          0x10
+
+#define RISING              0x01
+#define FALLING             0x02
+#define CHANGE              0x03
+
+#define PI                  3.1415926535897932384626433832795
+#define HALF_PI             1.5707963267948966192313216916398
+#define TWO_PI              6.283185307179586476925286766559
+#define DEG_TO_RAD          0.017453292519943295769236907684886
+#define RAD_TO_DEG          57.295779513082320876798154814105
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+
+#define lowByte(w)          ((uint8_t)((w) & 0xff))
+#define highByte(w)         ((uint8_t)((w) >> 8))
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef uint16_t word;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint32_t millis(void);
+uint32_t micros(void);
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield(void);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+uint16_t analogRead(uint8_t pin);
+void attachInterruptArg(uint8_t pin, void (*handler)(void *), void *arg, int mode);
+void detachInterrupt(uint8_t pin);
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration);
+
+// Touch pads never trigger on the host
+void touchAttachInterrupt(uint8_t pin, void (*handler)(void), uint16_t threshold);
+void touchDetachInterrupt(uint8_t pin);
+bool touchInterruptGetLastStatus(uint8_t pin);
+void touchSleepWakeUpEnable(uint8_t pin, uint16_t threshold);
+
+#if defined(__GLIBC__) && (__GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38))
+// newlib has it, older glibc does not
+static inline size_t strlcpy(char *dst, const char *src, size_t size)
+{
+    size_t len = strlen(src);
+    if (size) {
+        size_t n = len < size - 1 ? len : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return len;
+}
+#endif
+
+#ifdef __cplusplus
+}
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+using std::min;
+using std::max;
+using std::isnan;
+using std::isinf;
+
+#include "WString.h"
+#include "Stream.h"
+#include "HardwareSerial.h"
+#include "Esp.h"
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#endif
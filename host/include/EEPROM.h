@@ -0,0 +1,74 @@
+/*
+ * Host stand-in for the EEPROM emulation, kept in memory for the life of the program.
+ * Like the core, a new EEPROM reads as zeros.
+ */
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+
+class EEPROMClass
+{
+public:
+    bool begin(size_t size)
+    {
+        if (size > _data.size()) {
+            _data.resize(size, 0);
+        }
+        return true;
+    }
+    void end() {}
+    bool commit()
+    {
+        _commits++;
+        return true;
+    }
+
+    uint8_t read(int address)
+    {
+        return address >= 0 && (size_t)address < _data.size() ? _data[address] : 0;
+    }
+    void write(int address, uint8_t value)
+    {
+        if (address >= 0 && (size_t)address < _data.size()) {
+            _data[address] = value;
+        }
+    }
+    size_t length()
+    {
+        return _data.size();
+    }
+
+    template <typename T>
+    T &get(int address, T &t)
+    {
+        if (address >= 0 && address + sizeof(T) <= _data.size()) {
+            memcpy(&t, &_data[address], sizeof(T));
+        }
+        return t;
+    }
+    template <typename T>
+    const T &put(int address, const T &t)
+    {
+        if (address >= 0 && address + sizeof(T) <= _data.size()) {
+            memcpy(&_data[address], &t, sizeof(T));
+        }
+        return t;
+    }
+
+    // Host only: commits so far, and wiping it like nvs_flash_erase()
+    uint32_t commits()
+    {
+        return _commits;
+    }
+    void clear()
+    {
+        _data.assign(_data.size(), 0);
+    }
+
+private:
+    std::vector<uint8_t> _data;
+    uint32_t _commits = 0;
+};
+
+extern EEPROMClass EEPROM;
@@ -0,0 +1,24 @@
+/*
+ * Host stand-in for the ESP object
+ */
+#pragma once
+
+#include <stdint.h>
+
+class EspClass
+{
+public:
+    // Ends the host program, there is nothing to reboot into
+    void restart();
+
+    uint32_t getFreeHeap()
+    {
+        return 256 * 1024;
+    }
+    uint32_t getFreePsram()
+    {
+        return 8 * 1024 * 1024;
+    }
+};
+
+extern EspClass ESP;
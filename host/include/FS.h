@@ -0,0 +1,88 @@
+/*
+ * Host stand-in for the core file system API, files live in a host directory,
+ * see hostFsRoot() in HostRuntime.h
+ */
+#pragma once
+
+#include <Arduino.h>
+#include <memory>
+#include <string>
+
+#define FILE_READ       "r"
+#define FILE_WRITE      "w"
+#define FILE_APPEND     "a"
+
+namespace fs
+{
+
+enum SeekMode {
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+};
+
+// Copies share the open file like the core's File, close() closes it for all of them
+class File : public Stream
+{
+public:
+    File() {}
+    File(FILE *f, const char *path);
+
+    size_t write(uint8_t c);
+    size_t write(const uint8_t *buffer, size_t size);
+    using Print::write;
+
+    int available();
+    int read();
+    int peek();
+    size_t read(uint8_t *buffer, size_t size);
+    size_t readBytes(char *buffer, size_t length);
+    using Stream::readBytes;
+    void flush();
+
+    bool seek(uint32_t pos, SeekMode mode = SeekSet);
+    size_t position() const;
+    size_t size() const;
+    void close();
+    const char *path() const;
+    const char *name() const;
+    bool isDirectory() const
+    {
+        return false;
+    }
+
+    operator bool() const;
+
+private:
+    struct Handle {
+        FILE *f;
+        std::string path;
+        ~Handle();
+    };
+    std::shared_ptr<Handle> _h;
+};
+
+class FS
+{
+public:
+    virtual ~FS() {}
+
+    File open(const char *path, const char *mode = FILE_READ, bool create = false);
+    File open(const String &path, const char *mode = FILE_READ, bool create = false)
+    {
+        return open(path.c_str(), mode, create);
+    }
+    bool exists(const char *path);
+    bool remove(const char *path);
+    bool rename(const char *from, const char *to);
+    bool mkdir(const char *path);
+};
+
+}
+
+using fs::FS;
+using fs::File;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
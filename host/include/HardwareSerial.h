@@ -0,0 +1,33 @@
+/*
+ * Host stand-in for the USB serial port: output goes to stdout, input is whatever
+ * hostSerialInput() queued, see HostRuntime.h
+ */
+#pragma once
+
+#include "Stream.h"
+
+class HardwareSerial : public Stream
+{
+public:
+    void begin(unsigned long baud)
+    {
+        (void)baud;
+    }
+    void end() {}
+
+    int available();
+    int read();
+    int peek();
+    size_t write(uint8_t c);
+    size_t write(const uint8_t *buffer, size_t size);
+    void flush();
+
+    using Print::write;
+
+    operator bool() const
+    {
+        return true;
+    }
+};
+
+extern HardwareSerial Serial;
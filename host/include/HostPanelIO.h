@@ -0,0 +1,28 @@
+/*
+ * The SPI panel IO stand-in records every transfer instead of sending it, in the order
+ * the controller would see them. Tests decode the stream like the panel would: CASET
+ * and RASET set the window, RAMWR fills it.
+ *
+ * Color transfers are asynchronous like on the target: tx_color() queues them and a bus
+ * task completes them in order, each after the time it takes at pclk_hz, calling
+ * on_color_trans_done from there. Their bytes are logged when they complete. A
+ * command waits for the color transfers queued before it.
+ */
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+
+typedef struct {
+    int cmd;
+    std::vector<uint8_t> data;      // Parameters, or the pixel bytes of a color transfer
+    bool color;
+} host_spi_transfer_t;
+
+// Every transfer of every panel IO since the last hostSpiClear(). Both wait for the bus
+// to go idle first.
+const std::vector<host_spi_transfer_t> &hostSpiLog();
+void hostSpiClear();
+
+// Block the calling task until every queued color transfer has completed
+void hostSpiWaitIdle();
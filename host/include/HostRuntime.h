@@ -0,0 +1,31 @@
+/*
+ * Controls of the host runtime, for test drivers and benchmarks. Not part of the
+ * Arduino API.
+ *
+ * Time is simulated. The tasks share one core without preemption: the running task
+ * keeps the CPU until it sleeps (delay, vTaskDelay) or blocks (semaphore, queue,
+ * notification). Time then jumps to the earliest moment another task can run, so a
+ * sketch whose loop() ends in delay(10) runs as fast as the host can execute it, and
+ * two runs of the same input give the same output.
+ */
+#pragma once
+
+#include <Arduino.h>
+
+// Simulated time since the program started
+uint64_t hostMicros();
+
+// Let the other tasks run until the simulated clock reaches now + ms, like delay()
+void hostAdvance(uint32_t ms);
+
+// Level digitalRead() returns for a pin, every pin reads HIGH until set
+void hostSetPin(uint8_t pin, int level);
+
+// Bytes Serial.read() returns, appended to whatever is still queued
+void hostSerialInput(const char *text);
+
+// Drop everything written to Serial, e.g. for benchmarks
+void hostSerialMute(bool mute);
+
+// Host directory LittleFS works in, created if needed. Files in it survive the program.
+void hostFsRoot(const char *path);
@@ -0,0 +1,66 @@
+/*
+ * Host stand-in for the T-Glass board: the panel is a LilyGo_FrameBuffer, there are
+ * no sensors, and the boot button is host pin BOARD_BOOT_PIN, see hostSetPin().
+ * Sketches get it as LilyGo_Class exactly like the real header.
+ */
+#pragma once
+
+#include <Arduino.h>
+#include "LilyGo_FrameBuffer.h"
+
+#define BOARD_BOOT_PIN              (0)
+
+// The area visible through the T-GlassV2 prism, the same as the real board
+#define GLASS_VIEWPORT_X            (0)
+#define GLASS_VIEWPORT_Y            (168)
+#define GLASS_VIEWPORT_WIDTH        (126)
+#define GLASS_VIEWPORT_HEIGHT       (126)
+
+#define PANEL_QUEUE_DEPTH           (16)
+
+class LilyGo_HostGlass : public LilyGo_FrameBuffer
+{
+public:
+    LilyGo_HostGlass() : _brightness(0), _battery(100) {}
+
+    bool begin(bool waitSensors = true)
+    {
+        (void)waitSensors;
+        return LilyGo_FrameBuffer::begin();
+    }
+    void update() {}
+
+    void setBrightness(uint8_t level)
+    {
+        _brightness = level;
+    }
+    uint8_t getBrightness()
+    {
+        return _brightness;
+    }
+
+    // Flushes already complete synchronously, there is nothing to queue
+    bool enableCommandQueue(uint32_t depth = PANEL_QUEUE_DEPTH, BaseType_t core = 0)
+    {
+        (void)depth;
+        (void)core;
+        return true;
+    }
+
+    int getBatteryPercent()
+    {
+        return _battery;
+    }
+    void setBatteryPercent(int percent)
+    {
+        _battery = percent;
+    }
+
+private:
+    uint8_t _brightness;
+    int _battery;
+};
+
+#ifndef LilyGo_Class
+#define LilyGo_Class LilyGo_HostGlass
+#endif
@@ -0,0 +1,24 @@
+/*
+ * Host stand-in for LittleFS, the partition is the directory set with hostFsRoot()
+ */
+#pragma once
+
+#include "FS.h"
+
+namespace fs
+{
+
+class LittleFSFS : public FS
+{
+public:
+    bool begin(bool formatOnFail = false, const char *basePath = "/littlefs", uint8_t maxOpenFiles = 10,
+               const char *partitionLabel = "spiffs");
+    void end() {}
+    bool format();
+    size_t totalBytes();
+    size_t usedBytes();
+};
+
+}
+
+extern fs::LittleFSFS LittleFS;
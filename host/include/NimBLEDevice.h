@@ -0,0 +1,281 @@
+/*
+ * Host stand-in for the NimBLE-Arduino 1.4 central API the sketch uses.
+ *
+ * There is no radio on the host: scans report nothing and connects fail. Recorded
+ * sessions reach the same parse -> lap -> display path through RaceBoxReplay.
+ */
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+#include <list>
+#include <string>
+
+class NimBLEUUID
+{
+public:
+    NimBLEUUID(const char *uuid = "") : _uuid(uuid) {}
+    NimBLEUUID(const std::string &uuid) : _uuid(uuid) {}
+    std::string toString() const
+    {
+        return _uuid;
+    }
+    bool operator==(const NimBLEUUID &o) const
+    {
+        return _uuid == o._uuid;
+    }
+
+private:
+    std::string _uuid;
+};
+
+class NimBLEAddress
+{
+public:
+    NimBLEAddress() : _type(0) {}
+    NimBLEAddress(const std::string &address, uint8_t type = 0) : _address(address), _type(type) {}
+    std::string toString() const
+    {
+        return _address;
+    }
+    uint8_t getType() const
+    {
+        return _type;
+    }
+    bool operator==(const NimBLEAddress &o) const
+    {
+        return _address == o._address;
+    }
+
+private:
+    std::string _address;
+    uint8_t _type;
+};
+
+class NimBLEAdvertisedDevice
+{
+public:
+    std::string getName()
+    {
+        return "";
+    }
+    NimBLEAddress getAddress()
+    {
+        return NimBLEAddress();
+    }
+    int getRSSI()
+    {
+        return -127;
+    }
+    std::string toString()
+    {
+        return "";
+    }
+};
+
+class NimBLEAdvertisedDeviceCallbacks
+{
+public:
+    virtual ~NimBLEAdvertisedDeviceCallbacks() {}
+    virtual void onResult(NimBLEAdvertisedDevice *advertisedDevice) = 0;
+};
+
+class NimBLEScan
+{
+public:
+    void setAdvertisedDeviceCallbacks(NimBLEAdvertisedDeviceCallbacks *callbacks, bool wantDuplicates = false)
+    {
+        (void)callbacks;
+        (void)wantDuplicates;
+    }
+    void setInterval(uint16_t interval)
+    {
+        (void)interval;
+    }
+    void setWindow(uint16_t window)
+    {
+        (void)window;
+    }
+    void setActiveScan(bool active)
+    {
+        (void)active;
+    }
+    bool start(uint32_t duration, bool isContinue = false)
+    {
+        (void)duration;
+        (void)isContinue;
+        return true;
+    }
+    bool stop()
+    {
+        return true;
+    }
+};
+
+class NimBLERemoteCharacteristic;
+typedef std::function<void (NimBLERemoteCharacteristic *characteristic, uint8_t *data, size_t length, bool isNotify)> notify_callback;
+
+class NimBLERemoteCharacteristic
+{
+public:
+    uint16_t getHandle()
+    {
+        return 0;
+    }
+    bool canRead()
+    {
+        return false;
+    }
+    bool canNotify()
+    {
+        return false;
+    }
+    std::string readValue()
+    {
+        return "";
+    }
+    bool subscribe(bool notifications = true, notify_callback callback = nullptr, bool response = false)
+    {
+        (void)notifications;
+        (void)callback;
+        (void)response;
+        return false;
+    }
+};
+
+class NimBLERemoteService
+{
+public:
+    NimBLERemoteCharacteristic *getCharacteristic(const NimBLEUUID &uuid)
+    {
+        (void)uuid;
+        return nullptr;
+    }
+};
+
+class NimBLEConnInfo
+{
+public:
+    uint16_t getConnInterval()
+    {
+        return 0;
+    }
+    uint16_t getConnLatency()
+    {
+        return 0;
+    }
+    uint16_t getConnTimeout()
+    {
+        return 0;
+    }
+};
+
+class NimBLEClient;
+
+class NimBLEClientCallbacks
+{
+public:
+    virtual ~NimBLEClientCallbacks() {}
+    virtual void onConnect(NimBLEClient *client)
+    {
+        (void)client;
+    }
+    virtual void onDisconnect(NimBLEClient *client)
+    {
+        (void)client;
+    }
+};
+
+class NimBLEClient
+{
+public:
+    void setClientCallbacks(NimBLEClientCallbacks *callbacks, bool deleteCallbacks = true)
+    {
+        (void)deleteCallbacks;
+        _callbacks = callbacks;
+    }
+    NimBLEAddress getPeerAddress()
+    {
+        return _peer;
+    }
+    void setConnectTimeout(uint32_t seconds)
+    {
+        (void)seconds;
+    }
+    void setConnectionParams(uint16_t minInterval, uint16_t maxInterval, uint16_t latency, uint16_t timeout,
+                             uint16_t scanInterval = 16, uint16_t scanWindow = 16)
+    {
+        (void)minInterval;
+        (void)maxInterval;
+        (void)latency;
+        (void)timeout;
+        (void)scanInterval;
+        (void)scanWindow;
+    }
+    void updateConnParams(uint16_t minInterval, uint16_t maxInterval, uint16_t latency, uint16_t timeout)
+    {
+        setConnectionParams(minInterval, maxInterval, latency, timeout);
+    }
+    bool connect(NimBLEAdvertisedDevice *device, bool deleteAttributes = true)
+    {
+        return connect(device->getAddress(), deleteAttributes);
+    }
+    bool connect(const NimBLEAddress &address, bool deleteAttributes = true)
+    {
+        (void)deleteAttributes;
+        _peer = address;
+        return false;
+    }
+    int disconnect(uint8_t reason = 0x13)
+    {
+        (void)reason;
+        return 0;
+    }
+    bool isConnected()
+    {
+        return false;
+    }
+    NimBLERemoteService *getService(const NimBLEUUID &uuid)
+    {
+        (void)uuid;
+        return nullptr;
+    }
+    uint16_t getMTU()
+    {
+        return 23;
+    }
+    NimBLEConnInfo getConnInfo()
+    {
+        return NimBLEConnInfo();
+    }
+
+private:
+    NimBLEClientCallbacks *_callbacks = nullptr;
+    NimBLEAddress _peer;
+};
+
+class NimBLEDevice
+{
+public:
+    static void init(const std::string &deviceName)
+    {
+        (void)deviceName;
+    }
+    static void deinit(bool clearAll = false);
+    static bool setMTU(uint16_t mtu)
+    {
+        (void)mtu;
+        return true;
+    }
+    static NimBLEScan *getScan();
+    static NimBLEClient *createClient();
+    static std::list<NimBLEClient *> *getClientList();
+    static bool deleteAllBonds()
+    {
+        return true;
+    }
+};
+
+typedef NimBLEUUID BLEUUID;
+typedef NimBLEAddress BLEAddress;
+typedef NimBLERemoteCharacteristic BLERemoteCharacteristic;
@@ -0,0 +1,65 @@
+/*
+ * Host stand-in for Preferences, every namespace is kept in memory for the life of
+ * the program and wiped by nvs_flash_erase()
+ */
+#pragma once
+
+#include <Arduino.h>
+#include <map>
+#include <string>
+#include <vector>
+
+class Preferences
+{
+public:
+    bool begin(const char *name, bool readOnly = false);
+    void end();
+    bool clear();
+    bool remove(const char *key);
+    bool isKey(const char *key);
+
+    size_t putUChar(const char *key, uint8_t value)
+    {
+        return putBytes(key, &value, sizeof(value));
+    }
+    size_t putUShort(const char *key, uint16_t value)
+    {
+        return putBytes(key, &value, sizeof(value));
+    }
+    size_t putUInt(const char *key, uint32_t value)
+    {
+        return putBytes(key, &value, sizeof(value));
+    }
+    size_t putString(const char *key, const char *value)
+    {
+        return putBytes(key, value, strlen(value) + 1);
+    }
+    size_t putBytes(const char *key, const void *value, size_t len);
+
+    uint8_t getUChar(const char *key, uint8_t defaultValue = 0)
+    {
+        return getValue(key, defaultValue);
+    }
+    uint16_t getUShort(const char *key, uint16_t defaultValue = 0)
+    {
+        return getValue(key, defaultValue);
+    }
+    uint32_t getUInt(const char *key, uint32_t defaultValue = 0)
+    {
+        return getValue(key, defaultValue);
+    }
+    size_t getString(const char *key, char *value, size_t maxLen);
+    size_t getBytesLength(const char *key);
+    size_t getBytes(const char *key, void *buf, size_t maxLen);
+
+private:
+    template <typename T>
+    T getValue(const char *key, T defaultValue)
+    {
+        T value;
+        return getBytesLength(key) == sizeof(T) && getBytes(key, &value, sizeof(T)) ? value : defaultValue;
+    }
+
+    std::map<std::string, std::vector<uint8_t>> *_ns = nullptr;
+    bool _readOnly = false;
+};
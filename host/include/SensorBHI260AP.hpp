@@ -0,0 +1,26 @@
+/*
+ * Host stand-in for the SensorLib motion sensor, it is never found
+ */
+#pragma once
+
+#include <SPI.h>
+
+class SensorBHI260AP
+{
+public:
+    void setPins(int rst, int irq)
+    {
+        (void)rst;
+        (void)irq;
+    }
+    bool init(SPIClass &spi, int cs, int mosi, int miso, int sck)
+    {
+        (void)spi;
+        (void)cs;
+        (void)mosi;
+        (void)miso;
+        (void)sck;
+        return false;
+    }
+    void update() {}
+};
@@ -0,0 +1,16 @@
+/*
+ * Host stand-in for the SensorLib RTC, it is never found
+ */
+#pragma once
+
+#include <Wire.h>
+
+class SensorPCF85063
+{
+public:
+    bool init(TwoWire &wire)
+    {
+        (void)wire;
+        return false;
+    }
+};
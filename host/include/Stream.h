@@ -0,0 +1,160 @@
+/*
+ * Host stand-in for Print and Stream.
+ *
+ * printf widens 32-bit integer arguments to long before formatting. The sketches print
+ * uint32_t with %lu, which is the same width on the ESP32 but not on a 64-bit host.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "WString.h"
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class Print
+{
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size)
+    {
+        size_t n = 0;
+        while (size-- && write(*buffer++)) {
+            n++;
+        }
+        return n;
+    }
+    size_t write(const char *str)
+    {
+        return str ? write((const uint8_t *)str, strlen(str)) : 0;
+    }
+    size_t write(const char *buffer, size_t size)
+    {
+        return write((const uint8_t *)buffer, size);
+    }
+    virtual void flush() {}
+
+    size_t print(const char *s)
+    {
+        return write(s);
+    }
+    size_t print(const String &s)
+    {
+        return write(s.c_str());
+    }
+    size_t print(char c)
+    {
+        return write((uint8_t)c);
+    }
+    size_t print(unsigned char v, int base = DEC)
+    {
+        return printNumber(v, base);
+    }
+    size_t print(int v, int base = DEC)
+    {
+        return printSigned(v, base);
+    }
+    size_t print(unsigned int v, int base = DEC)
+    {
+        return printNumber(v, base);
+    }
+    size_t print(long v, int base = DEC)
+    {
+        return printSigned(v, base);
+    }
+    size_t print(unsigned long v, int base = DEC)
+    {
+        return printNumber(v, base);
+    }
+    size_t print(long long v, int base = DEC)
+    {
+        return printSigned(v, base);
+    }
+    size_t print(unsigned long long v, int base = DEC)
+    {
+        return printNumber(v, base);
+    }
+    size_t print(double v, int digits = 2)
+    {
+        return printf("%.*f", digits, v);
+    }
+
+    size_t println()
+    {
+        return write("\r\n");
+    }
+    template <typename T>
+    size_t println(T v)
+    {
+        size_t n = print(v);
+        return n + println();
+    }
+    template <typename T>
+    size_t println(T v, int format)
+    {
+        size_t n = print(v, format);
+        return n + println();
+    }
+
+    template <typename... Args>
+    size_t printf(const char *format, Args... args)
+    {
+        return printWidened(format, widen(args)...);
+    }
+
+private:
+    template <typename T>
+    static T widen(T v)
+    {
+        return v;
+    }
+    static long widen(int v)
+    {
+        return v;
+    }
+    static unsigned long widen(unsigned int v)
+    {
+        return v;
+    }
+
+    size_t printWidened(const char *format, ...);
+    size_t printNumber(unsigned long long v, int base);
+    size_t printSigned(long long v, int base);
+};
+
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long timeout)
+    {
+        _timeout = timeout;
+    }
+
+    // Nothing arrives while the host waits, so this returns what is there
+    virtual size_t readBytes(char *buffer, size_t length)
+    {
+        size_t n = 0;
+        int c;
+        while (n < length && (c = read()) >= 0) {
+            buffer[n++] = (char)c;
+        }
+        return n;
+    }
+    size_t readBytes(uint8_t *buffer, size_t length)
+    {
+        return readBytes((char *)buffer, length);
+    }
+
+protected:
+    unsigned long _timeout = 1000;
+};
@@ -0,0 +1,157 @@
+/*
+ * Host stand-in for the Arduino String, the members the library and sketches use
+ */
+#pragma once
+
+#include <stdio.h>
+#include <ctype.h>
+#include <string>
+
+class String
+{
+public:
+    String(const char *s = "") : _s(s ? s : "") {}
+    String(const std::string &s) : _s(s) {}
+    String(char c) : _s(1, c) {}
+    String(int v) : _s(std::to_string(v)) {}
+    String(unsigned int v) : _s(std::to_string(v)) {}
+    String(long v) : _s(std::to_string(v)) {}
+    String(unsigned long v) : _s(std::to_string(v)) {}
+    String(float v, unsigned int decimals = 2) : _s(format(v, decimals)) {}
+    String(double v, unsigned int decimals = 2) : _s(format(v, decimals)) {}
+
+    const char *c_str() const
+    {
+        return _s.c_str();
+    }
+    unsigned int length() const
+    {
+        return _s.length();
+    }
+    bool isEmpty() const
+    {
+        return _s.empty();
+    }
+    char charAt(unsigned int i) const
+    {
+        return i < _s.length() ? _s[i] : 0;
+    }
+    char operator[](unsigned int i) const
+    {
+        return charAt(i);
+    }
+
+    int indexOf(const String &s, unsigned int from = 0) const
+    {
+        size_t pos = _s.find(s._s, from);
+        return pos == std::string::npos ? -1 : (int)pos;
+    }
+    int indexOf(char c, unsigned int from = 0) const
+    {
+        size_t pos = _s.find(c, from);
+        return pos == std::string::npos ? -1 : (int)pos;
+    }
+    bool startsWith(const String &s) const
+    {
+        return _s.compare(0, s._s.length(), s._s) == 0;
+    }
+    String substring(unsigned int from) const
+    {
+        return from < _s.length() ? String(_s.substr(from)) : String();
+    }
+    String substring(unsigned int from, unsigned int to) const
+    {
+        return from < to && from < _s.length() ? String(_s.substr(from, to - from)) : String();
+    }
+
+    void toLowerCase()
+    {
+        for (char &c : _s) {
+            c = tolower((unsigned char)c);
+        }
+    }
+    void toUpperCase()
+    {
+        for (char &c : _s) {
+            c = toupper((unsigned char)c);
+        }
+    }
+    void trim()
+    {
+        size_t b = _s.find_first_not_of(" \t\r\n");
+        size_t e = _s.find_last_not_of(" \t\r\n");
+        _s = b == std::string::npos ? std::string() : _s.substr(b, e - b + 1);
+    }
+    long toInt() const
+    {
+        return strtol(_s.c_str(), NULL, 10);
+    }
+    float toFloat() const
+    {
+        return strtof(_s.c_str(), NULL);
+    }
+
+    String &operator+=(const String &s)
+    {
+        _s += s._s;
+        return *this;
+    }
+    String &operator+=(const char *s)
+    {
+        _s += s;
+        return *this;
+    }
+    String &operator+=(char c)
+    {
+        _s += c;
+        return *this;
+    }
+    bool concat(const String &s)
+    {
+        _s += s._s;
+        return true;
+    }
+
+    friend String operator+(const String &a, const String &b)
+    {
+        return String(a._s + b._s);
+    }
+    friend String operator+(const String &a, const char *b)
+    {
+        return String(a._s + b);
+    }
+    friend String operator+(const char *a, const String &b)
+    {
+        return String(a + b._s);
+    }
+    bool operator==(const String &s) const
+    {
+        return _s == s._s;
+    }
+    bool operator==(const char *s) const
+    {
+        return _s == s;
+    }
+    bool operator!=(const String &s) const
+    {
+        return _s != s._s;
+    }
+    bool operator!=(const char *s) const
+    {
+        return _s != s;
+    }
+    bool equals(const String &s) const
+    {
+        return _s == s._s;
+    }
+
+private:
+    static std::string format(double v, unsigned int decimals)
+    {
+        char buf[48];
+        snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+        return buf;
+    }
+
+    std::string _s;
+};
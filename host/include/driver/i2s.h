@@ -0,0 +1,83 @@
+/*
+ * Host stand-in for the legacy I2S driver, the microphone never installs
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+#define I2S_PIN_NO_CHANGE           (-1)
+#define ESP_INTR_FLAG_LEVEL1        (1 << 1)
+
+typedef enum {
+    I2S_NUM_0 = 0,
+    I2S_NUM_1 = 1,
+} i2s_port_t;
+
+typedef enum {
+    I2S_MODE_MASTER = 1 << 0,
+    I2S_MODE_SLAVE = 1 << 1,
+    I2S_MODE_TX = 1 << 2,
+    I2S_MODE_RX = 1 << 3,
+    I2S_MODE_PDM = 1 << 6,
+} i2s_mode_t;
+
+typedef enum {
+    I2S_BITS_PER_SAMPLE_16BIT = 16,
+} i2s_bits_per_sample_t;
+
+typedef enum {
+    I2S_CHANNEL_FMT_ONLY_RIGHT = 3,
+} i2s_channel_fmt_t;
+
+typedef enum {
+    I2S_COMM_FORMAT_STAND_PCM_SHORT = 0x04,
+} i2s_comm_format_t;
+
+typedef struct {
+    i2s_mode_t mode;
+    uint32_t sample_rate;
+    i2s_bits_per_sample_t bits_per_sample;
+    i2s_channel_fmt_t channel_format;
+    i2s_comm_format_t communication_format;
+    int intr_alloc_flags;
+    int dma_buf_count;
+    int dma_buf_len;
+    bool use_apll;
+} i2s_config_t;
+
+typedef struct {
+    int mck_io_num;
+    int bck_io_num;
+    int ws_io_num;
+    int data_out_num;
+    int data_in_num;
+} i2s_pin_config_t;
+
+static inline esp_err_t i2s_driver_install(i2s_port_t port, const i2s_config_t *config, int queue_size, void *queue)
+{
+    (void)port;
+    (void)config;
+    (void)queue_size;
+    (void)queue;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+static inline esp_err_t i2s_set_pin(i2s_port_t port, const i2s_pin_config_t *pins)
+{
+    (void)port;
+    (void)pins;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+static inline esp_err_t i2s_read(i2s_port_t port, void *dest, size_t size, size_t *bytes_read, TickType_t ticks)
+{
+    (void)port;
+    (void)dest;
+    (void)size;
+    (void)ticks;
+    *bytes_read = 0;
+    return ESP_ERR_NOT_SUPPORTED;
+}
@@ -0,0 +1,13 @@
+/*
+ * Host stand-in for the core log macros, CORE_DEBUG_LEVEL=2 like platformio.ini:
+ * errors and warnings are printed, info and debug are not
+ */
+#pragma once
+
+#include <stdio.h>
+
+#define log_e(format, ...)  printf("[E][%s:%d] %s(): " format "\n", __FILE__, __LINE__, __func__, ##__VA_ARGS__)
+#define log_w(format, ...)  printf("[W][%s:%d] %s(): " format "\n", __FILE__, __LINE__, __func__, ##__VA_ARGS__)
+#define log_i(format, ...)  do {} while (0)
+#define log_d(format, ...)  do {} while (0)
+#define log_v(format, ...)  do {} while (0)
@@ -0,0 +1,36 @@
+/*
+ * Host stand-in: PSRAM is ordinary heap memory
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline void *ps_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+static inline void *ps_calloc(size_t n, size_t size)
+{
+    return calloc(n, size);
+}
+
+static inline void *ps_realloc(void *ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+static inline bool psramFound(void)
+{
+    return true;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,10 @@
+/*
+ * Host stand-in: the versions the library is built against on the glasses,
+ * arduino-esp32 2.0.14 on ESP-IDF 4.4.6
+ */
+#pragma once
+
+#define ESP_ARDUINO_VERSION_VAL(major, minor, patch)    ((major << 16) | (minor << 8) | (patch))
+#define ESP_ARDUINO_VERSION                             ESP_ARDUINO_VERSION_VAL(2, 0, 14)
+
+#include "esp_idf_version.h"
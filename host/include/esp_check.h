@@ -0,0 +1,33 @@
+/*
+ * Host stand-in for the ESP-IDF error check macros
+ */
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "esp_err.h"
+#include "esp32-hal-log.h"
+
+#define ESP_ERROR_CHECK(x) do {                                                 \
+        esp_err_t err_rc_ = (x);                                                \
+        if (err_rc_ != ESP_OK) {                                                \
+            fprintf(stderr, "ESP_ERROR_CHECK failed: 0x%x at %s:%d\n",           \
+                    err_rc_, __FILE__, __LINE__);                               \
+            abort();                                                            \
+        }                                                                       \
+    } while (0)
+
+#define ESP_GOTO_ON_FALSE(a, err_code, goto_tag, log_tag, format, ...) do {     \
+        if (!(a)) {                                                             \
+            log_e("%s: " format, log_tag, ##__VA_ARGS__);                       \
+            ret = err_code;                                                     \
+            goto goto_tag;                                                      \
+        }                                                                       \
+    } while (0)
+
+#define ESP_RETURN_ON_FALSE(a, err_code, log_tag, format, ...) do {             \
+        if (!(a)) {                                                             \
+            log_e("%s: " format, log_tag, ##__VA_ARGS__);                       \
+            return err_code;                                                    \
+        }                                                                       \
+    } while (0)
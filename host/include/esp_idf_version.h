@@ -0,0 +1,7 @@
+/*
+ * Host stand-in, see esp_arduino_version.h
+ */
+#pragma once
+
+#define ESP_IDF_VERSION_VAL(major, minor, patch)        ((major << 16) | (minor << 8) | (patch))
+#define ESP_IDF_VERSION                                 ESP_IDF_VERSION_VAL(4, 4, 6)
@@ -0,0 +1,26 @@
+/*
+ * Host stand-in for the ESP-IDF 4.4 panel operations, they dispatch to the driver
+ */
+#pragma once
+
+#include "esp_lcd_panel_interface.h"
+
+static inline esp_err_t esp_lcd_panel_reset(esp_lcd_panel_handle_t panel)
+{
+    return panel->reset(panel);
+}
+
+static inline esp_err_t esp_lcd_panel_init(esp_lcd_panel_handle_t panel)
+{
+    return panel->init(panel);
+}
+
+static inline esp_err_t esp_lcd_panel_del(esp_lcd_panel_handle_t panel)
+{
+    return panel ? panel->del(panel) : ESP_OK;
+}
+
+static inline esp_err_t esp_lcd_panel_draw_bitmap(esp_lcd_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end, const void *color_data)
+{
+    return panel->draw_bitmap(panel, x_start, y_start, x_end, y_end, color_data);
+}
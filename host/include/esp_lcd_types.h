@@ -0,0 +1,16 @@
+/*
+ * Host stand-in for the ESP-IDF 4.4 LCD driver types
+ */
+#pragma once
+
+#include <stdint.h>
+
+typedef struct esp_lcd_panel_io_t *esp_lcd_panel_io_handle_t;
+typedef struct esp_lcd_panel_t *esp_lcd_panel_handle_t;
+typedef int esp_lcd_spi_bus_handle_t;
+
+typedef enum {
+    ESP_LCD_COLOR_SPACE_RGB,
+    ESP_LCD_COLOR_SPACE_BGR,
+    ESP_LCD_COLOR_SPACE_MONOCHROME,
+} esp_lcd_color_space_t;
@@ -0,0 +1,18 @@
+/*
+ * Host stand-in: there is nothing to sleep, esp_deep_sleep_start() ends the program
+ * like ESP.restart()
+ */
+#pragma once
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+esp_err_t esp_sleep_enable_touchpad_wakeup(void);
+void esp_deep_sleep_start(void);
+
+#ifdef __cplusplus
+}
+#endif
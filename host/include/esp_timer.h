@@ -0,0 +1,16 @@
+/*
+ * Host stand-in: microseconds of simulated time since the host program started
+ */
+#pragma once
+
+#include <Arduino.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int64_t esp_timer_get_time(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,58 @@
+/*
+ * Host stand-in for the FreeRTOS types and port macros.
+ *
+ * Tasks are threads, but only one of them runs at a time and switches happen only when
+ * the running task sleeps or blocks, like a single core without preemption. A tick is a
+ * millisecond of simulated time, see HostRuntime.h. Critical sections have nothing to
+ * protect and compile to nothing.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void (*TaskFunction_t)(void *);
+
+typedef struct host_task_t *TaskHandle_t;
+typedef struct host_queue_t *QueueHandle_t;
+typedef QueueHandle_t SemaphoreHandle_t;
+
+#define pdFALSE                 ((BaseType_t)0)
+#define pdTRUE                  ((BaseType_t)1)
+#define pdPASS                  pdTRUE
+#define pdFAIL                  pdFALSE
+#define errQUEUE_FULL           ((BaseType_t)0)
+
+#define portMAX_DELAY           ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS      ((TickType_t)1)
+#define configTICK_RATE_HZ      1000
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(ms))
+#define tskNO_AFFINITY          0x7FFFFFFF
+
+typedef struct {
+    uint32_t owner;
+    uint32_t count;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED    {0, 0}
+#define portMUX_INITIALIZE(mux)         do { (mux)->owner = 0; (mux)->count = 0; } while (0)
+#define portENTER_CRITICAL(mux)         do { (void)(mux); } while (0)
+#define portEXIT_CRITICAL(mux)          do { (void)(mux); } while (0)
+#define portENTER_CRITICAL_ISR(mux)     do { (void)(mux); } while (0)
+#define portEXIT_CRITICAL_ISR(mux)      do { (void)(mux); } while (0)
+#define portENTER_CRITICAL_SAFE(mux)    do { (void)(mux); } while (0)
+#define portEXIT_CRITICAL_SAFE(mux)     do { (void)(mux); } while (0)
+#define portYIELD_FROM_ISR(...)         do {} while (0)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+BaseType_t xPortGetCoreID(void);
+
+#ifdef __cplusplus
+}
+#endif
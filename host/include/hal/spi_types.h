@@ -0,0 +1,10 @@
+/*
+ * Host stand-in for the ESP32-S3 SPI host numbers
+ */
+#pragma once
+
+typedef enum {
+    SPI1_HOST = 0,
+    SPI2_HOST = 1,
+    SPI3_HOST = 2,
+} spi_host_device_t;
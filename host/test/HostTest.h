@@ -0,0 +1,33 @@
+/*
+ * Minimal checks for the host tests: a failed check prints where and why and the test
+ * carries on, testResult() is the exit code.
+ */
+#pragma once
+
+#include <stdio.h>
+#include <string>
+
+static int host_checks;
+static int host_failures;
+
+static inline bool hostCheck(bool ok, const char *file, int line, const char *expr, const std::string &detail = "")
+{
+    host_checks++;
+    if (!ok) {
+        host_failures++;
+        printf("%s:%d: CHECK(%s) failed%s%s\n", file, line, expr, detail.empty() ? "" : ": ", detail.c_str());
+    }
+    return ok;
+}
+
+#define CHECK(cond)             hostCheck((cond), __FILE__, __LINE__, #cond)
+#define CHECK_EQ(a, b)          hostCheck((a) == (b), __FILE__, __LINE__, #a " == " #b, \
+                                          std::to_string(a) + " != " + std::to_string(b))
+#define CHECK_NEAR(a, b, tol)   hostCheck(fabs((double)(a) - (double)(b)) <= (tol), __FILE__, __LINE__, \
+                                          #a " ~ " #b, std::to_string(a) + " vs " + std::to_string(b))
+
+static inline int testResult(const char *name)
+{
+    printf("%s: %d checks, %d failed\n", name, host_checks, host_failures);
+    return host_failures ? 1 : 0;
+}
@@ -0,0 +1,36 @@
+/*
+ * Arduino Stream over a byte vector for the tests: reads from pos, writes append.
+ */
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+
+class MemoryStream : public Stream {
+public:
+    std::vector<uint8_t> data;
+    size_t pos = 0;
+
+    int available() override
+    {
+        return (int)(data.size() - pos);
+    }
+    int read() override
+    {
+        return pos < data.size() ? data[pos++] : -1;
+    }
+    int peek() override
+    {
+        return pos < data.size() ? data[pos] : -1;
+    }
+    size_t write(uint8_t c) override
+    {
+        data.push_back(c);
+        return 1;
+    }
+    size_t write(const uint8_t *buffer, size_t size) override
+    {
+        data.insert(data.end(), buffer, buffer + size);
+        return size;
+    }
+};
@@ -0,0 +1,71 @@
+/*
+ * The JD9613 as the tests see it: decodes a recorded SPI stream (HostPanelIO.h) into
+ * panel RAM the way the controller does. CASET and RASET set an inclusive window,
+ * RAMWR writes it row by row from its top left corner. Pixels stay in bus order.
+ *
+ * The RAM is two columns wider than the glass, rotation 2 mirrors the columns and
+ * addresses the visible ones with its x gap.
+ */
+#pragma once
+
+#include <HostPanelIO.h>
+#include <vector>
+#include "initSequence.h"
+
+#define PANEL_RAM_WIDTH     (JD9613_WIDTH + 2)
+
+class PanelRam
+{
+public:
+    PanelRam() : ram(PANEL_RAM_WIDTH * JD9613_HEIGHT, 0), caset{0, PANEL_RAM_WIDTH - 1}, raset{0, JD9613_HEIGHT - 1},
+        windows(0), pixels(0), errors(0) {}
+
+    void apply(const std::vector<host_spi_transfer_t> &log)
+    {
+        for (const host_spi_transfer_t &t : log) {
+            if (t.cmd == 0x2A && t.data.size() == 4) {
+                caset[0] = t.data[0] << 8 | t.data[1];
+                caset[1] = t.data[2] << 8 | t.data[3];
+                windows++;
+            } else if (t.cmd == 0x2B && t.data.size() == 4) {
+                raset[0] = t.data[0] << 8 | t.data[1];
+                raset[1] = t.data[2] << 8 | t.data[3];
+            } else if (t.cmd == 0x2C && t.color) {
+                write(t.data);
+            }
+        }
+    }
+
+    uint16_t at(uint16_t x, uint16_t y) const
+    {
+        return ram[y * PANEL_RAM_WIDTH + x];
+    }
+
+    std::vector<uint16_t> ram;
+    uint16_t caset[2];
+    uint16_t raset[2];
+    uint32_t windows;       // CASET commands seen
+    uint32_t pixels;
+    uint32_t errors;        // Pixels outside the window or the RAM, odd byte counts
+
+private:
+    void write(const std::vector<uint8_t> &bytes)
+    {
+        if ((bytes.size() & 1) || caset[0] > caset[1] || raset[0] > raset[1] ||
+                caset[1] >= PANEL_RAM_WIDTH || raset[1] >= JD9613_HEIGHT) {
+            errors++;
+            return;
+        }
+        uint32_t w = caset[1] - caset[0] + 1;
+        uint32_t n = bytes.size() / 2;
+        if (n > w * (raset[1] - raset[0] + 1)) {
+            errors++;
+            return;
+        }
+        for (uint32_t i = 0; i < n; i++) {
+            uint16_t v = bytes[2 * i] | bytes[2 * i + 1] << 8;
+            ram[(raset[0] + i / w) * PANEL_RAM_WIDTH + caset[0] + i % w] = v;
+        }
+        pixels += n;
+    }
+};
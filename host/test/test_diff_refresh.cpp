@@ -0,0 +1,288 @@
+/*
+ * Scanline diff refresh of src/LilyGo_Wristband.cpp (panel_jd9613_write_diff) on the
+ * recording panel IO of HostPanelIO.h.
+ *
+ * A model of what the panel should show is updated with every pushColors and the SPI
+ * stream is decoded into panel RAM: after each flush the two must be identical, while
+ * only the changed rows went over the bus in the bursts the merge rules allow. Every
+ * flush completes exactly once, including one that sends nothing, which completes in
+ * the calling task and must say so: its callback may not use the FromISR calls.
+ */
+#include "HostRuntime.h"
+#include "HostTest.h"
+#include "PanelRam.h"
+#include "../../src/LilyGo_Wristband.cpp"
+
+static LilyGo_Wristband panel;
+static PanelRam ram;
+static std::vector<uint16_t> model(PANEL_RAM_WIDTH * JD9613_HEIGHT, 0);
+static uint32_t flushes_done;
+static bool flush_from_isr;
+
+static void flushDone(void *user_data, bool from_isr)
+{
+    (void)user_data;
+    flushes_done++;
+    flush_from_isr = from_isr;
+}
+
+static void panelPoint(uint8_t rotation, uint16_t x, uint16_t y, uint16_t *px, uint16_t *py)
+{
+    switch (rotation) {
+    case 1:
+        *px = JD9613_WIDTH - 1 - y;
+        *py = x;
+        break;
+    case 2:
+        *px = x + 2;
+        *py = y;
+        break;
+    case 3:
+        *px = y;
+        *py = JD9613_HEIGHT - 1 - x;
+        break;
+    default:
+        *px = x;
+        *py = y;
+        break;
+    }
+}
+
+// pushColors through the driver and into the model, the stats of that flush
+static diff_refresh_stats_t push(uint16_t x, uint16_t y, uint16_t w, uint16_t h, std::vector<uint16_t> &data)
+{
+    uint8_t rotation = panel.getRotation();
+    for (uint16_t j = 0; j < h; j++) {
+        for (uint16_t i = 0; i < w; i++) {
+            uint16_t px;
+            uint16_t py;
+            panelPoint(rotation, x + i, y + j, &px, &py);
+            model[py * PANEL_RAM_WIDTH + px] = data[j * w + i];
+        }
+    }
+    uint32_t before = flushes_done;
+    hostSpiClear();
+    panel.pushColors(x, y, w, h, data.data());
+    ram.apply(hostSpiLog());
+    CHECK_EQ(flushes_done, before + 1);
+    diff_refresh_stats_t stats;
+    panel.getDiffRefreshStats(&stats);
+    return stats;
+}
+
+static bool panelMatches()
+{
+    return ram.errors == 0 && ram.ram == model;
+}
+
+static uint32_t colorBytes()
+{
+    uint32_t bytes = 0;
+    for (const host_spi_transfer_t &t : hostSpiLog()) {
+        bytes += t.color ? t.data.size() : 0;
+    }
+    return bytes;
+}
+
+// Panel rows written by the last flush, one entry per burst
+static std::vector<std::pair<uint16_t, uint16_t>> bursts()
+{
+    std::vector<std::pair<uint16_t, uint16_t>> rows;
+    uint16_t first = 0;
+    uint16_t last = 0;
+    for (const host_spi_transfer_t &t : hostSpiLog()) {
+        if (t.cmd == LCD_CMD_RASET) {
+            first = t.data[0] << 8 | t.data[1];
+            last = t.data[2] << 8 | t.data[3];
+        } else if (t.color) {
+            rows.push_back(std::make_pair(first, last));
+        }
+    }
+    return rows;
+}
+
+static std::vector<uint16_t> screen(uint32_t seed)
+{
+    std::vector<uint16_t> data(JD9613_WIDTH * JD9613_HEIGHT);
+    for (uint32_t i = 0; i < data.size(); i++) {
+        data[i] = (uint16_t)((i + seed) * 2654435761u >> 16);
+    }
+    return data;
+}
+
+static void changeRow(std::vector<uint16_t> &data, uint16_t width, uint16_t row)
+{
+    for (uint16_t x = 0; x < width; x++) {
+        data[row * width + x] ^= 0x5A5A;
+    }
+}
+
+static void testEnable()
+{
+    hostSpiClear();
+    CHECK(panel.begin(false));
+    panel.setRotation(0);
+    panel.setFlushDoneCallback(flushDone, NULL);
+    hostSpiClear();
+    CHECK(panel.setDiffRefresh(true));
+    // Enabling clears the panel so the shadow and the panel agree
+    ram.apply(hostSpiLog());
+    CHECK_EQ(colorBytes(), JD9613_WIDTH * JD9613_HEIGHT * 2);
+    CHECK(panelMatches());
+}
+
+static void testFullScreen()
+{
+    const uint16_t w = JD9613_WIDTH;
+    const uint16_t h = JD9613_HEIGHT;
+    std::vector<uint16_t> data = screen(1);
+    diff_refresh_stats_t stats = push(0, 0, w, h, data);
+    CHECK(panelMatches());
+    CHECK_EQ(stats.bursts, 1);
+    CHECK_EQ(stats.bytes_sent, w * h * 2);
+    CHECK(flush_from_isr);
+
+    // Nothing changed: no window, no pixels, and the flush still completes, in the task
+    stats = push(0, 0, w, h, data);
+    CHECK(!flush_from_isr);
+    CHECK(hostSpiLog().empty());
+    CHECK_EQ(stats.bursts, 0);
+    CHECK_EQ(stats.bytes_sent, 0);
+    CHECK_EQ(stats.bytes_saved, w * h * 2);
+    CHECK_EQ(panel.getTransferTime(), 0);
+
+    // One row: a single burst of exactly that row
+    changeRow(data, w, 100);
+    stats = push(0, 0, w, h, data);
+    CHECK(panelMatches());
+    CHECK(bursts() == (std::vector<std::pair<uint16_t, uint16_t>> {{100, 100}}));
+    CHECK_EQ(colorBytes(), w * 2);
+    CHECK_EQ(stats.bytes_saved, (h - 1) * w * 2);
+
+    // Gaps up to DIFF_REFRESH_MERGE_ROWS are sent along, longer ones split the burst
+    changeRow(data, w, 10);
+    changeRow(data, w, 10 + DIFF_REFRESH_MERGE_ROWS + 1);
+    changeRow(data, w, 50);
+    changeRow(data, w, 50 + DIFF_REFRESH_MERGE_ROWS + 2);
+    stats = push(0, 0, w, h, data);
+    CHECK(panelMatches());
+    CHECK(bursts() == (std::vector<std::pair<uint16_t, uint16_t>> {
+        {10, 10 + DIFF_REFRESH_MERGE_ROWS + 1}, {50, 50}, {50 + DIFF_REFRESH_MERGE_ROWS + 2, 50 + DIFF_REFRESH_MERGE_ROWS + 2}
+    }));
+    CHECK_EQ(stats.bursts, 3);
+    CHECK_EQ(colorBytes(), stats.bytes_sent);
+
+    // Scattered rows: no more than DIFF_REFRESH_MAX_BURSTS, the last one takes the rest
+    for (uint16_t row = 5; row < h; row += 10) {
+        changeRow(data, w, row);
+    }
+    stats = push(0, 0, w, h, data);
+    CHECK(panelMatches());
+    CHECK_EQ(stats.bursts, DIFF_REFRESH_MAX_BURSTS);
+    CHECK(bursts().size() == DIFF_REFRESH_MAX_BURSTS && bursts().back().second == 285);
+    CHECK_EQ(colorBytes(), stats.bytes_sent);
+}
+
+static void testMostlyChanged()
+{
+    // Three quarters of a 36 row window changed in runs too far apart to merge: one burst
+    const uint16_t w = 40;
+    const uint16_t h = 36;
+    std::vector<uint16_t> data(w * h, 0x1111);
+    diff_refresh_stats_t stats = push(20, 200, w, h, data);
+    CHECK(panelMatches());
+    for (uint16_t row = 0; row < h; row++) {
+        if (row % 12 < 9) {
+            changeRow(data, w, row);
+        }
+    }
+    stats = push(20, 200, w, h, data);
+    CHECK(panelMatches());
+    CHECK_EQ(stats.bursts, 1);
+    CHECK(bursts() == (std::vector<std::pair<uint16_t, uint16_t>> {{200, 200 + 32}}));
+    CHECK_EQ(stats.bytes_sent, 33 * w * 2);
+}
+
+static void testRotation2()
+{
+    // The shadow is indexed without the x gap, the window and the panel with it
+    hostSpiClear();
+    panel.setRotation(2);
+    ram.apply(hostSpiLog());
+    std::fill(model.begin(), model.end(), 0);
+    for (uint16_t y = 0; y < JD9613_HEIGHT; y++) {
+        // Not addressed in this direction, still showing the last rotation 0 frame
+        model[y * PANEL_RAM_WIDTH] = ram.at(0, y);
+        model[y * PANEL_RAM_WIDTH + 1] = ram.at(1, y);
+    }
+    CHECK(panelMatches());
+
+    const uint16_t w = 30;
+    const uint16_t h = 20;
+    std::vector<uint16_t> data(w * h);
+    for (uint32_t i = 0; i < data.size(); i++) {
+        data[i] = 0x2000 + i;
+    }
+    push(10, 40, w, h, data);
+    CHECK(panelMatches());
+    CHECK(!hostSpiLog().empty() && hostSpiLog()[0].cmd == LCD_CMD_CASET && hostSpiLog()[0].data[1] == 12);
+    diff_refresh_stats_t stats = push(10, 40, w, h, data);
+    CHECK_EQ(stats.bursts, 0);
+    changeRow(data, w, 7);
+    stats = push(10, 40, w, h, data);
+    CHECK(panelMatches());
+    CHECK(bursts() == (std::vector<std::pair<uint16_t, uint16_t>> {{47, 47}}));
+}
+
+static void testSoftwareRotation()
+{
+    // Rows are diffed after the rotation: one changed logical column is one panel row
+    hostSpiClear();
+    panel.setRotation(1);
+    ram.apply(hostSpiLog());
+    for (uint16_t y = 0; y < JD9613_HEIGHT; y++) {
+        for (uint16_t x = 0; x < JD9613_WIDTH; x++) {
+            model[y * PANEL_RAM_WIDTH + x] = 0;
+        }
+    }
+    CHECK(panelMatches());
+
+    const uint16_t w = JD9613_HEIGHT;
+    const uint16_t h = JD9613_WIDTH;
+    std::vector<uint16_t> data = screen(7);
+    push(0, 0, w, h, data);
+    CHECK(panelMatches());
+    for (uint16_t y = 0; y < h; y++) {
+        data[y * w + 50] ^= 0x5A5A;
+    }
+    diff_refresh_stats_t stats = push(0, 0, w, h, data);
+    CHECK(panelMatches());
+    CHECK(bursts() == (std::vector<std::pair<uint16_t, uint16_t>> {{50, 50}}));
+    CHECK_EQ(stats.bytes_sent, JD9613_WIDTH * 2);
+}
+
+static void testDisable()
+{
+    // Without the shadow every flush is sent whole again
+    CHECK(panel.setDiffRefresh(false));
+    std::vector<uint16_t> data(10 * 10, 0x3333);
+    uint32_t before = flushes_done;
+    hostSpiClear();
+    panel.pushColors(0, 0, 10, 10, data.data());
+    panel.pushColors(0, 0, 10, 10, data.data());
+    CHECK_EQ(colorBytes(), 2 * 10 * 10 * 2);
+    CHECK_EQ(flushes_done, before + 2);
+}
+
+int main()
+{
+    hostSerialMute(true);
+    testEnable();
+    testFullScreen();
+    testMostlyChanged();
+    testRotation2();
+    testSoftwareRotation();
+    testDisable();
+    hostSerialMute(false);
+    return testResult("test_diff_refresh");
+}
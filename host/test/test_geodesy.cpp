@@ -0,0 +1,170 @@
+/*
+ * TrackFrame of the sketch against the exact local tangent plane.
+ *
+ * The reference converts WGS84 latitude and longitude to ECEF and rotates the offset
+ * from the origin into east/north/up, all in double. project() must stay within 2 mm
+ * of it out to 5 km from the origin, over latitudes 0 to 60 degrees in every direction,
+ * and the distance between any two points within 2.5 mm. projectFast() has no higher
+ * order terms: its error is checked to stay the size Geodesy.h states, metres at 5 km,
+ * so the warning there keeps matching the code.
+ */
+#include "HostTest.h"
+#include "Geodesy.h"
+#include <vector>
+
+#define WGS84_A         6378137.0
+#define WGS84_E2        6.69437999014e-3
+
+typedef struct {
+    double x;
+    double y;
+    double z;
+} ecef_t;
+
+static ecef_t toEcef(int32_t lat, int32_t lon)
+{
+    double phi = lat * 1e-7 * M_PI / 180.0;
+    double lambda = lon * 1e-7 * M_PI / 180.0;
+    double n = WGS84_A / sqrt(1.0 - WGS84_E2 * sin(phi) * sin(phi));
+    ecef_t p = {n * cos(phi) * cos(lambda), n * cos(phi) * sin(lambda), n * (1.0 - WGS84_E2) * sin(phi)};
+    return p;
+}
+
+// East and north of the tangent plane at (lat0, lon0), up is dropped
+static void toEnu(int32_t lat0, int32_t lon0, int32_t lat, int32_t lon, double *e, double *n)
+{
+    ecef_t o = toEcef(lat0, lon0);
+    ecef_t p = toEcef(lat, lon);
+    double dx = p.x - o.x;
+    double dy = p.y - o.y;
+    double dz = p.z - o.z;
+    double phi = lat0 * 1e-7 * M_PI / 180.0;
+    double lambda = lon0 * 1e-7 * M_PI / 180.0;
+    *e = -sin(lambda) * dx + cos(lambda) * dy;
+    *n = -sin(phi) * cos(lambda) * dx - sin(phi) * sin(lambda) * dy + cos(phi) * dz;
+}
+
+// The point at east/north metres from the origin on the ellipsoid, by Newton on toEnu
+static void fromEnu(int32_t lat0, int32_t lon0, double e, double n, int32_t *lat, int32_t *lon)
+{
+    double phi = lat0 * 1e-7 * M_PI / 180.0;
+    double w = sqrt(1.0 - WGS84_E2 * sin(phi) * sin(phi));
+    double mLat = WGS84_A * (1.0 - WGS84_E2) / (w * w * w) * M_PI / 180.0 * 1e-7;
+    double mLon = WGS84_A / w * cos(phi) * M_PI / 180.0 * 1e-7;
+    double la = lat0 + n / mLat;
+    double lo = lon0 + e / mLon;
+    for (int i = 0; i < 4; i++) {
+        double pe;
+        double pn;
+        toEnu(lat0, lon0, (int32_t)llround(la), (int32_t)llround(lo), &pe, &pn);
+        la += (n - pn) / mLat;
+        lo += (e - pe) / mLon;
+    }
+    *lat = (int32_t)llround(la);
+    *lon = (int32_t)llround(lo);
+}
+
+typedef struct {
+    double point;                   // Worst position error against the tangent plane
+    double distance;                // Worst error of the distance between two points
+} frame_error_t;
+
+// Points on rings around an origin at lat0, every 15 degrees out to radius metres
+static frame_error_t frameError(int32_t lat0, int32_t lon0, double radius, bool fast)
+{
+    TrackFrame frame;
+    frame.set(lat0, lon0);
+    std::vector<int32_t> lats;
+    std::vector<int32_t> lons;
+    for (double r = radius / 8; r <= radius * 1.0001; r += radius / 8) {
+        for (int a = 0; a < 360; a += 15) {
+            int32_t lat;
+            int32_t lon;
+            fromEnu(lat0, lon0, r * sin(a * M_PI / 180.0), r * cos(a * M_PI / 180.0), &lat, &lon);
+            lats.push_back(lat);
+            lons.push_back(lon);
+        }
+    }
+
+    frame_error_t err = {0, 0};
+    std::vector<enu_t> p(lats.size());
+    std::vector<double> e(lats.size());
+    std::vector<double> n(lats.size());
+    for (size_t i = 0; i < lats.size(); i++) {
+        p[i] = fast ? frame.projectFast(lats[i], lons[i]) : frame.project(lats[i], lons[i]);
+        toEnu(lat0, lon0, lats[i], lons[i], &e[i], &n[i]);
+        err.point = std::max(err.point, hypot(p[i].e - e[i], p[i].n - n[i]));
+    }
+    for (size_t i = 0; i < lats.size(); i++) {
+        for (size_t j = i + 1; j < lats.size(); j++) {
+            double exact = hypot(e[j] - e[i], n[j] - n[i]);
+            err.distance = std::max(err.distance, fabs(enuDistance(p[i], p[j]) - exact));
+        }
+    }
+    return err;
+}
+
+static void testReference()
+{
+    // The reference against itself: fromEnu lands within the 1e-7 degree grid
+    double e;
+    double n;
+    int32_t lat;
+    int32_t lon;
+    fromEnu(520733000, -10167000, 3000.0, -4000.0, &lat, &lon);
+    toEnu(520733000, -10167000, lat, lon, &e, &n);
+    CHECK_NEAR(e, 3000.0, 0.01);
+    CHECK_NEAR(n, -4000.0, 0.01);
+    toEnu(520733000, -10167000, 520733000, -10167000, &e, &n);
+    CHECK(e == 0 && n == 0);
+}
+
+static void testProject()
+{
+    const int32_t lats[] = {0, 150000000, 300000000, 450000000, 520733000, 600000000, -337500000};
+    const double radii[] = {200.0, 1000.0, 5000.0};
+    double worstPoint = 0;
+    double worstDistance = 0;
+    for (int32_t lat0 : lats) {
+        for (double radius : radii) {
+            frame_error_t err = frameError(lat0, -10167000, radius, false);
+            worstPoint = std::max(worstPoint, err.point);
+            worstDistance = std::max(worstDistance, err.distance);
+            if (err.point > 0.002 || err.distance > 0.0025) {
+                printf("project lat %.2f r %.0f m: point %.4f m, distance %.4f m\n", lat0 * 1e-7, radius,
+                       err.point, err.distance);
+            }
+        }
+    }
+    printf("project: worst point %.2f mm, worst distance %.2f mm within 5 km\n", worstPoint * 1e3,
+           worstDistance * 1e3);
+    CHECK(worstPoint <= 0.002);
+    // Two points, each rounded to float
+    CHECK(worstDistance <= 0.0025);
+}
+
+static void testProjectFast()
+{
+    // Millimetres within 200 m, a decimetre at 1 km, metres at 5 km, as Geodesy.h warns
+    const int32_t lat0 = 520733000;
+    frame_error_t near = frameError(lat0, -10167000, 200.0, true);
+    frame_error_t mid = frameError(lat0, -10167000, 1000.0, true);
+    frame_error_t far = frameError(lat0, -10167000, 5000.0, true);
+    printf("projectFast at %.1f deg: point %.3f / %.3f / %.3f m, distance %.3f / %.3f / %.3f m at 200 m / 1 km / 5 km\n",
+           lat0 * 1e-7, near.point, mid.point, far.point, near.distance, mid.distance, far.distance);
+    CHECK(near.point < 0.01 && near.distance < 0.01);
+    CHECK(mid.point > 0.05 && mid.point < 0.2);
+    CHECK(far.point > 2.0 && far.point < 4.0);
+    CHECK(far.distance > 4.0 && far.distance < 6.0);
+    // It stays exact at the equator, the error grows with the latitude
+    CHECK(frameError(0, -10167000, 5000.0, true).point < 0.005);
+    CHECK(frameError(600000000, -10167000, 5000.0, true).point > far.point);
+}
+
+int main()
+{
+    testReference();
+    testProject();
+    testProjectFast();
+    return testResult("test_geodesy");
+}
@@ -0,0 +1,71 @@
+/*
+ * Every HUD screen of the sketch at LV_COLOR_DEPTH 8 against the same screen at 16.
+ *
+ * hud_replay and hud_replay8 run the same session and then draw each display mode,
+ * writing the viewport of the panel RAM to $HUD_SCREENS16 and $HUD_SCREENS8. The 8-bit
+ * build flushes indexed pixels through the identity palette of LV_Helper, the RGB332
+ * expansion, and every color the HUD uses is exact in RGB332, so both panels must hold
+ * the same pixels. LVGL only antialiases above 8-bit, so the RGB565 run draws without
+ * antialiasing for the edges to compare.
+ */
+#include "HostTest.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+static bool readScreen(const std::string &path, std::vector<uint16_t> &pixels)
+{
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f) {
+        return false;
+    }
+    pixels.clear();
+    uint16_t buf[1024];
+    size_t n;
+    while ((n = fread(buf, sizeof(buf[0]), 1024, f)) > 0) {
+        pixels.insert(pixels.end(), buf, buf + n);
+    }
+    fclose(f);
+    return true;
+}
+
+int main()
+{
+    const char *prefix = getenv("HUD_SCREENS");
+    if (!CHECK(prefix != NULL)) {
+        return testResult("test_hud_depth");
+    }
+
+    int screens = 0;
+    bool lit = false;
+    std::vector<uint16_t> rgb565;
+    std::vector<uint16_t> index8;
+    for (int i = 0; i < 100; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "/screen%02d.raw", i);
+        if (!readScreen(std::string(prefix) + "16" + name, rgb565)) {
+            break;
+        }
+        screens++;
+        if (!CHECK(readScreen(std::string(prefix) + "8" + name, index8))) {
+            continue;
+        }
+        CHECK_EQ(index8.size(), rgb565.size());
+        size_t n = std::min(index8.size(), rgb565.size());
+        size_t differ = 0;
+        for (size_t p = 0; p < n; p++) {
+            if (index8[p] != rgb565[p] && differ++ == 0) {
+                printf("screen %02d: pixel %zu is %04X at 8-bit, %04X at 16-bit\n", i, p, index8[p], rgb565[p]);
+            }
+            lit |= rgb565[p] != 0;
+        }
+        if (!CHECK_EQ(differ, 0)) {
+            printf("screen %02d: %zu of %zu pixels differ\n", i, differ, n);
+        }
+    }
+    CHECK(screens > 0);
+    CHECK(lit);
+    printf("%d screens compared\n", screens);
+    return testResult("test_hud_depth");
+}
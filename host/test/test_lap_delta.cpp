@@ -0,0 +1,197 @@
+/*
+ * LapDelta of the sketch: reference persistence and replacement.
+ *
+ * Laps are circles of 100 m radius through the finish line at the frame origin, driven
+ * at constant speed at 25 Hz, so a lap time and the delta at any point of a lap are
+ * known. A saved reference must load back to the same trace, and a file for another
+ * finish line, a truncated or a foreign one must be refused with the reference in
+ * place untouched, the spare trace it was read into included. Only a faster flying
+ * lap replaces the reference.
+ */
+#include "HostRuntime.h"
+#include "HostTest.h"
+#include "LapDelta.h"
+#include "MemoryStream.h"
+#include <vector>
+
+#define ORIGIN_LAT      520733000
+#define ORIGIN_LON      -10167000
+#define RADIUS_M        100.0
+#define FIX_MS          40
+#define HEADER_SIZE     20          // "DLT1", count, lap ms, origin lat and lon
+
+static double lapMs(double speed)
+{
+    return 2 * M_PI * RADIUS_M / speed * 1000.0;
+}
+
+// One lap at speed m/s from crossing to crossing, the deltas of every fix
+static std::vector<int32_t> driveLap(LapDelta &delta, double speed, bool flying, bool *replaced)
+{
+    std::vector<int32_t> deltas;
+    double total = lapMs(speed);
+    delta.startLap(flying);
+    for (uint32_t t = FIX_MS; t < total; t += FIX_MS) {
+        double a = speed * t / 1000.0 / RADIUS_M;
+        enu_t pos = {(float)(RADIUS_M - RADIUS_M * cos(a)), (float)(RADIUS_M * sin(a))};
+        delta.update(pos, t);
+        deltas.push_back(delta.valid() ? delta.delta() : INT32_MIN);
+    }
+    bool r = delta.finishLap((uint32_t)lround(total));
+    if (replaced) {
+        *replaced = r;
+    }
+    return deltas;
+}
+
+static bool begin(LapDelta &delta, int32_t lat = ORIGIN_LAT, int32_t lon = ORIGIN_LON)
+{
+    if (!delta.begin()) {
+        return false;
+    }
+    delta.setOrigin(lat, lon);
+    return true;
+}
+
+static void testRoundTrip()
+{
+    LapDelta saved;
+    CHECK(begin(saved));
+    MemoryStream file;
+    CHECK(!saved.save(file));
+    CHECK(file.data.empty());
+    bool replaced;
+    driveLap(saved, 30.0, true, &replaced);
+    CHECK(replaced);
+    CHECK(saved.save(file));
+    CHECK(memcmp(file.data.data(), DELTA_MAGIC, 4) == 0);
+    uint32_t count;
+    memcpy(&count, &file.data[4], 4);
+    CHECK_EQ(file.data.size(), HEADER_SIZE + count * sizeof(delta_point_t));
+
+    LapDelta loaded;
+    CHECK(begin(loaded));
+    CHECK(loaded.load(file));
+    CHECK(loaded.hasReference());
+    CHECK_EQ(loaded.referenceMs(), saved.referenceMs());
+    CHECK_EQ(loaded.referenceMs(), (uint32_t)lround(lapMs(30.0)));
+
+    // Saved again it is the same file, and it gives the same deltas
+    MemoryStream again;
+    CHECK(loaded.save(again));
+    CHECK(again.data == file.data);
+    CHECK(driveLap(loaded, 29.0, false, NULL) == driveLap(saved, 29.0, false, NULL));
+}
+
+static void testRefused()
+{
+    LapDelta source;
+    CHECK(begin(source));
+    driveLap(source, 30.0, true, NULL);
+    MemoryStream file;
+    CHECK(source.save(file));
+
+    // Another finish line: not loaded, nothing there
+    hostSerialMute(true);
+    LapDelta other;
+    CHECK(begin(other, ORIGIN_LAT + 1, ORIGIN_LON));
+    file.pos = 0;
+    CHECK(!other.load(file));
+    CHECK(!other.hasReference());
+    hostSerialMute(false);
+
+    // Each way a file can be broken, against a reference already in place
+    LapDelta delta;
+    CHECK(begin(delta));
+    driveLap(delta, 25.0, true, NULL);
+    uint32_t refMs = delta.referenceMs();
+    std::vector<int32_t> before = driveLap(delta, 27.0, false, NULL);
+
+    std::vector<MemoryStream> broken;
+    for (size_t len : {(size_t)0, (size_t)3, (size_t)HEADER_SIZE - 1, (size_t)HEADER_SIZE, file.data.size() / 2,
+                       file.data.size() - 1}) {
+        MemoryStream f;
+        f.data.assign(file.data.begin(), file.data.begin() + len);
+        broken.push_back(f);
+    }
+    MemoryStream magic = file;
+    magic.data[0] = 'X';
+    broken.push_back(magic);
+    for (uint32_t count : {0u, 1u, (uint32_t)DELTA_MAX_POINTS + 1}) {
+        MemoryStream f = file;
+        memcpy(&f.data[4], &count, 4);
+        broken.push_back(f);
+    }
+    MemoryStream moved = file;
+    int32_t lat = ORIGIN_LAT - 1;
+    memcpy(&moved.data[12], &lat, 4);
+    broken.push_back(moved);
+
+    hostSerialMute(true);
+    for (MemoryStream &f : broken) {
+        if (!CHECK(!delta.load(f))) {
+            printf("a %zu byte file loaded\n", f.data.size());
+        }
+        CHECK(delta.hasReference());
+        CHECK_EQ(delta.referenceMs(), refMs);
+    }
+    hostSerialMute(false);
+    // The spare trace took the partial reads, the reference and the next lap do not care
+    CHECK(driveLap(delta, 27.0, false, NULL) == before);
+    bool replaced;
+    driveLap(delta, 26.0, true, &replaced);
+    CHECK(replaced);
+    CHECK_EQ(delta.referenceMs(), (uint32_t)lround(lapMs(26.0)));
+}
+
+static void testReplacement()
+{
+    LapDelta delta;
+    CHECK(begin(delta));
+    CHECK(!delta.hasReference());
+
+    // The out lap is not flying, it never becomes the reference
+    bool replaced;
+    driveLap(delta, 35.0, false, &replaced);
+    CHECK(!replaced);
+    CHECK(!delta.hasReference());
+
+    driveLap(delta, 30.0, true, &replaced);
+    CHECK(replaced);
+    uint32_t refMs = delta.referenceMs();
+
+    // Slower: delta grows to the difference of the lap times, the reference stays
+    std::vector<int32_t> deltas = driveLap(delta, 28.0, true, &replaced);
+    CHECK(!replaced);
+    CHECK_EQ(delta.referenceMs(), refMs);
+    CHECK(deltas.front() != INT32_MIN && deltas.back() != INT32_MIN);
+    CHECK_NEAR(deltas.back(), lapMs(28.0) - lapMs(30.0), 50.0);
+
+    // The same time again is not faster either
+    driveLap(delta, 30.0, true, &replaced);
+    CHECK(!replaced);
+
+    // Faster: ahead all lap, then it is the reference
+    deltas = driveLap(delta, 31.0, true, &replaced);
+    CHECK(replaced);
+    CHECK(deltas.back() < 0);
+    CHECK_EQ(delta.referenceMs(), (uint32_t)lround(lapMs(31.0)));
+    deltas = driveLap(delta, 31.0, false, NULL);
+    for (int32_t d : deltas) {
+        if (!CHECK(d != INT32_MIN && abs(d) <= 1)) {
+            break;
+        }
+    }
+
+    // A moved finish line drops it
+    delta.setOrigin(ORIGIN_LAT, ORIGIN_LON + 1);
+    CHECK(!delta.hasReference());
+}
+
+int main()
+{
+    testRoundTrip();
+    testRefused();
+    testReplacement();
+    return testResult("test_lap_delta");
+}
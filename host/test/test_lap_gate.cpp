@@ -0,0 +1,274 @@
+/*
+ * LapGate of the sketch on straight drives through the gate.
+ *
+ * A car on a straight line at constant speed crosses the gate at a whole millisecond,
+ * sampled at 25 Hz with every phase between two fixes: the interpolated crossing must
+ * be that millisecond exactly, for any heading, speed and place along the gate, and
+ * also when the GPS week rolls over between the two fixes. A gate set without a heading
+ * takes its direction from the first movement near it. Crossings backwards, beside the
+ * gate or over a gap in the fixes are not laps.
+ *
+ * host/data/two_laps.rbx is a capture file of two laps of a 650 m stadium at 25 Hz as
+ * the RaceBox sends them: about 20 cm of position noise, 8 to 30 ms of notification
+ * latency, a lost notification and some connection events carrying two frames. Played
+ * through RaceBoxReplay and UbxFramer like the sketch replays a capture, the gate must
+ * find the three crossings of the drive, listed below, and no other.
+ */
+#include "HostRuntime.h"
+#include "HostTest.h"
+#include "LapGate.h"
+#include "RaceBoxData.h"
+#include "RaceBoxReplay.h"
+#include "UbxFramer.h"
+#include <LittleFS.h>
+#include <vector>
+
+#define FIX_MS          40              // 25 Hz
+
+// Position of a car crossing centre at crossMs, heading degrees, speed m/s, side metres
+// to the right of the gate centre, at time t
+static enu_t carAt(enu_t centre, double heading, double speed, double side, double crossMs, double t)
+{
+    double h = heading * M_PI / 180.0;
+    double s = speed * (t - crossMs) / 1000.0;
+    enu_t p = {(float)(centre.e + s * sin(h) + side * cos(h)), (float)(centre.n + s * cos(h) - side * sin(h))};
+    return p;
+}
+
+// Feeds fixes from 10 before to 10 after the crossing, returns the crossings reported
+static std::vector<uint32_t> drive(LapGate &gate, enu_t centre, double heading, double speed, double side,
+                                   uint32_t crossMs, uint32_t phaseMs)
+{
+    std::vector<uint32_t> crossings;
+    // First fix 10 intervals before the one preceding the crossing by phaseMs
+    uint64_t first = (uint64_t)crossMs + GPS_WEEK_MS - phaseMs - 10 * FIX_MS;
+    for (uint32_t i = 0; i <= 20; i++) {
+        uint64_t t = first + i * FIX_MS;
+        uint32_t itow = t % GPS_WEEK_MS;
+        double rel = (double)t - GPS_WEEK_MS;
+        uint32_t cross;
+        if (gate.update(carAt(centre, heading, speed, side, crossMs, rel), itow, &cross)) {
+            crossings.push_back(cross);
+        }
+    }
+    return crossings;
+}
+
+static void testExactInterpolation()
+{
+    // Every phase of the crossing between two fixes, all directions, walking pace to
+    // 300 km/h, across the width of the gate
+    const enu_t centre = {137.5f, -412.25f};
+    const double speeds[] = {1.5, 27.8, 83.3};
+    const double sides[] = {0.0, -11.5, 7.25};
+    bool all = true;
+    for (int heading = 0; heading < 360 && all; heading += 15) {
+        for (double speed : speeds) {
+            for (double side : sides) {
+                for (uint32_t phase = 1; phase < FIX_MS && all; phase++) {
+                    LapGate gate;
+                    gate.set(centre, heading);
+                    uint32_t crossMs = 388800000 + phase * 7;
+                    std::vector<uint32_t> c = drive(gate, centre, heading, speed, side, crossMs, phase);
+                    if (c.size() != 1 || c[0] != crossMs) {
+                        printf("heading %d speed %.1f side %.2f phase %u: %zu crossings, first at %d ms\n",
+                               heading, speed, side, phase, c.size(), c.empty() ? 0 : (int)(c[0] - crossMs));
+                        all = false;
+                    }
+                }
+            }
+        }
+    }
+    CHECK(all);
+
+    // On a fix: the fix before is behind the line, the one on it counts as crossed
+    LapGate gate;
+    gate.set(centre, 90);
+    std::vector<uint32_t> c = drive(gate, centre, 90, 30.0, 0, 388800000, 0);
+    CHECK(c.size() == 1 && c[0] == 388800000);
+}
+
+static void testWeekRollover()
+{
+    CHECK_EQ(gpsTimeDiff(20, GPS_WEEK_MS - 20), 40u);
+    CHECK_EQ(gpsTimeDiff(500, 460), 40u);
+
+    // The two fixes straddle the end of the week, the crossing is before or after it
+    const enu_t centre = {0.0f, 0.0f};
+    for (uint32_t crossMs : {(uint32_t)GPS_WEEK_MS - 15, 5u, 0u, (uint32_t)GPS_WEEK_MS - 1}) {
+        for (uint32_t phase = 1; phase < FIX_MS; phase += 3) {
+            LapGate gate;
+            gate.set(centre, 45);
+            std::vector<uint32_t> c = drive(gate, centre, 45, 40.0, 2.0, crossMs, phase);
+            if (!CHECK(c.size() == 1 && c[0] == crossMs)) {
+                printf("crossing at %u, phase %u: %zu crossings, first at %u\n", crossMs, phase, c.size(),
+                       c.empty() ? 0 : c[0]);
+            }
+        }
+    }
+}
+
+static void testOrientFromMovement()
+{
+    // Standing still when the line was set: no direction until the car has moved
+    // LAP_GATE_ORIENT_STEP_M within LAP_GATE_ORIENT_RADIUS_M, then the first crossing
+    // in that direction counts
+    const enu_t centre = {50.0f, 20.0f};
+    for (float heading : {0.0f, 90.0f, 217.0f}) {
+        LapGate gate;
+        gate.set(centre, NAN);
+        CHECK(gate.valid());
+        CHECK(!gate.oriented());
+        CHECK(isnan(gate.heading()));
+
+        double h = heading * M_PI / 180.0;
+        uint32_t itow = 100000;
+        uint32_t crossings = 0;
+        bool orientedEarly = false;
+        float orientedAt = 0;
+        for (double s = -60.0; s <= 20.0; s += 0.8) {
+            enu_t p = {(float)(centre.e + s * sin(h)), (float)(centre.n + s * cos(h))};
+            uint32_t cross;
+            crossings += gate.update(p, itow, &cross);
+            itow += FIX_MS;
+            if (gate.oriented() && orientedAt == 0) {
+                orientedAt = (float)s;
+                orientedEarly = s < -LAP_GATE_ORIENT_RADIUS_M;
+            }
+        }
+        CHECK(!orientedEarly);
+        CHECK(orientedAt < 0 && orientedAt >= -LAP_GATE_ORIENT_RADIUS_M + LAP_GATE_ORIENT_STEP_M);
+        CHECK_NEAR(gate.heading(), heading, 0.01);
+        CHECK_EQ(crossings, 1u);
+    }
+
+    // Movement that stays outside the radius orients nothing
+    LapGate gate;
+    gate.set(centre, NAN);
+    uint32_t cross;
+    for (int i = 0; i < 50; i++) {
+        enu_t p = {centre.e + 40.0f, centre.n - 20.0f + i};
+        gate.update(p, 200000 + i * FIX_MS, &cross);
+    }
+    CHECK(!gate.oriented());
+}
+
+static void testIgnored()
+{
+    const enu_t centre = {0.0f, 0.0f};
+    LapGate gate;
+    uint32_t cross = 0;
+
+    // Backwards: no lap, and driving on forwards again is one
+    gate.set(centre, 0);
+    CHECK(drive(gate, centre, 180, 30.0, 0, 500000, 17).empty());
+    CHECK(gate.along() < 0);
+    gate.restart();
+    CHECK(drive(gate, centre, 0, 30.0, 0, 600000, 17) == std::vector<uint32_t> {600000});
+
+    // A backwards crossing right after a forward one does not end a lap either
+    gate.set(centre, 0);
+    CHECK(drive(gate, centre, 0, 10.0, 0, 700000, 5).size() == 1);
+    CHECK(drive(gate, centre, 180, 10.0, 0, 700800, 5).empty());
+
+    // Beside the gate
+    gate.set(centre, 0, 5.0f);
+    CHECK(drive(gate, centre, 0, 30.0, 5.5, 800000, 10).empty());
+    CHECK(drive(gate, centre, 0, 30.0, -4.5, 900000, 10).size() == 1);
+    CHECK_NEAR(gate.lateral(), -4.5, 1e-3);
+
+    // A gap longer than LAP_GATE_MAX_STEP_MS or a restart is not bridged
+    gate.set(centre, 0);
+    CHECK(!gate.update({0.0f, -10.0f}, 1000000, &cross));
+    CHECK(!gate.update({0.0f, 10.0f}, 1000000 + LAP_GATE_MAX_STEP_MS + 1, &cross));
+    CHECK(!gate.update({0.0f, -10.0f}, 1100000, &cross));
+    gate.restart();
+    CHECK(!gate.update({0.0f, 10.0f}, 1100040, &cross));
+
+    // A jump longer than LAP_GATE_MAX_STEP_M is a glitch
+    CHECK(!gate.update({0.0f, -50.0f}, 1200000, &cross));
+    CHECK(!gate.update({0.0f, 60.0f}, 1200040, &cross));
+
+    // A cleared gate reports nothing
+    gate.clear();
+    CHECK(!gate.valid());
+    CHECK(drive(gate, centre, 0, 30.0, 0, 1300000, 10).empty());
+}
+
+// two_laps.rbx: finish line, travel to the north, and the crossings of the drive in
+// iTOW ms before the noise
+#define RECORDED_LAT            520733000
+#define RECORDED_LON            -10167000
+#define RECORDED_FRAMES         1246
+static const double RECORDED_CROSSINGS[] = {302460500.000, 302484462.634, 302507351.218};
+
+static TrackFrame recorded_frame;
+static LapGate recorded_gate;
+static std::vector<uint32_t> recorded_crossings;
+
+static void onRecordedFrame(uint8_t msgClass, uint8_t msgId, const uint8_t *payload, uint16_t len, void *user)
+{
+    (void)user;
+    rbx_fix_t fix;
+    if (msgClass != RACEBOX_MSG_CLASS || msgId != RACEBOX_MSG_ID ||
+        !rbxDecode(payload, len, RBX_F_TIME | RBX_F_FIX | RBX_F_POSITION, &fix) || !(fix.fix_flags & 0x01)) {
+        return;
+    }
+    uint32_t cross;
+    if (recorded_gate.update(recorded_frame.project(fix.lat, fix.lon), fix.itow_ms, &cross)) {
+        recorded_crossings.push_back(cross);
+    }
+}
+
+static UbxFramer recorded_framer(onRecordedFrame);
+
+static void parseRecorded(uint8_t *data, size_t len)
+{
+    recorded_framer.push(data, len);
+}
+
+static void testRecordedSession()
+{
+    hostFsRoot(HOST_DATA_DIR);
+    fs::File file = LittleFS.open("/two_laps.rbx", FILE_READ);
+    if (!CHECK(file)) {
+        return;
+    }
+    recorded_frame.set(RECORDED_LAT, RECORDED_LON);
+    recorded_gate.set(recorded_frame.project(RECORDED_LAT, RECORDED_LON), 0);
+    RaceBoxReplay replay;
+    const rbx_pipeline_t pipeline = {parseRecorded, NULL, NULL};
+    hostSerialMute(true);
+    CHECK(replay.start(file, pipeline, 0));
+    while (replay.service()) {
+    }
+    hostSerialMute(false);
+    file.close();
+
+    ubx_framer_stats_t stats;
+    recorded_framer.getStats(&stats);
+    CHECK_EQ(stats.frames, (uint32_t)RECORDED_FRAMES);
+    CHECK_EQ(stats.crc_errors, 0u);
+    const size_t count = sizeof(RECORDED_CROSSINGS) / sizeof(RECORDED_CROSSINGS[0]);
+    if (!CHECK_EQ(recorded_crossings.size(), count)) {
+        return;
+    }
+    // 15 ms is 60 cm at 40 m/s, three times the noise of a position
+    for (size_t i = 0; i < count; i++) {
+        CHECK_NEAR(recorded_crossings[i], RECORDED_CROSSINGS[i], 15.0);
+    }
+    for (size_t i = 1; i < count; i++) {
+        CHECK_NEAR(gpsTimeDiff(recorded_crossings[i], recorded_crossings[i - 1]),
+                   RECORDED_CROSSINGS[i] - RECORDED_CROSSINGS[i - 1], 20.0);
+    }
+}
+
+int main()
+{
+    testExactInterpolation();
+    testWeekRollover();
+    testOrientFromMovement();
+    testIgnored();
+    testRecordedSession();
+    return testResult("test_lap_gate");
+}
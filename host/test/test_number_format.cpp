@@ -0,0 +1,109 @@
+/*
+ * lv_number_label_format(), the fixed point text of LV_NumberLabel and LV_BoundLabel.
+ *
+ * Against the exact text on values across the whole int32_t range at 0 to 4 decimals,
+ * and in buffers too small for the value or the decimals asked: the text must start
+ * inside the buffer, keep the sign, and nothing may be written past either end of it.
+ */
+#include "HostTest.h"
+#include "LV_NumberLabel.h"
+#include <algorithm>
+#include <random>
+#include <string>
+
+#define GUARD           0x5A
+#define GUARD_BYTES     8
+
+// value / 10^decimals from the exact integer
+static std::string reference(int32_t value, uint8_t decimals)
+{
+    bool negative = value < 0;
+    uint64_t v = negative ? -(int64_t)value : value;
+    std::string digits = std::to_string(v);
+    if (decimals) {
+        if (digits.size() <= decimals) {
+            digits.insert(0, decimals + 1 - digits.size(), '0');
+        }
+        digits.insert(digits.size() - decimals, ".");
+    }
+    return (negative ? "-" : "") + digits;
+}
+
+// Formats into size bytes with guards on both sides, false when one was touched
+static bool format(size_t size, int32_t value, uint8_t decimals, std::string *text)
+{
+    uint8_t mem[GUARD_BYTES + 32 + GUARD_BYTES];
+    memset(mem, GUARD, sizeof(mem));
+    char *buf = (char *)mem + GUARD_BYTES;
+    char *p = lv_number_label_format(buf, size, value, decimals);
+    bool inside = p >= buf && p < buf + size && memchr(p, '\0', buf + size - p);
+    for (size_t i = 0; i < GUARD_BYTES; i++) {
+        inside &= mem[i] == GUARD && buf[size + i] == (char)GUARD;
+    }
+    *text = inside ? p : "";
+    return inside;
+}
+
+static void testValues()
+{
+    std::mt19937 rng(20261017);
+    const int32_t edges[] = {0, 1, -1, 9, -9, 10, -10, 99, 100, 1234, -1234, INT32_MAX, INT32_MIN};
+    for (uint8_t decimals = 0; decimals <= 4; decimals++) {
+        for (int32_t value : edges) {
+            std::string text;
+            CHECK(format(16, value, decimals, &text));
+            CHECK(text == reference(value, decimals));
+        }
+        for (int i = 0; i < 10000; i++) {
+            int32_t value = (int32_t)rng();
+            std::string text;
+            CHECK(format(16, value, decimals, &text) && text == reference(value, decimals));
+        }
+    }
+    std::string text;
+    format(16, 1234, 1, &text);
+    CHECK(text == "123.4");
+    format(16, -5, 2, &text);
+    CHECK(text == "-0.05");
+}
+
+static void testSmallBuffer()
+{
+    // Every size and decimals count: the decimals that do not fit after the sign, the
+    // leading 0 and the point are dropped, then the leading digits that do not fit
+    for (size_t size = 1; size <= 16; size++) {
+        for (int decimals = 0; decimals <= 255; decimals++) {
+            for (int32_t value : {0, 7, -7, 123456, -123456, INT32_MIN}) {
+                std::string text;
+                CHECK(format(size, value, decimals, &text));
+                if (size < 4) {
+                    continue;
+                }
+                int kept = std::min(decimals, (int)size - 4);
+                int64_t shown = value;
+                for (int i = kept; i < decimals && shown; i++) {
+                    shown /= 10;
+                }
+                std::string exact = reference((int32_t)shown, kept);
+                if (exact.size() <= size - 1) {
+                    CHECK(text == exact);
+                } else {
+                    CHECK(text.size() == size - 1 && (shown > 0 || text[0] == '-'));
+                    CHECK(exact.compare(exact.size() - text.size() + 1, std::string::npos, text, 1) == 0);
+                }
+            }
+        }
+    }
+    std::string text;
+    CHECK(format(7, -1234, 3, &text) && text == "-1.234");
+    CHECK(format(6, -1234, 3, &text) && text == "-1.23");
+    CHECK(format(4, -5, 200, &text) && text == "0");
+    CHECK(format(5, 123456, 0, &text) && text == "3456");
+}
+
+int main()
+{
+    testValues();
+    testSmallBuffer();
+    return testResult("test_number_format");
+}
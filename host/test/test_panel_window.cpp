@@ -0,0 +1,347 @@
+/*
+ * JD9613 window commands of src/LilyGo_Wristband.cpp on the recorded SPI stream.
+ *
+ * The driver is compiled as is (the quoted includes of the .cpp resolve to src/) against
+ * the recording panel IO of HostPanelIO.h. Every pushColors is decoded the way the
+ * controller would: CASET/RASET big endian with inclusive ends, the window skipped when
+ * it did not change and sent again after anything that may have moved it, and the
+ * pixels landing where the software rotation says they do, also when frames follow
+ * each other faster than the bus sends them.
+ */
+#include "HostRuntime.h"
+#include "HostTest.h"
+#include "PanelRam.h"
+#include "../../src/LilyGo_Wristband.cpp"
+
+static LilyGo_Wristband panel;
+
+static std::vector<uint16_t> pattern(uint32_t len)
+{
+    std::vector<uint16_t> data(len);
+    for (uint32_t i = 0; i < len; i++) {
+        data[i] = 0x1000 + i;
+    }
+    return data;
+}
+
+static std::string commands()
+{
+    std::string s;
+    for (const host_spi_transfer_t &t : hostSpiLog()) {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%s%02X", s.empty() ? "" : " ", t.cmd);
+        s += buf;
+    }
+    return s;
+}
+
+static bool window(const host_spi_transfer_t &t, int cmd, uint16_t start, uint16_t end)
+{
+    const uint8_t expected[] = {highByte(start), lowByte(start), highByte(end), lowByte(end)};
+    return t.cmd == cmd && !t.color && t.data == std::vector<uint8_t>(expected, expected + 4);
+}
+
+static uint32_t windowSkips()
+{
+    panel_queue_stats_t stats;
+    panel.getCommandQueueStats(&stats);
+    return stats.window_skips;
+}
+
+static void testBegin()
+{
+    hostSpiClear();
+    CHECK(panel.begin(false));
+    const std::vector<host_spi_transfer_t> &log = hostSpiLog();
+    uint32_t init = 0;
+    while (jd9613_cmd[init].len != 0xff) {
+        init++;
+    }
+    // Init sequence, MADCTL of rotation 1, SLPOUT, DISPON and no window yet
+    CHECK_EQ(log.size(), init + 3);
+    CHECK(log.size() == init + 3 && log[init].cmd == LCD_CMD_MADCTL && log[init + 1].cmd == LCD_CMD_SLPOUT &&
+          log[init + 2].cmd == LCD_CMD_DISPON);
+    CHECK_EQ(panel.getRotation(), 1);
+    CHECK_EQ(panel.width(), JD9613_HEIGHT);
+    CHECK_EQ(panel.height(), JD9613_WIDTH);
+}
+
+static void testRotation0()
+{
+    panel.setRotation(0);
+    std::vector<uint16_t> data = pattern(4 * 3);
+    hostSpiClear();
+    panel.pushColors(10, 20, 4, 3, data.data());
+    const std::vector<host_spi_transfer_t> &log = hostSpiLog();
+    CHECK(commands() == "2A 2B 2C");
+    CHECK(log.size() == 3 && window(log[0], LCD_CMD_CASET, 10, 13) && window(log[1], LCD_CMD_RASET, 20, 22));
+    CHECK(log.size() == 3 && log[2].color && log[2].data.size() == 4 * 3 * 2);
+
+    PanelRam ram;
+    ram.apply(log);
+    CHECK_EQ(ram.errors, 0);
+    bool exact = true;
+    for (uint16_t y = 0; y < 3; y++) {
+        for (uint16_t x = 0; x < 4; x++) {
+            exact &= ram.at(10 + x, 20 + y) == data[y * 4 + x];
+        }
+    }
+    CHECK(exact);
+
+    // Same window: RAMWR restarts at its origin, CASET/RASET are not needed
+    uint32_t skips = windowSkips();
+    hostSpiClear();
+    panel.pushColors(10, 20, 4, 3, data.data());
+    CHECK(commands() == "2C");
+    CHECK_EQ(windowSkips(), skips + 1);
+
+    // A command may move the window behind the cache's back
+    panel.setBrightness(100);
+    hostSpiClear();
+    panel.pushColors(10, 20, 4, 3, data.data());
+    CHECK(commands() == "2A 2B 2C");
+
+    // So does setting the rotation again, even to the same one
+    panel.setRotation(0);
+    hostSpiClear();
+    panel.pushColors(10, 20, 4, 3, data.data());
+    CHECK(commands() == "2A 2B 2C");
+
+    // A different window is always sent
+    hostSpiClear();
+    panel.pushColors(10, 21, 4, 3, data.data());
+    CHECK(commands() == "2A 2B 2C");
+}
+
+static void testHighByte()
+{
+    // Row 293 needs the high byte of both RASET addresses
+    std::vector<uint16_t> data = pattern(JD9613_WIDTH * 44);
+    hostSpiClear();
+    panel.pushColors(0, 250, JD9613_WIDTH, 44, data.data());
+    const std::vector<host_spi_transfer_t> &log = hostSpiLog();
+    CHECK(log.size() == 3 && window(log[0], LCD_CMD_CASET, 0, 125) && window(log[1], LCD_CMD_RASET, 250, 293));
+    CHECK(log.size() == 3 && log[1].data[2] == 0x01 && log[1].data[3] == 0x25);
+    PanelRam ram;
+    ram.apply(log);
+    CHECK_EQ(ram.errors, 0);
+    CHECK_EQ(ram.at(0, 250), data[0]);
+    CHECK_EQ(ram.at(125, 293), data.back());
+}
+
+static void testRotation2()
+{
+    // The panel is offset by two columns in this direction
+    panel.setRotation(2);
+    std::vector<uint16_t> data = pattern(4 * 3);
+    hostSpiClear();
+    panel.pushColors(10, 20, 4, 3, data.data());
+    const std::vector<host_spi_transfer_t> &log = hostSpiLog();
+    CHECK(log.size() == 3 && window(log[0], LCD_CMD_CASET, 12, 15) && window(log[1], LCD_CMD_RASET, 20, 22));
+}
+
+// Logical (x, y) of a rotation 1 or 3 block lands on panel (px, py)
+static void panelPoint(uint8_t rotation, uint16_t x, uint16_t y, uint16_t *px, uint16_t *py)
+{
+    if (rotation == 1) {
+        *px = JD9613_WIDTH - 1 - y;
+        *py = x;
+    } else {
+        *px = y;
+        *py = JD9613_HEIGHT - 1 - x;
+    }
+}
+
+static void testSoftwareRotation(uint8_t rotation)
+{
+    panel.setRotation(rotation);
+    CHECK_EQ(panel.width(), JD9613_HEIGHT);
+    CHECK_EQ(panel.height(), JD9613_WIDTH);
+
+    const uint16_t x = 100;
+    const uint16_t y = 30;
+    const uint16_t w = 5;
+    const uint16_t h = 3;
+    std::vector<uint16_t> data = pattern(w * h);
+    hostSpiClear();
+    panel.pushColors(x, y, w, h, data.data());
+    const std::vector<host_spi_transfer_t> &log = hostSpiLog();
+    CHECK(commands() == "2A 2B 2C");
+
+    // The window is the rotated block: logical rows across, logical columns down
+    uint16_t xs = rotation == 1 ? JD9613_WIDTH - (y + h) : y;
+    uint16_t ys = rotation == 1 ? x : JD9613_HEIGHT - (x + w);
+    CHECK(log.size() == 3 && window(log[0], LCD_CMD_CASET, xs, xs + h - 1) && window(log[1], LCD_CMD_RASET, ys, ys + w - 1));
+
+    PanelRam ram;
+    ram.apply(log);
+    CHECK_EQ(ram.errors, 0);
+    CHECK_EQ(ram.pixels, (uint32_t)w * h);
+    bool exact = true;
+    for (uint16_t j = 0; j < h; j++) {
+        for (uint16_t i = 0; i < w; i++) {
+            uint16_t px;
+            uint16_t py;
+            panelPoint(rotation, x + i, y + j, &px, &py);
+            exact &= ram.at(px, py) == data[j * w + i];
+        }
+    }
+    CHECK(exact);
+
+    // The whole logical screen covers the whole panel
+    std::vector<uint16_t> full = pattern(JD9613_HEIGHT * JD9613_WIDTH);
+    hostSpiClear();
+    panel.pushColors(0, 0, JD9613_HEIGHT, JD9613_WIDTH, full.data());
+    CHECK(hostSpiLog().size() == 3 && window(hostSpiLog()[0], LCD_CMD_CASET, 0, JD9613_WIDTH - 1) &&
+          window(hostSpiLog()[1], LCD_CMD_RASET, 0, JD9613_HEIGHT - 1));
+    ram.apply(hostSpiLog());
+    CHECK_EQ(ram.errors, 0);
+    uint16_t px;
+    uint16_t py;
+    panelPoint(rotation, 0, 0, &px, &py);
+    CHECK_EQ(ram.at(px, py), full[0]);
+    panelPoint(rotation, JD9613_HEIGHT - 1, JD9613_WIDTH - 1, &px, &py);
+    CHECK_EQ(ram.at(px, py), full.back());
+}
+
+static void testIndexed(uint8_t rotation)
+{
+    // 8-bit indexes expanded, and rotated where needed, into the panel RAM
+    panel.setRotation(rotation);
+    uint16_t palette[256];
+    for (uint32_t i = 0; i < 256; i++) {
+        palette[i] = (uint16_t)(((255 - i) << 8) | (i ^ 0x5A));
+    }
+    const uint16_t x = 17;
+    const uint16_t y = 9;
+    const uint16_t w = 31;
+    const uint16_t h = 12;
+    std::vector<uint8_t> data(w * h);
+    for (uint32_t i = 0; i < data.size(); i++) {
+        data[i] = (uint8_t)(i * 37 + 11);
+    }
+    hostSpiClear();
+    panel.pushIndexedColors(x, y, w, h, data.data(), palette);
+    PanelRam ram;
+    ram.apply(hostSpiLog());
+    CHECK_EQ(ram.errors, 0);
+    CHECK_EQ(ram.pixels, (uint32_t)w * h);
+    bool exact = true;
+    for (uint16_t j = 0; j < h; j++) {
+        for (uint16_t i = 0; i < w; i++) {
+            uint16_t px = x + i;
+            uint16_t py = y + j;
+            if (rotation & 1) {
+                panelPoint(rotation, x + i, y + j, &px, &py);
+            }
+            exact &= ram.at(px, py) == palette[data[j * w + i]];
+        }
+    }
+    CHECK(exact);
+}
+
+static void testWaitColor()
+{
+    // Back to back frames through the rotation buffer with an unchanged window: nothing
+    // on the bus waits for the first transfer, the driver must sleep until it is out
+    // before rotating the second frame over it. A spinning wait never lets the bus
+    // task run here and hangs the test.
+    panel.setRotation(1);
+    const uint16_t w = JD9613_HEIGHT;
+    const uint16_t h = JD9613_WIDTH;
+    std::vector<uint16_t> a = pattern(w * h);
+    std::vector<uint16_t> b(w * h);
+    for (uint32_t i = 0; i < b.size(); i++) {
+        b[i] = ~a[i];
+    }
+    const uint64_t frame_us = (uint64_t)w * h * 16 * 1000000 / DEFAULT_SCK_SPEED;
+    panel.pushColors(0, 0, w, h, a.data());
+    hostSpiClear();
+
+    uint64_t start = hostMicros();
+    panel.pushColors(0, 0, w, h, a.data());
+    uint64_t queued = hostMicros();
+    panel.pushColors(0, 0, w, h, b.data());
+    uint64_t second = hostMicros();
+    CHECK(queued - start < frame_us);
+    CHECK(second - start >= frame_us);
+
+    CHECK(commands() == "2C 2C");
+    std::vector<uint16_t> want(w * h);
+    const std::vector<host_spi_transfer_t> &log = hostSpiLog();
+    rotate_rgb565_cw(a.data(), want.data(), w, h);
+    CHECK(log.size() == 2 && !memcmp(log[0].data.data(), want.data(), want.size() * 2));
+    rotate_rgb565_cw(b.data(), want.data(), w, h);
+    CHECK(log.size() == 2 && !memcmp(log[1].data.data(), want.data(), want.size() * 2));
+}
+
+static void testAddrWindow()
+{
+    // Direct writes, no rotation: w and h are sizes, the window end is inclusive
+    panel.setRotation(0);
+    std::vector<uint16_t> data = pattern(7 * 8);
+    hostSpiClear();
+    panel.setAddrWindow(5, 6, 7, 8);
+    panel.pushColors(data.data(), data.size() * 2);
+    const std::vector<host_spi_transfer_t> &log = hostSpiLog();
+    CHECK(log.size() == 3 && window(log[0], LCD_CMD_CASET, 5, 11) && window(log[1], LCD_CMD_RASET, 6, 13));
+    PanelRam ram;
+    ram.apply(log);
+    CHECK_EQ(ram.errors, 0);
+    CHECK_EQ(ram.at(11, 13), data.back());
+
+    hostSpiClear();
+    panel.setAddrWindow(5, 6, 7, 8);
+    CHECK(hostSpiLog().empty());
+}
+
+static void testReset()
+{
+    // A bare panel on its own IO: a reset forgets the window, software reset without a pin
+    esp_lcd_panel_handle_t handle = NULL;
+    esp_lcd_panel_io_spi_config_t io_config;
+    memset(&io_config, 0, sizeof(io_config));
+    io_config.on_color_trans_done = panel_jd9613_color_trans_done;
+    io_config.user_ctx = &handle;
+    esp_lcd_panel_io_handle_t io = NULL;
+    CHECK_EQ(esp_lcd_new_panel_io_spi(0, &io_config, &io), ESP_OK);
+    esp_lcd_panel_dev_config_t panel_config;
+    memset(&panel_config, 0, sizeof(panel_config));
+    panel_config.reset_gpio_num = -1;
+    panel_config.bits_per_pixel = 16;
+    CHECK_EQ(esp_lcd_new_panel_jd9613(io, &panel_config, &handle), ESP_OK);
+    if (!handle) {
+        return;
+    }
+    panel_jd9613_set_rotation(handle, 0);
+
+    std::vector<uint16_t> data = pattern(2 * 2);
+    hostSpiClear();
+    esp_lcd_panel_draw_bitmap(handle, 1, 1, 3, 3, data.data());
+    esp_lcd_panel_draw_bitmap(handle, 1, 1, 3, 3, data.data());
+    esp_lcd_panel_reset(handle);
+    esp_lcd_panel_draw_bitmap(handle, 1, 1, 3, 3, data.data());
+    CHECK(commands() == "2A 2B 2C 2C 01 2A 2B 2C");
+
+    esp_lcd_panel_del(handle);
+    esp_lcd_panel_io_del(io);
+}
+
+int main()
+{
+    hostSerialMute(true);
+    testBegin();
+    testRotation0();
+    testHighByte();
+    testRotation2();
+    testSoftwareRotation(1);
+    testSoftwareRotation(3);
+    testIndexed(0);
+    testIndexed(1);
+    testIndexed(3);
+    testWaitColor();
+    testAddrWindow();
+    testReset();
+    hostSerialMute(false);
+    return testResult("test_panel_window");
+}
@@ -0,0 +1,244 @@
+/*
+ * RaceBox Data Message decoding of the sketch against a golden payload.
+ *
+ * The payload is written out byte by byte from the RaceBox protocol description, every
+ * field a different value with its sign and byte order visible, so a shifted offset in
+ * the RBX_FIELDS table decodes to a wrong value here even though the table itself stays
+ * gapless. The host session encoder must produce the same bytes from the decoded fix.
+ *
+ * WIRE_FRAME is a whole data message the way a RaceBox standing still sends it, sync to
+ * checksum, after the example message of the protocol description: it must come out of
+ * the framer in one notification or split across several and decode to the values
+ * listed with it.
+ */
+#include "HostTest.h"
+#include "RaceBoxData.h"
+#include "RaceBoxSession.h"
+#include "UbxFramer.h"
+#include <vector>
+
+static const uint8_t GOLDEN[RACEBOX_PAYLOAD_LEN] = {
+    0xA0, 0xE7, 0x0C, 0x07,     //  0 iTOW 118286240 ms
+    0xE6, 0x07,                 //  4 year 2022
+    0x01,                       //  6 month 1
+    0x0A,                       //  7 day 10
+    0x08,                       //  8 hour 8
+    0x33,                       //  9 minute 51
+    0x08,                       // 10 second 8
+    0x37,                       // 11 validity
+    0x19, 0x00, 0x00, 0x00,     // 12 time accuracy 25 ns
+    0x79, 0x29, 0xED, 0xFF,     // 16 nanoseconds -1234567
+    0x03,                       // 20 fix status 3D
+    0x01,                       // 21 fix flags, valid fix
+    0xEA,                       // 22 date/time flags
+    0x0B,                       // 23 satellites 11
+    0x39, 0xD5, 0x63, 0xFF,     // 24 longitude -1.0234567
+    0x61, 0xC7, 0x09, 0x1F,     // 28 latitude 52.0734561
+    0x6B, 0x4A, 0x02, 0x00,     // 32 WGS altitude 150123 mm
+    0x6C, 0xEE, 0xFF, 0xFF,     // 36 MSL altitude -4500 mm
+    0x2C, 0x03, 0x00, 0x00,     // 40 horizontal accuracy 812 mm
+    0xFE, 0x05, 0x00, 0x00,     // 44 vertical accuracy 1534 mm
+    0x30, 0x89, 0x00, 0x00,     // 48 speed 35120 mm/s
+    0x0E, 0x43, 0xA1, 0x01,     // 52 heading 273.45678
+    0xB0, 0x00, 0x00, 0x00,     // 56 speed accuracy 176 mm/s
+    0xD8, 0x47, 0x03, 0x00,     // 60 heading accuracy 2.15
+    0x84, 0x00,                 // 64 PDOP 1.32
+    0x00,                       // 66 lat/lon flags, valid
+    0x8F,                       // 67 battery, charging 15 %
+    0xE9, 0xFF,                 // 68 G x -23 mg
+    0xDB, 0x03,                 // 70 G y 987 mg
+    0xEB, 0x03,                 // 72 G z 1003 mg
+    0x6A, 0xFF,                 // 74 rotation x -1.50 deg/s
+    0x0C, 0x00,                 // 76 rotation y 0.12 deg/s
+    0x76, 0xF3,                 // 78 rotation z -32.10 deg/s
+};
+
+static const uint8_t WIRE_FRAME[UBX_HEADER_SIZE + RACEBOX_PAYLOAD_LEN + 2] = {
+    0xB5, 0x62, 0xFF, 0x01, 0x50, 0x00,
+    0xA0, 0xE7, 0x0C, 0x07, 0xE6, 0x07, 0x01, 0x0A, 0x08, 0x33, 0x08, 0x37, 0x19, 0x00, 0x00, 0x00,
+    0x2A, 0xAD, 0x4D, 0x0E, 0x03, 0x01, 0xEA, 0x0B, 0xC6, 0x93, 0xE1, 0x0D, 0x3B, 0x37, 0x6F, 0x19,
+    0x61, 0x8C, 0x09, 0x00, 0x0C, 0x4C, 0x08, 0x00, 0x9A, 0x01, 0x00, 0x00, 0x2C, 0x01, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xD0, 0x00, 0x00, 0x00, 0x88, 0xA9, 0xDD, 0x00,
+    0x2C, 0x01, 0x00, 0x59, 0xFD, 0xFF, 0x71, 0x00, 0xCE, 0x03, 0x2F, 0xFF, 0x56, 0x00, 0xFC, 0xFF,
+    0x20, 0xF6,
+};
+
+static void testOffsets()
+{
+    // The fields the lap timer gates on
+    CHECK_EQ(RBX_FIELDS[RBX_ITOW].offset, 0);
+    CHECK_EQ(RBX_FIELDS[RBX_FIX_STATUS].offset, 20);
+    CHECK_EQ(RBX_FIELDS[RBX_FIX_FLAGS].offset, 21);
+    CHECK_EQ(RBX_FIELDS[RBX_NUM_SV].offset, 23);
+    CHECK_EQ(RBX_FIELDS[RBX_LON].offset, 24);
+    CHECK_EQ(RBX_FIELDS[RBX_LAT].offset, 28);
+    CHECK_EQ(RBX_FIELDS[RBX_SPEED].offset, 48);
+    CHECK_EQ(RBX_FIELDS[RBX_HEADING].offset, 52);
+}
+
+static void testDecodeAll()
+{
+    rbx_fix_t fix;
+    memset(&fix, 0, sizeof(fix));
+    CHECK(rbxDecode(GOLDEN, sizeof(GOLDEN), RBX_F_ALL, &fix));
+    CHECK_EQ(fix.mask, RBX_F_ALL);
+    CHECK_EQ(fix.itow_ms, 118286240u);
+    CHECK_EQ(fix.year, 2022);
+    CHECK_EQ(fix.month, 1);
+    CHECK_EQ(fix.day, 10);
+    CHECK_EQ(fix.hour, 8);
+    CHECK_EQ(fix.minute, 51);
+    CHECK_EQ(fix.second, 8);
+    CHECK_EQ(fix.validity, 0x37);
+    CHECK_EQ(fix.time_acc_ns, 25u);
+    CHECK_EQ(fix.nano, -1234567);
+    CHECK_EQ(fix.fix_status, 3);
+    CHECK_EQ(fix.fix_flags, 0x01);
+    CHECK_EQ(fix.datetime_flags, 0xEA);
+    CHECK_EQ(fix.num_sv, 11);
+    CHECK_EQ(fix.lon, -10234567);
+    CHECK_EQ(fix.lat, 520734561);
+    CHECK_EQ(fix.alt_wgs_mm, 150123);
+    CHECK_EQ(fix.alt_msl_mm, -4500);
+    CHECK_EQ(fix.h_acc_mm, 812u);
+    CHECK_EQ(fix.v_acc_mm, 1534u);
+    CHECK_EQ(fix.speed_mm_s, 35120);
+    CHECK_EQ(fix.heading, 27345678);
+    CHECK_EQ(fix.speed_acc_mm_s, 176u);
+    CHECK_EQ(fix.heading_acc, 215000u);
+    CHECK_EQ(fix.pdop, 132);
+    CHECK_EQ(fix.latlon_flags, 0x00);
+    CHECK_EQ(fix.battery, 0x8F);
+    CHECK_EQ(fix.g_mg[0], -23);
+    CHECK_EQ(fix.g_mg[1], 987);
+    CHECK_EQ(fix.g_mg[2], 1003);
+    CHECK_EQ(fix.rot_cdps[0], -150);
+    CHECK_EQ(fix.rot_cdps[1], 12);
+    CHECK_EQ(fix.rot_cdps[2], -3210);
+}
+
+static void testMask()
+{
+    // Only the requested groups are written, the rest keeps its previous value
+    rbx_fix_t fix;
+    memset(&fix, 0xCC, sizeof(fix));
+    CHECK(rbxDecode(GOLDEN, sizeof(GOLDEN), RBX_F_FIX | RBX_F_MOTION, &fix));
+    CHECK_EQ(fix.mask, RBX_F_FIX | RBX_F_MOTION);
+    CHECK_EQ(fix.fix_status, 3);
+    CHECK_EQ(fix.num_sv, 11);
+    CHECK_EQ(fix.speed_mm_s, 35120);
+    CHECK_EQ(fix.itow_ms, 0xCCCCCCCCu);
+    CHECK_EQ(fix.lat, (int32_t)0xCCCCCCCC);
+    CHECK_EQ(fix.battery, 0xCC);
+
+    // Too short to be a data message: nothing decoded
+    memset(&fix, 0xCC, sizeof(fix));
+    CHECK(!rbxDecode(GOLDEN, RACEBOX_PAYLOAD_LEN - 1, RBX_F_ALL, &fix));
+    CHECK_EQ(fix.mask, 0xCCCCCCCCu);
+}
+
+static void testView()
+{
+    RaceBoxView v;
+    CHECK(!v.attach(GOLDEN, RACEBOX_PAYLOAD_LEN - 1));
+    CHECK(v.attach(GOLDEN, RACEBOX_PAYLOAD_LEN));
+    CHECK_EQ(v.u<RBX_ITOW>(), 118286240u);
+    CHECK_EQ(v.u<RBX_FIX_STATUS>(), 3u);
+    CHECK_EQ(v.u<RBX_FIX_FLAGS>(), 1u);
+    CHECK_EQ(v.u<RBX_NUM_SV>(), 11u);
+    CHECK_EQ(v.i<RBX_NANO>(), -1234567);
+    CHECK_EQ(v.i<RBX_G_X>(), -23);
+    CHECK_EQ(v.u<RBX_G_X>(), 0xFFE9u);
+}
+
+static void testEncoder()
+{
+    // The host sessions are built with the same layout
+    rbx_fix_t fix;
+    memset(&fix, 0, sizeof(fix));
+    rbxDecode(GOLDEN, sizeof(GOLDEN), RBX_F_ALL, &fix);
+    uint8_t frame[SESSION_FRAME_SIZE];
+    CHECK_EQ(rbxEncodeFrame(fix, frame), SESSION_FRAME_SIZE);
+    CHECK(frame[2] == RACEBOX_MSG_CLASS && frame[3] == RACEBOX_MSG_ID);
+    CHECK(memcmp(frame + 6, GOLDEN, RACEBOX_PAYLOAD_LEN) == 0);
+}
+
+static std::vector<uint8_t> wirePayload;
+
+static void onWireFrame(uint8_t msgClass, uint8_t msgId, const uint8_t *payload, uint16_t len, void *user)
+{
+    (void)user;
+    if (msgClass == RACEBOX_MSG_CLASS && msgId == RACEBOX_MSG_ID) {
+        wirePayload.assign(payload, payload + len);
+    }
+}
+
+static void testWireFrame()
+{
+    // In one piece and in the 20 byte notifications of the default MTU
+    for (size_t piece : {sizeof(WIRE_FRAME), (size_t)20}) {
+        UbxFramer framer(onWireFrame);
+        wirePayload.clear();
+        uint32_t frames = 0;
+        for (size_t i = 0; i < sizeof(WIRE_FRAME); i += piece) {
+            frames += framer.push(WIRE_FRAME + i, std::min(piece, sizeof(WIRE_FRAME) - i));
+        }
+        CHECK_EQ(frames, 1u);
+        CHECK_EQ(wirePayload.size(), (size_t)RACEBOX_PAYLOAD_LEN);
+    }
+
+    rbx_fix_t fix;
+    memset(&fix, 0, sizeof(fix));
+    if (!CHECK(rbxDecode(wirePayload.data(), wirePayload.size(), RBX_F_ALL, &fix))) {
+        return;
+    }
+    CHECK_EQ(fix.itow_ms, 118286240u);
+    CHECK_EQ(fix.year, 2022);
+    CHECK_EQ(fix.month, 1);
+    CHECK_EQ(fix.day, 10);
+    CHECK_EQ(fix.hour, 8);
+    CHECK_EQ(fix.minute, 51);
+    CHECK_EQ(fix.second, 8);
+    CHECK_EQ(fix.validity, 0x37);
+    CHECK_EQ(fix.time_acc_ns, 25u);
+    CHECK_EQ(fix.nano, 239971626);
+    CHECK_EQ(fix.fix_status, 3);
+    CHECK_EQ(fix.fix_flags, 0x01);
+    CHECK_EQ(fix.datetime_flags, 0xEA);
+    CHECK_EQ(fix.num_sv, 11);
+    CHECK_EQ(fix.lon, 232887238);
+    CHECK_EQ(fix.lat, 426719035);
+    CHECK_EQ(fix.alt_wgs_mm, 625761);
+    CHECK_EQ(fix.alt_msl_mm, 543756);
+    CHECK_EQ(fix.h_acc_mm, 410u);
+    CHECK_EQ(fix.v_acc_mm, 300u);
+    CHECK_EQ(fix.speed_mm_s, 0);
+    CHECK_EQ(fix.heading, 0);
+    CHECK_EQ(fix.speed_acc_mm_s, 208u);
+    CHECK_EQ(fix.heading_acc, 14526856u);
+    CHECK_EQ(fix.pdop, 300);
+    CHECK_EQ(fix.latlon_flags, 0x00);
+    CHECK_EQ(fix.battery, 89);
+    CHECK_EQ(fix.g_mg[0], -3);
+    CHECK_EQ(fix.g_mg[1], 113);
+    CHECK_EQ(fix.g_mg[2], 974);
+    CHECK_EQ(fix.rot_cdps[0], -209);
+    CHECK_EQ(fix.rot_cdps[1], 86);
+    CHECK_EQ(fix.rot_cdps[2], -4);
+
+    // Re-encoded it is the same frame, checksum included
+    uint8_t frame[SESSION_FRAME_SIZE];
+    CHECK_EQ(rbxEncodeFrame(fix, frame), sizeof(WIRE_FRAME));
+    CHECK(memcmp(frame, WIRE_FRAME, sizeof(WIRE_FRAME)) == 0);
+}
+
+int main()
+{
+    testOffsets();
+    testDecodeAll();
+    testMask();
+    testView();
+    testEncoder();
+    testWireFrame();
+    return testResult("test_racebox_data");
+}
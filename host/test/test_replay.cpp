@@ -0,0 +1,215 @@
+/*
+ * RaceBoxReplay of the sketch against a synthetic session held in memory.
+ *
+ * Every record must reach the parse stage once, in order and byte for byte: as fast as
+ * possible in batches, or no earlier than its capture time scaled by the speed. A
+ * truncated or foreign file ends the replay cleanly. A RaceBoxCapture file of the same
+ * notifications replays to the same payloads.
+ */
+#include "HostRuntime.h"
+#include "HostTest.h"
+#include "MemoryStream.h"
+#include "RaceBoxSession.h"
+#include "RaceBoxCapture.h"
+#include "RaceBoxReplay.h"
+#include <vector>
+
+#define SERVICE_US      100             // Sleep of the paced service loop
+
+typedef struct {
+    uint32_t t_us;                  // Since the replay started
+    std::vector<uint8_t> payload;
+} parsed_t;
+
+static std::vector<parsed_t> parsed;
+static uint32_t replay_start;
+static uint32_t lap_calls;
+
+static void parse(uint8_t *data, size_t len)
+{
+    parsed.push_back({micros() - replay_start, std::vector<uint8_t>(data, data + len)});
+}
+
+static void lap()
+{
+    lap_calls++;
+}
+
+static const rbx_pipeline_t pipeline = {parse, lap, NULL};
+
+// The notifications of a short session and their capture file
+static std::vector<std::vector<uint8_t>> frames;
+static std::vector<uint32_t> times;
+
+static MemoryStream captureFile(size_t count)
+{
+    MemoryStream file;
+    file.write((const uint8_t *)RBX_MAGIC, 4);
+    for (size_t i = 0; i < count; i++) {
+        rbx_record_t record = {times[i], (uint16_t)frames[i].size()};
+        file.write((const uint8_t *)&record, sizeof(record));
+        file.write(frames[i].data(), frames[i].size());
+    }
+    return file;
+}
+
+static void makeSession()
+{
+    RaceBoxSession session(sessionDefaults(1));
+    uint32_t count = session.fixCount() < 400 ? session.fixCount() : 400;
+    for (uint32_t i = 0; i < count; i++) {
+        rbx_fix_t fix;
+        session.fix(i, &fix);
+        std::vector<uint8_t> frame(SESSION_FRAME_SIZE);
+        frame.resize(rbxEncodeFrame(fix, frame.data()));
+        frames.push_back(frame);
+        times.push_back(i * 1000000 / 25);
+    }
+}
+
+static bool startReplay(RaceBoxReplay &replay, MemoryStream &file, float speed)
+{
+    parsed.clear();
+    lap_calls = 0;
+    file.pos = 0;
+    replay_start = micros();
+    return replay.start(file, pipeline, speed);
+}
+
+static bool payloadsMatch(size_t count)
+{
+    if (parsed.size() != count) {
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (parsed[i].payload != frames[i]) {
+            printf("record %zu differs\n", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void testFastest()
+{
+    MemoryStream file = captureFile(frames.size());
+    RaceBoxReplay replay;
+    CHECK(startReplay(replay, file, 0));
+    uint32_t calls = 0;
+    size_t before = 0;
+    bool batched = true;
+    while (replay.service()) {
+        calls++;
+        batched &= parsed.size() - before <= RBX_REPLAY_BATCH;
+        before = parsed.size();
+    }
+    CHECK(batched);
+    CHECK(calls >= frames.size() / RBX_REPLAY_BATCH);
+    CHECK(payloadsMatch(frames.size()));
+    CHECK_EQ(replay.messages(), frames.size());
+    CHECK_EQ(lap_calls, frames.size());
+    CHECK(!replay.active());
+    CHECK(!replay.service());
+}
+
+static void testPaced(float speed)
+{
+    MemoryStream file = captureFile(100);
+    RaceBoxReplay replay;
+    CHECK(startReplay(replay, file, speed));
+    while (replay.service()) {
+        delayMicroseconds(SERVICE_US);
+    }
+    CHECK(payloadsMatch(100));
+    bool onTime = true;
+    for (size_t i = 0; i < parsed.size(); i++) {
+        uint32_t due = (uint32_t)(times[i] / speed);
+        if (parsed[i].t_us < due || parsed[i].t_us > due + SERVICE_US) {
+            printf("speed %.0f: record %zu at %u us, due %u us\n", speed, i, parsed[i].t_us, due);
+            onTime = false;
+            break;
+        }
+    }
+    CHECK(onTime);
+}
+
+static void testTruncated()
+{
+    // Cut inside the payload of the 11th record: ten are played and the replay stops
+    MemoryStream file = captureFile(11);
+    file.data.resize(file.data.size() - 5);
+    RaceBoxReplay replay;
+    CHECK(startReplay(replay, file, 0));
+    while (replay.service()) {
+    }
+    CHECK(payloadsMatch(10));
+    CHECK(!replay.active());
+
+    // A length past RBX_MAX_RECORD is not read into the payload buffer
+    file = captureFile(3);
+    rbx_record_t bad = {times[3], RBX_MAX_RECORD + 1};
+    file.write((const uint8_t *)&bad, sizeof(bad));
+    file.data.resize(file.data.size() + RBX_MAX_RECORD + 1, 0);
+    CHECK(startReplay(replay, file, 0));
+    while (replay.service()) {
+    }
+    CHECK(payloadsMatch(3));
+}
+
+static void testBadMagic()
+{
+    MemoryStream file = captureFile(3);
+    file.data[3] = '2';
+    RaceBoxReplay replay;
+    CHECK(!startReplay(replay, file, 0));
+    CHECK(!replay.active());
+
+    MemoryStream empty;
+    CHECK(!startReplay(replay, empty, 0));
+
+    // Without a parse stage there is nothing to replay into
+    file = captureFile(3);
+    rbx_pipeline_t none = {NULL, lap, NULL};
+    CHECK(!replay.start(file, none, 0));
+}
+
+static void testCaptureRoundTrip()
+{
+    // Notifications recorded at 25 Hz replay to the same payloads at the same times
+    MemoryStream file;
+    RaceBoxCapture capture;
+    CHECK(capture.start(file));
+    for (size_t i = 0; i < 50; i++) {
+        capture.record(frames[i].data(), frames[i].size());
+        if (i % 8 == 7) {
+            capture.service();
+        }
+        delay(40);
+    }
+    capture.stop();
+    rbx_capture_stats_t stats;
+    capture.getStats(&stats);
+    CHECK_EQ(stats.records, 50);
+    CHECK_EQ(stats.dropped, 0);
+    CHECK_EQ(file.data.size(), 4 + stats.bytes);
+
+    RaceBoxReplay replay;
+    CHECK(startReplay(replay, file, 1));
+    while (replay.service()) {
+        delayMicroseconds(SERVICE_US);
+    }
+    CHECK(payloadsMatch(50));
+    CHECK(!parsed.empty() && parsed.back().t_us >= 49 * 40000 && parsed.back().t_us <= 49 * 40000 + SERVICE_US);
+}
+
+int main()
+{
+    makeSession();
+    testFastest();
+    testPaced(1);
+    testPaced(4);
+    testTruncated();
+    testBadMagic();
+    testCaptureRoundTrip();
+    return testResult("test_replay");
+}
@@ -0,0 +1,212 @@
+/*
+ * The tiled, paired transposes of src/LilyGo_Rotation.cpp against the per pixel
+ * definitions in LilyGo_Rotation.h, for every block size up to a few tiles, the panel
+ * sized blocks, and buffers that are misaligned so the scalar fallback runs. Pixels
+ * around the destination block must stay untouched.
+ *
+ * The 8-bit indexed variants are held to the same definitions, each pixel being the
+ * palette entry of the source index.
+ */
+#include "HostTest.h"
+#include "LilyGo_Rotation.h"
+#include <vector>
+
+#define GUARD           8               // Pixels checked on both sides of the destination
+#define GUARD_VALUE     0xA5A5
+
+// Pixel values that differ in both bytes, so swapped halves of a 32-bit pair show up
+static std::vector<uint16_t> pattern(uint32_t len, uint32_t offset)
+{
+    std::vector<uint16_t> data(len + offset);
+    for (uint32_t i = 0; i < len; i++) {
+        data[offset + i] = (uint16_t)(i * 0x0101 + 0x1234);
+    }
+    return data;
+}
+
+static uint16_t expectedCw(const uint16_t *src, uint32_t width, uint32_t height, uint32_t j, uint32_t i)
+{
+    return src[(height - 1 - i) * width + j];
+}
+
+static uint16_t expectedCcw(const uint16_t *src, uint32_t width, uint32_t height, uint32_t j, uint32_t i)
+{
+    (void)height;
+    return src[i * width + (width - 1 - j)];
+}
+
+// offsets in pixels: 0 keeps both buffers 32-bit aligned
+static bool rotatesExactly(bool cw, uint32_t width, uint32_t height, uint32_t srcOffset, uint32_t dstOffset)
+{
+    uint32_t len = width * height;
+    std::vector<uint16_t> src = pattern(len, srcOffset);
+    std::vector<uint16_t> dst(dstOffset + GUARD + len + GUARD, GUARD_VALUE);
+    const uint16_t *s = src.data() + srcOffset;
+    uint16_t *d = dst.data() + dstOffset + GUARD;
+    if (cw) {
+        rotate_rgb565_cw(s, d, width, height);
+    } else {
+        rotate_rgb565_ccw(s, d, width, height);
+    }
+    for (uint32_t j = 0; j < width; j++) {
+        for (uint32_t i = 0; i < height; i++) {
+            uint16_t want = cw ? expectedCw(s, width, height, j, i) : expectedCcw(s, width, height, j, i);
+            if (d[j * height + i] != want) {
+                printf("%s %ux%u +%u/+%u: dst[%u][%u] = 0x%04X, expected 0x%04X\n", cw ? "cw" : "ccw",
+                       width, height, srcOffset, dstOffset, j, i, d[j * height + i], want);
+                return false;
+            }
+        }
+    }
+    for (uint32_t g = 0; g < GUARD; g++) {
+        if (d[-1 - (int)g] != GUARD_VALUE || d[len + g] != GUARD_VALUE) {
+            printf("%s %ux%u: wrote outside the block\n", cw ? "cw" : "ccw", width, height);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void testSizes()
+{
+    // Every size up to three tiles, odd and even, aligned and not
+    const uint32_t max = 3 * ROTATION_TILE_SIZE + 1;
+    for (int cw = 0; cw < 2; cw++) {
+        bool all = true;
+        for (uint32_t w = 1; w <= max && all; w++) {
+            for (uint32_t h = 1; h <= max && all; h++) {
+                all &= rotatesExactly(cw, w, h, 0, 0);
+                all &= rotatesExactly(cw, w, h, 1, 0);
+                all &= rotatesExactly(cw, w, h, 0, 1);
+            }
+        }
+        CHECK(all);
+    }
+}
+
+static void testPanelBlocks()
+{
+    // Full screen in both orientations and an LVGL band of the logical 294 x 126 screen
+    const uint32_t sizes[][2] = {{294, 126}, {126, 294}, {294, 40}, {294, 1}, {1, 126}};
+    for (const uint32_t *s : sizes) {
+        CHECK(rotatesExactly(true, s[0], s[1], 0, 0));
+        CHECK(rotatesExactly(false, s[0], s[1], 0, 0));
+        CHECK(rotatesExactly(true, s[0], s[1], 1, 1));
+        CHECK(rotatesExactly(false, s[0], s[1], 1, 1));
+    }
+}
+
+static void testInverse()
+{
+    // A clockwise turn of the counter-clockwise one is the original block
+    const uint32_t width = 294;
+    const uint32_t height = 126;
+    std::vector<uint16_t> src = pattern(width * height, 0);
+    std::vector<uint16_t> ccw(width * height);
+    std::vector<uint16_t> back(width * height);
+    rotate_rgb565_ccw(src.data(), ccw.data(), width, height);
+    rotate_rgb565_cw(ccw.data(), back.data(), height, width);
+    CHECK(back == src);
+}
+
+// A palette whose entries differ in both bytes and from their index
+static std::vector<uint16_t> palette()
+{
+    std::vector<uint16_t> colors(256);
+    for (uint32_t i = 0; i < 256; i++) {
+        colors[i] = (uint16_t)(((255 - i) << 8) | (i ^ 0x5A));
+    }
+    return colors;
+}
+
+// mode: 0 expand, 1 clockwise, 2 counter-clockwise. Offsets in bytes for src, pixels for dst.
+static bool indexedExactly(int mode, uint32_t width, uint32_t height, uint32_t srcOffset, uint32_t dstOffset)
+{
+    static const char *names[] = {"expand", "index cw", "index ccw"};
+    std::vector<uint16_t> colors = palette();
+    uint32_t len = width * height;
+    std::vector<uint8_t> src(srcOffset + len);
+    for (uint32_t i = 0; i < len; i++) {
+        src[srcOffset + i] = (uint8_t)(i * 37 + 11);
+    }
+    std::vector<uint16_t> dst(dstOffset + GUARD + len + GUARD, GUARD_VALUE);
+    const uint8_t *s = src.data() + srcOffset;
+    uint16_t *d = dst.data() + dstOffset + GUARD;
+    if (mode == 0) {
+        expand_index8(s, d, len, colors.data());
+    } else if (mode == 1) {
+        rotate_index8_cw(s, d, width, height, colors.data());
+    } else {
+        rotate_index8_ccw(s, d, width, height, colors.data());
+    }
+    for (uint32_t j = 0; j < width; j++) {
+        for (uint32_t i = 0; i < height; i++) {
+            uint32_t out = mode == 0 ? i * width + j : j * height + i;
+            uint32_t in = mode == 0 ? out : mode == 1 ? (height - 1 - i) * width + j : i * width + (width - 1 - j);
+            if (d[out] != colors[s[in]]) {
+                printf("%s %ux%u +%u/+%u: dst[%u] = 0x%04X, expected 0x%04X\n", names[mode], width, height,
+                       srcOffset, dstOffset, out, d[out], colors[s[in]]);
+                return false;
+            }
+        }
+    }
+    for (uint32_t g = 0; g < GUARD; g++) {
+        if (d[-1 - (int)g] != GUARD_VALUE || d[len + g] != GUARD_VALUE) {
+            printf("%s %ux%u: wrote outside the block\n", names[mode], width, height);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void testIndexed()
+{
+    // Every index at every source byte alignment, odd and even heights, both paths
+    const uint32_t max = 2 * ROTATION_TILE_SIZE + 3;
+    for (int mode = 0; mode < 3; mode++) {
+        bool all = true;
+        for (uint32_t w = 1; w <= max && all; w++) {
+            for (uint32_t h = 1; h <= max && all; h++) {
+                for (uint32_t offset = 0; offset < 4 && all; offset++) {
+                    all &= indexedExactly(mode, w, h, offset, 0);
+                }
+                all &= indexedExactly(mode, w, h, 0, 1);
+            }
+        }
+        CHECK(all);
+        CHECK(indexedExactly(mode, 294, 126, 0, 0));
+        CHECK(indexedExactly(mode, 294, 40, 1, 1));
+    }
+}
+
+static void testIndexedMatchesRgb565()
+{
+    // Expanding then rotating gives the same panel pixels as rotating the indexes
+    const uint32_t width = 294;
+    const uint32_t height = 40;
+    std::vector<uint16_t> colors = palette();
+    std::vector<uint8_t> src(width * height);
+    for (uint32_t i = 0; i < src.size(); i++) {
+        src[i] = (uint8_t)(i * 2654435761u >> 24);
+    }
+    std::vector<uint16_t> expanded(src.size());
+    std::vector<uint16_t> viaRgb(src.size());
+    std::vector<uint16_t> direct(src.size());
+    expand_index8(src.data(), expanded.data(), src.size(), colors.data());
+    rotate_rgb565_cw(expanded.data(), viaRgb.data(), width, height);
+    rotate_index8_cw(src.data(), direct.data(), width, height, colors.data());
+    CHECK(direct == viaRgb);
+    rotate_rgb565_ccw(expanded.data(), viaRgb.data(), width, height);
+    rotate_index8_ccw(src.data(), direct.data(), width, height, colors.data());
+    CHECK(direct == viaRgb);
+}
+
+int main()
+{
+    testSizes();
+    testPanelBlocks();
+    testInverse();
+    testIndexed();
+    testIndexedMatchesRgb565();
+    return testResult("test_rotation");
+}
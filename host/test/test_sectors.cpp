@@ -0,0 +1,268 @@
+/*
+ * SectorTimer of the sketch on synthetic sessions of RaceBoxSession.h, fed the way
+ * checkLapCrossing() does: finish gate, then the split gates while a lap runs.
+ *
+ * The session knows when every point of the lap is passed, so each sector time must be
+ * the exact one to the millisecond of rounding at either end. Bests, the delta of each
+ * closed sector against the best before it, the theoretical best, a standing start, a
+ * missed split gate and gates off the track are checked against that, and the split
+ * gates survive a trip through NVS.
+ */
+#include "HostRuntime.h"
+#include "HostTest.h"
+#include "RaceBoxSession.h"
+#include "Sectors.h"
+#include <vector>
+
+// What the timer reported over a session, sector times per lap
+typedef struct {
+    std::vector<std::vector<uint32_t>> sectors;
+    std::vector<bool> complete;
+    std::vector<int32_t> deltas;        // lastDelta() of every closed sector, 0 without a best
+    std::vector<bool> hasDelta;
+} run_t;
+
+static std::vector<float> splitAt;
+
+static void addSplits(SectorTimer &timer, const RaceBoxSession &session, const std::vector<float> &s, bool heading)
+{
+    timer.clearSplits();
+    splitAt = s;
+    for (float d : s) {
+        float h;
+        int32_t lat;
+        int32_t lon;
+        session.toLatLon(session.position(d, &h), &lat, &lon);
+        CHECK(timer.addSplit(lat, lon, heading ? h : NAN));
+    }
+}
+
+// skip: fixes between these iTOWs are lost, e.g. a gap in the BLE link
+static run_t run(SectorTimer &timer, const RaceBoxSession &session, const session_params_t &p, bool flying = true,
+                 uint32_t skipFrom = 0, uint32_t skipTo = 0)
+{
+    TrackFrame frame;
+    frame.set(p.lat, p.lon);
+    timer.setFrame(frame);
+    LapGate finish;
+    finish.set(frame.project(p.lat, p.lon), 0);
+
+    run_t r;
+    bool lapInProgress = false;
+    for (uint32_t i = 0; i < session.fixCount(); i++) {
+        rbx_fix_t fix;
+        session.fix(i, &fix);
+        if (fix.itow_ms >= skipFrom && fix.itow_ms < skipTo) {
+            continue;
+        }
+        enu_t pos = frame.project(fix.lat, fix.lon);
+        uint32_t cross;
+        bool crossed = finish.update(pos, fix.itow_ms, &cross);
+        if (lapInProgress && timer.update(pos, fix.itow_ms)) {
+            r.deltas.push_back(timer.lastHasDelta() ? timer.lastDelta() : 0);
+            r.hasDelta.push_back(timer.lastHasDelta());
+        }
+        if (!crossed) {
+            continue;
+        }
+        if (!flying && !lapInProgress) {
+            // GO! on the line: the lap runs from this fix, not from the crossing
+            timer.startLap(fix.itow_ms, false);
+            lapInProgress = true;
+            continue;
+        }
+        if (lapInProgress) {
+            bool complete = timer.finishLap(cross);
+            if (complete) {
+                r.deltas.push_back(timer.lastHasDelta() ? timer.lastDelta() : 0);
+                r.hasDelta.push_back(timer.lastHasDelta());
+            }
+            r.complete.push_back(complete);
+            std::vector<uint32_t> lap;
+            for (uint8_t k = 0; k < timer.sectors(); k++) {
+                lap.push_back(timer.lapSector(k));
+            }
+            r.sectors.push_back(lap);
+        }
+        timer.startLap(cross, true);
+        lapInProgress = true;
+    }
+    return r;
+}
+
+// Exact sector k of lap, 0 = the lap after the first crossing
+static double exactSector(const RaceBoxSession &session, uint8_t lap, uint8_t k)
+{
+    float from = k == 0 ? 0.0f : splitAt[k - 1];
+    float to = k == splitAt.size() ? session.lapLength() : splitAt[k];
+    return session.timeAt(lap, to) - session.timeAt(lap, from);
+}
+
+static bool sectorsExact(const RaceBoxSession &session, const run_t &r)
+{
+    if (r.sectors.size() != session.laps()) {
+        printf("%zu laps timed, expected %u\n", r.sectors.size(), session.laps());
+        return false;
+    }
+    for (uint8_t lap = 0; lap < session.laps(); lap++) {
+        for (uint8_t k = 0; k < r.sectors[lap].size(); k++) {
+            double exact = exactSector(session, lap, k);
+            if (fabs(r.sectors[lap][k] - exact) > 1.0) {
+                printf("lap %u sector %u: %u ms, exact %.3f ms\n", lap + 1, k + 1, r.sectors[lap][k], exact);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void testFlyingLaps()
+{
+    // Splits on the three straights, four laps each a different time
+    session_params_t p = sessionDefaults(4);
+    RaceBoxSession session(p);
+    SectorTimer timer;
+    addSplits(timer, session, {100.0f, 400.0f, 850.0f}, true);
+    run_t r = run(timer, session, p);
+    CHECK_EQ(timer.splits(), 3);
+    CHECK_EQ(timer.sectors(), 4);
+    CHECK(sectorsExact(session, r));
+    CHECK(r.complete == std::vector<bool>(4, true));
+
+    // Bests are the fastest of each sector over the laps, the theoretical best their sum
+    uint32_t sum = 0;
+    bool bestsRight = true;
+    for (uint8_t k = 0; k < timer.sectors(); k++) {
+        uint32_t best = UINT32_MAX;
+        for (const std::vector<uint32_t> &lap : r.sectors) {
+            best = std::min(best, lap[k]);
+        }
+        bestsRight &= timer.bestSector(k) == best;
+        sum += best;
+    }
+    CHECK(bestsRight);
+    CHECK_EQ(timer.theoreticalBest(), sum);
+
+    // The delta of each closed sector is against the best of the laps before it
+    CHECK_EQ(r.deltas.size(), 16u);
+    bool deltasRight = true;
+    for (size_t n = 0; n < r.deltas.size(); n++) {
+        uint8_t lap = n / 4;
+        uint8_t k = n % 4;
+        uint32_t best = 0;
+        for (uint8_t l = 0; l < lap; l++) {
+            best = best == 0 || r.sectors[l][k] < best ? r.sectors[l][k] : best;
+        }
+        deltasRight &= r.hasDelta[n] == (lap > 0);
+        deltasRight &= !r.hasDelta[n] || r.deltas[n] == (int32_t)r.sectors[lap][k] - (int32_t)best;
+    }
+    CHECK(deltasRight);
+}
+
+static void testStandingStart()
+{
+    // The first sector from a standstill is timed but never a best
+    session_params_t p = sessionDefaults(2);
+    RaceBoxSession session(p);
+    SectorTimer timer;
+    addSplits(timer, session, {100.0f, 400.0f}, true);
+    run_t r = run(timer, session, p, false);
+    CHECK(r.complete == std::vector<bool>(2, true));
+    CHECK(!r.sectors.empty() && r.sectors[0][0] > 0 && r.sectors[0][0] < exactSector(session, 0, 0));
+    CHECK_EQ(timer.bestSector(0), r.sectors[1][0]);
+    CHECK_EQ(timer.bestSector(1), std::min(r.sectors[0][1], r.sectors[1][1]));
+    CHECK_NEAR(r.sectors[0][1], exactSector(session, 0, 1), 1.0);
+}
+
+static void testMissedSplit()
+{
+    // Fixes lost around the second split gate: that lap is incomplete, its later sectors
+    // untimed, and the next lap is timed again
+    session_params_t p = sessionDefaults(3);
+    RaceBoxSession session(p);
+    SectorTimer timer;
+    addSplits(timer, session, {100.0f, 400.0f, 850.0f}, true);
+    uint32_t gapAt = (uint32_t)session.timeAt(1, 400.0f);
+    hostSerialMute(true);
+    run_t r = run(timer, session, p, true, gapAt - 1500, gapAt + 1500);
+    hostSerialMute(false);
+    CHECK(r.complete == (std::vector<bool> {true, false, true}));
+    CHECK(r.sectors[1][0] > 0 && r.sectors[1][1] == 0 && r.sectors[1][2] == 0 && r.sectors[1][3] == 0);
+    CHECK_NEAR(r.sectors[2][3], exactSector(session, 2, 3), 1.0);
+    CHECK_EQ(timer.bestSector(1), std::min(r.sectors[0][1], r.sectors[2][1]));
+}
+
+static void testUnorientedSplits()
+{
+    // Gates added while standing still orient on the first lap and time from then on
+    session_params_t p = sessionDefaults(3);
+    RaceBoxSession session(p);
+    SectorTimer timer;
+    addSplits(timer, session, {75.0f, 457.0f}, false);
+    run_t r = run(timer, session, p);
+    CHECK(sectorsExact(session, r));
+    CHECK(r.complete == std::vector<bool>(3, true));
+}
+
+static void testLimits()
+{
+    session_params_t p = sessionDefaults(1);
+    RaceBoxSession session(p);
+    SectorTimer timer;
+    addSplits(timer, session, {25.0f, 75.0f, 125.0f, 350.0f, 450.0f, 550.0f, 850.0f}, true);
+    CHECK(!timer.addSplit(p.lat, p.lon, 0));
+    CHECK_EQ(timer.splits(), 0);            // No frame yet
+    run_t r = run(timer, session, p);
+    CHECK_EQ(timer.splits(), SECTOR_MAX_SPLITS);
+    CHECK(sectorsExact(session, r));
+
+    // Adding a split changes the layout, the bests go
+    CHECK(timer.theoreticalBest() > 0);
+    timer.clearSplits();
+    CHECK(timer.addSplit(p.lat + 1000, p.lon, 0));
+    CHECK_EQ(timer.bestSector(0), 0u);
+    CHECK_EQ(timer.theoreticalBest(), 0u);
+
+    // A split gate on another track turns the sectors off
+    hostSerialMute(true);
+    TrackFrame frame;
+    frame.set(p.lat, p.lon);
+    timer.addSplit(p.lat + 500000, p.lon, 0);   // 5.6 km north
+    timer.setFrame(frame);
+    hostSerialMute(false);
+    CHECK_EQ(timer.splits(), 0);
+    CHECK_EQ(timer.sectors(), 1);
+}
+
+static void testStore()
+{
+    session_params_t p = sessionDefaults(2);
+    RaceBoxSession session(p);
+    SectorTimer timer;
+    addSplits(timer, session, {100.0f, 400.0f, 850.0f}, true);
+    timer.store();
+
+    hostSerialMute(true);
+    SectorTimer loaded;
+    CHECK(loaded.load());
+    hostSerialMute(false);
+    run_t a = run(timer, session, p);
+    run_t b = run(loaded, session, p);
+    CHECK_EQ(loaded.splits(), 3);
+    CHECK(a.sectors == b.sectors);
+
+    timer.clearSplits();
+    timer.store();
+    CHECK(!loaded.load());
+}
+
+int main()
+{
+    testFlyingLaps();
+    testStandingStart();
+    testMissedSplit();
+    testUnorientedSplits();
+    testLimits();
+    testStore();
+    return testResult("test_sectors");
+}
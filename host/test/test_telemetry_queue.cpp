@@ -0,0 +1,180 @@
+/*
+ * SpscQueue of the sketch (TelemetryQueue.h).
+ *
+ * The indices run free and only their difference counts, so a ring started just below
+ * 2^32 must behave the same across the wrap. A full ring drops the new item and counts
+ * it without touching the queued ones, the high water mark follows the deepest fill
+ * until resetStats(), clear() empties the ring and nothing else. Last, a producer and a
+ * consumer thread run a million items through a small ring across the wrap: each item
+ * arrives once and in order, and every push the full ring refused is counted.
+ */
+#include "HostTest.h"
+#include "TelemetryQueue.h"
+#include <thread>
+#include <vector>
+
+#define NEAR_WRAP       (UINT32_MAX - 5)
+
+typedef SpscQueue<uint32_t, 8> SmallQueue;
+
+static void testWrap()
+{
+    SmallQueue q(NEAR_WRAP);
+    CHECK_EQ(q.size(), 0u);
+    uint32_t next = 0;
+    uint32_t expect = 0;
+    bool ordered = true;
+    // Three times round the ring, half full, across the wrap of both indices
+    for (int i = 0; i < 24; i++) {
+        for (int k = 0; k < 4; k++) {
+            CHECK(q.push(next++));
+        }
+        CHECK_EQ(q.size(), 4u);
+        uint32_t v;
+        for (int k = 0; k < 4; k++) {
+            ordered &= q.pop(v) && v == expect++;
+        }
+        CHECK(!q.pop(v));
+        CHECK_EQ(q.size(), 0u);
+    }
+    CHECK(ordered);
+
+    // Full while the head has wrapped and the tail not yet
+    SmallQueue full(UINT32_MAX - 3);
+    for (uint32_t i = 0; i < 8; i++) {
+        CHECK(full.push(i));
+    }
+    CHECK_EQ(full.size(), 8u);
+    CHECK(!full.push(8));
+    CHECK_EQ(full.overflows(), 1u);
+}
+
+static void testOverflow()
+{
+    SmallQueue q;
+    for (uint32_t i = 0; i < q.capacity(); i++) {
+        CHECK(q.push(i));
+    }
+    // The new items are dropped, the queued ones stay as they were
+    for (uint32_t i = 0; i < 5; i++) {
+        CHECK(!q.push(100 + i));
+    }
+    CHECK_EQ(q.overflows(), 5u);
+    CHECK_EQ(q.size(), q.capacity());
+    uint32_t v;
+    CHECK(q.pop(v) && v == 0);
+    CHECK(q.push(200));
+    CHECK_EQ(q.overflows(), 5u);
+    for (uint32_t i = 1; i < q.capacity(); i++) {
+        CHECK(q.pop(v) && v == i);
+    }
+    CHECK(q.pop(v) && v == 200);
+    CHECK(!q.pop(v));
+}
+
+static void testHighWater()
+{
+    SmallQueue q;
+    CHECK_EQ(q.highWater(), 0u);
+    uint32_t v;
+    for (uint32_t i = 0; i < 5; i++) {
+        q.push(i);
+    }
+    q.pop(v);
+    q.pop(v);
+    CHECK_EQ(q.highWater(), 5u);
+    q.push(5);
+    CHECK_EQ(q.highWater(), 5u);
+    q.push(6);
+    q.push(7);
+    CHECK_EQ(q.highWater(), 6u);
+
+    // A drop does not raise it past the capacity
+    for (uint32_t i = 0; i < 4; i++) {
+        q.push(8 + i);
+    }
+    CHECK_EQ(q.highWater(), q.capacity());
+
+    q.resetStats();
+    CHECK_EQ(q.highWater(), 0u);
+    CHECK_EQ(q.overflows(), 0u);
+    q.pop(v);
+    q.push(12);
+    CHECK_EQ(q.highWater(), q.capacity());
+}
+
+static void testClear()
+{
+    SmallQueue q(NEAR_WRAP);
+    for (uint32_t i = 0; i < 10; i++) {
+        q.push(i);
+    }
+    uint32_t overflows = q.overflows();
+    uint32_t highWater = q.highWater();
+    q.clear();
+    CHECK_EQ(q.size(), 0u);
+    uint32_t v;
+    CHECK(!q.pop(v));
+    CHECK_EQ(q.overflows(), overflows);
+    CHECK_EQ(q.highWater(), highWater);
+
+    // Usable at once, the whole ring
+    for (uint32_t i = 0; i < q.capacity(); i++) {
+        CHECK(q.push(50 + i));
+    }
+    CHECK(q.pop(v) && v == 50);
+    q.clear();
+    CHECK(!q.pop(v));
+    q.clear();
+    CHECK_EQ(q.size(), 0u);
+}
+
+static void testThreads()
+{
+    const uint32_t items = 1000000;
+    static SpscQueue<uint32_t, 64> q(UINT32_MAX - 1000);
+    uint32_t refused = 0;
+    std::vector<uint32_t> received;
+    received.reserve(items);
+
+    // Every item retried until it fits, the last one ends the run
+    std::thread producer([&] {
+        for (uint32_t i = 0; i < items; i++) {
+            while (!q.push(i)) {
+                refused++;
+                std::this_thread::yield();
+            }
+        }
+    });
+    std::thread consumer([&] {
+        uint32_t v;
+        while (received.size() < items) {
+            if (q.pop(v)) {
+                received.push_back(v);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    producer.join();
+    consumer.join();
+
+    bool ordered = true;
+    for (uint32_t i = 0; i < items; i++) {
+        ordered &= received[i] == i;
+    }
+    CHECK(ordered);
+    CHECK_EQ(q.size(), 0u);
+    CHECK_EQ(q.overflows(), refused);
+    CHECK(q.highWater() <= q.capacity());
+}
+
+int main()
+{
+    testWrap();
+    testOverflow();
+    testHighWater();
+    testClear();
+    testThreads();
+    return testResult("test_telemetry_queue");
+}
@@ -0,0 +1,276 @@
+/*
+ * tools/build_trackdb.py against TrackDb and LapDelta of the sketch.
+ *
+ * With --prepare the test drives two laps of a host session through LapDelta, saves
+ * the reference lap the way the glasses do and writes the tracks JSON around it:
+ * the session track with two split gates and the reference, and a track without one
+ * further away, and a JSON pairing the reference with a moved finish line that the
+ * tool must refuse. ctest then runs the tool on them and with --random, and the test
+ * opens both databases from $TRACKDB_DIR. The session track must be found from the
+ * track, its gates and heading come back as written, and its reference lap loads
+ * through seekReference() and gives the same deltas as the lap that was saved.
+ * In the random database every finish line is found from its own position and any
+ * other position finds the nearest one a full scan finds.
+ */
+#include "HostRuntime.h"
+#include "HostTest.h"
+#include "LapDelta.h"
+#include "LapGate.h"
+#include "RaceBoxSession.h"
+#include "TrackDb.h"
+#include <LittleFS.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#define TRACK_NAME              "Host Stadium"
+#define RANDOM_TRACKS           3000    // --random of the ctest
+#define RANDOM_LOOKUPS          500
+
+// Splits of the session track, metres past the finish line
+static const float SPLIT_S[] = {200.0f, 600.0f};
+
+// Both laps through the gate and LapDelta, the way checkLapCrossing() feeds them. Without
+// a replayLap the fastest becomes the reference, with one the reference is kept and the
+// deltas of that lap are returned.
+static std::vector<int32_t> driveSession(const RaceBoxSession &session, LapDelta &delta, uint8_t replayLap)
+{
+    session_params_t params = sessionDefaults(2);
+    TrackFrame frame;
+    frame.set(params.lat, params.lon);
+    LapGate gate;
+    gate.set(frame.project(params.lat, params.lon), 0);
+    int lap = -1;
+    uint32_t lapStart = 0;
+    std::vector<int32_t> deltas;
+    for (uint32_t i = 0; i < session.fixCount(); i++) {
+        rbx_fix_t fix;
+        session.fix(i, &fix);
+        enu_t pos = frame.project(fix.lat, fix.lon);
+        uint32_t cross;
+        if (gate.update(pos, fix.itow_ms, &cross)) {
+            if (lap >= 0 && replayLap == UINT8_MAX) {
+                delta.finishLap(gpsTimeDiff(cross, lapStart));
+            }
+            lap++;
+            lapStart = cross;
+            delta.startLap(lap < session.laps());
+        } else if (lap >= 0) {
+            delta.update(pos, gpsTimeDiff(fix.itow_ms, lapStart));
+            if (lap == replayLap) {
+                deltas.push_back(delta.valid() ? delta.delta() : INT32_MIN);
+            }
+        }
+    }
+    return deltas;
+}
+
+static std::string dataDir()
+{
+    const char *dir = getenv("TRACKDB_DIR");
+    return dir ? dir : "";
+}
+
+static std::string degrees(int32_t e7)
+{
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%s%d.%07d", e7 < 0 ? "-" : "", abs(e7) / 10000000, abs(e7) % 10000000);
+    return buf;
+}
+
+// The reference lap and the tracks JSON for the tool
+static int prepare()
+{
+    std::string dir = dataDir();
+    if (!CHECK(!dir.empty())) {
+        return testResult("test_trackdb --prepare");
+    }
+    hostFsRoot(dir.c_str());
+    session_params_t params = sessionDefaults(2);
+    RaceBoxSession session(params);
+
+    hostSerialMute(true);
+    LapDelta delta;
+    CHECK(delta.begin());
+    delta.setOrigin(params.lat, params.lon);
+    driveSession(session, delta, UINT8_MAX);
+    hostSerialMute(false);
+    CHECK(delta.hasReference());
+    File f = LittleFS.open("/reference.lap", FILE_WRITE);
+    CHECK(f && delta.save(f));
+    f.close();
+
+    std::string splits;
+    for (float s : SPLIT_S) {
+        float heading;
+        int32_t lat;
+        int32_t lon;
+        session.toLatLon(session.position(s, &heading), &lat, &lon);
+        splits += std::string(splits.empty() ? "" : ", ") + "{\"lat\": " + degrees(lat) + ", \"lon\": " +
+                  degrees(lon) + ", \"heading\": " + std::to_string(heading) + "}";
+    }
+    std::string json = "[\n"
+        "  {\"name\": \"" TRACK_NAME "\", \"finish\": {\"lat\": " + degrees(params.lat) + ", \"lon\": " +
+        degrees(params.lon) + ", \"heading\": 0}, \"splits\": [" + splits + "], \"reference\": \"reference.lap\"},\n"
+        "  {\"name\": \"Far Track\", \"finish\": {\"lat\": " + degrees(params.lat + 3000000) + ", \"lon\": " +
+        degrees(params.lon - 4000000) + "}}\n"
+        "]\n";
+    FILE *out = fopen((dir + "/tracks.json").c_str(), "w");
+    CHECK(out && fputs(json.c_str(), out) >= 0 && fclose(out) == 0);
+
+    // The same reference under a finish line moved by 1e-7 degree, the tool refuses it
+    std::string foreign = "[{\"name\": \"Moved\", \"finish\": {\"lat\": " + degrees(params.lat + 1) +
+                          ", \"lon\": " + degrees(params.lon) + "}, \"reference\": \"reference.lap\"}]\n";
+    out = fopen((dir + "/foreign.json").c_str(), "w");
+    CHECK(out && fputs(foreign.c_str(), out) >= 0 && fclose(out) == 0);
+    return testResult("test_trackdb --prepare");
+}
+
+static void testJsonDatabase()
+{
+    session_params_t params = sessionDefaults(2);
+    RaceBoxSession session(params);
+    File file = LittleFS.open("/tracks.db", FILE_READ);
+    TrackDb db;
+    if (!CHECK(file && db.open(file))) {
+        return;
+    }
+    CHECK_EQ(db.count(), 2u);
+
+    // From the far side of the track, the way detectTrack() looks it up at a fix
+    int32_t lat;
+    int32_t lon;
+    session.toLatLon(session.position(session.lapLength() / 2, NULL), &lat, &lon);
+    trackdb_track_t track;
+    float dist;
+    if (!CHECK(db.findNearest(lat, lon, &track, &dist))) {
+        return;
+    }
+    CHECK(strcmp(track.name, TRACK_NAME) == 0);
+    CHECK_EQ(track.lat, params.lat);
+    CHECK_EQ(track.lon, params.lon);
+    CHECK_NEAR(track.heading, 0.0, 1e-6);
+    CHECK_NEAR(dist, 100.0, 1.0);
+    CHECK_EQ(track.splits, 2);
+    for (int i = 0; i < 2; i++) {
+        float heading;
+        int32_t slat;
+        int32_t slon;
+        session.toLatLon(session.position(SPLIT_S[i], &heading), &slat, &slon);
+        CHECK_EQ(track.split[i].lat, slat);
+        CHECK_EQ(track.split[i].lon, slon);
+        CHECK_NEAR(track.split[i].heading, heading, 1e-3);
+    }
+
+    // The reference lap out of the database gives the deltas of the one it was saved
+    // from, the same lap driven again against it stays within a few ms
+    hostSerialMute(true);
+    LapDelta recorded;
+    CHECK(recorded.begin());
+    recorded.setOrigin(track.lat, track.lon);
+    driveSession(session, recorded, UINT8_MAX);
+    LapDelta delta;
+    CHECK(delta.begin());
+    delta.setOrigin(track.lat, track.lon);
+    bool loaded = db.seekReference(track) && delta.load(file);
+    hostSerialMute(false);
+    if (!CHECK(loaded)) {
+        return;
+    }
+    uint8_t fastest = session.lapTime(1) < session.lapTime(0) ? 1 : 0;
+    CHECK_EQ(delta.referenceMs(), recorded.referenceMs());
+    CHECK_NEAR(delta.referenceMs(), session.lapTime(fastest), 1.0);
+    std::vector<int32_t> deltas = driveSession(session, delta, fastest);
+    CHECK(deltas == driveSession(session, recorded, fastest));
+    int32_t worst = 0;
+    for (int32_t d : deltas) {
+        worst = std::max(worst, d == INT32_MIN ? INT32_MAX : abs(d));
+    }
+    // Only where the speed steps at a corner is the linear trace off, by a few ms
+    CHECK(worst <= 10);
+
+    // The other track has no reference
+    CHECK(db.findNearest(params.lat + 3000000, params.lon - 4000000, &track, &dist));
+    CHECK(strcmp(track.name, "Far Track") == 0);
+    CHECK(isnan(track.heading));
+    CHECK(!db.seekReference(track));
+    file.close();
+}
+
+// The records as the tool laid them out, read past the header and the cells
+static std::vector<trackdb_track_t> readTracks(File &file)
+{
+    trackdb_header_t header;
+    std::vector<trackdb_track_t> tracks;
+    if (!file.seek(0) || file.read((uint8_t *)&header, sizeof(header)) != sizeof(header)) {
+        return tracks;
+    }
+    tracks.resize(header.tracks);
+    file.seek(sizeof(header) + header.cells * sizeof(trackdb_cell_t));
+    size_t bytes = tracks.size() * sizeof(trackdb_track_t);
+    if (file.read((uint8_t *)tracks.data(), bytes) != bytes) {
+        tracks.clear();
+    }
+    return tracks;
+}
+
+static void testRandomDatabase()
+{
+    File file = LittleFS.open("/random.db", FILE_READ);
+    TrackDb db;
+    if (!CHECK(file && db.open(file))) {
+        return;
+    }
+    CHECK_EQ(db.count(), (uint32_t)RANDOM_TRACKS);
+    std::vector<trackdb_track_t> tracks = readTracks(file);
+    if (!CHECK_EQ(tracks.size(), (size_t)RANDOM_TRACKS)) {
+        return;
+    }
+
+    uint32_t missed = 0;
+    uint32_t differ = 0;
+    std::mt19937 rng(20251017);
+    for (int i = 0; i < RANDOM_LOOKUPS; i++) {
+        // A finish line from its own position
+        const trackdb_track_t &t = tracks[rng() % tracks.size()];
+        trackdb_track_t found;
+        float dist;
+        missed += !db.findNearest(t.lat, t.lon, &found, &dist) || dist > 0.01f || found.lat != t.lat ||
+                  found.lon != t.lon;
+
+        // A few kilometres off it, against every record
+        int32_t lat = t.lat + (int32_t)(rng() % 600000) - 300000;
+        int32_t lon = t.lon + (int32_t)(rng() % 600000) - 300000;
+        TrackFrame here;
+        here.set(lat, lon);
+        const trackdb_track_t *nearest = NULL;
+        float best = TRACKDB_MATCH_RANGE_M;
+        for (const trackdb_track_t &c : tracks) {
+            float d = enuLength(here.project(c.lat, c.lon));
+            if (d <= best) {
+                best = d;
+                nearest = &c;
+            }
+        }
+        bool ok = db.findNearest(lat, lon, &found, &dist);
+        differ += ok != (nearest != NULL) || (ok && strcmp(found.name, nearest->name) != 0);
+    }
+    CHECK_EQ(missed, 0u);
+    CHECK_EQ(differ, 0u);
+    file.close();
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && !strcmp(argv[1], "--prepare")) {
+        return prepare();
+    }
+    std::string dir = dataDir();
+    if (!CHECK(!dir.empty())) {
+        return testResult("test_trackdb");
+    }
+    hostFsRoot(dir.c_str());
+    testJsonDatabase();
+    testRandomDatabase();
+    return testResult("test_trackdb");
+}
@@ -0,0 +1,309 @@
+/*
+ * UbxFramer of the sketch fed random streams in random pieces.
+ *
+ * The streams mix valid frames with garbage rich in sync bytes, frames with a bad
+ * checksum, truncated frames and headers announcing too long a payload. A plain scan
+ * of the whole stream says what must come out: at each position either a complete
+ * valid frame, which is taken, or one byte skipped. The frames and every counter of the
+ * framer must match it, whatever the piece sizes, so a frame split across
+ * notifications or hidden inside rejected bytes is never lost and each loss of sync
+ * counts as one resync.
+ */
+#include "HostTest.h"
+#include "UbxFramer.h"
+#include <random>
+#include <vector>
+
+typedef struct {
+    uint8_t cls;
+    uint8_t id;
+    std::vector<uint8_t> payload;
+} frame_t;
+
+static bool operator==(const frame_t &a, const frame_t &b)
+{
+    return a.cls == b.cls && a.id == b.id && a.payload == b.payload;
+}
+
+static std::vector<frame_t> received;
+
+static void onFrame(uint8_t msgClass, uint8_t msgId, const uint8_t *payload, uint16_t len, void *user)
+{
+    (void)user;
+    received.push_back({msgClass, msgId, std::vector<uint8_t>(payload, payload + len)});
+}
+
+static void append(std::vector<uint8_t> &stream, const frame_t &f)
+{
+    uint16_t len = f.payload.size();
+    size_t start = stream.size();
+    stream.insert(stream.end(), {UBX_SYNC1, UBX_SYNC2, f.cls, f.id, (uint8_t)len, (uint8_t)(len >> 8)});
+    stream.insert(stream.end(), f.payload.begin(), f.payload.end());
+    uint8_t ck_a = 0, ck_b = 0;
+    for (size_t i = start + 2; i < stream.size(); i++) {
+        ck_a += stream[i];
+        ck_b += ck_a;
+    }
+    stream.push_back(ck_a);
+    stream.push_back(ck_b);
+}
+
+// What the framer must produce from stream, with its counters
+typedef struct {
+    std::vector<frame_t> frames;
+    ubx_framer_stats_t stats;
+} expected_t;
+
+static expected_t scan(const std::vector<uint8_t> &s)
+{
+    expected_t e = {};
+    bool inSync = true;
+    size_t p = 0;
+    while (p < s.size()) {
+        bool skip = true;
+        if (s[p] == UBX_SYNC1) {
+            if (p + 1 >= s.size()) {
+                break;
+            }
+            if (s[p + 1] == UBX_SYNC2) {
+                if (p + UBX_HEADER_SIZE > s.size()) {
+                    break;
+                }
+                uint16_t len = s[p + 4] | (s[p + 5] << 8);
+                if (len > UBX_MAX_PAYLOAD) {
+                    e.stats.oversize++;
+                } else {
+                    size_t end = p + UBX_HEADER_SIZE + len + 2;
+                    if (end > s.size()) {
+                        break;
+                    }
+                    uint8_t ck_a = 0, ck_b = 0;
+                    for (size_t i = p + 2; i < end - 2; i++) {
+                        ck_a += s[i];
+                        ck_b += ck_a;
+                    }
+                    if (ck_a == s[end - 2] && ck_b == s[end - 1]) {
+                        e.frames.push_back({s[p + 2], s[p + 3],
+                                            std::vector<uint8_t>(s.begin() + p + UBX_HEADER_SIZE, s.begin() + end - 2)});
+                        e.stats.frames++;
+                        inSync = true;
+                        p = end;
+                        skip = false;
+                    } else {
+                        e.stats.crc_errors++;
+                    }
+                }
+            }
+        }
+        if (skip) {
+            if (inSync) {
+                e.stats.resyncs++;
+                inSync = false;
+            }
+            e.stats.skipped_bytes++;
+            p++;
+        }
+    }
+    e.stats.bytes = s.size();
+    return e;
+}
+
+// Push stream in pieces of 1 to maxPiece bytes, maxPiece 0 for all at once
+static bool framesMatch(const std::vector<uint8_t> &stream, std::mt19937 &rng, size_t maxPiece, const char *what)
+{
+    UbxFramer framer(onFrame);
+    received.clear();
+    uint32_t returned = 0;
+    for (size_t i = 0; i < stream.size();) {
+        size_t n = maxPiece ? std::min<size_t>(rng() % maxPiece + 1, stream.size() - i) : stream.size();
+        returned += framer.push(stream.data() + i, n);
+        i += n;
+    }
+    expected_t e = scan(stream);
+    ubx_framer_stats_t stats;
+    framer.getStats(&stats);
+    bool ok = received == e.frames && returned == e.frames.size() && stats.frames == e.stats.frames &&
+              stats.crc_errors == e.stats.crc_errors && stats.oversize == e.stats.oversize &&
+              stats.resyncs == e.stats.resyncs && stats.skipped_bytes == e.stats.skipped_bytes &&
+              stats.bytes == e.stats.bytes;
+    if (!ok) {
+        printf("%s, pieces up to %zu: frames %zu/%zu crc %u/%u oversize %u/%u resyncs %u/%u skipped %u/%u\n",
+               what, maxPiece, received.size(), e.frames.size(), stats.crc_errors, e.stats.crc_errors,
+               stats.oversize, e.stats.oversize, stats.resyncs, e.stats.resyncs, stats.skipped_bytes,
+               e.stats.skipped_bytes);
+    }
+    return ok;
+}
+
+static frame_t randomFrame(std::mt19937 &rng, uint16_t maxLen)
+{
+    frame_t f = {(uint8_t)rng(), (uint8_t)rng(), std::vector<uint8_t>(rng() % (maxLen + 1))};
+    for (uint8_t &b : f.payload) {
+        // Sync bytes inside payloads too
+        b = rng() % 8 == 0 ? (rng() % 2 ? UBX_SYNC1 : UBX_SYNC2) : (uint8_t)rng();
+    }
+    return f;
+}
+
+static void garbage(std::vector<uint8_t> &stream, std::mt19937 &rng, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        uint32_t r = rng() % 4;
+        stream.push_back(r == 0 ? UBX_SYNC1 : r == 1 ? UBX_SYNC2 : (uint8_t)rng());
+    }
+}
+
+// Kinds of damage mixed into the fuzzed streams
+enum {
+    DAMAGE_NONE,
+    DAMAGE_GARBAGE,
+    DAMAGE_CHECKSUM,
+    DAMAGE_TRUNCATED,
+    DAMAGE_OVERSIZE,
+    DAMAGE_COUNT
+};
+
+static std::vector<uint8_t> fuzzStream(std::mt19937 &rng, uint32_t items, bool damage)
+{
+    std::vector<uint8_t> stream;
+    for (uint32_t i = 0; i < items; i++) {
+        uint32_t kind = damage ? rng() % DAMAGE_COUNT : DAMAGE_NONE;
+        frame_t f = randomFrame(rng, rng() % 4 ? 100 : UBX_MAX_PAYLOAD);
+        size_t start = stream.size();
+        switch (kind) {
+        case DAMAGE_GARBAGE:
+            garbage(stream, rng, rng() % 40 + 1);
+            append(stream, f);
+            break;
+        case DAMAGE_CHECKSUM:
+            append(stream, f);
+            stream[start + UBX_HEADER_SIZE + rng() % (f.payload.size() + 2)] ^= rng() % 255 + 1;
+            break;
+        case DAMAGE_TRUNCATED:
+            append(stream, f);
+            stream.resize(start + rng() % (stream.size() - start));
+            break;
+        case DAMAGE_OVERSIZE: {
+            uint16_t len = UBX_MAX_PAYLOAD + 1 + rng() % 1000;
+            stream.insert(stream.end(), {UBX_SYNC1, UBX_SYNC2, 0x01, 0x07, (uint8_t)len, (uint8_t)(len >> 8)});
+            break;
+        }
+        default:
+            append(stream, f);
+            break;
+        }
+    }
+    return stream;
+}
+
+static void testClean()
+{
+    // Every frame out, split anywhere, nothing skipped
+    std::mt19937 rng(1);
+    std::vector<uint8_t> stream = fuzzStream(rng, 300, false);
+    expected_t e = scan(stream);
+    CHECK_EQ(e.frames.size(), 300);
+    CHECK_EQ(e.stats.resyncs, 0);
+    for (size_t piece : {0, 1, 2, 7, 20, 244, 600}) {
+        CHECK(framesMatch(stream, rng, piece, "clean"));
+    }
+}
+
+static void testFuzz()
+{
+    bool all = true;
+    for (uint32_t seed = 0; seed < 200 && all; seed++) {
+        std::mt19937 rng(seed);
+        std::vector<uint8_t> stream = fuzzStream(rng, 60, true);
+        for (size_t piece : {0, 1, 13, 244}) {
+            all &= framesMatch(stream, rng, piece, "fuzz");
+        }
+    }
+    CHECK(all);
+}
+
+static void testResyncCount()
+{
+    std::mt19937 rng(2);
+    frame_t a = randomFrame(rng, 40);
+    frame_t b = randomFrame(rng, 40);
+    UbxFramer framer(onFrame);
+    received.clear();
+
+    // Garbage, a false sync, a false header, an oversize header and a bad frame are one
+    // loss of sync up to the next good frame
+    std::vector<uint8_t> stream = {0x00, 0x11, UBX_SYNC1, 0x00, UBX_SYNC1, UBX_SYNC2, 0x01, 0x07, 0xFF, 0xFF};
+    std::vector<uint8_t> bad;
+    append(bad, b);
+    bad[bad.size() - 1] ^= 1;
+    stream.insert(stream.end(), bad.begin(), bad.end());
+    append(stream, a);
+    framer.push(stream.data(), stream.size());
+    ubx_framer_stats_t stats;
+    framer.getStats(&stats);
+    CHECK_EQ(stats.frames, 1);
+    CHECK_EQ(stats.resyncs, 1);
+    CHECK_EQ(stats.oversize, 1);
+    CHECK_EQ(stats.crc_errors, 1);
+    CHECK_EQ(stats.skipped_bytes, stream.size() - (UBX_HEADER_SIZE + a.payload.size() + 2));
+
+    // Frames back to back keep sync, a single bad frame in between is one more
+    stream.clear();
+    append(stream, a);
+    append(stream, b);
+    stream.insert(stream.end(), bad.begin(), bad.end());
+    append(stream, a);
+    framer.push(stream.data(), stream.size());
+    framer.getStats(&stats);
+    CHECK_EQ(stats.frames, 4);
+    CHECK_EQ(stats.resyncs, 2);
+    CHECK(received.size() == 4 && received[3] == a);
+}
+
+static void testReset()
+{
+    // A partial frame is dropped, the next one starts clean
+    std::mt19937 rng(3);
+    frame_t a = randomFrame(rng, 60);
+    a.payload.resize(40, 0x33);
+    std::vector<uint8_t> stream;
+    append(stream, a);
+    UbxFramer framer(onFrame);
+    received.clear();
+    uint32_t delivered = framer.push(stream.data(), 10);
+    CHECK_EQ(delivered, 0);
+    framer.reset();
+    delivered = framer.push(stream.data(), stream.size());
+    CHECK_EQ(delivered, 1);
+    CHECK(received.size() == 1 && received[0] == a);
+
+    framer.resetStats();
+    ubx_framer_stats_t stats;
+    framer.getStats(&stats);
+    CHECK_EQ(stats.frames, 0);
+    CHECK_EQ(stats.bytes, 0);
+}
+
+static void testLongest()
+{
+    // UBX_MAX_PAYLOAD is taken, one more is oversize
+    std::mt19937 rng(4);
+    frame_t f = randomFrame(rng, 0);
+    f.payload.assign(UBX_MAX_PAYLOAD, 0x5A);
+    std::vector<uint8_t> stream;
+    append(stream, f);
+    f.payload.push_back(0x5A);
+    append(stream, f);
+    CHECK(framesMatch(stream, rng, 0, "longest"));
+    CHECK_EQ(received.size(), 1);
+}
+
+int main()
+{
+    testClean();
+    testFuzz();
+    testResyncCount();
+    testReset();
+    testLongest();
+    return testResult("test_ubx_framer");
+}
@@ -0,0 +1,120 @@
+/**
+ * @file      LV_BoundLabel.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2023  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2023-10-06
+ *
+ */
+#include <Arduino.h>
+#include "LV_BoundLabel.h"
+#include "LV_NumberLabel.h"
+#include "LV_Helper.h"
+
+LV_BoundLabel::LV_BoundLabel() : _obj(NULL), _number_label(false)
+{
+    invalidate();
+}
+
+void LV_BoundLabel::attach(lv_obj_t *obj)
+{
+    _obj = obj;
+    _number_label = obj && lv_obj_check_type(obj, &lv_number_label_class);
+    invalidate();
+}
+
+void LV_BoundLabel::invalidate()
+{
+    _font = NULL;
+    _color_valid = false;
+    _len = 0;
+    _text_valid = false;
+    _number_valid = false;
+}
+
+bool LV_BoundLabel::apply(bool changed)
+{
+    countLvglUpdate(changed);
+    return changed;
+}
+
+bool LV_BoundLabel::setText(const char *text)
+{
+    if (!_obj) {
+        return false;
+    }
+    size_t len = strlen(text);
+    if (_text_valid && len == _len && memcmp(_text, text, len) == 0) {
+        return apply(false);
+    }
+    if (_number_label) {
+        lv_number_label_set_text(_obj, text);
+    } else {
+        lv_label_set_text(_obj, text);
+    }
+    // Texts too long for the cache are always applied
+    _text_valid = len < LV_BOUND_LABEL_MAX_TEXT;
+    if (_text_valid) {
+        memcpy(_text, text, len);
+        _len = len;
+    }
+    _number_valid = false;
+    return apply(true);
+}
+
+bool LV_BoundLabel::setFont(const lv_font_t *font)
+{
+    if (!_obj) {
+        return false;
+    }
+    // The digit atlas of a number label is fixed at creation
+    if (_number_label || font == _font) {
+        return apply(false);
+    }
+    lv_obj_set_style_text_font(_obj, font, 0);
+    _font = font;
+    return apply(true);
+}
+
+bool LV_BoundLabel::setColor(lv_color_t color)
+{
+    if (!_obj) {
+        return false;
+    }
+    if (_color_valid && color.full == _color.full) {
+        return apply(false);
+    }
+    lv_obj_set_style_text_color(_obj, color, 0);
+    _color = color;
+    _color_valid = true;
+    return apply(true);
+}
+
+bool LV_BoundLabel::setNumber(int32_t value, uint8_t decimals, const char *suffix)
+{
+    if (!_obj) {
+        return false;
+    }
+    if (!suffix) {
+        suffix = "";
+    }
+    if (_number_valid && value == _value && decimals == _decimals && strcmp(suffix, _suffix) == 0) {
+        return apply(false);
+    }
+
+    // The number ends at buf + 16, the suffix follows it
+    char buf[LV_BOUND_LABEL_MAX_TEXT];
+    char *p = lv_number_label_format(buf, 16 + 1, value, decimals);
+    strncpy(buf + 16, suffix, sizeof(buf) - 16 - 1);
+    buf[sizeof(buf) - 1] = '\0';
+
+    bool changed = setText(p);
+    _value = value;
+    _decimals = decimals;
+    // Longer suffixes are never matched, the text compare still catches repeats
+    _number_valid = strlen(suffix) < LV_BOUND_LABEL_MAX_SUFFIX;
+    if (_number_valid) {
+        strcpy(_suffix, suffix);
+    }
+    return changed;
+}
@@ -0,0 +1,62 @@
+/**
+ * @file      LV_BoundLabel.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2023  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2023-10-06
+ *
+ */
+#pragma once
+
+#include <lvgl.h>
+
+/*
+ * Caches the text, font and color last given to a label and only calls into LVGL when
+ * one of them really changes. Every LVGL setter invalidates the object, even with the
+ * same value, so a HUD refreshed every few ms redraws for nothing.
+ * Works with lv_label and lv_number_label objects. All changes must go through the
+ * binding, otherwise the cache is stale; call invalidate() after touching the object directly.
+ * Applied and suppressed updates are counted in getLvglPerf().
+ */
+#define LV_BOUND_LABEL_MAX_TEXT     32
+#define LV_BOUND_LABEL_MAX_SUFFIX   8
+
+class LV_BoundLabel
+{
+public:
+    LV_BoundLabel();
+
+    void attach(lv_obj_t *obj);
+    lv_obj_t *obj()
+    {
+        return _obj;
+    }
+
+    // Forget the cached values, the next setters are applied
+    void invalidate();
+
+    // Each returns true when LVGL was updated
+    bool setText(const char *text);
+    bool setFont(const lv_font_t *font);
+    bool setColor(lv_color_t color);
+
+    // value / 10^decimals followed by suffix, e.g. (1234, 1, "*") shows "123.4*".
+    // Nothing is formatted when value, decimals and suffix are the same as last time
+    bool setNumber(int32_t value, uint8_t decimals, const char *suffix = NULL);
+
+private:
+    bool apply(bool changed);
+
+    lv_obj_t *_obj;
+    bool _number_label;
+    const lv_font_t *_font;
+    lv_color_t _color;
+    bool _color_valid;
+    char _text[LV_BOUND_LABEL_MAX_TEXT];
+    uint16_t _len;
+    bool _text_valid;
+    int32_t _value;
+    uint8_t _decimals;
+    char _suffix[LV_BOUND_LABEL_MAX_SUFFIX];
+    bool _number_valid;
+};
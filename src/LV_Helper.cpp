@@ -8,6 +8,7 @@
  */
 #include <Arduino.h>
 #include "LV_Helper.h"
+#include "LilyGo_BootTimeline.h"
 
 
 #if LV_VERSION_CHECK(9,0,0)
@@ -18,13 +19,186 @@ static lv_disp_draw_buf_t draw_buf;
 static lv_disp_drv_t disp_drv;
 static lv_indev_drv_t  indev_drv;
 
+static bool async_flush = false;
+static lv_helper_timing_t timing;
+
+// Frame bookkeeping, all timestamps are micros()
+static uint32_t frame_start_us;
+static uint32_t segment_start_us;
+static uint32_t wait_start_us;
+static uint32_t frame_render_us;
+// Written from the flush done ISR
+static volatile uint32_t flush_start_us;
+static volatile uint32_t flush_ready_us;
+static volatile uint32_t frame_transfer_us;
+static volatile bool flush_last;
+static volatile uint32_t last_frame_start_us;
+static volatile uint32_t last_frame_render_us;
+static volatile uint32_t last_frame_bytes;
+static volatile uint16_t last_frame_areas;
+// Given once LVGL's flushing flag is cleared, see wait_flush_done
+static SemaphoreHandle_t flush_done_event;
+static uint32_t frame_bytes;
+static uint16_t frame_areas;
+static bool first_frame_marked;
+
+// Rolling record of the last frames, filled when the last area of a frame is sent
+static lv_helper_frame_t perf_frames[LV_HELPER_PERF_FRAMES];
+static uint32_t perf_head;
+static lv_helper_perf_t perf;
+static uint32_t perf_last_done_us;
+static portMUX_TYPE perf_lock = portMUX_INITIALIZER_UNLOCKED;
+static const uint16_t perf_bucket_ms[LV_HELPER_PERF_BUCKETS - 1] = LV_HELPER_PERF_BUCKET_MS;
+
+#if LV_COLOR_DEPTH == 8
+// RGB332 index to byte swapped RGB565, expanded by the display while flushing
+static uint16_t palette[256];
+static const uint16_t *flush_palette = palette;
+
+static void init_palette()
+{
+    for (uint32_t i = 0; i < 256; i++) {
+        lv_color8_t c;
+        c.full = i;
+        uint16_t r = (c.ch.red << 2) | (c.ch.red >> 1);
+        uint16_t g = (c.ch.green << 3) | c.ch.green;
+        uint16_t b = (c.ch.blue << 3) | (c.ch.blue << 1) | (c.ch.blue >> 1);
+        uint16_t rgb = (r << 11) | (g << 5) | b;
+        palette[i] = (rgb >> 8) | (rgb << 8);
+    }
+}
+#endif
+
+static void perf_record(uint32_t now)
+{
+    lv_helper_frame_t *f = &perf_frames[perf_head % LV_HELPER_PERF_FRAMES];
+    portENTER_CRITICAL_SAFE(&perf_lock);
+    f->frame_us = timing.frame_us;
+    f->render_us = timing.render_us;
+    f->transfer_us = timing.transfer_us;
+    f->gap_us = perf_last_done_us ? now - perf_last_done_us : 0;
+    f->bytes = last_frame_bytes;
+    f->areas = last_frame_areas;
+    f->reserved = 0;
+    perf_head++;
+    perf.frames++;
+    if (f->frame_us > LV_DISP_DEF_REFR_PERIOD * 1000) {
+        perf.dropped++;
+    }
+    if (f->frame_us > perf.max_frame_us) {
+        perf.max_frame_us = f->frame_us;
+    }
+    if (f->gap_us > perf.max_gap_us) {
+        perf.max_gap_us = f->gap_us;
+    }
+    perf_last_done_us = now;
+    portEXIT_CRITICAL_SAFE(&perf_lock);
+}
+
+static void flush_done(uint32_t now)
+{
+    flush_ready_us = now;
+    frame_transfer_us += now - flush_start_us;
+    if (flush_last) {
+        timing.render_us = last_frame_render_us;
+        timing.transfer_us = frame_transfer_us;
+        timing.frame_us = now - last_frame_start_us;
+        timing.frames++;
+        frame_transfer_us = 0;
+        perf_record(now);
+    }
+}
+
+/* Called from the SPI ISR once the pixels of the last flush have been sent, or from the
+   flushing task when the display had nothing to send */
+static void disp_flush_done(void *user_data, bool from_isr)
+{
+    flush_done(micros());
+    lv_disp_flush_ready(static_cast<lv_disp_drv_t *>(user_data));
+    if (!from_isr) {
+        xSemaphoreGive(flush_done_event);
+        return;
+    }
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(flush_done_event, &woken);
+    if (woken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+/* The draw buffers are about to change, block until the area in flight has been sent.
+   Called with the LVGL lock held, so no new flush can start. */
+static void wait_flush_done()
+{
+    while (draw_buf.flushing) {
+        xSemaphoreTake(flush_done_event, portMAX_DELAY);
+    }
+}
+
+/* LVGL starts rendering a new frame */
+static void disp_render_start(lv_disp_drv_t *disp_drv)
+{
+    frame_start_us = micros();
+    segment_start_us = frame_start_us;
+    wait_start_us = 0;
+    frame_render_us = 0;
+    frame_bytes = 0;
+    frame_areas = 0;
+}
+
+/* LVGL needs a buffer that is still being sent, it calls this until the flushing flag clears */
+static void disp_wait(lv_disp_drv_t *disp_drv)
+{
+    if (!wait_start_us) {
+        wait_start_us = micros();
+    }
+    // Sleep instead of spinning, the flush done ISR gives the event after clearing the flag
+    xSemaphoreTake(flush_done_event, portMAX_DELAY);
+}
+
 /* Display flushing */
 static void disp_flush( lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p )
 {
+    uint32_t now = micros();
+    uint32_t render_us = now - segment_start_us;
+    if (wait_start_us) {
+        // Depending on the buffer layout LVGL waits before rendering or before flushing,
+        // either way the wait ended when the previous transfer completed
+        uint32_t waited = flush_ready_us - wait_start_us;
+        render_us = waited < render_us ? render_us - waited : 0;
+        wait_start_us = 0;
+    }
+    frame_render_us += render_us;
+
     uint32_t w = ( area->x2 - area->x1 + 1 );
     uint32_t h = ( area->y2 - area->y1 + 1 );
-    static_cast<LilyGo_Display *>(disp_drv->user_data)->pushColors(area->x1, area->y1, w, h, (uint16_t *)color_p);
-    lv_disp_flush_ready( disp_drv );
+    frame_bytes += w * h * sizeof(uint16_t);
+    frame_areas++;
+    flush_last = lv_disp_flush_is_last(disp_drv);
+    if (flush_last) {
+        last_frame_start_us = frame_start_us;
+        last_frame_render_us = frame_render_us;
+        last_frame_bytes = frame_bytes;
+        last_frame_areas = frame_areas;
+    }
+    if (flush_last && !first_frame_marked) {
+        first_frame_marked = true;
+        bootPhaseMark("first frame");
+    }
+    flush_start_us = now;
+    LilyGo_Display *board = static_cast<LilyGo_Display *>(disp_drv->user_data);
+    // LVGL coordinates are relative to the viewport
+#if LV_COLOR_DEPTH == 8
+    board->pushIndexedColors(area->x1 + board->viewportX(), area->y1 + board->viewportY(), w, h, (const uint8_t *)color_p, flush_palette);
+#else
+    board->pushColors(area->x1 + board->viewportX(), area->y1 + board->viewportY(), w, h, (uint16_t *)color_p);
+#endif
+    if (!async_flush) {
+        flush_done(micros());
+        lv_disp_flush_ready( disp_drv );
+    }
+    // With an asynchronous display the next area is rendered while this one is sent
+    segment_start_us = micros();
 }
 
 /*Read the touchpad*/
@@ -45,7 +219,12 @@ static void touchpad_read( lv_indev_drv_t *indev_driver, lv_indev_data_t *data )
 #error "Please turn on PSRAM to QSPI !"
 #else
 static lv_color_t *buf = NULL;
+static lv_color_t *buf2 = NULL;
 #endif
+static lv_helper_buf_info_t buf_info;
+
+static SemaphoreHandle_t lvgl_mutex;
+static TaskHandle_t lvgl_task;
 
 #if LV_USE_LOG
 void lv_log_print_g_cb(const char *buf)
@@ -68,38 +247,126 @@ static void lv_rounder_cb(lv_disp_drv_t *disp_drv, lv_area_t *area)
         area->y2++;
 }
 
-void beginLvglHelper(LilyGo_Display &board, bool debug)
+static void init_draw_buf(LilyGo_Display &board, bool full_refresh)
+{
+    uint32_t size_in_px = board.viewportWidth() * board.viewportHeight();
+    if (buf_info.mode != LV_HELPER_BUF_PSRAM_FULL) {
+        lv_disp_draw_buf_init( &draw_buf, buf, buf2, board.viewportWidth() * buf_info.lines);
+    } else if (full_refresh) {
+        lv_disp_draw_buf_init( &draw_buf, buf, NULL, size_in_px);
+    } else {
+        lv_disp_draw_buf_init( &draw_buf, buf, buf2, size_in_px / 2);
+    }
+}
+
+static void alloc_draw_buf(LilyGo_Display &board, lv_helper_buf_mode_t mode, uint16_t lines)
+{
+    uint32_t width = board.viewportWidth();
+    uint32_t height = board.viewportHeight();
+    // Partial areas are rounded to even lines
+    lines = (lines + 1) & ~1;
+    if (lines < 2) {
+        lines = 2;
+    }
+    if (lines > height) {
+        lines = height;
+    }
+    size_t stripe_size = width * lines * sizeof(lv_color_t);
+
+    buf_info.mode = mode;
+    buf_info.lines = lines;
+    buf_info.internal_bytes = 0;
+    buf_info.psram_bytes = 0;
+
+    if (mode != LV_HELPER_BUF_PSRAM_FULL) {
+        // The SPI driver sends DMA capable memory as is, anything else goes through a bounce buffer
+        uint32_t caps = mode == LV_HELPER_BUF_DMA_DOUBLE ? MALLOC_CAP_DMA : MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+        buf = (lv_color_t *)heap_caps_malloc(stripe_size, caps);
+        buf2 = NULL;
+        if (buf && mode != LV_HELPER_BUF_SRAM_STRIPE) {
+            buf2 = (lv_color_t *)heap_caps_malloc(stripe_size, caps);
+            if (!buf2) {
+                free(buf);
+                buf = NULL;
+            }
+        }
+        if (buf) {
+            buf_info.internal_bytes = buf2 ? stripe_size * 2 : stripe_size;
+            log_i("LVGL draw buffer: %u lines, %u bytes internal", lines, buf_info.internal_bytes);
+            return;
+        }
+        log_e("No internal memory for %u line draw buffers, using PSRAM", lines);
+        buf_info.mode = LV_HELPER_BUF_PSRAM_FULL;
+    }
+
+    // A screen sized buffer for full refresh plus a second half sized one.
+    // LVGL only overlaps rendering with flushing when the two buffers are smaller
+    // than the screen, so partial refresh renders into two half screen buffers.
+    // With a viewport the LVGL screen is only the viewport
+    size_t lv_buffer_size = width * height * sizeof(lv_color_t);
+    buf = (lv_color_t *)ps_malloc(lv_buffer_size);
+    assert(buf);
+    buf2 = (lv_color_t *)ps_malloc(lv_buffer_size / 2);
+    assert(buf2);
+    buf_info.lines = height;
+    buf_info.psram_bytes = lv_buffer_size + lv_buffer_size / 2;
+    log_i("LVGL draw buffer: %u bytes PSRAM", buf_info.psram_bytes);
+}
+
+void beginLvglHelper(LilyGo_Display &board, bool debug, lv_helper_buf_mode_t mode, uint16_t lines)
 {
+    int phase = bootPhaseBegin("lvgl");
 
     lv_init();
 
+    lvgl_mutex = xSemaphoreCreateRecursiveMutex();
+    assert(lvgl_mutex);
+    flush_done_event = xSemaphoreCreateBinary();
+    assert(flush_done_event);
+
+#if LV_COLOR_DEPTH == 8
+    init_palette();
+#endif
+
 #if LV_USE_LOG
     if (debug) {
         lv_log_register_print_cb(lv_log_print_g_cb);
     }
 #endif
 
-    size_t lv_buffer_size = board.width() * board.height() * sizeof(lv_color_t);
-    buf = (lv_color_t *)ps_malloc(lv_buffer_size);
-    assert(buf);
+    alloc_draw_buf(board, mode, lines);
 
-    lv_disp_draw_buf_init( &draw_buf, buf, NULL, board.width() * board.height());
+    // Full refresh needs a screen sized buffer
+    bool full_refresh = board.needFullRefresh();
+    if (full_refresh && buf_info.mode != LV_HELPER_BUF_PSRAM_FULL) {
+        full_refresh = false;
+        board.setFullRefresh(false);
+    }
+    init_draw_buf(board, full_refresh);
 
     /*Initialize the display*/
     lv_disp_drv_init( &disp_drv );
     /* display resolution */
-    disp_drv.hor_res = board.width();
-    disp_drv.ver_res = board.height();
+    disp_drv.hor_res = board.viewportWidth();
+    disp_drv.ver_res = board.viewportHeight();
     disp_drv.flush_cb = disp_flush;
+    disp_drv.render_start_cb = disp_render_start;
+    disp_drv.wait_cb = disp_wait;
     disp_drv.draw_buf = &draw_buf;
-    bool full_refresh = board.needFullRefresh();
     disp_drv.full_refresh = full_refresh;
     disp_drv.user_data = &board;
-    // if (!full_refresh) {
-    // disp_drv.rounder_cb = lv_rounder_cb;
-    // }
+    if (!full_refresh) {
+        disp_drv.rounder_cb = lv_rounder_cb;
+    }
     lv_disp_drv_register( &disp_drv );
 
+    async_flush = board.setFlushDoneCallback(disp_flush_done, &disp_drv);
+
+    if (board.hasViewport()) {
+        // Nothing outside the viewport is ever written again
+        board.fillScreen(0x0000);
+    }
+
     // if (board.hasTouch()) {
     //     lv_indev_drv_init( &indev_drv );
     //     indev_drv.type = LV_INDEV_TYPE_POINTER;
@@ -107,4 +374,204 @@ void beginLvglHelper(LilyGo_Display &board, bool debug)
     //     indev_drv.user_data = &board;
     //     lv_indev_drv_register( &indev_drv );
     // }
+    bootPhaseEnd(phase);
+}
+
+void setLvglFullRefresh(bool enable)
+{
+    LilyGo_Display *board = static_cast<LilyGo_Display *>(disp_drv.user_data);
+    if (!board) {
+        return;
+    }
+    if (enable && buf_info.mode != LV_HELPER_BUF_PSRAM_FULL) {
+        log_e("Full refresh needs the PSRAM draw buffer");
+        return;
+    }
+    lvglLock();
+    // The draw buffers are swapped below, wait for the one in flight
+    wait_flush_done();
+    board->setFullRefresh(enable);
+    init_draw_buf(*board, enable);
+    disp_drv.full_refresh = enable;
+    // Partial areas must start on even coordinates and span an even number of pixels
+    disp_drv.rounder_cb = enable ? NULL : lv_rounder_cb;
+    // Re-applies the driver and invalidates the active screen
+    lv_disp_drv_update(lv_disp_get_default(), &disp_drv);
+    lvglUnlock();
+}
+
+void getLvglHelperTiming(lv_helper_timing_t *out)
+{
+    *out = timing;
+}
+
+void getLvglHelperBuffer(lv_helper_buf_info_t *out)
+{
+    *out = buf_info;
+}
+
+void getLvglPerf(lv_helper_perf_t *out)
+{
+    portENTER_CRITICAL(&perf_lock);
+    *out = perf;
+    uint32_t count = perf_head < LV_HELPER_PERF_FRAMES ? perf_head : LV_HELPER_PERF_FRAMES;
+    memset(out->histogram, 0, sizeof(out->histogram));
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t bucket = 0;
+        while (bucket < LV_HELPER_PERF_BUCKETS - 1 && perf_frames[i].frame_us >= perf_bucket_ms[bucket] * 1000U) {
+            bucket++;
+        }
+        out->histogram[bucket]++;
+    }
+    portEXIT_CRITICAL(&perf_lock);
+}
+
+uint32_t getLvglPerfFrames(lv_helper_frame_t *frames, uint32_t max)
+{
+    portENTER_CRITICAL(&perf_lock);
+    uint32_t count = perf_head < LV_HELPER_PERF_FRAMES ? perf_head : LV_HELPER_PERF_FRAMES;
+    if (count > max) {
+        count = max;
+    }
+    // Oldest of the requested frames first
+    for (uint32_t i = 0; i < count; i++) {
+        frames[i] = perf_frames[(perf_head - count + i) % LV_HELPER_PERF_FRAMES];
+    }
+    portEXIT_CRITICAL(&perf_lock);
+    return count;
+}
+
+void countLvglUpdate(bool applied)
+{
+    portENTER_CRITICAL(&perf_lock);
+    if (applied) {
+        perf.updates_applied++;
+    } else {
+        perf.updates_suppressed++;
+    }
+    portEXIT_CRITICAL(&perf_lock);
+}
+
+void resetLvglPerf()
+{
+    portENTER_CRITICAL(&perf_lock);
+    memset(&perf, 0, sizeof(perf));
+    perf_head = 0;
+    perf_last_done_us = 0;
+    portEXIT_CRITICAL(&perf_lock);
+}
+
+void dumpLvglPerf(Stream &stream, bool binary)
+{
+    static lv_helper_frame_t frames[LV_HELPER_PERF_FRAMES];
+    lv_helper_perf_t summary;
+    getLvglPerf(&summary);
+    uint32_t count = getLvglPerfFrames(frames, LV_HELPER_PERF_FRAMES);
+
+    if (binary) {
+        uint8_t header[28] = {'L', 'V', 'P', 'F', 2, sizeof(lv_helper_frame_t)};
+        uint16_t n = count;
+        memcpy(&header[6], &n, sizeof(n));
+        memcpy(&header[8], &summary.frames, sizeof(uint32_t));
+        memcpy(&header[12], &summary.dropped, sizeof(uint32_t));
+        memcpy(&header[16], &summary.max_gap_us, sizeof(uint32_t));
+        memcpy(&header[20], &summary.updates_applied, sizeof(uint32_t));
+        memcpy(&header[24], &summary.updates_suppressed, sizeof(uint32_t));
+        stream.write(header, sizeof(header));
+        stream.write((const uint8_t *)frames, count * sizeof(lv_helper_frame_t));
+        return;
+    }
+
+    stream.printf("# frames:%lu dropped:%lu max_frame_us:%lu max_gap_us:%lu hist_ms",
+                  (unsigned long)summary.frames, (unsigned long)summary.dropped,
+                  (unsigned long)summary.max_frame_us, (unsigned long)summary.max_gap_us);
+    for (uint32_t i = 0; i < LV_HELPER_PERF_BUCKETS; i++) {
+        if (i < LV_HELPER_PERF_BUCKETS - 1) {
+            stream.printf(" <%u:%lu", perf_bucket_ms[i], (unsigned long)summary.histogram[i]);
+        } else {
+            stream.printf(" >=%u:%lu", perf_bucket_ms[i - 1], (unsigned long)summary.histogram[i]);
+        }
+    }
+    stream.printf(" applied:%lu suppressed:%lu\n", (unsigned long)summary.updates_applied,
+                  (unsigned long)summary.updates_suppressed);
+    stream.println("frame_us,render_us,transfer_us,gap_us,bytes,areas");
+    for (uint32_t i = 0; i < count; i++) {
+        lv_helper_frame_t *f = &frames[i];
+        stream.printf("%lu,%lu,%lu,%lu,%lu,%u\n", (unsigned long)f->frame_us, (unsigned long)f->render_us,
+                      (unsigned long)f->transfer_us, (unsigned long)f->gap_us, (unsigned long)f->bytes, f->areas);
+    }
+}
+
+void setLvglViewportOffset(uint16_t x, uint16_t y)
+{
+    LilyGo_Display *board = static_cast<LilyGo_Display *>(disp_drv.user_data);
+    if (!board || !board->hasViewport()) {
+        return;
+    }
+    lvglLock();
+    wait_flush_done();
+    board->setViewportOffset(x, y);
+    // Clear the old position and redraw at the new one
+    board->fillScreen(0x0000);
+    lv_obj_invalidate(lv_scr_act());
+    lvglUnlock();
+}
+
+#if LV_COLOR_DEPTH == 8
+void setLvglPalette(const uint16_t *colors)
+{
+    lvglLock();
+    wait_flush_done();
+    flush_palette = colors ? colors : palette;
+    lv_obj_invalidate(lv_scr_act());
+    lvglUnlock();
+}
+#endif
+
+static void lvgl_task_loop(void *arg)
+{
+    for (;;) {
+        xSemaphoreTakeRecursive(lvgl_mutex, portMAX_DELAY);
+        uint32_t next_ms = lv_timer_handler();
+        xSemaphoreGiveRecursive(lvgl_mutex);
+        // Sleep until the next timer is due, the display refresh timer runs every LV_DISP_DEF_REFR_PERIOD
+        if (next_ms > LV_HELPER_TASK_MAX_SLEEP_MS) {
+            next_ms = LV_HELPER_TASK_MAX_SLEEP_MS;
+        }
+        TickType_t ticks = pdMS_TO_TICKS(next_ms);
+        vTaskDelay(ticks ? ticks : 1);
+    }
+}
+
+bool beginLvglTask(BaseType_t core, UBaseType_t priority)
+{
+    if (!lvgl_mutex) {
+        log_e("Call beginLvglHelper first");
+        return false;
+    }
+    if (lvgl_task) {
+        return true;
+    }
+    if (xTaskCreatePinnedToCore(lvgl_task_loop, "lvgl", LV_HELPER_TASK_STACK, NULL,
+                                priority, &lvgl_task, core) != pdPASS) {
+        log_e("Failed to create LVGL task");
+        lvgl_task = NULL;
+        return false;
+    }
+    return true;
+}
+
+bool lvglLock(TickType_t timeout)
+{
+    if (!lvgl_mutex) {
+        return false;
+    }
+    return xSemaphoreTakeRecursive(lvgl_mutex, timeout) == pdTRUE;
+}
+
+void lvglUnlock()
+{
+    if (lvgl_mutex) {
+        xSemaphoreGiveRecursive(lvgl_mutex);
+    }
 }
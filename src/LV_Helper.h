@@ -8,8 +8,106 @@
  */
 
 #pragma once
+#include <Arduino.h>
 #include <lvgl.h>
 #include "LilyGo_Display.h"
 
+typedef struct {
+    uint32_t render_us;     // Time spent rendering the last frame, excluding waits for the panel
+    uint32_t transfer_us;   // Time spent sending the areas of the last frame over SPI
+    uint32_t frame_us;      // Render start to last transfer done, less than the sum when they overlap
+    uint32_t frames;        // Number of completed frames
+} lv_helper_timing_t;
 
-void beginLvglHelper(LilyGo_Display &board, bool debug = false);
+// Where LVGL renders. Rendering into PSRAM is slower than internal SRAM, and PSRAM
+// buffers are copied again into a DMA bounce buffer by the SPI driver
+typedef enum {
+    LV_HELPER_BUF_PSRAM_FULL,       // Screen sized PSRAM buffer plus a half sized one (default)
+    LV_HELPER_BUF_SRAM_STRIPE,      // One internal SRAM buffer of N lines, no render/flush overlap
+    LV_HELPER_BUF_SRAM_DOUBLE,      // Two internal SRAM buffers of N lines
+    LV_HELPER_BUF_DMA_DOUBLE,       // Two DMA capable buffers of N lines, sent without a bounce copy
+} lv_helper_buf_mode_t;
+
+#define LV_HELPER_STRIPE_LINES      20
+
+typedef struct {
+    lv_helper_buf_mode_t mode;      // Mode in use, differs from the requested one if allocation failed
+    uint16_t lines;                 // Lines per buffer
+    uint32_t internal_bytes;        // Draw buffer memory in internal SRAM
+    uint32_t psram_bytes;           // Draw buffer memory in PSRAM
+} lv_helper_buf_info_t;
+
+// Stripe modes always use partial refresh, lines is rounded up to an even number
+void beginLvglHelper(LilyGo_Display &board, bool debug = false,
+                     lv_helper_buf_mode_t mode = LV_HELPER_BUF_PSRAM_FULL,
+                     uint16_t lines = LV_HELPER_STRIPE_LINES);
+
+// Switch between full frame refresh and dirty area (partial) refresh at runtime
+void setLvglFullRefresh(bool enable);
+
+// Move the viewport set with board.setViewport() before beginLvglHelper
+void setLvglViewportOffset(uint16_t x, uint16_t y);
+
+#if LV_COLOR_DEPTH == 8
+// Map the 256 RGB332 colors LVGL renders to byte swapped RGB565, e.g. to tint the HUD.
+// colors must stay valid, NULL restores the plain RGB332 expansion
+void setLvglPalette(const uint16_t *colors);
+#endif
+
+// Timings of the last completed frame
+void getLvglHelperTiming(lv_helper_timing_t *timing);
+
+// Draw buffer placement and memory, compare with getLvglHelperTiming to pick a mode
+void getLvglHelperBuffer(lv_helper_buf_info_t *info);
+
+#define LV_HELPER_PERF_FRAMES       (64)
+#define LV_HELPER_PERF_BUCKETS      (8)
+// Upper bounds of the frame time histogram buckets in ms, the last bucket takes the rest
+#define LV_HELPER_PERF_BUCKET_MS    {2, 4, 8, 16, 33, 66, 133}
+
+typedef struct {
+    uint32_t frame_us;      // Render start to last transfer done
+    uint32_t render_us;     // Rendering only, excluding waits for the panel
+    uint32_t transfer_us;   // Time the areas spent being sent
+    uint32_t gap_us;        // Since the previous frame was done, includes idle time
+    uint32_t bytes;         // RGB565 bytes handed to the display
+    uint16_t areas;         // Dirty areas flushed
+    uint16_t reserved;
+} lv_helper_frame_t;
+
+typedef struct {
+    uint32_t frames;        // Frames since the last reset
+    uint32_t dropped;       // Frames longer than the refresh period, the next refresh was late
+    uint32_t max_frame_us;
+    uint32_t max_gap_us;
+    uint32_t histogram[LV_HELPER_PERF_BUCKETS];    // frame_us of the last LV_HELPER_PERF_FRAMES frames
+    uint32_t updates_applied;       // Widget updates that reached LVGL, see LV_BoundLabel
+    uint32_t updates_suppressed;    // Widget updates skipped because nothing changed
+} lv_helper_perf_t;
+
+#define LV_HELPER_TASK_STACK        (8192)
+#define LV_HELPER_TASK_PRIORITY     (2)
+#define LV_HELPER_TASK_MAX_SLEEP_MS (50)
+
+// Run lv_timer_handler in its own task instead of loop(). The task sleeps until the next
+// LVGL timer is due. Once started, other tasks must hold lvglLock while touching LVGL objects
+bool beginLvglTask(BaseType_t core = 1, UBaseType_t priority = LV_HELPER_TASK_PRIORITY);
+
+// Recursive, also usable without the task. Keep the section short, rendering waits for it
+bool lvglLock(TickType_t timeout = portMAX_DELAY);
+void lvglUnlock();
+
+// Frame statistics since the last resetLvglPerf
+void getLvglPerf(lv_helper_perf_t *perf);
+
+// Copies up to max of the last LV_HELPER_PERF_FRAMES frames, oldest first, returns the count
+uint32_t getLvglPerfFrames(lv_helper_frame_t *frames, uint32_t max);
+
+void resetLvglPerf();
+
+// Called by the widget bindings for every update, applied or suppressed
+void countLvglUpdate(bool applied);
+
+// CSV with a summary comment line, or binary: "LVPF", version, record size, uint16 count,
+// uint32 frames, dropped, max_gap_us, updates_applied, updates_suppressed, then the records, little endian
+void dumpLvglPerf(Stream &stream = Serial, bool binary = false);
@@ -0,0 +1,322 @@
+/**
+ * @file      LV_NumberLabel.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2023  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2023-10-06
+ *
+ */
+#include <Arduino.h>
+#include "LV_NumberLabel.h"
+#include <src/draw/sw/lv_draw_sw.h>
+
+#if LV_VERSION_CHECK(9,0,0)
+#error "Currently not supported 9.x"
+#endif
+
+#define MY_CLASS &lv_number_label_class
+#define CHARSET_LEN (sizeof(NUMBER_LABEL_CHARSET) - 1)
+
+typedef struct {
+    const lv_font_t *font;
+    lv_coord_t cell_w;                  // Widest digit advance
+    lv_coord_t cell_h;                  // Font line height
+    lv_coord_t width[CHARSET_LEN];      // Advance of every character, digits use cell_w
+    lv_opa_t *alpha;                    // CHARSET_LEN cells of cell_w x cell_h
+} number_atlas_t;
+
+typedef struct {
+    lv_obj_t obj;
+    const number_atlas_t *atlas;
+    uint8_t cells;
+    uint8_t len;
+    char text[NUMBER_LABEL_MAX_CELLS + 1];
+    lv_coord_t x[NUMBER_LABEL_MAX_CELLS];   // Cell offsets relative to the object
+} lv_number_label_t;
+
+static void lv_number_label_constructor(const lv_obj_class_t *class_p, lv_obj_t *obj);
+static void lv_number_label_event(const lv_obj_class_t *class_p, lv_event_t *e);
+
+const lv_obj_class_t lv_number_label_class = {
+    .base_class = &lv_obj_class,
+    .constructor_cb = lv_number_label_constructor,
+    .destructor_cb = NULL,
+#if LV_USE_USER_DATA
+    .user_data = NULL,
+#endif
+    .event_cb = lv_number_label_event,
+    .width_def = LV_SIZE_CONTENT,
+    .height_def = LV_SIZE_CONTENT,
+    .editable = LV_OBJ_CLASS_EDITABLE_INHERIT,
+    .group_def = LV_OBJ_CLASS_GROUP_DEF_INHERIT,
+    .instance_size = sizeof(lv_number_label_t),
+};
+
+static number_atlas_t atlases[NUMBER_LABEL_MAX_FONTS];
+
+static int charset_index(char c)
+{
+    const char *p = strchr(NUMBER_LABEL_CHARSET, c);
+    return (p && c) ? p - NUMBER_LABEL_CHARSET : CHARSET_LEN - 1;
+}
+
+// Rasterize the charset once, with the same placement lv_draw_letter uses
+static const number_atlas_t *get_atlas(const lv_font_t *font)
+{
+    number_atlas_t *atlas = NULL;
+    for (uint32_t i = 0; i < NUMBER_LABEL_MAX_FONTS; i++) {
+        if (atlases[i].font == font) {
+            return &atlases[i];
+        }
+        if (!atlas && !atlases[i].font) {
+            atlas = &atlases[i];
+        }
+    }
+    if (!atlas) {
+        LV_LOG_WARN("number label atlas table full");
+        return NULL;
+    }
+
+    lv_font_glyph_dsc_t g;
+    lv_coord_t cell_w = 0;
+    for (char c = '0'; c <= '9'; c++) {
+        if (lv_font_get_glyph_dsc(font, &g, c, 0) && g.adv_w > cell_w) {
+            cell_w = g.adv_w;
+        }
+    }
+    lv_coord_t cell_h = lv_font_get_line_height(font);
+    lv_opa_t *alpha = (lv_opa_t *)ps_malloc(CHARSET_LEN * cell_w * cell_h);
+    if (!alpha) {
+        return NULL;
+    }
+    memset(alpha, 0, CHARSET_LEN * cell_w * cell_h);
+
+    for (uint32_t i = 0; i < CHARSET_LEN; i++) {
+        char c = NUMBER_LABEL_CHARSET[i];
+        atlas->width[i] = cell_w;
+        if (!lv_font_get_glyph_dsc(font, &g, c, 0)) {
+            continue;
+        }
+        if (c < '0' || c > '9') {
+            atlas->width[i] = g.adv_w < cell_w ? g.adv_w : cell_w;
+        }
+        const uint8_t *bitmap = lv_font_get_glyph_bitmap(font, c);
+        if (!bitmap || !g.box_w || !g.box_h) {
+            continue;
+        }
+        uint32_t mask = (1 << g.bpp) - 1;
+        lv_opa_t *cell = alpha + i * cell_w * cell_h;
+        lv_coord_t ox = g.ofs_x;
+        lv_coord_t oy = (font->line_height - font->base_line) - g.box_h - g.ofs_y;
+        for (lv_coord_t row = 0; row < g.box_h; row++) {
+            for (lv_coord_t col = 0; col < g.box_w; col++) {
+                lv_coord_t x = ox + col;
+                lv_coord_t y = oy + row;
+                if (x < 0 || x >= cell_w || y < 0 || y >= cell_h) {
+                    continue;
+                }
+                uint32_t bit = (row * g.box_w + col) * g.bpp;
+                uint32_t v = (bitmap[bit >> 3] >> (8 - g.bpp - (bit & 7))) & mask;
+                cell[y * cell_w + x] = v * 255 / mask;
+            }
+        }
+    }
+    atlas->cell_w = cell_w;
+    atlas->cell_h = cell_h;
+    atlas->alpha = alpha;
+    atlas->font = font;
+    return atlas;
+}
+
+static void lv_number_label_constructor(const lv_obj_class_t *class_p, lv_obj_t *obj)
+{
+    LV_UNUSED(class_p);
+    lv_number_label_t *label = (lv_number_label_t *)obj;
+    label->atlas = NULL;
+    label->cells = 0;
+    label->len = 0;
+    label->text[0] = '\0';
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
+}
+
+static void invalidate_cell(lv_obj_t *obj, lv_coord_t x, lv_coord_t w)
+{
+    lv_number_label_t *label = (lv_number_label_t *)obj;
+    lv_area_t area;
+    area.x1 = obj->coords.x1 + x;
+    area.y1 = obj->coords.y1;
+    area.x2 = area.x1 + w - 1;
+    area.y2 = area.y1 + label->atlas->cell_h - 1;
+    lv_obj_invalidate_area(obj, &area);
+}
+
+static void draw_cells(lv_obj_t *obj, lv_draw_ctx_t *draw_ctx)
+{
+    lv_number_label_t *label = (lv_number_label_t *)obj;
+    const number_atlas_t *atlas = label->atlas;
+    if (!atlas) {
+        return;
+    }
+    lv_color_t color = lv_obj_get_style_text_color(obj, LV_PART_MAIN);
+    lv_opa_t opa = lv_obj_get_style_text_opa(obj, LV_PART_MAIN);
+
+    for (uint32_t i = 0; i < label->len; i++) {
+        int index = charset_index(label->text[i]);
+        if (NUMBER_LABEL_CHARSET[index] == ' ') {
+            continue;
+        }
+        lv_area_t cell;
+        cell.x1 = obj->coords.x1 + label->x[i];
+        cell.y1 = obj->coords.y1;
+        cell.x2 = cell.x1 + atlas->cell_w - 1;
+        cell.y2 = cell.y1 + atlas->cell_h - 1;
+        lv_area_t clipped;
+        if (!_lv_area_intersect(&clipped, &cell, draw_ctx->clip_area)) {
+            continue;
+        }
+        lv_opa_t *mask = atlas->alpha + index * atlas->cell_w * atlas->cell_h;
+        if (lv_draw_mask_is_any(&cell)) {
+            // Clip masks need the generic image path
+            lv_img_dsc_t img;
+            memset(&img, 0, sizeof(img));
+            img.header.cf = LV_IMG_CF_ALPHA_8BIT;
+            img.header.w = atlas->cell_w;
+            img.header.h = atlas->cell_h;
+            img.data_size = atlas->cell_w * atlas->cell_h;
+            img.data = mask;
+            lv_draw_img_dsc_t dsc;
+            lv_draw_img_dsc_init(&dsc);
+            dsc.recolor = color;
+            dsc.opa = opa;
+            lv_draw_img(draw_ctx, &dsc, &cell, &img);
+            continue;
+        }
+        lv_draw_sw_blend_dsc_t blend;
+        memset(&blend, 0, sizeof(blend));
+        blend.blend_area = &cell;
+        blend.mask_area = &cell;
+        blend.mask_buf = mask;
+        blend.mask_res = LV_DRAW_MASK_RES_CHANGED;
+        blend.color = color;
+        blend.opa = opa;
+        blend.blend_mode = LV_BLEND_MODE_NORMAL;
+        lv_draw_sw_blend(draw_ctx, &blend);
+    }
+}
+
+static void lv_number_label_event(const lv_obj_class_t *class_p, lv_event_t *e)
+{
+    LV_UNUSED(class_p);
+
+    lv_res_t res = lv_obj_event_base(MY_CLASS, e);
+    if (res != LV_RES_OK) {
+        return;
+    }
+
+    lv_event_code_t code = lv_event_get_code(e);
+    lv_obj_t *obj = lv_event_get_target(e);
+    lv_number_label_t *label = (lv_number_label_t *)obj;
+    if (code == LV_EVENT_GET_SELF_SIZE) {
+        lv_point_t *p = (lv_point_t *)lv_event_get_param(e);
+        if (label->atlas) {
+            p->x = LV_MAX(p->x, label->atlas->cell_w * label->cells);
+            p->y = LV_MAX(p->y, label->atlas->cell_h);
+        }
+    } else if (code == LV_EVENT_DRAW_MAIN) {
+        draw_cells(obj, lv_event_get_draw_ctx(e));
+    }
+}
+
+lv_obj_t *lv_number_label_create(lv_obj_t *parent, const lv_font_t *font, uint8_t cells)
+{
+    LV_LOG_INFO("begin");
+    lv_obj_t *obj = lv_obj_class_create_obj(MY_CLASS, parent);
+    lv_obj_class_init_obj(obj);
+    lv_number_label_t *label = (lv_number_label_t *)obj;
+    label->atlas = get_atlas(font);
+    label->cells = cells < NUMBER_LABEL_MAX_CELLS ? cells : NUMBER_LABEL_MAX_CELLS;
+    lv_obj_refresh_self_size(obj);
+    return obj;
+}
+
+void lv_number_label_set_text(lv_obj_t *obj, const char *text)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+    lv_number_label_t *label = (lv_number_label_t *)obj;
+    const number_atlas_t *atlas = label->atlas;
+    if (!atlas) {
+        return;
+    }
+
+    uint32_t len = strlen(text);
+    if (len > label->cells) {
+        // Keep the least significant characters
+        text += len - label->cells;
+        len = label->cells;
+    }
+    lv_coord_t total = 0;
+    for (uint32_t i = 0; i < len; i++) {
+        total += atlas->width[charset_index(text[i])];
+    }
+
+    // Right aligned, only cells whose character or position changed are redrawn
+    lv_coord_t x = atlas->cell_w * label->cells - total;
+    for (uint32_t i = 0; i < len; i++) {
+        lv_coord_t w = atlas->width[charset_index(text[i])];
+        // A narrow character is still drawn from a full cell
+        if (i >= label->len || label->text[i] != text[i] || label->x[i] != x) {
+            if (i < label->len) {
+                invalidate_cell(obj, label->x[i], atlas->cell_w);
+            }
+            invalidate_cell(obj, x, atlas->cell_w);
+        }
+        label->text[i] = text[i];
+        label->x[i] = x;
+        x += w;
+    }
+    for (uint32_t i = len; i < label->len; i++) {
+        invalidate_cell(obj, label->x[i], atlas->cell_w);
+    }
+    label->text[len] = '\0';
+    label->len = len;
+}
+
+char *lv_number_label_format(char *buf, size_t size, int32_t value, uint8_t decimals)
+{
+    if (size < 4) {
+        buf[0] = '\0';
+        return buf;
+    }
+    bool negative = value < 0;
+    uint32_t v = negative ? -(uint32_t)value : value;
+    // Decimals that do not fit are dropped, not the scale
+    while (decimals > size - 4) {
+        v /= 10;
+        decimals--;
+    }
+    negative &= v != 0;
+    char *p = buf + size - 1;
+    *p = '\0';
+    // Leftmost slot a digit or the point may take, the sign goes before it
+    char *first = buf + negative;
+    uint32_t digits = 0;
+    do {
+        if (decimals && digits == decimals) {
+            *--p = '.';
+        }
+        *--p = '0' + v % 10;
+        v /= 10;
+        digits++;
+    } while ((v || digits <= decimals) && p - first >= (decimals && digits == decimals ? 2 : 1));
+    if (negative) {
+        *--p = '-';
+    }
+    return p;
+}
+
+void lv_number_label_set_fixed(lv_obj_t *obj, int32_t value, uint8_t decimals)
+{
+    char buf[NUMBER_LABEL_MAX_CELLS + 2];
+    lv_number_label_set_text(obj, lv_number_label_format(buf, sizeof(buf), value, decimals));
+}
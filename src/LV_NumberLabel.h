@@ -0,0 +1,37 @@
+/**
+ * @file      LV_NumberLabel.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2023  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2023-10-06
+ *
+ */
+#pragma once
+
+#include <lvgl.h>
+
+/*
+ * Fixed width numeric label for fast changing HUD values such as speed and lap time.
+ * The glyphs of NUMBER_LABEL_CHARSET are rasterized once per font into an alpha atlas,
+ * drawing blends the atlas cells directly and set_text only invalidates the cells that
+ * changed, there is no relayout or glyph decoding per update.
+ * Other characters are drawn as blanks. Text is right aligned, the color is text_color.
+ */
+#define NUMBER_LABEL_CHARSET        "0123456789.:-+* "
+#define NUMBER_LABEL_MAX_CELLS      12
+#define NUMBER_LABEL_MAX_FONTS      4
+
+extern const lv_obj_class_t lv_number_label_class;
+
+// cells: the number of digit wide cells the object is sized for
+lv_obj_t *lv_number_label_create(lv_obj_t *parent, const lv_font_t *font, uint8_t cells);
+
+void lv_number_label_set_text(lv_obj_t *obj, const char *text);
+
+// value / 10^decimals without printf, e.g. (1234, 1) shows "123.4"
+void lv_number_label_set_fixed(lv_obj_t *obj, int32_t value, uint8_t decimals);
+
+// The text of set_fixed, right aligned in buf and NUL terminated at buf[size - 1].
+// Returns where it starts, never before buf: the last decimals are dropped when they do
+// not fit with the sign, a leading zero and the point, then the leading digits that do not.
+char *lv_number_label_format(char *buf, size_t size, int32_t value, uint8_t decimals);
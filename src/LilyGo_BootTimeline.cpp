@@ -0,0 +1,72 @@
+/**
+ * @file      LilyGo_BootTimeline.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2023  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2023-10-06
+ *
+ */
+#include <esp_timer.h>
+#include "LilyGo_BootTimeline.h"
+
+typedef struct {
+    const char *name;
+    int64_t start_us;
+    int64_t end_us;
+    uint8_t core;
+} boot_phase_t;
+
+static boot_phase_t phases[BOOT_TIMELINE_MAX_PHASES];
+static int phase_count;
+static portMUX_TYPE phase_lock = portMUX_INITIALIZER_UNLOCKED;
+
+int bootPhaseBegin(const char *name)
+{
+    int64_t now = esp_timer_get_time();
+    int phase = -1;
+    portENTER_CRITICAL(&phase_lock);
+    if (phase_count < BOOT_TIMELINE_MAX_PHASES) {
+        phase = phase_count++;
+        phases[phase].name = name;
+        phases[phase].start_us = now;
+        phases[phase].end_us = -1;
+        phases[phase].core = xPortGetCoreID();
+    }
+    portEXIT_CRITICAL(&phase_lock);
+    return phase;
+}
+
+void bootPhaseEnd(int phase)
+{
+    if (phase < 0 || phase >= BOOT_TIMELINE_MAX_PHASES) {
+        return;
+    }
+    phases[phase].end_us = esp_timer_get_time();
+}
+
+void bootPhaseMark(const char *name)
+{
+    bootPhaseEnd(bootPhaseBegin(name));
+}
+
+void printBootTimeline(Stream &stream)
+{
+    int count;
+    boot_phase_t copy[BOOT_TIMELINE_MAX_PHASES];
+    portENTER_CRITICAL(&phase_lock);
+    count = phase_count;
+    memcpy(copy, phases, sizeof(boot_phase_t) * count);
+    portEXIT_CRITICAL(&phase_lock);
+
+    stream.println("Boot timeline (ms since reset)");
+    stream.printf("%-20s %8s %8s %8s %4s\n", "phase", "start", "end", "time", "core");
+    for (int i = 0; i < count; i++) {
+        boot_phase_t *p = &copy[i];
+        if (p->end_us < 0) {
+            stream.printf("%-20s %8.1f %8s %8s %4u\n", p->name, p->start_us / 1000.0, "-", "-", p->core);
+        } else {
+            stream.printf("%-20s %8.1f %8.1f %8.1f %4u\n", p->name, p->start_us / 1000.0,
+                          p->end_us / 1000.0, (p->end_us - p->start_us) / 1000.0, p->core);
+        }
+    }
+}
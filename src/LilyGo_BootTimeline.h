@@ -0,0 +1,26 @@
+/**
+ * @file      LilyGo_BootTimeline.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2023  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2023-10-06
+ *
+ */
+#pragma once
+
+#include <Arduino.h>
+
+/*
+ * Timestamps of the boot phases, in microseconds since the chip came out of reset.
+ * Phases may run on different tasks at the same time, the report shows the overlap.
+ */
+#define BOOT_TIMELINE_MAX_PHASES    24
+
+// Returns the phase index for bootPhaseEnd, -1 when the table is full
+int bootPhaseBegin(const char *name);
+void bootPhaseEnd(int phase);
+
+// A point in time, e.g. the first frame on the panel
+void bootPhaseMark(const char *name);
+
+void printBootTimeline(Stream &stream = Serial);
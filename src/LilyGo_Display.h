@@ -10,6 +10,9 @@
 
 #include <stdint.h>
 
+// from_isr: raised from the transfer done interrupt, false when a flush completes in a task
+typedef void (*disp_flush_done_cb_t)(void *user_data, bool from_isr);
+
 enum DispRotation {
     DISP_VERTICAL,      // vertical
     DISP_HORIZONTAL,    // horizontal
@@ -24,6 +27,10 @@ public:
     virtual void setAddrWindow(uint16_t xs, uint16_t ys, uint16_t xe, uint16_t ye) = 0;
     virtual void pushColors(uint16_t *data, uint32_t len) = 0;
     virtual void pushColors(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t *data) = 0;
+    // 8-bit indexes expanded through a 256 entry palette of panel order RGB565 while sending
+    virtual void pushIndexedColors(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t *data, const uint16_t *palette) = 0;
+    // Returns false if the display does not complete pushColors asynchronously
+    virtual bool setFlushDoneCallback(disp_flush_done_cb_t cb, void *user_data) = 0;
     virtual uint16_t  width() = 0;
     virtual uint16_t  height() = 0;
 
@@ -31,9 +38,57 @@ public:
     virtual bool    hasTouch() = 0;
 
     virtual bool needFullRefresh() = 0;
+    virtual void setFullRefresh(bool enable) = 0;
+
+    // Fill the whole panel, ignoring the viewport
+    virtual void fillScreen(uint16_t color) = 0;
+
+    // Restrict LVGL to a window of the panel, e.g. the area visible through the prism.
+    // Offsets are kept even and inside the panel, a zero size disables the viewport.
+    void setViewport(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+    {
+        _viewport_w = w < width() ? w : width();
+        _viewport_h = h < height() ? h : height();
+        setViewportOffset(x, y);
+    }
+
+    void setViewportOffset(uint16_t x, uint16_t y)
+    {
+        uint16_t max_x = hasViewport() ? width() - _viewport_w : 0;
+        uint16_t max_y = hasViewport() ? height() - _viewport_h : 0;
+        _offset_x = (x < max_x ? x : max_x) & ~1;
+        _offset_y = (y < max_y ? y : max_y) & ~1;
+    }
+
+    bool hasViewport()
+    {
+        return _viewport_w && _viewport_h;
+    }
+
+    uint16_t viewportX()
+    {
+        return _offset_x;
+    }
+
+    uint16_t viewportY()
+    {
+        return _offset_y;
+    }
+
+    uint16_t viewportWidth()
+    {
+        return hasViewport() ? _viewport_w : width();
+    }
+
+    uint16_t viewportHeight()
+    {
+        return hasViewport() ? _viewport_h : height();
+    }
 
 protected:
     uint16_t _offset_x = 0;
     uint16_t _offset_y = 0;
+    uint16_t _viewport_w = 0;
+    uint16_t _viewport_h = 0;
     uint8_t _rotation;
 };
@@ -0,0 +1,223 @@
+/**
+ * @file      LilyGo_FrameBuffer.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2023  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2023-10-06
+ *
+ */
+#include "LilyGo_FrameBuffer.h"
+
+LilyGo_FrameBuffer::LilyGo_FrameBuffer(uint16_t width, uint16_t height) :
+    _buffer(NULL), _panel_w(width), _panel_h(height), _window_pos(0),
+    _fullRefresh(false), _touch_x(0), _touch_y(0), _touched(false)
+{
+    memset(_window, 0, sizeof(_window));
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+LilyGo_FrameBuffer::~LilyGo_FrameBuffer()
+{
+    free(_buffer);
+}
+
+bool LilyGo_FrameBuffer::begin()
+{
+    if (!_buffer) {
+        _buffer = (uint16_t *)malloc(_panel_w * _panel_h * sizeof(uint16_t));
+        if (!_buffer) {
+            return false;
+        }
+    }
+    fillScreen(0x0000);
+    resetStats();
+    return true;
+}
+
+void LilyGo_FrameBuffer::setRotation(uint8_t rotation)
+{
+    _rotation = rotation & 3;
+    if (_buffer) {
+        fillScreen(0x0000);
+    }
+}
+
+uint8_t LilyGo_FrameBuffer::getRotation()
+{
+    return _rotation;
+}
+
+uint16_t LilyGo_FrameBuffer::width()
+{
+    return (_rotation & 1) ? _panel_h : _panel_w;
+}
+
+uint16_t LilyGo_FrameBuffer::height()
+{
+    return (_rotation & 1) ? _panel_w : _panel_h;
+}
+
+void LilyGo_FrameBuffer::setAddrWindow(uint16_t xs, uint16_t ys, uint16_t xe, uint16_t ye)
+{
+    // Inclusive end coordinates, like the panel
+    _window[0] = xs;
+    _window[1] = ys;
+    _window[2] = xe < width() ? xe : width() - 1;
+    _window[3] = ye < height() ? ye : height() - 1;
+    _window_pos = 0;
+}
+
+void LilyGo_FrameBuffer::pushColors(uint16_t *data, uint32_t len)
+{
+    if (!_buffer) {
+        return;
+    }
+    uint32_t w = _window[2] - _window[0] + 1;
+    uint32_t total = w * (_window[3] - _window[1] + 1);
+    // Continues where the last call stopped, like RAMWR
+    for (uint32_t i = 0; i < len && _window_pos < total; i++, _window_pos++) {
+        uint32_t x = _window[0] + _window_pos % w;
+        uint32_t y = _window[1] + _window_pos / w;
+        _buffer[y * width() + x] = data[i];
+    }
+    _stats.pushes++;
+    _stats.pixels += len;
+}
+
+void LilyGo_FrameBuffer::writePixels(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *data, const uint8_t *index, const uint16_t *palette)
+{
+    if (!_buffer) {
+        return;
+    }
+    uint16_t stride = width();
+    for (uint32_t row = 0; row < h; row++) {
+        if (y + row >= height()) {
+            break;
+        }
+        uint16_t *dst = _buffer + (y + row) * stride + x;
+        uint32_t count = x + w <= stride ? w : (x < stride ? stride - x : 0);
+        if (data) {
+            memcpy(dst, data + row * w, count * sizeof(uint16_t));
+        } else {
+            const uint8_t *src = index + row * w;
+            for (uint32_t i = 0; i < count; i++) {
+                dst[i] = palette[src[i]];
+            }
+        }
+    }
+    _stats.pushes++;
+    _stats.pixels += w * h;
+}
+
+void LilyGo_FrameBuffer::pushColors(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t *data)
+{
+    writePixels(x, y, width, height, data, NULL, NULL);
+}
+
+void LilyGo_FrameBuffer::pushIndexedColors(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t *data, const uint16_t *palette)
+{
+    writePixels(x, y, width, height, NULL, data, palette);
+}
+
+bool LilyGo_FrameBuffer::setFlushDoneCallback(disp_flush_done_cb_t cb, void *user_data)
+{
+    // Nothing is sent, every push is done when it returns
+    return false;
+}
+
+void LilyGo_FrameBuffer::setPoint(int16_t x, int16_t y, bool pressed)
+{
+    _touch_x = x;
+    _touch_y = y;
+    _touched = pressed;
+}
+
+uint8_t LilyGo_FrameBuffer::getPoint(int16_t *x, int16_t *y, uint8_t get_point)
+{
+    if (!_touched) {
+        return 0;
+    }
+    *x = _touch_x;
+    *y = _touch_y;
+    return 1;
+}
+
+bool LilyGo_FrameBuffer::hasTouch()
+{
+    return true;
+}
+
+bool LilyGo_FrameBuffer::needFullRefresh()
+{
+    return _fullRefresh;
+}
+
+void LilyGo_FrameBuffer::setFullRefresh(bool enable)
+{
+    _fullRefresh = enable;
+}
+
+void LilyGo_FrameBuffer::fillScreen(uint16_t color)
+{
+    if (!_buffer) {
+        return;
+    }
+    uint32_t len = _panel_w * _panel_h;
+    for (uint32_t i = 0; i < len; i++) {
+        _buffer[i] = color;
+    }
+    _stats.fills++;
+}
+
+const uint16_t *LilyGo_FrameBuffer::getBuffer()
+{
+    return _buffer;
+}
+
+uint16_t LilyGo_FrameBuffer::getPixel(uint16_t x, uint16_t y)
+{
+    if (!_buffer || x >= width() || y >= height()) {
+        return 0;
+    }
+    return _buffer[y * width() + x];
+}
+
+void LilyGo_FrameBuffer::writePPM(Stream &stream, bool viewportOnly)
+{
+    uint16_t x0 = viewportOnly ? viewportX() : 0;
+    uint16_t y0 = viewportOnly ? viewportY() : 0;
+    uint16_t w = viewportOnly ? viewportWidth() : width();
+    uint16_t h = viewportOnly ? viewportHeight() : height();
+
+    stream.printf("P6\n%u %u\n255\n", w, h);
+    uint8_t line[FRAMEBUFFER_DEFAULT_HEIGHT * 3];
+    for (uint32_t y = y0; y < (uint32_t)y0 + h; y++) {
+        uint32_t n = 0;
+        for (uint32_t x = x0; x < (uint32_t)x0 + w; x++) {
+            // Panel order is big endian RGB565
+            uint16_t c = getPixel(x, y);
+            c = (c >> 8) | (c << 8);
+            uint8_t r = (c >> 11) & 0x1F;
+            uint8_t g = (c >> 5) & 0x3F;
+            uint8_t b = c & 0x1F;
+            line[n++] = (r << 3) | (r >> 2);
+            line[n++] = (g << 2) | (g >> 4);
+            line[n++] = (b << 3) | (b >> 2);
+            if (n == sizeof(line)) {
+                stream.write(line, n);
+                n = 0;
+            }
+        }
+        stream.write(line, n);
+    }
+}
+
+void LilyGo_FrameBuffer::getStats(framebuffer_stats_t *stats)
+{
+    *stats = _stats;
+}
+
+void LilyGo_FrameBuffer::resetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
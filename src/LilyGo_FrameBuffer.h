@@ -0,0 +1,82 @@
+/**
+ * @file      LilyGo_FrameBuffer.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2023  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2023-10-06
+ *
+ */
+#pragma once
+
+#include <Arduino.h>
+#include "LilyGo_Display.h"
+
+#define FRAMEBUFFER_DEFAULT_WIDTH   (126)
+#define FRAMEBUFFER_DEFAULT_HEIGHT  (294)
+
+typedef struct {
+    uint32_t pushes;            // pushColors and pushIndexedColors calls
+    uint32_t pixels;            // Pixels written by them
+    uint32_t fills;             // fillScreen calls
+} framebuffer_stats_t;
+
+/*
+ * A LilyGo_Display that only writes to memory, with the JD9613 geometry by default.
+ * Lets LV_Helper and the HUD run without a panel, e.g. for screenshots or for timing
+ * rendering on its own. Pixels are kept in panel order (byte swapped RGB565), writePPM
+ * converts them. Flushes complete synchronously.
+ */
+class LilyGo_FrameBuffer : public LilyGo_Display
+{
+public:
+    LilyGo_FrameBuffer(uint16_t width = FRAMEBUFFER_DEFAULT_WIDTH, uint16_t height = FRAMEBUFFER_DEFAULT_HEIGHT);
+    ~LilyGo_FrameBuffer();
+
+    bool begin();
+
+    // Rotation 1 and 3 swap width and height and clear the buffer
+    void setRotation(uint8_t rotation);
+    uint8_t getRotation();
+
+    void setAddrWindow(uint16_t xs, uint16_t ys, uint16_t xe, uint16_t ye);
+    void pushColors(uint16_t *data, uint32_t len);
+    void pushColors(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t *data);
+    void pushIndexedColors(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t *data, const uint16_t *palette);
+    bool setFlushDoneCallback(disp_flush_done_cb_t cb, void *user_data);
+
+    uint16_t width();
+    uint16_t height();
+
+    // Simulated touch, reported by getPoint until released
+    void setPoint(int16_t x, int16_t y, bool pressed);
+    uint8_t getPoint(int16_t *x, int16_t *y, uint8_t get_point);
+    bool hasTouch();
+
+    bool needFullRefresh();
+    void setFullRefresh(bool enable);
+    void fillScreen(uint16_t color);
+
+    // width() * height() pixels, row major, panel order
+    const uint16_t *getBuffer();
+    uint16_t getPixel(uint16_t x, uint16_t y);
+
+    // Binary PPM (P6) of the whole buffer, or of the viewport only
+    void writePPM(Stream &stream, bool viewportOnly = false);
+
+    void getStats(framebuffer_stats_t *stats);
+    void resetStats();
+
+private:
+    void writePixels(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *data, const uint8_t *index, const uint16_t *palette);
+
+    uint16_t *_buffer;
+    uint16_t _panel_w;
+    uint16_t _panel_h;
+    uint16_t _window[4];
+    uint32_t _window_pos;
+    bool _fullRefresh;
+    int16_t _touch_x;
+    int16_t _touch_y;
+    bool _touched;
+    framebuffer_stats_t _stats;
+};
@@ -0,0 +1,180 @@
+/**
+ * @file      LilyGo_Rotation.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2023  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2023-10-06
+ *
+ */
+#include "LilyGo_Rotation.h"
+
+static inline bool rotation_paired(const void *src, const void *dst, uint32_t width, uint32_t height)
+{
+    return !((width | height) & 1) && !(((uintptr_t)src | (uintptr_t)dst) & 3);
+}
+
+static void rotate_cw_scalar(const uint16_t *src, uint16_t *dst, uint32_t width, uint32_t height)
+{
+    uint32_t index = 0;
+    for (uint32_t j = 0; j < width; j++) {
+        for (uint32_t i = 0; i < height; i++) {
+            dst[index++] = src[width * (height - i - 1) + j];
+        }
+    }
+}
+
+static void rotate_ccw_scalar(const uint16_t *src, uint16_t *dst, uint32_t width, uint32_t height)
+{
+    uint32_t index = 0;
+    for (uint32_t j = 0; j < width; j++) {
+        for (uint32_t i = 0; i < height; i++) {
+            dst[index++] = src[width * i + (width - 1 - j)];
+        }
+    }
+}
+
+void rotate_rgb565_cw(const uint16_t *src, uint16_t *dst, uint32_t width, uint32_t height)
+{
+    if (!rotation_paired(src, dst, width, height)) {
+        rotate_cw_scalar(src, dst, width, height);
+        return;
+    }
+
+    const uint32_t src_stride = width >> 1;     // in 32-bit words
+    const uint32_t dst_stride = height >> 1;
+    const uint32_t *s = (const uint32_t *)src;
+    uint32_t *d = (uint32_t *)dst;
+
+    for (uint32_t tj = 0; tj < width; tj += ROTATION_TILE_SIZE) {
+        uint32_t je = tj + ROTATION_TILE_SIZE < width ? tj + ROTATION_TILE_SIZE : width;
+        for (uint32_t ti = 0; ti < height; ti += ROTATION_TILE_SIZE) {
+            uint32_t ie = ti + ROTATION_TILE_SIZE < height ? ti + ROTATION_TILE_SIZE : height;
+            for (uint32_t i = ti; i < ie; i += 2) {
+                // Output columns i and i + 1 come from source rows height - 1 - i and height - 2 - i
+                const uint32_t *r0 = s + (height - 1 - i) * src_stride;
+                const uint32_t *r1 = r0 - src_stride;
+                uint32_t *out = d + (i >> 1);
+                for (uint32_t j = tj; j < je; j += 2) {
+                    uint32_t p0 = r0[j >> 1];
+                    uint32_t p1 = r1[j >> 1];
+                    out[j * dst_stride] = (p0 & 0xFFFF) | (p1 << 16);
+                    out[(j + 1) * dst_stride] = (p0 >> 16) | (p1 & 0xFFFF0000);
+                }
+            }
+        }
+    }
+}
+
+void rotate_rgb565_ccw(const uint16_t *src, uint16_t *dst, uint32_t width, uint32_t height)
+{
+    if (!rotation_paired(src, dst, width, height)) {
+        rotate_ccw_scalar(src, dst, width, height);
+        return;
+    }
+
+    const uint32_t src_stride = width >> 1;
+    const uint32_t dst_stride = height >> 1;
+    const uint32_t *s = (const uint32_t *)src;
+    uint32_t *d = (uint32_t *)dst;
+
+    for (uint32_t tj = 0; tj < width; tj += ROTATION_TILE_SIZE) {
+        uint32_t je = tj + ROTATION_TILE_SIZE < width ? tj + ROTATION_TILE_SIZE : width;
+        for (uint32_t ti = 0; ti < height; ti += ROTATION_TILE_SIZE) {
+            uint32_t ie = ti + ROTATION_TILE_SIZE < height ? ti + ROTATION_TILE_SIZE : height;
+            for (uint32_t i = ti; i < ie; i += 2) {
+                // Output columns i and i + 1 come from source rows i and i + 1
+                const uint32_t *r0 = s + i * src_stride;
+                const uint32_t *r1 = r0 + src_stride;
+                uint32_t *out = d + (i >> 1);
+                for (uint32_t j = tj; j < je; j += 2) {
+                    // Output rows j and j + 1 come from source columns width - 1 - j and width - 2 - j
+                    uint32_t c = (width - 2 - j) >> 1;
+                    uint32_t p0 = r0[c];
+                    uint32_t p1 = r1[c];
+                    out[j * dst_stride] = (p0 >> 16) | (p1 & 0xFFFF0000);
+                    out[(j + 1) * dst_stride] = (p0 & 0xFFFF) | (p1 << 16);
+                }
+            }
+        }
+    }
+}
+
+void expand_index8(const uint8_t *src, uint16_t *dst, uint32_t len, const uint16_t *palette)
+{
+    uint32_t i = 0;
+    if (!(((uintptr_t)src | (uintptr_t)dst) & 3)) {
+        // Four indexes per load, two pixels per store
+        const uint32_t *s = (const uint32_t *)src;
+        uint32_t *d = (uint32_t *)dst;
+        for (; i + 4 <= len; i += 4) {
+            uint32_t p = *s++;
+            *d++ = palette[p & 0xFF] | ((uint32_t)palette[(p >> 8) & 0xFF] << 16);
+            *d++ = palette[(p >> 16) & 0xFF] | ((uint32_t)palette[p >> 24] << 16);
+        }
+    }
+    for (; i < len; i++) {
+        dst[i] = palette[src[i]];
+    }
+}
+
+void rotate_index8_cw(const uint8_t *src, uint16_t *dst, uint32_t width, uint32_t height, const uint16_t *palette)
+{
+    if ((height & 1) || ((uintptr_t)dst & 3)) {
+        uint32_t index = 0;
+        for (uint32_t j = 0; j < width; j++) {
+            for (uint32_t i = 0; i < height; i++) {
+                dst[index++] = palette[src[width * (height - i - 1) + j]];
+            }
+        }
+        return;
+    }
+
+    const uint32_t dst_stride = height >> 1;
+    uint32_t *d = (uint32_t *)dst;
+
+    for (uint32_t tj = 0; tj < width; tj += ROTATION_TILE_SIZE) {
+        uint32_t je = tj + ROTATION_TILE_SIZE < width ? tj + ROTATION_TILE_SIZE : width;
+        for (uint32_t ti = 0; ti < height; ti += ROTATION_TILE_SIZE) {
+            uint32_t ie = ti + ROTATION_TILE_SIZE < height ? ti + ROTATION_TILE_SIZE : height;
+            for (uint32_t i = ti; i < ie; i += 2) {
+                const uint8_t *r0 = src + (height - 1 - i) * width;
+                const uint8_t *r1 = r0 - width;
+                uint32_t *out = d + (i >> 1);
+                for (uint32_t j = tj; j < je; j++) {
+                    out[j * dst_stride] = palette[r0[j]] | ((uint32_t)palette[r1[j]] << 16);
+                }
+            }
+        }
+    }
+}
+
+void rotate_index8_ccw(const uint8_t *src, uint16_t *dst, uint32_t width, uint32_t height, const uint16_t *palette)
+{
+    if ((height & 1) || ((uintptr_t)dst & 3)) {
+        uint32_t index = 0;
+        for (uint32_t j = 0; j < width; j++) {
+            for (uint32_t i = 0; i < height; i++) {
+                dst[index++] = palette[src[width * i + (width - 1 - j)]];
+            }
+        }
+        return;
+    }
+
+    const uint32_t dst_stride = height >> 1;
+    uint32_t *d = (uint32_t *)dst;
+
+    for (uint32_t tj = 0; tj < width; tj += ROTATION_TILE_SIZE) {
+        uint32_t je = tj + ROTATION_TILE_SIZE < width ? tj + ROTATION_TILE_SIZE : width;
+        for (uint32_t ti = 0; ti < height; ti += ROTATION_TILE_SIZE) {
+            uint32_t ie = ti + ROTATION_TILE_SIZE < height ? ti + ROTATION_TILE_SIZE : height;
+            for (uint32_t i = ti; i < ie; i += 2) {
+                const uint8_t *r0 = src + i * width + (width - 1);
+                const uint8_t *r1 = r0 + width;
+                uint32_t *out = d + (i >> 1);
+                for (uint32_t j = tj; j < je; j++) {
+                    out[j * dst_stride] = palette[*(r0 - j)] | ((uint32_t)palette[*(r1 - j)] << 16);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,47 @@
+/**
+ * @file      LilyGo_Rotation.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2023  ShenZhen XinYuan Electronic Technology Co., Ltd
+ * @date      2023-10-06
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Software rotation of RGB565 blocks for the JD9613, which cannot rotate by itself.
+ * src holds width x height packed pixels, dst receives width rows of height pixels.
+ *
+ * The block is walked in ROTATION_TILE_SIZE square tiles so the source rows touched
+ * by a tile stay in cache, and pixels are moved in pairs with 32-bit loads and stores.
+ * Odd sizes or unaligned buffers fall back to the per pixel loop.
+ */
+#define ROTATION_TILE_SIZE      16
+
+// Rotation 1: dst[j * height + i] = src[(height - 1 - i) * width + j]
+void rotate_rgb565_cw(const uint16_t *src, uint16_t *dst, uint32_t width, uint32_t height);
+
+// Rotation 3: dst[j * height + i] = src[i * width + (width - 1 - j)]
+void rotate_rgb565_ccw(const uint16_t *src, uint16_t *dst, uint32_t width, uint32_t height);
+
+/*
+ * 8-bit indexed blocks, e.g. LVGL rendering with LV_COLOR_DEPTH 8, expanded through a
+ * 256 entry palette of panel ready (byte swapped) RGB565 while they are copied or rotated.
+ */
+void expand_index8(const uint8_t *src, uint16_t *dst, uint32_t len, const uint16_t *palette);
+
+// Same index mapping as rotate_rgb565_cw
+void rotate_index8_cw(const uint8_t *src, uint16_t *dst, uint32_t width, uint32_t height, const uint16_t *palette);
+
+// Same index mapping as rotate_rgb565_ccw
+void rotate_index8_ccw(const uint8_t *src, uint16_t *dst, uint32_t width, uint32_t height, const uint16_t *palette);
+
+#ifdef __cplusplus
+}
+#endif
@@ -16,8 +16,11 @@
 #include <hal/spi_types.h>
 #include <driver/spi_common.h>
 #include <esp_adc_cal.h>
+#include <esp_timer.h>
 #include "LilyGo_Wristband.h"
 #include "initSequence.h"
+#include "LilyGo_Rotation.h"
+#include "LilyGo_BootTimeline.h"
 
 static volatile bool touchDetected;
 static void touchISR()
@@ -34,6 +37,23 @@ __BEGIN_DECLS
 
 #define TAG  "jd9613"
 
+// Reset and wake waits. A reset while in sleep out needs 120ms before SLPOUT and SLPOUT
+// 120ms before DISPON, the defaults keep those and the vendor's 100ms reset pulse. The
+// MIPI DCS minimums save about 450ms of boot but are not verified on this panel:
+// -DJD9613_RESET_PULSE_MS=1 -DJD9613_RESET_WAIT_MS=5 -DJD9613_SLPOUT_WAIT_MS=5 -DJD9613_DISPON_WAIT_MS=0
+#ifndef JD9613_RESET_PULSE_MS
+#define JD9613_RESET_PULSE_MS   (100)
+#endif
+#ifndef JD9613_RESET_WAIT_MS
+#define JD9613_RESET_WAIT_MS    (120)
+#endif
+#ifndef JD9613_SLPOUT_WAIT_MS
+#define JD9613_SLPOUT_WAIT_MS   (120)
+#endif
+#ifndef JD9613_DISPON_WAIT_MS
+#define JD9613_DISPON_WAIT_MS   (120)
+#endif
+
 typedef struct {
     esp_lcd_panel_t base;
     esp_lcd_panel_io_handle_t io;
@@ -44,13 +64,64 @@ typedef struct {
     uint16_t width;
     uint16_t height;
     bool flipHorizontal;
+    // Asynchronous flush, called from the SPI ISR when the last pixel chunk is out
+    disp_flush_done_cb_t flush_done_cb;
+    void *flush_done_user_data;
+    volatile bool flush_pending;
+    // A color transfer is in flight, tx_color never queues a second one before the first is done
+    volatile bool color_busy;
+    // Given by panel_jd9613_color_trans_done, the task waiting for color_busy sleeps on it
+    SemaphoreHandle_t color_done;
+    int64_t flush_start_us;
+    volatile uint32_t transfer_us;
+    // Copy of the panel RAM for diff refresh, NULL when disabled
+    uint16_t *shadow_buffer;
+    diff_refresh_stats_t diff_stats;
+    // Last CASET/RASET window, RAMWR restarts at its origin so an unchanged window is not sent again
+    bool window_valid;
+    uint16_t window[4];
+    // Command queue, NULL when writes are issued by the caller
+    QueueHandle_t queue;
+    TaskHandle_t queue_task;
+    panel_queue_stats_t queue_stats;
 } jd9613_panel_t;
 
+typedef enum {
+    PANEL_OP_DRAW,
+    PANEL_OP_CMD,
+    PANEL_OP_SYNC,
+} panel_op_type_t;
+
+typedef struct {
+    panel_op_type_t type;
+    union {
+        struct {
+            int x_start;
+            int y_start;
+            int x_end;
+            int y_end;
+            const void *color_data;
+            const uint16_t *palette;
+        } draw;
+        struct {
+            int cmd;
+            uint8_t len;
+            uint8_t param[PANEL_QUEUE_MAX_PARAM];
+        } cmd;
+        TaskHandle_t sync;
+    };
+} panel_op_t;
+
 static esp_err_t panel_jd9613_del(esp_lcd_panel_t *panel);
 static esp_err_t panel_jd9613_reset(esp_lcd_panel_t *panel);
 static esp_err_t panel_jd9613_init(esp_lcd_panel_t *panel);
 static esp_err_t panel_jd9613_draw_bitmap(esp_lcd_panel_t *panel, int x_start, int y_start, int x_end, int y_end, const void *color_data);
 static esp_err_t panel_jd9613_set_rotation(esp_lcd_panel_t *panel, uint8_t r);
+static bool panel_jd9613_color_trans_done(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx);
+static esp_err_t panel_jd9613_write_bitmap(jd9613_panel_t *jd9613, int x_start, int y_start, int x_end, int y_end, const void *color_data, const uint16_t *palette);
+static esp_err_t panel_jd9613_submit_bitmap(jd9613_panel_t *jd9613, int x_start, int y_start, int x_end, int y_end, const void *color_data, const uint16_t *palette);
+static void panel_jd9613_queue_sync(jd9613_panel_t *jd9613);
+static void panel_jd9613_wait_color(jd9613_panel_t *jd9613);
 
 
 static esp_err_t esp_lcd_new_panel_jd9613(const esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_config_t *panel_dev_config, esp_lcd_panel_handle_t *ret_panel)
@@ -71,6 +142,13 @@ static esp_err_t esp_lcd_new_panel_jd9613(const esp_lcd_panel_io_handle_t io, co
         return ESP_FAIL;
     }
 
+    jd9613->color_done = xSemaphoreCreateBinary();
+    if (!jd9613->color_done) {
+        free(jd9613->frame_buffer);
+        free(jd9613);
+        return ESP_ERR_NO_MEM;
+    }
+
     if (panel_dev_config->reset_gpio_num >= 0) {
         pinMode(panel_dev_config->reset_gpio_num, OUTPUT);
     }
@@ -112,6 +190,10 @@ err:
         if (panel_dev_config->reset_gpio_num >= 0) {
             pinMode(panel_dev_config->reset_gpio_num, OPEN_DRAIN);
         }
+        if (jd9613->color_done) {
+            vSemaphoreDelete(jd9613->color_done);
+        }
+        free(jd9613->frame_buffer);
         free(jd9613);
     }
     return ret;
@@ -126,8 +208,16 @@ static esp_err_t panel_jd9613_del(esp_lcd_panel_t *panel)
         pinMode(jd9613->reset_gpio_num, OPEN_DRAIN);
     }
     log_d("del jd9613 panel @%p", jd9613);
-    free(jd9613);
+    if (jd9613->queue) {
+        panel_jd9613_queue_sync(jd9613);
+        vTaskDelete(jd9613->queue_task);
+        vQueueDelete(jd9613->queue);
+    }
+    panel_jd9613_wait_color(jd9613);
+    vSemaphoreDelete(jd9613->color_done);
     free(jd9613->frame_buffer);
+    free(jd9613->shadow_buffer);
+    free(jd9613);
     return ESP_OK;
 }
 
@@ -136,16 +226,17 @@ static esp_err_t panel_jd9613_reset(esp_lcd_panel_t *panel)
     jd9613_panel_t *jd9613 = __containerof(panel, jd9613_panel_t, base);
     esp_lcd_panel_io_handle_t io = jd9613->io;
 
+    jd9613->window_valid = false;
     // perform hardware reset
     if (jd9613->reset_gpio_num >= 0) {
         digitalWrite(jd9613->reset_gpio_num, jd9613->reset_level);
-        delay((100));
+        delay(JD9613_RESET_PULSE_MS);
         digitalWrite(jd9613->reset_gpio_num, !jd9613->reset_level);
-        delay((100));
+        delay(JD9613_RESET_WAIT_MS);
     } else {
         // perform software reset
         esp_lcd_panel_io_tx_param(io, LCD_CMD_SWRESET, NULL, 0);
-        delay((20)); // spec, wait at least 5ms before sending new command
+        delay(JD9613_RESET_WAIT_MS); // spec, wait at least 5ms before sending new command, 120ms from sleep out
     }
 
     return ESP_OK;
@@ -172,30 +263,229 @@ static esp_err_t panel_jd9613_init(esp_lcd_panel_t *panel)
     panel_jd9613_set_rotation(panel, jd9613->rotation);
 
     esp_lcd_panel_io_tx_param(io, LCD_CMD_SLPOUT, NULL, 0);
-    delay((120));
+    delay(JD9613_SLPOUT_WAIT_MS);
 
     esp_lcd_panel_io_tx_param(io, LCD_CMD_DISPON, NULL, 0);
-    delay((120));
+    delay(JD9613_DISPON_WAIT_MS);
 
     return ESP_OK;
 }
 
+static void panel_jd9613_set_window(jd9613_panel_t *jd9613, uint32_t xs, uint32_t ys, uint32_t xe, uint32_t ye)
+{
+    esp_lcd_panel_io_handle_t io = jd9613->io;
+    if (jd9613->window_valid && jd9613->window[0] == xs && jd9613->window[1] == ys &&
+            jd9613->window[2] == xe && jd9613->window[3] == ye) {
+        jd9613->queue_stats.window_skips++;
+        return;
+    }
+    // xe and ye are exclusive, the controller expects inclusive end addresses
+    uint8_t data1[] = {lowByte(xs >> 8), lowByte(xs), lowByte((xe - 1) >> 8), lowByte(xe - 1)};
+    esp_lcd_panel_io_tx_param(io, LCD_CMD_CASET, data1, 4);
+    uint8_t data2[] = {lowByte(ys >> 8), lowByte(ys), lowByte((ye - 1) >> 8), lowByte(ye - 1)};
+    esp_lcd_panel_io_tx_param(io, LCD_CMD_RASET, data2, 4);
+    jd9613->window[0] = xs;
+    jd9613->window[1] = ys;
+    jd9613->window[2] = xe;
+    jd9613->window[3] = ye;
+    jd9613->window_valid = true;
+}
+
+// A cached window skips the CASET/RASET that used to wait for the previous transfer,
+// wait here before frame_buffer is written again. Only the ISR clears color_busy and it
+// gives color_done right after, a give left over from an earlier transfer just loops once.
+static void panel_jd9613_wait_color(jd9613_panel_t *jd9613)
+{
+    while (jd9613->color_busy) {
+        xSemaphoreTake(jd9613->color_done, portMAX_DELAY);
+    }
+}
+
+// flush: the transfer completes a pushColors and raises flush_done_cb
+static void panel_jd9613_tx_color(jd9613_panel_t *jd9613, const void *color, size_t color_size, bool flush)
+{
+    // The done callback of a transfer still in flight must not see the new flush_pending
+    panel_jd9613_wait_color(jd9613);
+    jd9613->flush_pending = flush;
+    jd9613->color_busy = true;
+    esp_lcd_panel_io_tx_color(jd9613->io, LCD_CMD_RAMWR, color, color_size);
+}
+
+static void panel_jd9613_queue_task(void *arg)
+{
+    jd9613_panel_t *jd9613 = (jd9613_panel_t *)arg;
+    panel_op_t op;
+    while (1) {
+        xQueueReceive(jd9613->queue, &op, portMAX_DELAY);
+        switch (op.type) {
+        case PANEL_OP_DRAW:
+            panel_jd9613_write_bitmap(jd9613, op.draw.x_start, op.draw.y_start, op.draw.x_end, op.draw.y_end, op.draw.color_data, op.draw.palette);
+            break;
+        case PANEL_OP_CMD:
+            jd9613->window_valid = false;
+            esp_lcd_panel_io_tx_param(jd9613->io, op.cmd.cmd, op.cmd.len ? op.cmd.param : NULL, op.cmd.len);
+            break;
+        case PANEL_OP_SYNC:
+            xTaskNotifyGive(op.sync);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+static void panel_jd9613_queue_send(jd9613_panel_t *jd9613, const panel_op_t *op)
+{
+    panel_queue_stats_t *stats = &jd9613->queue_stats;
+    if (xQueueSend(jd9613->queue, op, 0) != pdTRUE) {
+        // Back-pressure, block until the queue task frees a slot
+        int64_t start = esp_timer_get_time();
+        xQueueSend(jd9613->queue, op, portMAX_DELAY);
+        stats->stalls++;
+        stats->stall_us += esp_timer_get_time() - start;
+    }
+    stats->queued++;
+    uint16_t depth = uxQueueMessagesWaiting(jd9613->queue);
+    if (depth > stats->max_depth) {
+        stats->max_depth = depth;
+    }
+}
+
+// Wait until every queued operation has been issued, the last pixels may still be in flight
+static void panel_jd9613_queue_sync(jd9613_panel_t *jd9613)
+{
+    if (!jd9613->queue) {
+        return;
+    }
+    panel_op_t op;
+    op.type = PANEL_OP_SYNC;
+    op.sync = xTaskGetCurrentTaskHandle();
+    panel_jd9613_queue_send(jd9613, &op);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+static bool panel_jd9613_row_equal(const uint16_t *a, const uint16_t *b, uint32_t len)
+{
+    // Compare two pixels at a time when both rows allow it
+    if (!(len & 1) && !(((uintptr_t)a | (uintptr_t)b) & 3)) {
+        const uint32_t *a32 = (const uint32_t *)a;
+        const uint32_t *b32 = (const uint32_t *)b;
+        for (uint32_t i = 0; i < len / 2; i++) {
+            if (a32[i] != b32[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    for (uint32_t i = 0; i < len; i++) {
+        if (a[i] != b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Write only the rows of the window that differ from shadow_buffer
+static void panel_jd9613_write_diff(jd9613_panel_t *jd9613, uint32_t x, uint32_t y, uint32_t xe, uint32_t ye, uint32_t x_gap, const uint16_t *data)
+{
+    diff_refresh_stats_t *stats = &jd9613->diff_stats;
+    uint32_t width = xe - x;
+    uint32_t height = ye - y;
+    uint16_t *shadow = jd9613->shadow_buffer + y * jd9613->width + (x - x_gap);
+    // Runs of changed rows, last is exclusive
+    uint16_t first[DIFF_REFRESH_MAX_BURSTS];
+    uint16_t last[DIFF_REFRESH_MAX_BURSTS];
+    uint32_t runs = 0;
+    uint32_t changed = 0;
+
+    for (uint32_t row = 0; row < height; row++) {
+        const uint16_t *src = data + row * width;
+        uint16_t *dst = shadow + row * jd9613->width;
+        if (panel_jd9613_row_equal(src, dst, width)) {
+            continue;
+        }
+        memcpy(dst, src, width * sizeof(uint16_t));
+        changed++;
+        if (runs && (row - last[runs - 1] <= DIFF_REFRESH_MERGE_ROWS || runs == DIFF_REFRESH_MAX_BURSTS)) {
+            last[runs - 1] = row + 1;
+        } else {
+            first[runs] = row;
+            last[runs] = row + 1;
+            runs++;
+        }
+    }
+
+    // When most rows changed a single burst is cheaper than several window setups
+    if (runs > 1 && changed * 4 >= height * 3) {
+        last[0] = last[runs - 1];
+        runs = 1;
+    }
+
+    uint32_t sent = 0;
+    for (uint32_t i = 0; i < runs; i++) {
+        sent += (last[i] - first[i]) * width * sizeof(uint16_t);
+    }
+    stats->bytes_sent = sent;
+    stats->bytes_saved = width * height * sizeof(uint16_t) - sent;
+    stats->bursts = runs;
+    stats->flushes++;
+    stats->total_bytes_saved += stats->bytes_saved;
+
+    jd9613->flush_start_us = esp_timer_get_time();
+    if (!runs) {
+        // Nothing to send, the flush is already complete, in the calling task
+        jd9613->transfer_us = 0;
+        if (jd9613->flush_done_cb) {
+            jd9613->flush_done_cb(jd9613->flush_done_user_data, false);
+        }
+        return;
+    }
+    for (uint32_t i = 0; i < runs; i++) {
+        // Setting the window waits for the previous burst, only the last one completes the flush
+        panel_jd9613_set_window(jd9613, x, y + first[i], xe, y + last[i]);
+        panel_jd9613_tx_color(jd9613, data + first[i] * width, (last[i] - first[i]) * width * sizeof(uint16_t), i == runs - 1);
+    }
+}
+
 static esp_err_t panel_jd9613_draw_bitmap(esp_lcd_panel_t *panel, int x_start, int y_start, int x_end, int y_end, const void *color_data)
 {
     jd9613_panel_t *jd9613 = __containerof(panel, jd9613_panel_t, base);
+    return panel_jd9613_submit_bitmap(jd9613, x_start, y_start, x_end, y_end, color_data, NULL);
+}
+
+// palette: color_data holds 8-bit indexes instead of RGB565 pixels
+static esp_err_t panel_jd9613_submit_bitmap(jd9613_panel_t *jd9613, int x_start, int y_start, int x_end, int y_end, const void *color_data, const uint16_t *palette)
+{
     assert((x_start < x_end) && (y_start < y_end) && "start position must be smaller than end position");
-    esp_lcd_panel_io_handle_t io = jd9613->io;
+    if (!jd9613->queue) {
+        return panel_jd9613_write_bitmap(jd9613, x_start, y_start, x_end, y_end, color_data, palette);
+    }
+    // Rotation, diff and window setup run in the queue task, color_data must stay valid until the flush is done
+    panel_op_t op;
+    op.type = PANEL_OP_DRAW;
+    op.draw.x_start = x_start;
+    op.draw.y_start = y_start;
+    op.draw.x_end = x_end;
+    op.draw.y_end = y_end;
+    op.draw.color_data = color_data;
+    op.draw.palette = palette;
+    panel_jd9613_queue_send(jd9613, &op);
+    return ESP_OK;
+}
 
-    uint32_t width = x_start + x_end;
-    uint32_t height = y_start + y_end;
+static esp_err_t panel_jd9613_write_bitmap(jd9613_panel_t *jd9613, int x_start, int y_start, int x_end, int y_end, const void *color_data, const uint16_t *palette)
+{
+    // x_end and y_end are exclusive, color_data holds width * height packed pixels
+    uint32_t width = x_end - x_start;
+    uint32_t height = y_end - y_start;
     uint32_t _x = x_start,
              _y = y_start,
-             _xe = width,
-             _ye = height;
+             _xe = x_end,
+             _ye = y_end;
     size_t write_colors_bytes = width * height * sizeof(uint16_t);
     uint16_t *data_ptr = (uint16_t *)color_data;
 
-    // log_i("%s W:%lu H:%lu B:%lu\n", __func__, width, height, write_colors_bytes);
+    // log_i("%s X:%d Y:%d W:%lu H:%lu B:%lu\n", __func__, x_start, y_start, width, height, write_colors_bytes);
 
 #ifdef SW_ROTATION
     bool sw_rotation = false;
@@ -209,41 +499,88 @@ static esp_err_t panel_jd9613_draw_bitmap(esp_lcd_panel_t *panel, int x_start, i
         break;
     }
 
-    if (sw_rotation) {
-        _x = JD9613_WIDTH - (y_start + height);
+    if (jd9613->rotation == 1) {
+        // Logical rows become panel columns counted from the right edge,
+        // logical columns become panel rows
+        _x = JD9613_WIDTH - y_end;
         _y = x_start;
-        _xe = height;
-        _ye = width;
+    } else if (jd9613->rotation == 3) {
+        // Logical rows become panel columns,
+        // logical columns become panel rows counted from the bottom edge
+        _x = y_start;
+        _y = JD9613_HEIGHT - x_end;
+    }
+    if (sw_rotation) {
+        _xe = _x + height;
+        _ye = _y + width;
     }
 #endif
 
     // Direction 2 requires offset pixels
+    uint32_t x_gap = 0;
     if (jd9613->rotation == 2) {
-        _x += 2;
-        _xe += 2;
+        x_gap = 2;
+        _x += x_gap;
+        _xe += x_gap;
     }
 
-    uint8_t data1[] = {lowByte(_x >> 8), lowByte(_x), lowByte((_xe - 1) >> 8), lowByte(_xe - 1)};
-    esp_lcd_panel_io_tx_param(io, LCD_CMD_CASET, data1, 4);
-    uint8_t data2[] = {lowByte(_y >> 8), lowByte(_y), lowByte((_ye - 1) >> 8), lowByte(_ye - 1)};
-    esp_lcd_panel_io_tx_param(io, LCD_CMD_RASET, data2, 4);
+    if (!jd9613->shadow_buffer) {
+        panel_jd9613_set_window(jd9613, _x, _y, _xe, _ye);
+    }
 
 #ifdef SW_ROTATION
     if (sw_rotation) {
-        int index = 0;
-        uint16_t *pdat = (uint16_t *)color_data;
-        for (uint16_t j = 0; j < width; j++) {
-            for (uint16_t i = 0; i < height; i++) {
-                jd9613->frame_buffer[index++] = pdat[width * (height - i - 1) + j];
+        panel_jd9613_wait_color(jd9613);
+        if (palette) {
+            if (jd9613->rotation == 1) {
+                rotate_index8_cw((const uint8_t *)color_data, jd9613->frame_buffer, width, height, palette);
+            } else {
+                rotate_index8_ccw((const uint8_t *)color_data, jd9613->frame_buffer, width, height, palette);
             }
+        } else if (jd9613->rotation == 1) {
+            rotate_rgb565_cw((const uint16_t *)color_data, jd9613->frame_buffer, width, height);
+        } else {
+            rotate_rgb565_ccw((const uint16_t *)color_data, jd9613->frame_buffer, width, height);
         }
         data_ptr = jd9613->frame_buffer;
     }
 #endif
-    esp_lcd_panel_io_tx_color(io, LCD_CMD_RAMWR, data_ptr, write_colors_bytes);
+    if (palette && data_ptr != jd9613->frame_buffer) {
+        panel_jd9613_wait_color(jd9613);
+        expand_index8((const uint8_t *)color_data, jd9613->frame_buffer, width * height, palette);
+        data_ptr = jd9613->frame_buffer;
+    }
+    if (jd9613->shadow_buffer) {
+        panel_jd9613_write_diff(jd9613, _x, _y, _xe, _ye, x_gap, data_ptr);
+        return ESP_OK;
+    }
+    // Data chunks are queued, the transfer completes in panel_jd9613_color_trans_done
+    jd9613->flush_start_us = esp_timer_get_time();
+    panel_jd9613_tx_color(jd9613, data_ptr, write_colors_bytes, true);
     return ESP_OK;
 }
 
+static bool panel_jd9613_color_trans_done(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
+{
+    esp_lcd_panel_handle_t panel = *(esp_lcd_panel_handle_t *)user_ctx;
+    if (!panel) {
+        return false;
+    }
+    jd9613_panel_t *jd9613 = __containerof(panel, jd9613_panel_t, base);
+    BaseType_t woken = pdFALSE;
+    jd9613->color_busy = false;
+    xSemaphoreGiveFromISR(jd9613->color_done, &woken);
+    if (!jd9613->flush_pending) {
+        return woken == pdTRUE;
+    }
+    jd9613->flush_pending = false;
+    jd9613->transfer_us = esp_timer_get_time() - jd9613->flush_start_us;
+    if (jd9613->flush_done_cb) {
+        jd9613->flush_done_cb(jd9613->flush_done_user_data, true);
+    }
+    return woken == pdTRUE;
+}
+
 #define  LCD_CMD_RGB 0x00
 //There is only 1/2 RAM inside the JD9613 screen, and it cannot be rotated in directions 1 and 3.
 static esp_err_t panel_jd9613_set_rotation(esp_lcd_panel_t *panel, uint8_t r)
@@ -300,6 +637,7 @@ static esp_err_t panel_jd9613_set_rotation(esp_lcd_panel_t *panel, uint8_t r)
     }
     // write_data |= 0x01; //Flip Vertical
     jd9613->rotation = r;
+    jd9613->window_valid = false;
     log_i("set_rotation:%d write reg :0x%X , data : 0x%X Width:%d Height:%d", r, LCD_CMD_MADCTL, write_data, jd9613->width, jd9613->height);
     esp_lcd_panel_io_tx_param(io, LCD_CMD_MADCTL, &write_data, 1);
     return ESP_OK;
@@ -332,6 +670,7 @@ static esp_err_t panel_jd9613_set_rotation(esp_lcd_panel_t *panel, uint8_t r)
     write_data |= (0x01 << 1); //Flip Horizontal
     // write_data |= 0x01; //Flip Vertical
     jd9613->rotation = r;
+    jd9613->window_valid = false;
     log_i("set_rotation:%d write reg :0x%X , data : 0x%X Width:%d Height:%d", r, LCD_CMD_MADCTL, write_data, jd9613->width, jd9613->height);
     esp_lcd_panel_io_tx_param(io, LCD_CMD_MADCTL, &write_data, 1);
     return ESP_OK;
@@ -344,7 +683,7 @@ static bool touchPadReadFunction()
     return touchInterruptGetLastStatus(BOARD_TOUCH_BUTTON) == 0;
 }
 
-LilyGo_Wristband::LilyGo_Wristband(): _brightness(AMOLED_DEFAULT_BRIGHTNESS), panel_handle(NULL), threshold(2000)
+LilyGo_Wristband::LilyGo_Wristband(): _brightness(AMOLED_DEFAULT_BRIGHTNESS), _fullRefresh(true), _sensorsDone(false), _sensorsEvent(NULL), panel_handle(NULL), threshold(2000)
 {
 }
 
@@ -379,14 +718,30 @@ bool LilyGo_Wristband::isPressed()
     return touchInterruptGetLastStatus(BOARD_TOUCH_BUTTON);
 }
 
-bool LilyGo_Wristband::begin()
+void LilyGo_Wristband::sensorsTask(void *arg)
+{
+    static_cast<LilyGo_Wristband *>(arg)->initSensors();
+    vTaskDelete(NULL);
+}
+
+bool LilyGo_Wristband::begin(bool waitSensors)
 {
     if (panel_handle) {
         return true;
     }
 
+    // The RTC and the motion sensor are on their own buses, the BHI260AP firmware upload
+    // is the slowest step of the boot so it runs on core 0 while the panel comes up
+    _sensorsEvent = xSemaphoreCreateBinary();
+    if (!_sensorsEvent || xTaskCreatePinnedToCore(sensorsTask, "sensors", 8192, this, 1, NULL, 0) != pdPASS) {
+        log_e("create sensors task failed");
+        initSensors();
+    }
+
     // Initialize display
+    int phase = bootPhaseBegin("display");
     initBUS();
+    bootPhaseEnd(phase);
 
     // Initialize touch button
     touchAttachInterrupt(BOARD_TOUCH_BUTTON, touchISR, threshold);
@@ -396,6 +751,15 @@ bool LilyGo_Wristband::begin()
     // Initialize vibration motor
     tone(BOARD_VIBRATION_PIN, 1000, 50);
 
+    if (waitSensors) {
+        waitSensorsReady();
+    }
+    return true;
+}
+
+void LilyGo_Wristband::initSensors()
+{
+    int phase = bootPhaseBegin("rtc");
     Wire.begin(BOARD_I2C_SDA, BOARD_I2C_SCL);
 
     // Initialize RTC PCF85063
@@ -403,23 +767,44 @@ bool LilyGo_Wristband::begin()
     if (!result) {
         log_e("Real time clock initialization failed!");
     }
+    bootPhaseEnd(phase);
 
     pinMode(BOARD_BHI_EN, OUTPUT);
     digitalWrite(BOARD_BHI_EN, HIGH);
 
     // Initialize Sensor
+    phase = bootPhaseBegin("bhi260ap");
     SensorBHI260AP::setPins(BOARD_BHI_RST, BOARD_BHI_IRQ);
     result = SensorBHI260AP::init(SPI, BOARD_BHI_CS, BOARD_BHI_MOSI, BOARD_BHI_MISO, BOARD_BHI_SCK);
     if (!result) {
         log_e("Motion sensor initialization failed!");
     }
+    bootPhaseEnd(phase);
 
-    return true;
+    _sensorsDone = true;
+    if (_sensorsEvent) {
+        xSemaphoreGive(_sensorsEvent);
+    }
+}
+
+bool LilyGo_Wristband::waitSensorsReady(TickType_t ticks_to_wait)
+{
+    if (_sensorsDone) {
+        return true;
+    }
+    if (_sensorsEvent && xSemaphoreTake(_sensorsEvent, ticks_to_wait) == pdTRUE) {
+        // Leave the event set for the next caller
+        xSemaphoreGive(_sensorsEvent);
+    }
+    return _sensorsDone;
 }
 
 void LilyGo_Wristband::update()
 {
-    SensorBHI260AP::update();
+    // The sensor may still be loading its firmware after begin(false)
+    if (_sensorsDone) {
+        SensorBHI260AP::update();
+    }
     LilyGo_Button::update();
 }
 
@@ -443,7 +828,14 @@ uint8_t LilyGo_Wristband::getBrightness()
 void LilyGo_Wristband::setRotation(uint8_t rotation)
 {
     assert(panel_handle);
+    jd9613_panel_t *jd9613 = __containerof(panel_handle, jd9613_panel_t, base);
+    // Queued draws were issued for the old rotation
+    panel_jd9613_queue_sync(jd9613);
     panel_jd9613_set_rotation(panel_handle, rotation);
+    if (jd9613->shadow_buffer) {
+        // The shadow no longer matches the panel layout, start again from a known state
+        fillScreen(0x0000);
+    }
 }
 
 uint8_t LilyGo_Wristband::getRotation()
@@ -457,31 +849,41 @@ void LilyGo_Wristband::setAddrWindow(uint16_t xs, uint16_t ys, uint16_t w, uint1
 {
     assert(panel_handle);
     jd9613_panel_t *jd9613 = __containerof(panel_handle, jd9613_panel_t, base);
-    uint8_t data1[] = {lowByte(xs >> 8), lowByte(xs), lowByte((xs + w - 1) >> 8), lowByte(xs + w - 1)};
-    esp_lcd_panel_io_tx_param(jd9613->io, LCD_CMD_CASET, data1, 4);
-    uint8_t data2[] = {lowByte(ys >> 8), lowByte(ys), lowByte((ys + h - 1) >> 8), lowByte(ys + h - 1)};
-    esp_lcd_panel_io_tx_param(jd9613->io, LCD_CMD_RASET, data2, 4);
+    panel_jd9613_queue_sync(jd9613);
+    panel_jd9613_set_window(jd9613, xs, ys, xs + w, ys + h);
 }
 
 void LilyGo_Wristband::flipHorizontal(bool enable)
 {
     assert(panel_handle);
     jd9613_panel_t *jd9613 = __containerof(panel_handle, jd9613_panel_t, base);
+    panel_jd9613_queue_sync(jd9613);
     jd9613->flipHorizontal = enable;
     panel_jd9613_set_rotation(panel_handle, jd9613->rotation);
+    if (jd9613->shadow_buffer) {
+        fillScreen(0x0000);
+    }
 }
 
 void LilyGo_Wristband::pushColors(uint16_t *data, uint32_t len)
 {
     assert(panel_handle);
     jd9613_panel_t *jd9613 = __containerof(panel_handle, jd9613_panel_t, base);
-    esp_lcd_panel_io_tx_color(jd9613->io, LCD_CMD_RAMWR, data, len);
+    panel_jd9613_queue_sync(jd9613);
+    panel_jd9613_tx_color(jd9613, data, len, false);
 }
 
 void LilyGo_Wristband::pushColors(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t *data)
 {
     assert(panel_handle);
-    esp_lcd_panel_draw_bitmap(panel_handle, x, y, width, height, data);
+    esp_lcd_panel_draw_bitmap(panel_handle, x, y, x + width, y + height, data);
+}
+
+void LilyGo_Wristband::pushIndexedColors(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t *data, const uint16_t *palette)
+{
+    assert(panel_handle);
+    jd9613_panel_t *jd9613 = __containerof(panel_handle, jd9613_panel_t, base);
+    panel_jd9613_submit_bitmap(jd9613, x, y, x + width, y + height, data, palette);
 }
 
 bool LilyGo_Wristband::initBUS()
@@ -514,8 +916,9 @@ bool LilyGo_Wristband::initBUS()
     io_config.spi_mode = 0;
     io_config.pclk_hz = DEFAULT_SCK_SPEED;
     io_config.trans_queue_depth = 10;
-    io_config.on_color_trans_done = NULL;
-    io_config.user_ctx = NULL;
+    io_config.on_color_trans_done = panel_jd9613_color_trans_done;
+    // panel_handle is assigned below, the callback ignores transfers issued before that
+    io_config.user_ctx = &panel_handle;
     io_config.lcd_cmd_bits = 8;
     io_config.lcd_param_bits = 8;
 
@@ -549,9 +952,13 @@ bool LilyGo_Wristband::initBUS()
     log_i( "Install JD9613 panel driver");
     ESP_ERROR_CHECK(esp_lcd_new_panel_jd9613(io_handle, &panel_config, &panel_handle));
 
+    int phase = bootPhaseBegin("panel reset");
     ESP_ERROR_CHECK(esp_lcd_panel_reset(panel_handle));
+    bootPhaseEnd(phase);
 
+    phase = bootPhaseBegin("panel init");
     ESP_ERROR_CHECK(esp_lcd_panel_init(panel_handle));
+    bootPhaseEnd(phase);
 
     return true;
 }
@@ -559,6 +966,18 @@ bool LilyGo_Wristband::initBUS()
 void LilyGo_Wristband::writeCommand(uint32_t cmd, uint8_t *pdat, uint32_t length)
 {
     jd9613_panel_t *jd9613 = __containerof(panel_handle, jd9613_panel_t, base);
+    if (jd9613->queue && length <= PANEL_QUEUE_MAX_PARAM) {
+        panel_op_t op;
+        op.type = PANEL_OP_CMD;
+        op.cmd.cmd = cmd;
+        op.cmd.len = length;
+        memcpy(op.cmd.param, pdat, length);
+        panel_jd9613_queue_send(jd9613, &op);
+        return;
+    }
+    panel_jd9613_queue_sync(jd9613);
+    // The command may move the window behind the cache's back
+    jd9613->window_valid = false;
     esp_lcd_panel_io_tx_param(jd9613->io, cmd, pdat, length);
 }
 
@@ -573,6 +992,7 @@ void LilyGo_Wristband::sleep()
 {
     lcd_cmd_t t = {0x10, {0x00}, 1}; //Sleep in
     writeCommand(t.addr, t.param, t.len);
+    panel_jd9613_queue_sync(__containerof(panel_handle, jd9613_panel_t, base));
 
     detachInterrupt(BOARD_RTC_IRQ);
 
@@ -666,11 +1086,51 @@ void LilyGo_Wristband::vibration(uint8_t duty, uint32_t delay_ms)
     tone(BOARD_VIBRATION_PIN, 1000, delay_ms);
 }
 
-bool LilyGo_Wristband::needFullRefresh()
+void LilyGo_Wristband::fillScreen(uint16_t color)
+{
+    assert(panel_handle);
+    jd9613_panel_t *jd9613 = __containerof(panel_handle, jd9613_panel_t, base);
+    uint32_t x = jd9613->rotation == 2 ? 2 : 0;
+    panel_jd9613_queue_sync(jd9613);
+    panel_jd9613_wait_color(jd9613);
+    panel_jd9613_set_window(jd9613, x, 0, x + jd9613->width, jd9613->height);
+    uint32_t len = jd9613->width * jd9613->height;
+    for (uint32_t i = 0; i < len; i++) {
+        jd9613->frame_buffer[i] = color;
+    }
+    if (jd9613->shadow_buffer) {
+        memcpy(jd9613->shadow_buffer, jd9613->frame_buffer, len * sizeof(uint16_t));
+    }
+    panel_jd9613_tx_color(jd9613, jd9613->frame_buffer, len * sizeof(uint16_t), false);
+}
+
+bool LilyGo_Wristband::setFlushDoneCallback(disp_flush_done_cb_t cb, void *user_data)
 {
+    assert(panel_handle);
+    jd9613_panel_t *jd9613 = __containerof(panel_handle, jd9613_panel_t, base);
+    jd9613->flush_done_cb = NULL;
+    jd9613->flush_done_user_data = user_data;
+    jd9613->flush_done_cb = cb;
     return true;
 }
 
+uint32_t LilyGo_Wristband::getTransferTime()
+{
+    assert(panel_handle);
+    jd9613_panel_t *jd9613 = __containerof(panel_handle, jd9613_panel_t, base);
+    return jd9613->transfer_us;
+}
+
+bool LilyGo_Wristband::needFullRefresh()
+{
+    return _fullRefresh;
+}
+
+void LilyGo_Wristband::setFullRefresh(bool enable)
+{
+    _fullRefresh = enable;
+}
+
 bool LilyGo_Wristband::initMicrophone()
 {
     static i2s_config_t i2s_config = {
@@ -709,3 +1169,72 @@ bool LilyGo_Wristband::readMicrophone(void *dest, size_t size, size_t *bytes_rea
 {
     return i2s_read(MIC_I2S_PORT, dest, size, bytes_read, ticks_to_wait) == ESP_OK;
 }
+
+bool LilyGo_Wristband::setDiffRefresh(bool enable)
+{
+    assert(panel_handle);
+    jd9613_panel_t *jd9613 = __containerof(panel_handle, jd9613_panel_t, base);
+    if (!enable) {
+        panel_jd9613_queue_sync(jd9613);
+        free(jd9613->shadow_buffer);
+        jd9613->shadow_buffer = NULL;
+        return true;
+    }
+    if (jd9613->shadow_buffer) {
+        return true;
+    }
+    size_t size = JD9613_WIDTH * JD9613_HEIGHT * sizeof(uint16_t);
+    // The shadow is compared on every flush, prefer internal RAM
+    uint16_t *shadow = (uint16_t *)heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!shadow) {
+        shadow = (uint16_t *)ps_malloc(size);
+    }
+    if (!shadow) {
+        log_e("no mem for diff refresh");
+        return false;
+    }
+    memset(&jd9613->diff_stats, 0, sizeof(diff_refresh_stats_t));
+    jd9613->shadow_buffer = shadow;
+    // The panel content is unknown, clear it so panel and shadow match
+    fillScreen(0x0000);
+    return true;
+}
+
+void LilyGo_Wristband::getDiffRefreshStats(diff_refresh_stats_t *stats)
+{
+    assert(panel_handle);
+    jd9613_panel_t *jd9613 = __containerof(panel_handle, jd9613_panel_t, base);
+    *stats = jd9613->diff_stats;
+}
+
+bool LilyGo_Wristband::enableCommandQueue(uint32_t depth, BaseType_t core)
+{
+    assert(panel_handle);
+    jd9613_panel_t *jd9613 = __containerof(panel_handle, jd9613_panel_t, base);
+    if (jd9613->queue) {
+        return true;
+    }
+    QueueHandle_t queue = xQueueCreate(depth, sizeof(panel_op_t));
+    if (!queue) {
+        log_e("no mem for panel queue");
+        return false;
+    }
+    memset(&jd9613->queue_stats, 0, sizeof(panel_queue_stats_t));
+    jd9613->queue = queue;
+    if (xTaskCreatePinnedToCore(panel_jd9613_queue_task, "panel", 4096, jd9613,
+                                PANEL_QUEUE_TASK_PRIORITY, &jd9613->queue_task, core) != pdPASS) {
+        log_e("create panel task failed");
+        jd9613->queue = NULL;
+        vQueueDelete(queue);
+        return false;
+    }
+    return true;
+}
+
+void LilyGo_Wristband::getCommandQueueStats(panel_queue_stats_t *stats)
+{
+    assert(panel_handle);
+    jd9613_panel_t *jd9613 = __containerof(panel_handle, jd9613_panel_t, base);
+    *stats = jd9613->queue_stats;
+    stats->depth = jd9613->queue ? uxQueueMessagesWaiting(jd9613->queue) : 0;
+}
@@ -69,6 +69,39 @@
 #define MIC_I2S_PORT                I2S_NUM_0
 #define MIC_I2S_BITS_PER_SAMPLE     I2S_BITS_PER_SAMPLE_16BIT
 
+// The area visible through the T-GlassV2 prism in portrait orientation, see setViewport
+#define GLASS_VIEWPORT_X            (0)
+#define GLASS_VIEWPORT_Y            (168)
+#define GLASS_VIEWPORT_WIDTH        (126)
+#define GLASS_VIEWPORT_HEIGHT       (126)
+
+// Scanline diff refresh, see setDiffRefresh
+#define DIFF_REFRESH_MAX_BURSTS     (8)
+// Unchanged rows between two changed runs that are still sent to save a window setup
+#define DIFF_REFRESH_MERGE_ROWS     (2)
+
+// Panel command queue, see enableCommandQueue
+#define PANEL_QUEUE_DEPTH           (16)
+#define PANEL_QUEUE_MAX_PARAM       (20)
+#define PANEL_QUEUE_TASK_PRIORITY   (3)
+
+typedef struct {
+    uint16_t depth;             // Operations waiting right now
+    uint16_t max_depth;
+    uint32_t queued;
+    uint32_t stalls;            // Times the caller waited for a free slot
+    uint32_t stall_us;
+    uint32_t window_skips;      // CASET/RASET pairs not sent because the window did not change
+} panel_queue_stats_t;
+
+typedef struct {
+    uint32_t bytes_sent;        // Pixel bytes written by the last pushColors
+    uint32_t bytes_saved;       // Pixel bytes of the last pushColors that matched the panel
+    uint16_t bursts;            // CASET/RASET/RAMWR bursts of the last pushColors
+    uint32_t flushes;
+    uint64_t total_bytes_saved;
+} diff_refresh_stats_t;
+
 
 class LilyGo_Wristband :
     public LilyGo_Display,
@@ -80,7 +113,10 @@ public:
     LilyGo_Wristband();
     ~LilyGo_Wristband();
 
-    bool begin();
+    // waitSensors false: return once the display is up, the RTC and motion sensor
+    // keep starting on core 0, see waitSensorsReady
+    bool begin(bool waitSensors = true);
+    bool waitSensorsReady(TickType_t ticks_to_wait = portMAX_DELAY);
 
     void update();
 
@@ -104,6 +140,24 @@ public:
 
     // Software rotation is possible
     void pushColors(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, uint16_t *data);
+    // Expanded and rotated straight into the DMA buffer
+    void pushIndexedColors(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t *data, const uint16_t *palette);
+
+    // pushColors returns once the transfer is queued, cb runs in ISR context when it is done
+    bool setFlushDoneCallback(disp_flush_done_cb_t cb, void *user_data);
+    // Duration of the last pushColors DMA transfer in microseconds
+    uint32_t getTransferTime();
+
+    // Compare every pushColors row with the last pixels sent and only write the changed rows.
+    // Costs a panel sized shadow buffer, mostly useful with full refresh.
+    // Enabling clears the panel, call it before beginLvglHelper.
+    bool setDiffRefresh(bool enable);
+    void getDiffRefreshStats(diff_refresh_stats_t *stats);
+
+    // Hand pushColors and writeCommand to a task on the given core so the caller returns at once.
+    // Window setup, rotation and diffing run in that task, calls that need the panel idle wait for it.
+    bool enableCommandQueue(uint32_t depth = PANEL_QUEUE_DEPTH, BaseType_t core = 0);
+    void getCommandQueueStats(panel_queue_stats_t *stats);
 
     uint16_t  width();
     uint16_t  height();
@@ -119,14 +173,22 @@ public:
     void sleep();
     void wakeup();
     bool needFullRefresh();
+    void fillScreen(uint16_t color);
+    // false: only the dirty areas reported by LVGL are written to the panel
+    void setFullRefresh(bool enable);
 
     bool initMicrophone();
     bool readMicrophone(void *dest, size_t size, size_t *bytes_read, TickType_t ticks_to_wait = portMAX_DELAY);
 
 private:
     bool initBUS();
+    void initSensors();
+    static void sensorsTask(void *arg);
     void writeCommand(uint32_t cmd, uint8_t *pdat, uint32_t length);
     uint8_t _brightness;
+    bool _fullRefresh;
+    volatile bool _sensorsDone;
+    SemaphoreHandle_t _sensorsEvent;
     esp_lcd_panel_handle_t panel_handle ;
     int  threshold ;
 };
@@ -23,11 +23,19 @@
    COLOR SETTINGS
  *====================*/
 
-/*Color depth: 1 (1 byte per pixel), 8 (RGB332), 16 (RGB565), 32 (ARGB8888)*/
+/*Color depth: 1 (1 byte per pixel), 8 (RGB332), 16 (RGB565), 32 (ARGB8888)
+ *8 halves the draw buffers and blend work of the monochrome HUD, LV_Helper expands
+ *the RGB332 pixels to RGB565 while flushing*/
+#ifndef LV_COLOR_DEPTH
 #define LV_COLOR_DEPTH 16
+#endif
 
 /*Swap the 2 bytes of RGB565 color. Useful if the display has an 8-bit interface (e.g. SPI)*/
+#if LV_COLOR_DEPTH == 16
 #define LV_COLOR_16_SWAP 1
+#else
+#define LV_COLOR_16_SWAP 0
+#endif
 
 /*Enable features to draw on transparent background.
  *It's required if opa, and transform_* style properties are used.